@@ -0,0 +1,485 @@
+/*
+  This code measures the throughput of residual and Jacobian assembly
+  for point kernels taken from the demos, and reports setup time,
+  assembly rates (elements/s, DoF/s), solve time, and the memory
+  high-water mark as one JSON record per run.
+
+  keywords: benchmark, assembly, performance
+ */
+#include "petiga.h"
+
+#if PETSC_VERSION_LT(3,5,0)
+#define KSPSetOperators(ksp,A,B) KSPSetOperators(ksp,A,B,SAME_NONZERO_PATTERN)
+#endif
+
+typedef struct {
+  PetscReal lambda,mu;   /* elasticity */
+  PetscReal theta,alpha; /* Cahn-Hilliard */
+  PetscReal nu,tau;      /* Navier-Stokes */
+} AppCtx;
+
+/* Poisson, as in Poisson3D */
+
+#undef  __FUNCT__
+#define __FUNCT__ "PoissonFunction"
+PetscErrorCode PoissonFunction(IGAPoint p,const PetscScalar *U,PetscScalar *F,void *ctx)
+{
+  PetscInt a,i,nen = p->nen,dim = p->dim;
+  const PetscReal *N0 = p->shape[0], *N1 = p->shape[1];
+  PetscScalar u1[3];
+  IGAPointFormGrad(p,U,u1);
+  for (a=0; a<nen; a++) {
+    PetscScalar Fa = -N0[a];
+    for (i=0; i<dim; i++) Fa += N1[a*dim+i]*u1[i];
+    F[a] = Fa;
+  }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "PoissonJacobian"
+PetscErrorCode PoissonJacobian(IGAPoint p,const PetscScalar *U,PetscScalar *J,void *ctx)
+{
+  PetscInt a,b,i,nen = p->nen,dim = p->dim;
+  const PetscReal *N1 = p->shape[1];
+  for (a=0; a<nen; a++)
+    for (b=0; b<nen; b++) {
+      PetscReal Kab = 0;
+      for (i=0; i<dim; i++) Kab += N1[a*dim+i]*N1[b*dim+i];
+      J[a*nen+b] = Kab;
+    }
+  return 0;
+}
+
+/* Linear elasticity, as in Elasticity3D */
+
+#undef  __FUNCT__
+#define __FUNCT__ "ElasticityFunction"
+PetscErrorCode ElasticityFunction(IGAPoint p,const PetscScalar *U,PetscScalar *F,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscReal lambda = user->lambda, mu = user->mu;
+  PetscInt a,i,j,nen = p->nen,dim = p->dim;
+  const PetscReal *N1 = p->shape[1];
+  PetscScalar u1[9],S[3][3],div = 0;
+  IGAPointFormGrad(p,U,u1);
+  for (i=0; i<dim; i++) div += u1[i*dim+i];
+  for (i=0; i<dim; i++)
+    for (j=0; j<dim; j++)
+      S[i][j] = mu*(u1[i*dim+j]+u1[j*dim+i]) + ((i==j) ? lambda*div : 0);
+  for (a=0; a<nen; a++)
+    for (i=0; i<dim; i++) {
+      PetscScalar Fai = 0;
+      for (j=0; j<dim; j++) Fai += N1[a*dim+j]*S[i][j];
+      F[a*dim+i] = Fai;
+    }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "ElasticityJacobian"
+PetscErrorCode ElasticityJacobian(IGAPoint p,const PetscScalar *U,PetscScalar *J,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscReal lambda = user->lambda, mu = user->mu;
+  PetscInt a,b,i,k,nen = p->nen,dim = p->dim;
+  const PetscReal *N1 = p->shape[1];
+  for (a=0; a<nen; a++) {
+    const PetscReal *Na = &N1[a*dim];
+    for (b=0; b<nen; b++) {
+      const PetscReal *Nb = &N1[b*dim];
+      PetscReal dot = 0;
+      for (i=0; i<dim; i++) dot += Na[i]*Nb[i];
+      for (i=0; i<dim; i++)
+        for (k=0; k<dim; k++)
+          J[((a*dim+i)*nen+b)*dim+k] = lambda*Na[i]*Nb[k] + mu*Na[k]*Nb[i] + ((i==k) ? mu*dot : 0);
+    }
+  }
+  return 0;
+}
+
+/* Cahn-Hilliard, as in CahnHilliard3D (with unit shift) */
+
+#undef  __FUNCT__
+#define __FUNCT__ "CahnHilliardFunction"
+PetscErrorCode CahnHilliardFunction(IGAPoint p,const PetscScalar *U,PetscScalar *F,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,i,nen = p->nen,dim = p->dim;
+  const PetscReal *N0 = p->shape[0], *N1 = p->shape[1], *N2 = p->shape[2];
+  PetscScalar c,c1[3],del2c;
+  IGAPointFormValue(p,U,&c);
+  IGAPointFormGrad(p,U,c1);
+  IGAPointFormDel2(p,U,&del2c);
+  {
+    PetscScalar M   = c*(1-c), dM = 1-2*c;
+    PetscScalar dmu = 0.5/user->theta/(c*(1-c)) - 2;
+    PetscScalar t1  = M*dmu + dM*del2c;
+    for (a=0; a<nen; a++) {
+      PetscReal del2Na = 0;
+      PetscScalar Fa = N0[a]*c;
+      for (i=0; i<dim; i++) del2Na += N2[(a*dim+i)*dim+i];
+      for (i=0; i<dim; i++) Fa += N1[a*dim+i]*t1*c1[i];
+      Fa += del2Na*M*del2c/user->alpha;
+      F[a] = Fa;
+    }
+  }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CahnHilliardJacobian"
+PetscErrorCode CahnHilliardJacobian(IGAPoint p,const PetscScalar *U,PetscScalar *J,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,b,i,nen = p->nen,dim = p->dim;
+  const PetscReal *N0 = p->shape[0], *N1 = p->shape[1], *N2 = p->shape[2];
+  PetscScalar c,c1[3],del2c;
+  IGAPointFormValue(p,U,&c);
+  IGAPointFormGrad(p,U,c1);
+  IGAPointFormDel2(p,U,&del2c);
+  {
+    PetscScalar M    = c*(1-c), dM = 1-2*c, d2M = -2;
+    PetscScalar dmu  = 0.5/user->theta/(c*(1-c)) - 2;
+    PetscScalar d2mu = -0.5/user->theta*(1-2*c)/(c*c*(1-c)*(1-c));
+    PetscScalar t1   = M*dmu + dM*del2c;
+    for (a=0; a<nen; a++) {
+      PetscReal del2Na = 0;
+      for (i=0; i<dim; i++) del2Na += N2[(a*dim+i)*dim+i];
+      for (b=0; b<nen; b++) {
+        PetscReal del2Nb = 0, dot = 0;
+        PetscScalar t2,dotc = 0,Kab = N0[a]*N0[b];
+        for (i=0; i<dim; i++) del2Nb += N2[(b*dim+i)*dim+i];
+        for (i=0; i<dim; i++) dot    += N1[a*dim+i]*N1[b*dim+i];
+        for (i=0; i<dim; i++) dotc   += N1[a*dim+i]*c1[i];
+        t2 = (dM*dmu + M*d2mu + d2M*del2c)*N0[b] + dM*del2Nb;
+        Kab += t1*dot + t2*dotc;
+        Kab += del2Na*(dM*del2c*N0[b] + M*del2Nb)/user->alpha;
+        J[a*nen+b] = Kab;
+      }
+    }
+  }
+  return 0;
+}
+
+/* Incompressible Navier-Stokes, Galerkin with pressure stabilization */
+
+#undef  __FUNCT__
+#define __FUNCT__ "NavierStokesFunction"
+PetscErrorCode NavierStokesFunction(IGAPoint p,const PetscScalar *U,PetscScalar *F,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,i,j,nen = p->nen,dim = p->dim,dof = dim+1;
+  const PetscReal *N0 = p->shape[0], *N1 = p->shape[1];
+  PetscScalar u[4],u1[12],div = 0;
+  IGAPointFormValue(p,U,u);
+  IGAPointFormGrad(p,U,u1);
+  for (i=0; i<dim; i++) div += u1[i*dim+i];
+  for (a=0; a<nen; a++) {
+    const PetscReal *Na = &N1[a*dim];
+    for (i=0; i<dim; i++) {
+      PetscScalar Fai = -Na[i]*u[dim];
+      for (j=0; j<dim; j++) Fai += N0[a]*u[j]*u1[i*dim+j] + user->nu*Na[j]*u1[i*dim+j];
+      F[a*dof+i] = Fai;
+    }
+    F[a*dof+dim] = N0[a]*div;
+    for (j=0; j<dim; j++) F[a*dof+dim] += user->tau*Na[j]*u1[dim*dim+j];
+  }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "NavierStokesJacobian"
+PetscErrorCode NavierStokesJacobian(IGAPoint p,const PetscScalar *U,PetscScalar *J,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,b,i,k,nen = p->nen,dim = p->dim,dof = dim+1;
+  const PetscReal *N0 = p->shape[0], *N1 = p->shape[1];
+  PetscScalar u[4],u1[12];
+  IGAPointFormValue(p,U,u);
+  IGAPointFormGrad(p,U,u1);
+  for (a=0; a<nen; a++) {
+    const PetscReal *Na = &N1[a*dim];
+    for (b=0; b<nen; b++) {
+      const PetscReal *Nb = &N1[b*dim];
+      PetscScalar (*Kab)[dof] = (PetscScalar (*)[dof])&J[a*dof*nen*dof+b*dof];
+      PetscScalar adv = 0; PetscReal dot = 0;
+      for (i=0; i<dim; i++) adv += u[i]*Nb[i];
+      for (i=0; i<dim; i++) dot += Na[i]*Nb[i];
+      for (i=0; i<dim; i++) {
+        for (k=0; k<dim; k++)
+          Kab[i*nen][k] = N0[a]*N0[b]*u1[i*dim+k] + ((i==k) ? N0[a]*adv + user->nu*dot : 0);
+        Kab[i*nen][dim] = -Na[i]*N0[b];
+        Kab[dim*nen][i] = N0[a]*Nb[i];
+      }
+      Kab[dim*nen][dim] = user->tau*dot;
+    }
+  }
+  return 0;
+}
+
+/* Hyperelasticity, St. Venant-Kirchhoff in place of the Neo-Hookean
+   material of HyperElasticity */
+
+#undef  __FUNCT__
+#define __FUNCT__ "HyperStress"
+static void HyperStress(AppCtx *user,PetscInt dim,const PetscScalar u1[],PetscScalar F[3][3],PetscScalar S[3][3])
+{
+  PetscInt i,j,k; PetscScalar trE = 0;
+  for (i=0; i<dim; i++)
+    for (j=0; j<dim; j++)
+      F[i][j] = u1[i*dim+j] + ((i==j) ? 1 : 0);
+  for (i=0; i<dim; i++)
+    for (j=0; j<dim; j++) {
+      PetscScalar E = ((i==j) ? -0.5 : 0);
+      for (k=0; k<dim; k++) E += 0.5*F[k][i]*F[k][j];
+      S[i][j] = 2*user->mu*E;
+      if (i==j) trE += E;
+    }
+  for (i=0; i<dim; i++) S[i][i] += user->lambda*trE;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "HyperElasticityFunction"
+PetscErrorCode HyperElasticityFunction(IGAPoint p,const PetscScalar *U,PetscScalar *R,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,i,j,k,nen = p->nen,dim = p->dim;
+  const PetscReal *N1 = p->shape[1];
+  PetscScalar u1[9],F[3][3],S[3][3],P[3][3];
+  IGAPointFormGrad(p,U,u1);
+  HyperStress(user,dim,u1,F,S);
+  for (i=0; i<dim; i++)
+    for (j=0; j<dim; j++) {
+      P[i][j] = 0;
+      for (k=0; k<dim; k++) P[i][j] += F[i][k]*S[k][j];
+    }
+  for (a=0; a<nen; a++)
+    for (i=0; i<dim; i++) {
+      PetscScalar Rai = 0;
+      for (j=0; j<dim; j++) Rai += N1[a*dim+j]*P[i][j];
+      R[a*dim+i] = Rai;
+    }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "HyperElasticityJacobian"
+PetscErrorCode HyperElasticityJacobian(IGAPoint p,const PetscScalar *U,PetscScalar *K,void *ctx)
+{
+  AppCtx *user = (AppCtx *)ctx;
+  PetscInt a,b,i,j,k,l,nen = p->nen,dim = p->dim;
+  const PetscReal *N1 = p->shape[1];
+  PetscScalar u1[9],F[3][3],S[3][3];
+  IGAPointFormGrad(p,U,u1);
+  HyperStress(user,dim,u1,F,S);
+  for (a=0; a<nen; a++) {
+    const PetscReal *Na = &N1[a*dim];
+    for (b=0; b<nen; b++) {
+      const PetscReal *Nb = &N1[b*dim];
+      PetscScalar NaSNb = 0;
+      for (j=0; j<dim; j++)
+        for (l=0; l<dim; l++)
+          NaSNb += Na[j]*S[l][j]*Nb[l];
+      for (k=0; k<dim; k++) {
+        PetscScalar FNb = 0, dS[3][3];
+        for (l=0; l<dim; l++) FNb += F[k][l]*Nb[l];
+        for (l=0; l<dim; l++)
+          for (j=0; j<dim; j++)
+            dS[l][j] = user->mu*(Nb[l]*F[k][j] + F[k][l]*Nb[j]) + ((l==j) ? user->lambda*FNb : 0);
+        for (i=0; i<dim; i++) {
+          PetscScalar Kaibk = (i==k) ? NaSNb : 0;
+          for (j=0; j<dim; j++)
+            for (l=0; l<dim; l++)
+              Kaibk += Na[j]*F[i][l]*dS[l][j];
+          K[((a*dim+i)*nen+b)*dim+k] = Kaibk;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+typedef struct {
+  const char      *name;
+  PetscInt        dof;      /* fields per node, 0:dim, -1:dim+1 */
+  PetscInt        order;    /* derivative order required */
+  PetscBool       dirichlet;
+  IGAFormFunction Function;
+  IGAFormJacobian Jacobian;
+} BenchKernel;
+
+static BenchKernel Kernels[] = {
+  {"poisson",         1, 1, PETSC_TRUE,  PoissonFunction,         PoissonJacobian        },
+  {"elasticity",      0, 1, PETSC_TRUE,  ElasticityFunction,      ElasticityJacobian     },
+  {"cahnhilliard",    1, 2, PETSC_FALSE, CahnHilliardFunction,    CahnHilliardJacobian   },
+  {"navierstokes",   -1, 1, PETSC_TRUE,  NavierStokesFunction,    NavierStokesJacobian   },
+  {"hyperelasticity", 0, 1, PETSC_TRUE,  HyperElasticityFunction, HyperElasticityJacobian},
+};
+
+#undef  __FUNCT__
+#define __FUNCT__ "BenchPrintArray"
+static PetscErrorCode BenchPrintArray(MPI_Comm comm,FILE *fp,const char name[],PetscInt n,const PetscInt a[])
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscFPrintf(comm,fp,"\"%s\": [",name);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {ierr = PetscFPrintf(comm,fp,"%s%D",i?", ":"",a[i]);CHKERRQ(ierr);}
+  ierr = PetscFPrintf(comm,fp,"], ");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  PetscErrorCode  ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+  ierr = PetscMemorySetGetMaximumUsage();CHKERRQ(ierr);
+
+  MPI_Comm comm = PETSC_COMM_WORLD;
+  PetscMPIInt size;
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+
+  AppCtx user;
+  user.lambda = 1.0; user.mu    = 1.0;
+  user.theta  = 1.5; user.alpha = 3000.0;
+  user.nu     = 0.1; user.tau   = 0.01;
+
+  char      kname[64] = "poisson";
+  char      output[PETSC_MAX_PATH_LEN] = "";
+  PetscInt  dim = 3, repeat = 3;
+  PetscBool solve = PETSC_TRUE;
+  ierr = PetscOptionsBegin(comm,"","Benchmark Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsString("-bench_kernel","poisson, elasticity, cahnhilliard, navierstokes, hyperelasticity",__FILE__,kname,kname,sizeof(kname),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-bench_repeat","Number of timed assemblies",__FILE__,repeat,&repeat,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-bench_solve","Time a linear solve with the Jacobian",__FILE__,solve,&solve,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-bench_output","Append JSON records to file (default stdout)",__FILE__,output,output,sizeof(output),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-iga_dim","Number of dimensions",__FILE__,dim,&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  repeat = PetscMax(repeat,1);
+
+  BenchKernel *kernel = NULL;
+  PetscInt k;
+  for (k=0; k<(PetscInt)(sizeof(Kernels)/sizeof(Kernels[0])); k++) {
+    PetscBool match;
+    ierr = PetscStrcmp(kname,Kernels[k].name,&match);CHKERRQ(ierr);
+    if (match) kernel = &Kernels[k];
+  }
+  if (!kernel) SETERRQ1(comm,PETSC_ERR_ARG_UNKNOWN_TYPE,"Unknown benchmark kernel %s",kname);
+
+  PetscLogDouble t0,t1,tsetup;
+  PetscInt dof = (kernel->dof > 0) ? kernel->dof : (kernel->dof == 0) ? dim : dim+1;
+
+  IGA iga;
+  ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+  t0 = MPI_Wtime();
+  ierr = IGACreate(comm,&iga);CHKERRQ(ierr);
+  ierr = IGASetDim(iga,dim);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,dof);CHKERRQ(ierr);
+  ierr = IGASetOrder(iga,kernel->order);CHKERRQ(ierr);
+  ierr = IGASetFromOptions(iga);CHKERRQ(ierr);
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+  if (kernel->dirichlet) {
+    PetscInt dir,side,field;
+    for (dir=0; dir<dim; dir++)
+      for (side=0; side<2; side++)
+        for (field=0; field<dof; field++)
+          {ierr = IGASetBoundaryValue(iga,dir,side,field,0.0);CHKERRQ(ierr);}
+  }
+  ierr = IGASetFormFunction(iga,kernel->Function,&user);CHKERRQ(ierr);
+  ierr = IGASetFormJacobian(iga,kernel->Jacobian,&user);CHKERRQ(ierr);
+
+  Vec U,F,X;
+  Mat J;
+  ierr = IGACreateVec(iga,&U);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&F);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&X);CHKERRQ(ierr);
+  ierr = IGACreateMat(iga,&J);CHKERRQ(ierr);
+  t1 = MPI_Wtime() - t0;
+  ierr = MPI_Allreduce(&t1,&tsetup,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+
+  /* states within (0.45,0.55) keep the Cahn-Hilliard kernel well defined */
+  ierr = VecSetRandom(U,NULL);CHKERRQ(ierr);
+  ierr = VecScale(U,0.1);CHKERRQ(ierr);
+  ierr = VecShift(U,0.45);CHKERRQ(ierr);
+
+  /* first assembly allocates the matrix, time the best of repeat */
+  PetscLogDouble tres = 0, tjac = 0, tmax;
+  PetscInt r;
+  ierr = IGAComputeFunction(iga,U,F);CHKERRQ(ierr);
+  ierr = IGAComputeJacobian(iga,U,J);CHKERRQ(ierr);
+  for (r=0; r<repeat; r++) {
+    ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+    t0 = MPI_Wtime();
+    ierr = IGAComputeFunction(iga,U,F);CHKERRQ(ierr);
+    t1 = MPI_Wtime() - t0;
+    ierr = MPI_Allreduce(&t1,&tmax,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    tres = (r==0) ? tmax : PetscMin(tres,tmax);
+  }
+  for (r=0; r<repeat; r++) {
+    ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+    t0 = MPI_Wtime();
+    ierr = IGAComputeJacobian(iga,U,J);CHKERRQ(ierr);
+    t1 = MPI_Wtime() - t0;
+    ierr = MPI_Allreduce(&t1,&tmax,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    tjac = (r==0) ? tmax : PetscMin(tjac,tmax);
+  }
+
+  PetscLogDouble tsolve = 0;
+  PetscInt its = 0;
+  if (solve) {
+    KSP ksp;
+    ierr = IGACreateKSP(iga,&ksp);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,J,J);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+    ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+    t0 = MPI_Wtime();
+    ierr = KSPSolve(ksp,F,X);CHKERRQ(ierr);
+    t1 = MPI_Wtime() - t0;
+    ierr = MPI_Allreduce(&t1,&tsolve,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  }
+
+  PetscLogDouble mem,memmax,memsum;
+  ierr = PetscMemoryGetMaximumUsage(&mem);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&mem,&memmax,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&mem,&memsum,1,MPIU_PETSCLOGDOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+
+  PetscInt i,degree[3],cont[3],nel = 1,ndof = dof;
+  for (i=0; i<dim; i++) {
+    IGAAxis axis = iga->axis[i];
+    PetscInt m = 1;
+    while (axis->nel > 1 && axis->U[axis->p+1+m] == axis->U[axis->p+1]) m++;
+    degree[i] = axis->p;
+    cont[i]   = (axis->nel > 1) ? axis->p - m : axis->p - 1;
+    nel  *= iga->elem_sizes[i];
+    ndof *= iga->node_sizes[i];
+  }
+
+  FILE *fp = PETSC_STDOUT;
+  if (output[0]) {ierr = PetscFOpen(comm,output,"a",&fp);CHKERRQ(ierr);}
+  ierr = PetscFPrintf(comm,fp,"{\"kernel\": \"%s\", \"nprocs\": %d, \"dim\": %D, \"dof\": %D, ",
+                      kernel->name,(int)size,dim,dof);CHKERRQ(ierr);
+  ierr = BenchPrintArray(comm,fp,"degree",dim,degree);CHKERRQ(ierr);
+  ierr = BenchPrintArray(comm,fp,"continuity",dim,cont);CHKERRQ(ierr);
+  ierr = BenchPrintArray(comm,fp,"elements",dim,iga->elem_sizes);CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm,fp,"\"nelem\": %D, \"ndof\": %D, \"setup_time\": %g, ",nel,ndof,(double)tsetup);CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm,fp,"\"residual\": {\"time\": %g, \"elements_per_sec\": %g, \"dofs_per_sec\": %g}, ",
+                      (double)tres,(double)(nel/tres),(double)(ndof/tres));CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm,fp,"\"jacobian\": {\"time\": %g, \"elements_per_sec\": %g, \"dofs_per_sec\": %g}, ",
+                      (double)tjac,(double)(nel/tjac),(double)(ndof/tjac));CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm,fp,"\"solve\": {\"time\": %g, \"iterations\": %D}, ",(double)tsolve,its);CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm,fp,"\"memory\": {\"max\": %g, \"sum\": %g}}\n",(double)memmax,(double)memsum);CHKERRQ(ierr);
+  if (output[0]) {ierr = PetscFClose(comm,fp);CHKERRQ(ierr);}
+
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = VecDestroy(&F);CHKERRQ(ierr);
+  ierr = VecDestroy(&X);CHKERRQ(ierr);
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
@@ -0,0 +1,413 @@
+/*
+  This code times the Fortran basis, geometry and interpolation
+  kernels in isolation across dimension, degree and derivative order.
+  Flops and bytes are counted analytically from the loops of the
+  kernels; the achieved GFLOP/s and GB/s are compared against a STREAM
+  triad and a multiply-add peak measured on the machine (roofline).
+
+  keywords: benchmark, kernels, roofline
+ */
+#include "petiga.h"
+
+EXTERN_C_BEGIN
+extern void IGA_Basis_BSpline(PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+EXTERN_C_END
+
+EXTERN_C_BEGIN
+extern void IGA_BasisFuns_1D(PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+extern void IGA_BasisFuns_2D(PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+extern void IGA_BasisFuns_3D(PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+EXTERN_C_END
+
+EXTERN_C_BEGIN
+extern void IGA_ShapeFuns_1D(PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             const PetscReal[],const PetscReal[],const PetscReal[],const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+extern void IGA_ShapeFuns_2D(PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             const PetscReal[],const PetscReal[],const PetscReal[],const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+extern void IGA_ShapeFuns_3D(PetscInt,PetscInt,PetscInt,const PetscReal[],
+                             const PetscReal[],const PetscReal[],const PetscReal[],const PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],
+                             PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[],PetscReal[]);
+EXTERN_C_END
+
+EXTERN_C_BEGIN
+extern void IGA_GetValue(PetscInt nen,PetscInt dof,/*         */const PetscReal N[],const PetscScalar U[],PetscScalar u[]);
+extern void IGA_GetGrad (PetscInt nen,PetscInt dof,PetscInt dim,const PetscReal N[],const PetscScalar U[],PetscScalar u[]);
+extern void IGA_GetHess (PetscInt nen,PetscInt dof,PetscInt dim,const PetscReal N[],const PetscScalar U[],PetscScalar u[]);
+EXTERN_C_END
+
+typedef enum {
+  KERNEL_BSPLINE,
+  KERNEL_BASISFUNS,
+  KERNEL_SHAPEFUNS,
+  KERNEL_GETVALUE,
+  KERNEL_GETGRAD,
+  KERNEL_GETHESS,
+  KERNEL_COUNT
+} KernelType;
+
+static const char *KernelNames[] = {
+  "Basis_BSpline",
+  "BasisFuns",
+  "ShapeFuns",
+  "GetValue",
+  "GetGrad",
+  "GetHess",
+};
+
+typedef struct {
+  KernelType type;
+  PetscInt   dim,p,order,dof;
+  PetscInt   nqp,nen; /* per element, tensor product */
+  /* inputs */
+  PetscReal  *U;      /* knot vector */
+  PetscReal  *B1;     /* 1D basis [nqp1][p+1][4] */
+  PetscReal  *W;      /* weights (unused, non-rational) */
+  PetscReal  *X;      /* control points [nen][dim] */
+  PetscScalar *A;     /* element values [nen][dof] */
+  /* outputs */
+  PetscReal  *M[4],*N[4];
+  PetscReal  *dX,*G[2],*H[2],*I[2];
+  PetscScalar *u;
+} Kernel;
+
+static PetscReal sink = 0; /* keeps the reference loops alive */
+
+#undef  __FUNCT__
+#define __FUNCT__ "MeasureStream"
+static PetscErrorCode MeasureStream(PetscInt n,PetscLogDouble *gbs)
+{
+  PetscReal      *a,*b,*c,s = 3.0;
+  PetscLogDouble t,best = 0;
+  PetscInt       i,k;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&b);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&c);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {a[i] = 0; b[i] = 1; c[i] = 2;}
+  for (k=0; k<5; k++) {
+    t = MPI_Wtime();
+    for (i=0; i<n; i++) a[i] = b[i] + s*c[i];
+    t = MPI_Wtime() - t;
+    if (k == 0 || t < best) best = t;
+    sink += a[k];
+  }
+  *gbs = 3.0*sizeof(PetscReal)*n/best*1e-9;
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  ierr = PetscFree(b);CHKERRQ(ierr);
+  ierr = PetscFree(c);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MeasurePeak"
+static PetscErrorCode MeasurePeak(PetscInt n,PetscLogDouble *gflops)
+{
+  PetscReal      a[8] = {1,2,3,4,5,6,7,8}, x = 0.999999, y = 1e-6;
+  PetscLogDouble t,best = 0;
+  PetscInt       i,j,k;
+  PetscFunctionBegin;
+  for (k=0; k<5; k++) {
+    t = MPI_Wtime();
+    for (i=0; i<n; i++)
+      for (j=0; j<8; j++)
+        a[j] = a[j]*x + y;
+    t = MPI_Wtime() - t;
+    if (k == 0 || t < best) best = t;
+  }
+  for (j=0; j<8; j++) sink += a[j];
+  *gflops = 2.0*8*n/best*1e-9;
+  PetscFunctionReturn(0);
+}
+
+/* Operation counts follow the loops in petigabsp.F90, petiga{1,2,3}d.F90,
+   petigageo.f90.in and petigaval.F90. Bytes count the kernel arguments
+   read and written once (compulsory traffic). */
+static void KernelCounts(Kernel *k,PetscLogDouble *flops,PetscLogDouble *bytes)
+{
+  PetscLogDouble D = k->dim, n = k->nen, q = k->nqp, p = k->p, dof = k->dof;
+  PetscLogDouble o = k->order, r = sizeof(PetscReal), s = sizeof(PetscScalar);
+  PetscLogDouble E = 1 + D + (o>=2 ? D*D : 0) + (o>=3 ? D*D*D : 0);
+  PetscInt j;
+  *flops = 0; *bytes = 0;
+  switch (k->type) {
+  case KERNEL_BSPLINE:
+    *flops = 2*p + 5*p*(p+1)/2 + (p+1)*o;
+    for (j=1; j<=k->order; j++) *flops += (p+1)*(3*PetscMin(j,k->p)+3);
+    *bytes = (2*p + (p+1)*(o+1))*r;
+    break;
+  case KERNEL_BASISFUNS:
+    *flops = q*n*E*(D-1);
+    *bytes = (q*n*E + D*q*(p+1)*(o+1))*r;
+    break;
+  case KERNEL_SHAPEFUNS:
+    *flops = q*(2*D*D*n + 2*D*D*D + 2*D*D*n);
+    if (o >= 2) *flops += q*(2*D*D*D*n + 4*pow(D,6) + 3*n*pow(D,4) + 2*n*D*D*D);
+    if (o >= 3) *flops += q*(2*pow(D,4)*n + 5*pow(D,8) + 8*pow(D,7) + n*(4*pow(D,6) + 7*pow(D,5) + 2*pow(D,4)));
+    *bytes = (D*n + 2*q*n*E + q*(1 + 2*D*D + (o>=2 ? 2*D*D*D : 0) + (o>=3 ? 2*pow(D,4) : 0)))*r;
+    break;
+  case KERNEL_GETVALUE:
+    *flops = 2*n*dof;
+    *bytes = n*r + (n*dof + dof)*s;
+    break;
+  case KERNEL_GETGRAD:
+    *flops = 2*n*dof*D;
+    *bytes = n*D*r + (n*dof + D*dof)*s;
+    break;
+  case KERNEL_GETHESS:
+    *flops = 2*n*dof*D*D;
+    *bytes = n*D*D*r + (n*dof + D*D*dof)*s;
+    break;
+  default: break;
+  }
+}
+
+static void KernelCall(Kernel *k,PetscInt reps)
+{
+  PetscInt  i,p = k->p, o = k->order, q1 = p+1, n1 = p+1, d = 3;
+  PetscReal *B = k->B1, u = 0.5*(k->U[p]+k->U[p+1]);
+  switch (k->type) {
+  case KERNEL_BSPLINE:
+    for (i=0; i<reps; i++) IGA_Basis_BSpline(p,u,p,o,k->U,k->N[0]);
+    break;
+  case KERNEL_BASISFUNS:
+    for (i=0; i<reps; i++) {
+      switch (k->dim) {
+      case 3: IGA_BasisFuns_3D(o,0,k->W,q1,n1,d,B,q1,n1,d,B,q1,n1,d,B,
+                               k->N[0],k->N[1],k->N[2],k->N[3]); break;
+      case 2: IGA_BasisFuns_2D(o,0,k->W,q1,n1,d,B,q1,n1,d,B,
+                               k->N[0],k->N[1],k->N[2],k->N[3]); break;
+      case 1: IGA_BasisFuns_1D(o,0,k->W,q1,n1,d,B,
+                               k->N[0],k->N[1],k->N[2],k->N[3]); break;
+      }
+    }
+    break;
+  case KERNEL_SHAPEFUNS:
+    for (i=0; i<reps; i++) {
+      switch (k->dim) {
+      case 3: IGA_ShapeFuns_3D(o,k->nqp,k->nen,k->X,
+                               k->M[0],k->M[1],k->M[2],k->M[3],
+                               k->N[0],k->N[1],k->N[2],k->N[3],
+                               k->dX,k->G[0],k->G[1],k->H[0],k->H[1],k->I[0],k->I[1]); break;
+      case 2: IGA_ShapeFuns_2D(o,k->nqp,k->nen,k->X,
+                               k->M[0],k->M[1],k->M[2],k->M[3],
+                               k->N[0],k->N[1],k->N[2],k->N[3],
+                               k->dX,k->G[0],k->G[1],k->H[0],k->H[1],k->I[0],k->I[1]); break;
+      case 1: IGA_ShapeFuns_1D(o,k->nqp,k->nen,k->X,
+                               k->M[0],k->M[1],k->M[2],k->M[3],
+                               k->N[0],k->N[1],k->N[2],k->N[3],
+                               k->dX,k->G[0],k->G[1],k->H[0],k->H[1],k->I[0],k->I[1]); break;
+      }
+    }
+    break;
+  case KERNEL_GETVALUE:
+    for (i=0; i<reps; i++) IGA_GetValue(k->nen,k->dof,k->M[0],k->A,k->u);
+    break;
+  case KERNEL_GETGRAD:
+    for (i=0; i<reps; i++) IGA_GetGrad(k->nen,k->dof,k->dim,k->M[1],k->A,k->u);
+    break;
+  case KERNEL_GETHESS:
+    for (i=0; i<reps; i++) IGA_GetHess(k->nen,k->dof,k->dim,k->M[2],k->A,k->u);
+    break;
+  default: break;
+  }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "KernelSetUp"
+static PetscErrorCode KernelSetUp(Kernel *k,PetscInt dim,PetscInt p,PetscInt dof)
+{
+  PetscInt       i,a,q,n1 = p+1,q1 = p+1,nen,nqp,o = 3;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscMemzero(k,sizeof(Kernel));CHKERRQ(ierr);
+  k->dim = dim; k->p = p; k->dof = dof;
+  for (nen=1, nqp=1, i=0; i<dim; i++) {nen *= n1; nqp *= q1;}
+  k->nen = nen; k->nqp = nqp;
+  /* open uniform knot vector with a single span */
+  ierr = PetscMalloc1(2*(p+1),&k->U);CHKERRQ(ierr);
+  for (i=0; i<=p; i++) {k->U[i] = 0; k->U[p+1+i] = 1;}
+  /* 1D basis at equispaced interior points */
+  ierr = PetscMalloc1(q1*n1*(o+1),&k->B1);CHKERRQ(ierr);
+  for (q=0; q<q1; q++)
+    IGA_Basis_BSpline(p,(q+0.5)/q1,p,o,k->U,&k->B1[q*n1*(o+1)]);
+  ierr = PetscMalloc1(nen,&k->W);CHKERRQ(ierr);
+  for (a=0; a<nen; a++) k->W[a] = 1;
+  /* slightly distorted control net of the unit cube */
+  ierr = PetscMalloc1(nen*dim,&k->X);CHKERRQ(ierr);
+  for (a=0; a<nen; a++) {
+    PetscInt c = a;
+    for (i=0; i<dim; i++) {
+      k->X[a*dim+i] = (PetscReal)(c % n1)/p + 0.01*(PetscReal)((a*7+i*3) % 5)/p;
+      c /= n1;
+    }
+  }
+  ierr = PetscMalloc1(nen*dof,&k->A);CHKERRQ(ierr);
+  for (a=0; a<nen*dof; a++) k->A[a] = 1.0/(1+a);
+  for (i=0; i<4; i++) {
+    PetscInt m = (i==0) ? 1 : (i==1) ? dim : (i==2) ? dim*dim : dim*dim*dim;
+    ierr = PetscMalloc1(nqp*nen*m,&k->M[i]);CHKERRQ(ierr);
+    ierr = PetscMalloc1(PetscMax(nqp*nen*m,(p+1)*(o+1)),&k->N[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscMalloc1(nqp,&k->dX);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    ierr = PetscMalloc1(nqp*dim*dim,&k->G[i]);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nqp*dim*dim*dim,&k->H[i]);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nqp*dim*dim*dim*dim,&k->I[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscMalloc1(dim*dim*dof,&k->u);CHKERRQ(ierr);
+  /* parametric shape functions, input to ShapeFuns and GetValue/Grad/Hess */
+  k->type = KERNEL_BASISFUNS; k->order = o;
+  KernelCall(k,1);
+  for (i=0; i<4; i++) {
+    PetscInt m = (i==0) ? 1 : (i==1) ? dim : (i==2) ? dim*dim : dim*dim*dim;
+    ierr = PetscMemcpy(k->M[i],k->N[i],nqp*nen*m*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "KernelDestroy"
+static PetscErrorCode KernelDestroy(Kernel *k)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscFree(k->U);CHKERRQ(ierr);
+  ierr = PetscFree(k->B1);CHKERRQ(ierr);
+  ierr = PetscFree(k->W);CHKERRQ(ierr);
+  ierr = PetscFree(k->X);CHKERRQ(ierr);
+  ierr = PetscFree(k->A);CHKERRQ(ierr);
+  for (i=0; i<4; i++) {
+    ierr = PetscFree(k->M[i]);CHKERRQ(ierr);
+    ierr = PetscFree(k->N[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(k->dX);CHKERRQ(ierr);
+  for (i=0; i<2; i++) {
+    ierr = PetscFree(k->G[i]);CHKERRQ(ierr);
+    ierr = PetscFree(k->H[i]);CHKERRQ(ierr);
+    ierr = PetscFree(k->I[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(k->u);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "KernelTime"
+static PetscErrorCode KernelTime(Kernel *k,PetscLogDouble tmin,PetscLogDouble *time)
+{
+  PetscInt       reps = 1;
+  PetscLogDouble t = 0;
+  PetscFunctionBegin;
+  KernelCall(k,1); /* warm up */
+  while (1) {
+    t = MPI_Wtime();
+    KernelCall(k,reps);
+    t = MPI_Wtime() - t;
+    if (t >= tmin || reps >= (PETSC_MAX_INT/2)) break;
+    reps *= 2;
+  }
+  *time = t/reps;
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  PetscErrorCode  ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  MPI_Comm comm = PETSC_COMM_WORLD;
+
+  PetscInt  dims[3] = {1,2,3}, ndims = 3;
+  PetscInt  degrees[8] = {1,2,3,4}, ndegrees = 4;
+  PetscInt  orders[4] = {0,1,2,3}, norders = 4;
+  PetscInt  dof = 1, ssize = 1<<22;
+  PetscReal tmin = 0.05;
+  PetscReal peak = 0, stream = 0;
+  char      output[PETSC_MAX_PATH_LEN] = "";
+  ierr = PetscOptionsBegin(comm,"","Kernel Benchmark Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsIntArray("-bench_dims","Dimensions",__FILE__,dims,&ndims,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsIntArray("-bench_degrees","Polynomial degrees",__FILE__,degrees,&ndegrees,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsIntArray("-bench_orders","Derivative orders",__FILE__,orders,&norders,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-bench_dof","Components for GetValue/Grad/Hess",__FILE__,dof,&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_time","Minimum time per measurement",__FILE__,tmin,&tmin,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-bench_stream_size","STREAM triad array length",__FILE__,ssize,&ssize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_peak_gflops","Peak GFLOP/s (default measured)",__FILE__,peak,&peak,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-bench_stream_gbs","Memory bandwidth in GB/s (default measured)",__FILE__,stream,&stream,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-bench_output","Append JSON records to file",__FILE__,output,output,sizeof(output),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  PetscLogDouble gflops = peak, gbs = stream;
+  if (gflops <= 0) {ierr = MeasurePeak(1<<24,&gflops);CHKERRQ(ierr);}
+  if (gbs    <= 0) {ierr = MeasureStream(ssize,&gbs);CHKERRQ(ierr);}
+  PetscLogDouble ridge = gflops/gbs;
+
+  FILE *fp = NULL;
+  if (output[0]) {ierr = PetscFOpen(comm,output,"a",&fp);CHKERRQ(ierr);}
+  ierr = PetscPrintf(comm,"Machine: peak %.2f GFLOP/s, STREAM triad %.2f GB/s, ridge point %.2f flop/byte\n",
+                     (double)gflops,(double)gbs,(double)ridge);CHKERRQ(ierr);
+  ierr = PetscPrintf(comm,"%-14s %3s %3s %3s %12s %10s %10s %8s %8s %7s %s\n",
+                     "Kernel","dim","p","ord","Time/call","GFLOP/s","GB/s","F/B","%Roof","","Bound");CHKERRQ(ierr);
+  if (fp) {ierr = PetscFPrintf(comm,fp,"{\"machine\": {\"peak_gflops\": %g, \"stream_gbs\": %g}}\n",(double)gflops,(double)gbs);CHKERRQ(ierr);}
+
+  KernelType t;
+  PetscInt   d,j,l;
+  for (d=0; d<ndims; d++) {
+    PetscInt dim = dims[d];
+    if (dim < 1 || dim > 3) continue;
+    for (j=0; j<ndegrees; j++) {
+      Kernel k;
+      ierr = KernelSetUp(&k,dim,degrees[j],dof);CHKERRQ(ierr);
+      for (t=KERNEL_BSPLINE; t<KERNEL_COUNT; t++) {
+        if (t == KERNEL_BSPLINE && dim != 1) continue; /* 1D kernel */
+        for (l=0; l<norders; l++) {
+          PetscLogDouble time,flops,bytes,ai,roof,perf,bw;
+          PetscInt o = orders[l];
+          if (o < 0 || o > 3) continue;
+          if (t == KERNEL_SHAPEFUNS && o < 1) continue;
+          if (t >= KERNEL_GETVALUE && o != (PetscInt)(t-KERNEL_GETVALUE)) continue;
+          k.type = t; k.order = o;
+          ierr = KernelTime(&k,tmin,&time);CHKERRQ(ierr);
+          KernelCounts(&k,&flops,&bytes);
+          ai   = flops/bytes;
+          roof = PetscMin(gflops,ai*gbs);
+          perf = flops/time*1e-9;
+          bw   = bytes/time*1e-9;
+          ierr = PetscPrintf(comm,"%-14s %3D %3D %3D %12.4e %10.3f %10.3f %8.3f %7.1f%% %s\n",
+                             KernelNames[t],dim,k.p,o,(double)time,(double)perf,(double)bw,(double)ai,
+                             (double)(100*perf/roof),(ai >= ridge) ? "compute" : "memory");CHKERRQ(ierr);
+          if (fp) {
+            ierr = PetscFPrintf(comm,fp,"{\"kernel\": \"%s\", \"dim\": %D, \"degree\": %D, \"order\": %D, \"dof\": %D, "
+                                "\"time\": %g, \"flops\": %g, \"bytes\": %g, \"gflops\": %g, \"gbs\": %g, "
+                                "\"intensity\": %g, \"roofline\": %g, \"bound\": \"%s\"}\n",
+                                KernelNames[t],dim,k.p,o,dof,(double)time,(double)flops,(double)bytes,
+                                (double)perf,(double)bw,(double)ai,(double)roof,
+                                (ai >= ridge) ? "compute" : "memory");CHKERRQ(ierr);
+          }
+        }
+      }
+      ierr = KernelDestroy(&k);CHKERRQ(ierr);
+    }
+  }
+  if (fp) {ierr = PetscFClose(comm,fp);CHKERRQ(ierr);}
+  if (sink == 12345.6789) {ierr = PetscPrintf(comm,"%g\n",(double)sink);CHKERRQ(ierr);}
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
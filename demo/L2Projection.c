@@ -93,6 +93,27 @@ PetscErrorCode System(IGAPoint p,PetscScalar *K,PetscScalar *F,void *ctx)
   return 0;
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "Vector"
+PetscErrorCode Vector(IGAPoint p,PetscScalar *F,void *ctx)
+{
+  AppCtx  *app = (AppCtx*)ctx;
+  PetscInt nen = p->nen;
+  PetscInt dim = p->dim;
+
+  PetscReal xyz[3] = {0,0,0};
+  IGAPointFormPoint(p,xyz);
+  PetscScalar f = app->Function(dim,xyz);
+
+  const PetscReal *N = (typeof(N)) p->shape[0];
+
+  PetscInt a;
+  for (a=0; a<nen; a++)
+    F[a] = N[a] * f;
+
+  return 0;
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "Error"
 PetscErrorCode Error(IGAPoint p,const PetscScalar *U,PetscInt n,PetscScalar *S,void *ctx)
@@ -122,12 +143,15 @@ int main(int argc, char *argv[]) {
 
   const char *choicelist[] = {"linear", "quadratic", "cubic", "quartic", "hill", "peaks", "sine", "step"};
   PetscInt choice = 0, nchoices = (PetscInt)(sizeof(choicelist)/sizeof(choicelist[0]));
+  const char *methodlist[] = {"ksp", "project", "quasi"};
+  PetscInt method = 0, nmethods = (PetscInt)(sizeof(methodlist)/sizeof(methodlist[0]));
   PetscBool print_error = PETSC_FALSE;
   PetscBool check_error = PETSC_FALSE;
   PetscBool save = PETSC_FALSE;
   PetscBool draw = PETSC_FALSE;
   ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","L2Projection Options","IGA");CHKERRQ(ierr);
   ierr = PetscOptionsEList("-function","Function to project",__FILE__,choicelist,nchoices,choicelist[choice],&choice,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-method","Solve with KSP, IGAProject() or IGAQuasiInterpolate()",__FILE__,methodlist,nmethods,methodlist[method],&method,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-print_error","Prints the L2 error of the solution",__FILE__,print_error,&print_error,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-check_error","Checks the L2 error of the solution",__FILE__,check_error,&check_error,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-save","Save the solution to file",__FILE__,save,&save,NULL);CHKERRQ(ierr);
@@ -162,19 +186,30 @@ int main(int argc, char *argv[]) {
   PetscInt dim;
   ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
 
-  Mat A;
   Vec x,b;
-  ierr = IGACreateMat(iga,&A);CHKERRQ(ierr);
   ierr = IGACreateVec(iga,&x);CHKERRQ(ierr);
   ierr = IGACreateVec(iga,&b);CHKERRQ(ierr);
-  ierr = IGASetFormSystem(iga,System,&app);CHKERRQ(ierr);
-  ierr = IGAComputeSystem(iga,A,b);CHKERRQ(ierr);
 
-  KSP ksp;
-  ierr = IGACreateKSP(iga,&ksp);CHKERRQ(ierr);
-  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
-  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
-  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  if (method == 0) {
+    Mat A;
+    KSP ksp;
+    ierr = IGACreateMat(iga,&A);CHKERRQ(ierr);
+    ierr = IGASetFormSystem(iga,System,&app);CHKERRQ(ierr);
+    ierr = IGAComputeSystem(iga,A,b);CHKERRQ(ierr);
+    ierr = IGACreateKSP(iga,&ksp);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  } else if (method == 1) {
+    ierr = IGASetFormVector(iga,Vector,&app);CHKERRQ(ierr);
+    ierr = IGAComputeVector(iga,b);CHKERRQ(ierr);
+    ierr = IGAProject(iga,b,x);CHKERRQ(ierr);
+  } else {
+    ierr = IGASetFormVector(iga,Vector,&app);CHKERRQ(ierr);
+    ierr = IGAQuasiInterpolate(iga,x);CHKERRQ(ierr);
+  }
 
   PetscScalar scalar;
   ierr = IGAComputeScalar(iga,x,1,&scalar,Error,&app);CHKERRQ(ierr);
@@ -186,8 +221,6 @@ int main(int argc, char *argv[]) {
   if (save) {ierr = IGAWriteVec(iga,x,"L2Projection-solution.dat");CHKERRQ(ierr);}
   if (draw && dim <= 2) {ierr = VecView(x,PETSC_VIEWER_DRAW_WORLD);CHKERRQ(ierr);}
 
-  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
-  ierr = MatDestroy(&A);CHKERRQ(ierr);
   ierr = VecDestroy(&x);CHKERRQ(ierr);
   ierr = VecDestroy(&b);CHKERRQ(ierr);
   ierr = IGADestroy(&iga);CHKERRQ(ierr);
@@ -57,9 +57,18 @@ PETSC_EXTERN PetscErrorCode IGAAxisInitBreaks(IGAAxis axis,PetscInt nu,const Pet
 PETSC_EXTERN PetscErrorCode IGAAxisInitUniform(IGAAxis axis,PetscInt N,PetscReal Ui,PetscReal Uf,PetscInt C);
 PETSC_EXTERN PetscErrorCode IGAAxisSetUp(IGAAxis axis);
 
+typedef enum {
+  IGA_RULE_LEGENDRE=0,
+  IGA_RULE_REDUCED
+} IGARuleType;
+
+PETSC_EXTERN const char *const IGARuleTypes[];
+
 struct _n_IGARule {
   PetscInt refct;
   /**/
+  IGARuleType type;   /* rule type */
+  /**/
   PetscInt  nqp;      /* number of quadrature points */
   PetscReal *point;   /* [nqp] quadrature points  */
   PetscReal *weight;  /* [nqp] quadrature weights */
@@ -70,9 +79,12 @@ PETSC_EXTERN PetscErrorCode IGARuleReset(IGARule rule);
 PETSC_EXTERN PetscErrorCode IGARuleReference(IGARule rule);
 PETSC_EXTERN PetscErrorCode IGARuleCopy(IGARule base,IGARule rule);
 PETSC_EXTERN PetscErrorCode IGARuleDuplicate(IGARule base,IGARule *rule);
+PETSC_EXTERN PetscErrorCode IGARuleSetType(IGARule rule,IGARuleType type);
+PETSC_EXTERN PetscErrorCode IGARuleGetType(IGARule rule,IGARuleType *type);
 PETSC_EXTERN PetscErrorCode IGARuleInit(IGARule rule,PetscInt q);
 PETSC_EXTERN PetscErrorCode IGARuleSetRule(IGARule rule,PetscInt q,const PetscReal x[],const PetscReal w[]);
 PETSC_EXTERN PetscErrorCode IGARuleGetRule(IGARule rule,PetscInt *q,PetscReal *x[],PetscReal *w[]);
+PETSC_EXTERN PetscErrorCode IGARuleComputeReduced(IGAAxis axis,PetscInt count[],PetscReal point[],PetscReal weight[]);
 
 typedef enum {
   IGA_BASIS_BSPLINE=0,
@@ -83,27 +95,60 @@ typedef enum {
 
 PETSC_EXTERN const char *const IGABasisTypes[];
 
+typedef enum {
+  IGA_ELEMENT_ORDER_LEXICOGRAPHIC=0,
+  IGA_ELEMENT_ORDER_TILED,
+  IGA_ELEMENT_ORDER_MORTON
+} IGAElementOrder;
+
+PETSC_EXTERN const char *const IGAElementOrders[];
+
+typedef enum {
+  IGA_PROFILE_CLOSURE=0, /* element closure and boundary fixes setup */
+  IGA_PROFILE_VALUES,    /* gather of element values              */
+  IGA_PROFILE_BASIS,     /* quadrature and basis tensorization     */
+  IGA_PROFILE_GEOMETRY,  /* geometry mapping                       */
+  IGA_PROFILE_KERNEL,    /* user point routine                     */
+  IGA_PROFILE_ADDPOINT,  /* point contribution to element arrays   */
+  IGA_PROFILE_FIX,       /* boundary fixes on element arrays       */
+  IGA_PROFILE_SETVALUES, /* insertion into global Vec/Mat          */
+  IGA_PROFILE_ASSEMBLY,  /* final Vec/Mat assembly                 */
+  IGA_PROFILE_PHASES
+} IGAProfilePhase;
+
+PETSC_EXTERN const char *const IGAProfilePhases[];
+
 struct _n_IGABasis {
   PetscInt refct;
   /**/
   IGABasisType type;  /* basis type */
   /**/
   PetscInt  nel;      /* number of elements */
-  PetscInt  nqp;      /* number of quadrature points */
+  PetscInt  nqp;      /* max number of quadrature points per element */
   PetscInt  nen;      /* number of local basis functions */
   PetscInt  p,d;      /* polynomial order, last derivative index */
 
   PetscInt  *offset;  /* [nel] basis offset   */
+  PetscInt  *count;   /* [nel] quadrature points per element */
   PetscReal *detJ;    /* [nel]                */
-  PetscReal *weight;  /* [nqp]                */
+  PetscReal *weight;  /* [nel][nqp]           */
   PetscReal *point;   /* [nel][nqp]           */
-  PetscReal *value;   /* [nel][nqp][nen][d+1] */
+  PetscReal *value;   /* [nel][nqp][nen][d+1], NULL with Bezier extraction */
+
+  PetscInt   nop;       /* number of distinct extraction operators */
+  PetscInt  *opid;      /* [nel] extraction operator of each element */
+  PetscReal *extract;   /* [nop][nen][nen] Bernstein coefficients */
+  PetscReal *bernstein; /* [nqp][nen][d+1] reference Bernstein values */
+  PetscInt   cached;    /* element whose values are in work */
+  PetscReal *work;      /* [nqp][nen][d+1] */
 
   PetscInt   bnd_offset[2];
   PetscReal  bnd_detJ[2];
   PetscReal  bnd_weight[2];
   PetscReal  bnd_point[2];
   PetscReal *bnd_value[2]; /* [nen][d+1] */
+
+  PetscLogDouble mem;      /* bytes held by the arrays above */
 };
 
 PETSC_EXTERN PetscErrorCode IGABasisCreate(IGABasis *basis);
@@ -113,6 +158,8 @@ PETSC_EXTERN PetscErrorCode IGABasisReference(IGABasis basis);
 PETSC_EXTERN PetscErrorCode IGABasisSetType(IGABasis basis,IGABasisType type);
 PETSC_EXTERN PetscErrorCode IGABasisInitQuadrature (IGABasis basis,IGAAxis axis,IGARule rule,PetscInt order);
 PETSC_EXTERN PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt order);
+PETSC_EXTERN PetscErrorCode IGABasisInitBezier     (IGABasis basis,IGAAxis axis,IGARule rule,PetscInt order);
+PETSC_EXTERN const PetscReal *IGABasisGetValues(IGABasis basis,PetscInt iel);
 
 /* ---------------------------------------------------------------- */
 
@@ -197,6 +244,23 @@ struct _IGAFormOps {
   void               *RHSJacCtx;
 };
 
+typedef enum {
+  IGA_FORM_VECTOR=0,
+  IGA_FORM_MATRIX,
+  IGA_FORM_SYSTEM,
+  IGA_FORM_FUNCTION,
+  IGA_FORM_JACOBIAN,
+  IGA_FORM_IFUNCTION,
+  IGA_FORM_IJACOBIAN,
+  IGA_FORM_IEFUNCTION,
+  IGA_FORM_IEJACOBIAN,
+  IGA_FORM_RHSFUNCTION,
+  IGA_FORM_RHSJACOBIAN
+} IGAFormKind;
+#define IGA_FORM_KINDS 11
+
+PETSC_EXTERN const char *const IGAFormKinds[];
+
 struct _n_IGAForm {
   PetscInt refct;
   /**/
@@ -205,6 +269,7 @@ struct _n_IGAForm {
   IGAFormBC  value[3][2];
   IGAFormBC  load [3][2];
   PetscBool  visit[3][2];
+  PetscInt   quadr[IGA_FORM_KINDS][3]; /* 0: use the IGA rule */
 };
 
 PETSC_EXTERN PetscErrorCode IGAGetForm(IGA iga,IGAForm *form);
@@ -219,6 +284,7 @@ PETSC_EXTERN PetscErrorCode IGAFormSetBoundaryValue(IGAForm form,PetscInt axis,P
 PETSC_EXTERN PetscErrorCode IGAFormSetBoundaryLoad (IGAForm form,PetscInt axis,PetscInt side,PetscInt field,PetscScalar value);
 PETSC_EXTERN PetscErrorCode IGAFormSetBoundaryForm (IGAForm form,PetscInt axis,PetscInt side,PetscBool flag);
 PETSC_EXTERN PetscErrorCode IGAFormClearBoundary   (IGAForm form,PetscInt axis,PetscInt side);
+PETSC_EXTERN PetscErrorCode IGAFormSetQuadrature   (IGAForm form,IGAFormKind kind,PetscInt n,const PetscInt q[]);
 
 PETSC_EXTERN PetscErrorCode IGAFormSetVector     (IGAForm form,IGAFormVector      Vector,     void *ctx);
 PETSC_EXTERN PetscErrorCode IGAFormSetMatrix     (IGAForm form,IGAFormMatrix      Matrix,     void *ctx);
@@ -252,6 +318,7 @@ PETSC_EXTERN PetscErrorCode IGASetFormIEFunction (IGA iga,IGAFormIEFunction  IEF
 PETSC_EXTERN PetscErrorCode IGASetFormIEJacobian (IGA iga,IGAFormIEJacobian  IEJacobian, void *ctx);
 PETSC_EXTERN PetscErrorCode IGASetFormRHSFunction(IGA iga,IGAFormRHSFunction RHSFunction,void *ctx);
 PETSC_EXTERN PetscErrorCode IGASetFormRHSJacobian(IGA iga,IGAFormRHSJacobian RHSJacobian,void *ctx);
+PETSC_EXTERN PetscErrorCode IGASetFormQuadrature (IGA iga,IGAFormKind kind,PetscInt n,const PetscInt q[]);
 
 /* ---------------------------------------------------------------- */
 
@@ -269,6 +336,7 @@ struct _p_IGA {
   PetscBool  setup;
   PetscInt   setupstage;
   PetscBool  collocation;
+  PetscBool  bezier;
 
   VecType    vectype;
   MatType    mattype;
@@ -281,9 +349,12 @@ struct _p_IGA {
   IGAAxis     axis[3];
   IGARule     rule[3];
   IGABasis    basis[3];
+  IGABasis    formbasis[IGA_FORM_KINDS][3]; /* NULL: use basis[] */
   IGAForm     form;
 
   IGAElement  iterator;
+  IGAElementOrder elem_order;
+  PetscInt        elem_tile[3];
 
   PetscBool   rational;
   PetscInt    geometry;
@@ -317,10 +388,19 @@ struct _p_IGA {
   LGMap       lgmap;
   PetscLayout map;
   VecScatter  g2l,l2g,l2l;
+  PetscBool   haloexchange;
+  struct _n_IGA_Halo *halo;
   PetscInt    nwork;
   Vec         vwork[16];
   Vec         natural;
   VecScatter  n2g,g2n;
+  struct _n_IGA_Proj *proj;
+
+  PetscBool      profile;
+  PetscLogDouble profile_tic[IGA_PROFILE_PHASES];
+  PetscLogDouble profile_time[IGA_PROFILE_PHASES];
+  PetscInt       profile_count[IGA_PROFILE_PHASES];
+  PetscLogDouble elem_tic,elem_time; /* element loop of the last IGACompute*() */
 
   DM elem_dm;
   DM geom_dm;
@@ -330,6 +410,8 @@ struct _p_IGA {
 
 PETSC_EXTERN PetscClassId IGA_CLASSID;
 #define IGA_FILE_CLASSID 1211299
+#define IGA_CHECKPOINT_CLASSID 1211300
+#define IGA_SUBSET_FILE_CLASSID 1211301
 
 PETSC_EXTERN PetscErrorCode IGAInitializePackage(void);
 PETSC_EXTERN PetscErrorCode IGAFinalizePackage(void);
@@ -340,6 +422,7 @@ PETSC_EXTERN PetscErrorCode IGADestroy(IGA *iga);
 PETSC_EXTERN PetscErrorCode IGAReset(IGA iga);
 PETSC_EXTERN PetscErrorCode IGASetUp(IGA iga);
 PETSC_EXTERN PetscErrorCode IGAView(IGA iga,PetscViewer viewer);
+PETSC_EXTERN PetscErrorCode IGAViewBalance(IGA iga,PetscViewer viewer);
 
 PETSC_EXTERN PetscErrorCode IGAGetOptionsPrefix(IGA iga,const char *prefix[]);
 PETSC_EXTERN PetscErrorCode IGASetOptionsPrefix(IGA iga,const char prefix[]);
@@ -366,9 +449,21 @@ PETSC_EXTERN PetscErrorCode IGASaveProperty(IGA iga,PetscViewer viewer);
 
 PETSC_EXTERN PetscErrorCode IGALoadVec(IGA iga,Vec vec,PetscViewer viewer);
 PETSC_EXTERN PetscErrorCode IGASaveVec(IGA iga,Vec vec,PetscViewer viewer);
+PETSC_EXTERN PetscErrorCode IGASaveVecTime(IGA iga,Vec vec,PetscReal time,PetscViewer viewer);
 PETSC_EXTERN PetscErrorCode IGADrawVec(IGA iga,Vec vec,PetscViewer viewer);
 PETSC_EXTERN PetscErrorCode IGAReadVec(IGA iga,Vec vec,const char filename[]);
 PETSC_EXTERN PetscErrorCode IGAWriteVec(IGA iga,Vec vec,const char filename[]);
+PETSC_EXTERN PetscErrorCode IGAWriteVecSubset(IGA iga,Vec vec,const char filename[]);
+PETSC_EXTERN PetscErrorCode IGAWriteVecVTK(IGA iga,Vec vec,const char filename[]);
+
+typedef struct _n_IGACheckpoint *IGACheckpoint;
+PETSC_EXTERN PetscErrorCode IGACheckpointCreate(IGA iga,IGACheckpoint *ckpt);
+PETSC_EXTERN PetscErrorCode IGACheckpointDestroy(IGACheckpoint *ckpt);
+PETSC_EXTERN PetscErrorCode IGACheckpointFlush(IGACheckpoint ckpt);
+PETSC_EXTERN PetscErrorCode IGACheckpointWrite(IGACheckpoint ckpt,const char filename[],PetscReal t,PetscInt step,PetscInt nvec,const Vec vecs[]);
+PETSC_EXTERN PetscErrorCode IGACheckpointWriteTS(IGACheckpoint ckpt,TS ts,const char filename[]);
+PETSC_EXTERN PetscErrorCode IGACheckpointRead(IGA iga,const char filename[],PetscReal *t,PetscInt *step,PetscInt nvec,Vec vecs[]);
+PETSC_EXTERN PetscErrorCode IGACheckpointReadTS(IGA iga,TS ts,const char filename[],PetscInt *step);
 
 PETSC_EXTERN PetscErrorCode IGASetDim(IGA iga,PetscInt dim);
 PETSC_EXTERN PetscErrorCode IGAGetDim(IGA iga,PetscInt *dim);
@@ -381,7 +476,12 @@ PETSC_EXTERN PetscErrorCode IGAGetOrder(IGA iga,PetscInt *order);
 PETSC_EXTERN PetscErrorCode IGASetProcessors(IGA iga,PetscInt i,PetscInt processors);
 PETSC_EXTERN PetscErrorCode IGASetBasisType(IGA iga,PetscInt i,IGABasisType type);
 PETSC_EXTERN PetscErrorCode IGASetQuadrature(IGA iga,PetscInt i,PetscInt q);
+PETSC_EXTERN PetscErrorCode IGASetRuleType(IGA iga,PetscInt i,IGARuleType type);
 PETSC_EXTERN PetscErrorCode IGASetUseCollocation(IGA iga,PetscBool collocation);
+PETSC_EXTERN PetscErrorCode IGASetUseBezierExtraction(IGA iga,PetscBool bezier);
+PETSC_EXTERN PetscErrorCode IGASetUseHaloExchange(IGA iga,PetscBool halo);
+PETSC_EXTERN PetscErrorCode IGASetElementOrder(IGA iga,IGAElementOrder order,const PetscInt tile[]);
+PETSC_EXTERN PetscErrorCode IGAGetElementOrder(IGA iga,IGAElementOrder *order,PetscInt tile[]);
 
 PETSC_EXTERN PetscErrorCode IGAGetComm(IGA iga,MPI_Comm *comm);
 PETSC_EXTERN PetscErrorCode IGAGetAxis(IGA iga,PetscInt i,IGAAxis *axis);
@@ -424,6 +524,7 @@ PETSC_EXTERN PetscErrorCode IGALocalToLocalBegin (IGA iga,Vec gvec,Vec lvec,Inse
 PETSC_EXTERN PetscErrorCode IGALocalToLocalEnd   (IGA iga,Vec gvec,Vec lvec,InsertMode addv);
 PETSC_EXTERN PetscErrorCode IGALocalToLocal      (IGA iga,Vec gvec,Vec lvec,InsertMode addv);
 
+PETSC_EXTERN PetscErrorCode IGAGetAO(IGA iga,AO *ao);
 PETSC_EXTERN PetscErrorCode IGAGetNaturalVec(IGA iga,Vec *nvec);
 PETSC_EXTERN PetscErrorCode IGANaturalToGlobal(IGA iga,Vec nvec,Vec gvec);
 PETSC_EXTERN PetscErrorCode IGAGlobalToNatural(IGA iga,Vec gvec,Vec nvec);
@@ -454,6 +555,7 @@ struct _n_IGAElement {
   /**/
   PetscInt count;
   PetscInt index;
+  PetscInt *order; /* [count] traversal order, NULL if lexicographic */
   /**/
   PetscInt neq;
   PetscInt nen;
@@ -473,6 +575,7 @@ struct _n_IGAElement {
   PetscScalar *propertyA; /*[nen][npd] */
 
   PetscInt  nqp;
+  IGABasis  *BD;       /*   [3] quadrature in use     */
 
   PetscReal *point;    /*   [nqp][dim]                */
   PetscReal *weight;   /*   [nqp]                     */
@@ -501,6 +604,9 @@ struct _n_IGAElement {
   IGA      parent;
   IGAPoint iterator;
 
+  Mat asmmat;   /* matrix of the last IGAElementAssembleMat() call */
+  Mat asmlocal; /* its MATIS subdomain matrix, NULL otherwise     */
+
   PetscBool   collocation;
 
   PetscInt     nfix;
@@ -519,6 +625,7 @@ struct _n_IGAElement {
   PetscInt    nmat;
   PetscScalar *wmat[4];
 
+  PetscLogDouble mem; /* bytes held by the arrays above */
 };
 
 PETSC_EXTERN PetscErrorCode IGAElementCreate(IGAElement *element);
@@ -532,6 +639,7 @@ PETSC_EXTERN PetscErrorCode IGABeginElement(IGA iga,IGAElement *element);
 PETSC_EXTERN PetscBool      IGANextElement(IGA iga,IGAElement element);
 PETSC_EXTERN PetscErrorCode IGAEndElement(IGA iga,IGAElement *element);
 PETSC_EXTERN PetscBool      IGAElementNextForm(IGAElement element,PetscBool visit[][2]);
+PETSC_EXTERN PetscErrorCode IGAElementUseFormQuadrature(IGAElement element,IGAFormKind kind);
 PETSC_EXTERN PetscErrorCode IGAElementGetPoint(IGAElement element,IGAPoint *point);
 PETSC_EXTERN PetscErrorCode IGAElementBeginPoint(IGAElement element,IGAPoint *point);
 PETSC_EXTERN PetscBool      IGAElementNextPoint(IGAElement element,IGAPoint point);
@@ -617,6 +725,8 @@ struct _n_IGAPoint {
   PetscScalar *wvec[8];
   PetscInt    nmat;
   PetscScalar *wmat[4];
+
+  PetscLogDouble mem; /* bytes held by the arrays above */
 };
 
 PETSC_EXTERN PetscErrorCode IGAPointCreate(IGAPoint *point);
@@ -665,6 +775,28 @@ PETSC_EXTERN PetscLogEvent IGA_FormJacobian;
 PETSC_EXTERN PetscLogEvent IGA_FormIFunction;
 PETSC_EXTERN PetscLogEvent IGA_FormIJacobian;
 
+PETSC_STATIC_INLINE void IGAProfileBegin(IGA iga,IGAProfilePhase phase)
+{ if (PetscUnlikely(iga->profile)) iga->profile_tic[phase] = MPI_Wtime(); }
+PETSC_STATIC_INLINE void IGAProfileEnd(IGA iga,IGAProfilePhase phase)
+{ if (PetscUnlikely(iga->profile)) {
+    iga->profile_time[phase] += MPI_Wtime() - iga->profile_tic[phase];
+    iga->profile_count[phase]++; } }
+
+PETSC_EXTERN PetscBool IGATraceActive;
+PETSC_EXTERN void IGATraceRecord(const char name[],char phase);
+PETSC_STATIC_INLINE void IGATraceBegin(const char name[])
+{ if (PetscUnlikely(IGATraceActive)) IGATraceRecord(name,'B'); }
+PETSC_STATIC_INLINE void IGATraceEnd(const char name[])
+{ if (PetscUnlikely(IGATraceActive)) IGATraceRecord(name,'E'); }
+
+PETSC_EXTERN PetscErrorCode IGATraceInitialize(void);
+PETSC_EXTERN PetscErrorCode IGATraceFinalize(void);
+PETSC_EXTERN PetscErrorCode IGATraceDump(MPI_Comm comm,const char filename[]);
+
+PETSC_EXTERN PetscErrorCode IGASetUseProfile(IGA iga,PetscBool profile);
+PETSC_EXTERN PetscErrorCode IGAGetAssemblyProfile(IGA iga,PetscLogDouble time[],PetscInt count[]);
+PETSC_EXTERN PetscErrorCode IGAResetAssemblyProfile(IGA iga);
+
 PETSC_EXTERN PetscErrorCode IGAComputeScalar(IGA iga,Vec U,
                                              PetscInt n,PetscScalar S[],
                                              IGAFormScalar Scalar,void *ctx);
@@ -676,10 +808,14 @@ PETSC_EXTERN PetscErrorCode IGAComputeScalarCustom(IGA iga,Vec U,
 #define PCIGAEBE "igaebe"
 #define PCIGABBB "igabbb"
 
+#define MATIGA "iga"
+
 PETSC_EXTERN PetscErrorCode IGACreateKSP(IGA iga,KSP *ksp);
 PETSC_EXTERN PetscErrorCode IGAComputeVector(IGA iga,Vec B);
 PETSC_EXTERN PetscErrorCode IGAComputeMatrix(IGA iga,Mat A);
 PETSC_EXTERN PetscErrorCode IGAComputeSystem(IGA iga,Mat A,Vec B);
+PETSC_EXTERN PetscErrorCode IGAProject(IGA iga,Vec b,Vec x);
+PETSC_EXTERN PetscErrorCode IGAQuasiInterpolate(IGA iga,Vec x);
 
 PETSC_EXTERN PetscErrorCode IGACreateSNES(IGA iga,SNES *snes);
 PETSC_EXTERN PetscErrorCode IGAComputeFunction(IGA iga,Vec U,Vec F);
@@ -726,6 +862,7 @@ PETSC_EXTERN PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
 /* ---------------------------------------------------------------- */
 
 PETSC_EXTERN PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc);
+PETSC_EXTERN PetscErrorCode IGAPreparePCASM(IGA iga,PC pc);
 PETSC_EXTERN PetscErrorCode IGASetOptionsHandlerPC(PC pc);
 PETSC_EXTERN PetscErrorCode IGASetOptionsHandlerKSP(KSP ksp);
 PETSC_EXTERN PetscErrorCode IGASetOptionsHandlerSNES(SNES snes);
@@ -778,6 +915,10 @@ PETSC_EXTERN PetscErrorCode IGASetOptionsHandlerTS(TS ts);
   (PetscMalloc1((m1),r1) || PetscMemzero(*(r1),(m1)*sizeof(**(r1))))
 #endif
 
+/* PetscMalloc1() adding the bytes allocated to a running total */
+#define IGAMalloc1(mem,m1,r1) \
+  ((mem) += (PetscLogDouble)(m1)*sizeof(**(r1)), PetscMalloc1((m1),r1))
+
 /* ---------------------------------------------------------------- */
 
 #if PETSC_VERSION_(3,3,0)
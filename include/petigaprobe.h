@@ -51,6 +51,23 @@ struct _n_IGAProbe {
                        /*1: [nen][nsd]           */
                        /*2: [nen][nsd][nsd]      */
                        /*3: [nen][nsd][nsd][nsd] */
+  /**/
+  PetscInt  npts;      /* number of batched points */
+  PetscInt  maxpts;    /* allocated batch capacity */
+  PetscInt  ptsorder;  /* order of the cached basis */
+  PetscReal *pts;      /* [npts][dim]              */
+  PetscInt  *ptsID;    /* [npts][3]                */
+  PetscBool *ptsown;   /* [npts]                   */
+  PetscReal *ptsBD[3]; /* [npts][p+1][4]           */
+  /**/
+  PetscInt  nbox;      /* number of element boxes  */
+  PetscReal *box;      /* [nbox][2][dim]           */
+  PetscInt  *boxID;    /* [nbox][3]                */
+  PetscInt  cells[3];  /* hash grid cells          */
+  PetscReal origin[3]; /* hash grid origin         */
+  PetscReal delta[3];  /* hash grid cell size      */
+  PetscInt  *celloff;  /* [ncells+1]               */
+  PetscInt  *cellbox;  /* [celloff[ncells]]        */
 };
 
 PETSC_EXTERN PetscErrorCode IGAProbeCreate(IGA iga,Vec A,IGAProbe *prb);
@@ -70,4 +87,9 @@ PETSC_EXTERN PetscErrorCode IGAProbeFormGrad (IGAProbe prb,PetscScalar A[]);
 PETSC_EXTERN PetscErrorCode IGAProbeFormHess (IGAProbe prb,PetscScalar A[]);
 PETSC_EXTERN PetscErrorCode IGAProbeFormDer3 (IGAProbe prb,PetscScalar A[]);
 
+PETSC_EXTERN PetscErrorCode IGAProbeSetPoints(IGAProbe prb,PetscInt npts,const PetscReal u[]);
+PETSC_EXTERN PetscErrorCode IGAProbeGeomMapMany(IGAProbe prb,PetscReal x[]);
+PETSC_EXTERN PetscErrorCode IGAProbeEvaluateMany(IGAProbe prb,PetscInt der,PetscScalar A[]);
+PETSC_EXTERN PetscErrorCode IGAProbeLocatePoints(IGAProbe prb,PetscInt npts,const PetscReal x[],PetscReal u[],PetscBool found[]);
+
 #endif/*PETIGAPROBE_H*/
@@ -16,5 +16,7 @@ PETSC_EXTERN PetscErrorCode TSSolve2(TS,Vec,Vec);
 PETSC_EXTERN PetscErrorCode TSAlpha2SetRadius(TS,PetscReal);
 PETSC_EXTERN PetscErrorCode TSAlpha2SetParams(TS,PetscReal,PetscReal,PetscReal,PetscReal);
 PETSC_EXTERN PetscErrorCode TSAlpha2GetParams(TS,PetscReal*,PetscReal*,PetscReal*,PetscReal*);
+PETSC_EXTERN PetscErrorCode TSAlpha2SetAcceleration(TS,Vec);
+PETSC_EXTERN PetscErrorCode TSAlpha2GetAcceleration(TS,Vec*);
 
 #endif/*__PETSCTS2_H*/
@@ -44,6 +44,10 @@ PetscErrorCode IGACreate(MPI_Comm comm,IGA *newiga)
   for (i=0; i<3; i++)
     iga->proc_sizes[i] = -1;
 
+  iga->elem_order = IGA_ELEMENT_ORDER_LEXICOGRAPHIC;
+  for (i=0; i<3; i++)
+    iga->elem_tile[i] = 8;
+
   for (i=0; i<3; i++) {
     ierr = IGAAxisCreate(&iga->axis[i]);CHKERRQ(ierr);
     ierr = IGARuleCreate(&iga->rule[i]);CHKERRQ(ierr);
@@ -55,6 +59,8 @@ PetscErrorCode IGACreate(MPI_Comm comm,IGA *newiga)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode IGA_ProfileView(IGA,PetscViewer);
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGADestroy"
 /*@
@@ -71,7 +77,7 @@ PetscErrorCode IGACreate(MPI_Comm comm,IGA *newiga)
 @*/
 PetscErrorCode IGADestroy(IGA *_iga)
 {
-  PetscInt       i;
+  PetscInt       i,n;
   IGA            iga;
   PetscErrorCode ierr;
   PetscFunctionBegin;
@@ -81,6 +87,15 @@ PetscErrorCode IGADestroy(IGA *_iga)
   PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
   if (--((PetscObject)iga)->refct > 0) PetscFunctionReturn(0);
 
+  if (iga->setup) { /* report after the last assembly */
+    PetscBool balance = PETSC_FALSE;
+    ierr = PetscOptionsGetBool(((PetscObject)iga)->prefix,"-iga_view_balance",&balance,NULL);CHKERRQ(ierr);
+    if (balance) {ierr = IGAViewBalance(iga,NULL);CHKERRQ(ierr);}
+  }
+  if (iga->profile) { /* report the accumulated profile */
+    ierr = IGA_ProfileView(iga,NULL);CHKERRQ(ierr);
+  }
+
   ierr = PetscFree(iga->vectype);CHKERRQ(ierr);
   ierr = PetscFree(iga->mattype);CHKERRQ(ierr);
   if (iga->fieldname) {
@@ -95,6 +110,9 @@ PetscErrorCode IGADestroy(IGA *_iga)
     ierr = IGARuleDestroy(&iga->rule[i]);CHKERRQ(ierr);
     ierr = IGABasisDestroy(&iga->basis[i]);CHKERRQ(ierr);
   }
+  for (n=0; n<IGA_FORM_KINDS; n++)
+    for (i=0; i<3; i++)
+      {ierr = IGABasisDestroy(&iga->formbasis[n][i]);CHKERRQ(ierr);}
   ierr = IGAFormDestroy(&iga->form);CHKERRQ(ierr);
   ierr = IGAElementDestroy(&iga->iterator);CHKERRQ(ierr);
 
@@ -103,6 +121,8 @@ PetscErrorCode IGADestroy(IGA *_iga)
   PetscFunctionReturn(0);
 }
 
+PETSC_EXTERN PetscErrorCode IGA_Proj_Destroy(struct _n_IGA_Proj**);
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAReset"
 PetscErrorCode IGAReset(IGA iga)
@@ -131,9 +151,11 @@ PetscErrorCode IGAReset(IGA iga)
   ierr = VecScatterDestroy(&iga->g2l);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->l2g);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->l2l);CHKERRQ(ierr);
+  ierr = IGA_Halo_Destroy(&iga->halo);CHKERRQ(ierr);
   ierr = VecDestroy(&iga->natural);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->n2g);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->g2n);CHKERRQ(ierr);
+  ierr = IGA_Proj_Destroy(&iga->proj);CHKERRQ(ierr);
   while (iga->nwork > 0)
     {ierr = VecDestroy(&iga->vwork[--iga->nwork]);CHKERRQ(ierr);}
 
@@ -171,7 +193,7 @@ PetscErrorCode IGAView(IGA iga,PetscViewer viewer)
   ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
   {
     MPI_Comm comm;
-    PetscInt i,dim,dof,order;
+    PetscInt i,k,dim,dof,order;
     ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
     ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
     ierr = IGAGetDof(iga,&dof);CHKERRQ(ierr);
@@ -183,6 +205,29 @@ PetscErrorCode IGAView(IGA iga,PetscViewer viewer)
       ierr = PetscViewerASCIIPrintf(viewer,"Axis %D: periodic=%d  degree=%D  quadrature=%D  processors=%D  nodes=%D  elements=%D\n",
                                     i,(int)iga->axis[i]->periodic,iga->axis[i]->p,iga->rule[i]->nqp,
                                     iga->proc_sizes[i],iga->node_sizes[i],iga->elem_sizes[i]);CHKERRQ(ierr);
+      if (iga->rule[i]->type == IGA_RULE_REDUCED && iga->basis[i]->count) {
+        IGABasis BD = iga->basis[i];
+        PetscInt e,total = 0;
+        for (e=0; e<BD->nel; e++) total += BD->count[e];
+        ierr = PetscViewerASCIIPrintf(viewer,"Axis %D: reduced quadrature  points=%D  per element=%g  max=%D\n",
+                                      i,total,(double)total/(double)BD->nel,BD->nqp);CHKERRQ(ierr);
+      }
+    }
+    if (iga->bezier) {
+      ierr = PetscViewerASCIIPrintf(viewer,"Bezier extraction - operators:");CHKERRQ(ierr);
+      ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+      for (i=0; i<dim; i++) {ierr = PetscViewerASCIIPrintf(viewer," %D/%D",iga->basis[i]->nop,iga->basis[i]->nel);CHKERRQ(ierr);}
+      ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+      ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
+    }
+    for (k=0; k<IGA_FORM_KINDS; k++) {
+      IGABasis *BD = iga->formbasis[k];
+      if (!BD[0]) continue;
+      ierr = PetscViewerASCIIPrintf(viewer,"Form %s: quadrature=%D",IGAFormKinds[k],BD[0]->nqp);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+      for (i=1; i<dim; i++) {ierr = PetscViewerASCIIPrintf(viewer,",%D",BD[i]->nqp);CHKERRQ(ierr);}
+      ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+      ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
     }
     { /* */
       PetscInt isum[2],imin[2],imax[2],iloc[2] = {1, 1};
@@ -222,6 +267,143 @@ PetscErrorCode IGAView(IGA iga,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_GetMemory"
+static PetscErrorCode IGA_GetMemory(IGA iga,PetscLogDouble mem[5])
+{
+  PetscInt       i,n;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  for (i=0; i<5; i++) mem[i] = 0;
+  /* basis functions */
+  for (i=0; i<iga->dim; i++) {
+    mem[0] += iga->basis[i]->mem;
+  }
+  for (n=0; n<IGA_FORM_KINDS; n++)
+    for (i=0; i<iga->dim; i++) {
+      IGABasis BD = iga->formbasis[n][i];
+      PetscInt j;
+      if (!BD || BD == iga->basis[i]) continue;
+      for (j=0; j<n; j++) if (iga->formbasis[j][i] == BD) break;
+      if (j < n) continue; /* shared with a previous kind */
+      mem[0] += BD->mem;
+    }
+  /* element and point work arrays */
+  mem[1] += iga->iterator->mem;
+  mem[1] += iga->iterator->iterator->mem;
+  /* geometry, properties, and fix table */
+  n = iga->geom_gwidth[0]*iga->geom_gwidth[1]*iga->geom_gwidth[2];
+  if (iga->rationalW) mem[2] += (PetscLogDouble)n*sizeof(PetscReal);
+  if (iga->geometryX) mem[2] += (PetscLogDouble)n*iga->geometry*sizeof(PetscReal);
+  if (iga->propertyA) mem[2] += (PetscLogDouble)n*iga->property*sizeof(PetscScalar);
+  n = iga->node_gwidth[0]*iga->node_gwidth[1]*iga->node_gwidth[2];
+  if (iga->fixtableU) mem[2] += (PetscLogDouble)n*iga->dof*sizeof(PetscScalar);
+  /* work and natural vectors */
+  for (i=0; i<iga->nwork; i++) {
+    ierr = VecGetLocalSize(iga->vwork[i],&n);CHKERRQ(ierr);
+    mem[3] += (PetscLogDouble)n*sizeof(PetscScalar);
+  }
+  if (iga->natural) {
+    ierr = VecGetLocalSize(iga->natural,&n);CHKERRQ(ierr);
+    mem[3] += (PetscLogDouble)n*sizeof(PetscScalar);
+  }
+  /* scatters, mappings, and ordering, as logged by PETSc */
+  {
+    PetscObject obj[7];
+    obj[0] = (PetscObject)iga->g2l;
+    obj[1] = (PetscObject)iga->l2g;
+    obj[2] = (PetscObject)iga->l2l;
+    obj[3] = (PetscObject)iga->n2g;
+    obj[4] = (PetscObject)iga->g2n;
+    obj[5] = (PetscObject)iga->lgmap;
+    obj[6] = (PetscObject)iga->ao;
+    for (i=0; i<7; i++) if (obj[i]) mem[4] += obj[i]->mem;
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAViewBalance"
+/*@
+   IGAViewBalance - Prints, for each process, the work and memory
+   held by the IGA, together with the imbalance across processes.
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+-  viewer - an ASCII viewer (or NULL for stdout)
+
+   Options Database Keys:
+.  -iga_view_balance - print the report when the IGA is destroyed
+
+   Notes:
+   For each process, the report lists owned and ghost nodes, local and
+   boundary elements, the time spent in the element loop of the last
+   IGACompute*() call (other element loops, e.g. VTK output or point
+   location, are not timed), and the bytes held in basis functions and
+   element and point work arrays (counted as they are allocated),
+   geometry and properties, work and natural vectors, and scatters,
+   mappings and ordering (as logged by PETSc). The max/mean ratios at the end give the imbalance.
+
+   Level: advanced
+
+.keywords: IGA, view, load balance, memory
+.seealso: IGAView(), IGASetUseProfile()
+@*/
+PetscErrorCode IGAViewBalance(IGA iga,PetscViewer viewer)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size;
+  PetscBool      isascii;
+  PetscInt       i,dim;
+  PetscInt       nnp = 1,gnp = 1,nel = 1,iel = 1;
+  PetscLogDouble mem[5],tmem,loc[4],lmax[4],lsum[4];
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  if (!viewer) {ierr = PetscViewerASCIIGetStdout(((PetscObject)iga)->comm,&viewer);CHKERRQ(ierr);}
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,2);
+  PetscCheckSameComm(iga,1,viewer,2);
+  IGACheckSetUp(iga,1);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&isascii);CHKERRQ(ierr);
+  if (!isascii) PetscFunctionReturn(0);
+
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
+  for (i=0; i<dim; i++) {
+    PetscInt w = iga->elem_width[i];
+    if (!iga->axis[i]->periodic) {
+      if (iga->elem_start[i] == 0) w--;
+      if (iga->elem_start[i] + iga->elem_width[i] == iga->elem_sizes[i]) w--;
+    }
+    nnp *= iga->node_lwidth[i];
+    gnp *= iga->node_gwidth[i];
+    nel *= iga->elem_width[i];
+    iel *= PetscMax(w,0);
+  }
+  ierr = IGA_GetMemory(iga,mem);CHKERRQ(ierr);
+  for (tmem=0, i=0; i<5; i++) tmem += mem[i];
+
+  loc[0] = nnp; loc[1] = nel; loc[2] = iga->elem_time; loc[3] = tmem;
+  ierr = MPI_Allreduce(loc,lmax,4,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(loc,lsum,4,MPIU_PETSCLOGDOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+
+  ierr = PetscViewerASCIIPrintf(viewer,"IGA balance: memory in bytes (basis/work/geometry/vectors/scatters)\n");CHKERRQ(ierr);
+  ierr = PetscViewerASCIISynchronizedAllow(viewer,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] nodes=%D+%D  elements=%D (boundary=%D)  time=%g  memory=%.0f (%.0f/%.0f/%.0f/%.0f/%.0f)\n",
+                                            (int)rank,nnp,gnp-nnp,nel,nel-iel,(double)iga->elem_time,
+                                            (double)tmem,(double)mem[0],(double)mem[1],(double)mem[2],(double)mem[3],(double)mem[4]);CHKERRQ(ierr);
+  ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIISynchronizedAllow(viewer,PETSC_FALSE);CHKERRQ(ierr);
+  for (i=0; i<4; i++) lsum[i] = (lsum[i] > 0) ? lmax[i]*size/lsum[i] : 1;
+  ierr = PetscViewerASCIIPrintf(viewer,"Imbalance max/mean: nodes=%g  elements=%g  time=%g  memory=%g\n",
+                                (double)lsum[0],(double)lsum[1],(double)lsum[2],(double)lsum[3]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #if PETSC_VERSION_LE(3,3,0)
 PETSC_EXTERN PetscErrorCode PetscOptionsGetViewer(MPI_Comm,const char[],const char[],PetscViewer*,PetscViewerFormat*,PetscBool*);
 #endif
@@ -486,6 +668,49 @@ PetscErrorCode IGASetQuadrature(IGA iga,PetscInt i,PetscInt q)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetRuleType"
+/*@
+   IGASetRuleType - Sets the type of the quadrature rule along a direction.
+
+   Logically Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  i - the direction
+-  type - IGA_RULE_LEGENDRE or IGA_RULE_REDUCED
+
+   Options Database Keys:
+.  -iga_rule_type <legendre,reduced> - the rule type (all directions)
+
+   Notes:
+   The reduced rule (see IGARuleComputeReduced()) integrates the mass
+   and stiffness integrands of the spline space exactly, with fewer
+   points than Gauss-Legendre on smooth meshes. The points are shared
+   among the elements of a patch, so an element may get any number of
+   points, including none. Only the assembled global integrals are
+   exact; element-local operations (element mass matrices, element
+   error indicators, and the like) are not supported with this rule.
+
+   Level: intermediate
+
+.keywords: IGA, quadrature, rule
+@*/
+PetscErrorCode IGASetRuleType(IGA iga,PetscInt i,IGARuleType type)
+{
+  IGARule        rule;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveInt(iga,i,2);
+  PetscValidLogicalCollectiveEnum(iga,type,3);
+  ierr = IGAGetRule(iga,i,&rule);CHKERRQ(ierr);
+  if (rule->type == type) PetscFunctionReturn(0);
+  ierr = IGARuleSetType(rule,type);CHKERRQ(ierr);
+  iga->setup = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGASetProcessors"
 PetscErrorCode IGASetProcessors(IGA iga,PetscInt i,PetscInt processors)
@@ -534,6 +759,255 @@ PetscErrorCode IGASetUseCollocation(IGA iga,PetscBool collocation)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetUseBezierExtraction"
+PetscErrorCode IGASetUseBezierExtraction(IGA iga,PetscBool bezier)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveBool(iga,bezier,2);
+  if (iga->bezier == bezier) PetscFunctionReturn(0);
+  iga->bezier = bezier;
+  iga->setup = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetUseHaloExchange"
+/*@
+   IGASetUseHaloExchange - Use a structured neighbor-only ghost exchange
+   instead of general vector scatters to update ghost values.
+
+   Logically Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+-  halo - whether to use the halo exchange
+
+   Options Database Keys:
+.  -iga_halo_exchange - use the halo exchange
+
+   Notes:
+   The halo exchange only communicates with the neighbors in the
+   processor grid, using persistent MPI requests. If the ghost regions
+   cannot be filled from the immediate neighbors, general vector
+   scatters are used instead.
+
+   Level: advanced
+
+.keywords: IGA, ghost, halo
+@*/
+PetscErrorCode IGASetUseHaloExchange(IGA iga,PetscBool halo)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveBool(iga,halo,2);
+  if (iga->setupstage > 0 && iga->haloexchange != halo)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,
+            "Cannot change halo exchange after IGASetUp()");
+  iga->haloexchange = halo;
+  PetscFunctionReturn(0);
+}
+
+const char *const IGAProfilePhases[] = {
+  "Closure",
+  "Values",
+  "Basis",
+  "Geometry",
+  "Kernel",
+  "AddPoint",
+  "Fix",
+  "SetValues",
+  "Assembly",
+  /* */
+  "IGAProfilePhase","IGA_PROFILE_",0};
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetUseProfile"
+/*@
+   IGASetUseProfile - Accumulate the time spent in each phase of the
+   element assembly loops.
+
+   Logically Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+-  profile - whether to profile the assembly phases
+
+   Options Database Keys:
+.  -iga_profile - profile the assembly phases
+
+   Notes:
+   The phases are timed with MPI_Wtime() and accumulated in the IGA
+   context, avoiding the overhead of logging events per element and per
+   quadrature point. Profiling is off by default; when enabled, the
+   profile is printed when the IGA context is destroyed.
+
+   Level: advanced
+
+.keywords: IGA, profile, assembly
+.seealso: IGAGetAssemblyProfile(), IGAResetAssemblyProfile()
+@*/
+PetscErrorCode IGASetUseProfile(IGA iga,PetscBool profile)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveBool(iga,profile,2);
+  iga->profile = profile;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAGetAssemblyProfile"
+/*@
+   IGAGetAssemblyProfile - Gets the time spent and the number of calls
+   in each phase of the element assembly loops on this process.
+
+   Not Collective
+
+   Input Parameter:
+.  iga - the IGA context
+
+   Output Parameters:
++  time - the accumulated time, an array of size IGA_PROFILE_PHASES (or NULL)
+-  count - the number of timed calls, an array of size IGA_PROFILE_PHASES (or NULL)
+
+   Notes:
+   The arrays are indexed by IGAProfilePhase; the phase names are in
+   IGAProfilePhases[]. Profiling must be enabled with IGASetUseProfile().
+
+   Level: advanced
+
+.keywords: IGA, profile, assembly
+.seealso: IGASetUseProfile(), IGAResetAssemblyProfile()
+@*/
+PetscErrorCode IGAGetAssemblyProfile(IGA iga,PetscLogDouble time[],PetscInt count[])
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  if (time)  {ierr = PetscMemcpy(time, iga->profile_time, sizeof(iga->profile_time));CHKERRQ(ierr);}
+  if (count) {ierr = PetscMemcpy(count,iga->profile_count,sizeof(iga->profile_count));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAResetAssemblyProfile"
+/*@
+   IGAResetAssemblyProfile - Zeros the accumulated assembly profile.
+
+   Not Collective
+
+   Input Parameter:
+.  iga - the IGA context
+
+   Level: advanced
+
+.keywords: IGA, profile, assembly
+.seealso: IGASetUseProfile(), IGAGetAssemblyProfile()
+@*/
+PetscErrorCode IGAResetAssemblyProfile(IGA iga)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  ierr = PetscMemzero(iga->profile_time, sizeof(iga->profile_time));CHKERRQ(ierr);
+  ierr = PetscMemzero(iga->profile_count,sizeof(iga->profile_count));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_ProfileView"
+static PetscErrorCode IGA_ProfileView(IGA iga,PetscViewer viewer)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    size;
+  PetscLogDouble tmax[IGA_PROFILE_PHASES],tsum[IGA_PROFILE_PHASES],total = 0;
+  PetscInt       i,csum[IGA_PROFILE_PHASES];
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (!viewer) viewer = PETSC_VIEWER_STDOUT_(comm);
+  ierr = MPI_Allreduce(iga->profile_time,tmax,IGA_PROFILE_PHASES,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(iga->profile_time,tsum,IGA_PROFILE_PHASES,MPIU_PETSCLOGDOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(iga->profile_count,csum,IGA_PROFILE_PHASES,MPIU_INT,MPIU_SUM,comm);CHKERRQ(ierr);
+  for (i=0; i<IGA_PROFILE_PHASES; i++) total += tsum[i];
+  if (total <= 0) total = 1;
+  ierr = PetscViewerASCIIPrintf(viewer,"IGA assembly profile (%s):\n",((PetscObject)iga)->prefix?((PetscObject)iga)->prefix:"");CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"  %-10s %12s %12s %6s %14s\n","Phase","Max Time","Avg Time","%T","Calls");CHKERRQ(ierr);
+  for (i=0; i<IGA_PROFILE_PHASES; i++) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  %-10s %12.4e %12.4e %6.1f %14D\n",IGAProfilePhases[i],
+                                  (double)tmax[i],(double)(tsum[i]/size),(double)(100*tsum[i]/total),csum[i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetElementOrder"
+/*@
+   IGASetElementOrder - Sets the order in which IGANextElement() visits
+   the elements owned by the local process.
+
+   Logically Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  order - the traversal order
+-  tile - the tile sizes for IGA_ELEMENT_ORDER_TILED (or NULL to keep the current)
+
+   Options Database Keys:
++  -iga_element_order <lexicographic,tiled,morton> - element traversal order
+-  -iga_element_tile <8,8,8> - tile sizes for tiled traversal
+
+   Notes:
+   The default IGA_ELEMENT_ORDER_LEXICOGRAPHIC order walks elements with
+   the first index running fastest. IGA_ELEMENT_ORDER_TILED walks the
+   local element box tile by tile, and IGA_ELEMENT_ORDER_MORTON follows
+   a Z-order curve obtained by recursive bisection of the local box.
+   Both keep neighboring elements, and hence the rows of the local
+   arrays they touch, close together in time for large 2D/3D blocks.
+   IGAElementGetIndex() still returns the lexicographic index of the
+   element in the local box, whatever the traversal order.
+
+   Level: normal
+
+.keywords: IGA, element, order
+@*/
+PetscErrorCode IGASetElementOrder(IGA iga,IGAElementOrder order,const PetscInt tile[])
+{
+  PetscInt       i;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(iga,order,2);
+  if (tile) PetscValidIntPointer(tile,3);
+  if (tile) for (i=0; i<3; i++)
+    if (tile[i] < 1)
+      SETERRQ2(((PetscObject)iga)->comm,PETSC_ERR_ARG_OUTOFRANGE,
+               "Tile size must be positive, got %D in direction %D",tile[i],i);
+  if (iga->elem_order != order) iga->setup = PETSC_FALSE;
+  iga->elem_order = order;
+  if (tile) for (i=0; i<3; i++) {
+      if (iga->elem_tile[i] != tile[i]) iga->setup = PETSC_FALSE;
+      iga->elem_tile[i] = tile[i];
+    }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAGetElementOrder"
+PetscErrorCode IGAGetElementOrder(IGA iga,IGAElementOrder *order,PetscInt tile[])
+{
+  PetscInt i;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  if (order) PetscValidPointer(order,2);
+  if (tile)  PetscValidIntPointer(tile,3);
+  if (order) *order = iga->elem_order;
+  if (tile) for (i=0; i<3; i++) tile[i] = iga->elem_tile[i];
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAGetAxis"
 /*@
@@ -695,10 +1169,14 @@ PetscErrorCode IGASetFromOptions(IGA iga)
   PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
   {
     PetscBool flg;
-    PetscInt  i,nw,nl;
+    PetscInt  i,k,nw,nl;
     const char *prefix = NULL;
     PetscBool collocation = iga->collocation;
+    PetscBool bezier = iga->bezier;
+    PetscBool haloexchange = iga->haloexchange;
+    PetscBool profile = iga->profile;
     IGABasisType btype[3] = {IGA_BASIS_BSPLINE,IGA_BASIS_BSPLINE,IGA_BASIS_BSPLINE};
+    IGARuleType  rtype[3] = {IGA_RULE_LEGENDRE,IGA_RULE_LEGENDRE,IGA_RULE_LEGENDRE};
     PetscBool    wraps[3] = {PETSC_FALSE, PETSC_FALSE, PETSC_FALSE };
     PetscInt  np,procs[3] = {PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE};
     PetscInt  nq,quadr[3] = {PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE};
@@ -712,6 +1190,8 @@ PetscErrorCode IGASetFromOptions(IGA iga)
     PetscInt  dim = (iga->dim > 0) ? iga->dim : 3;
     PetscInt  dof = (iga->dof > 0) ? iga->dof : 1;
     PetscInt  order = iga->order;
+    IGAElementOrder eorder = iga->elem_order;
+    PetscInt  nt,etile[3];
 
     ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
 
@@ -719,6 +1199,7 @@ PetscErrorCode IGASetFromOptions(IGA iga)
       procs[i] = iga->proc_sizes[i];
       wraps[i] = iga->axis[i]->periodic;
       btype[i] = iga->basis[i]->type;
+      rtype[i] = iga->rule[i]->type;
       if (iga->rule[i]->nqp > 0)
         quadr[i] = iga->rule[i]->nqp;
     }
@@ -756,6 +1237,8 @@ PetscErrorCode IGASetFromOptions(IGA iga)
     ierr = PetscOptionsBool("-iga_collocation","Use collocation","IGASetUseCollocation",collocation,&collocation,&flg);CHKERRQ(ierr);
     if (flg) {ierr = IGASetUseCollocation(iga,collocation);CHKERRQ(ierr);}
     if (iga->collocation) {ierr = IGAOptionsReject(prefix,"-iga_quadrature");CHKERRQ(ierr);}
+    if (iga->collocation) {ierr = IGAOptionsReject(prefix,"-iga_rule_type");CHKERRQ(ierr);}
+    if (iga->collocation) {ierr = IGAOptionsReject(prefix,"-iga_bezier_extraction");CHKERRQ(ierr);}
 
     /* Processor grid */
     ierr = PetscOptionsIntArray("-iga_processors","Processor grid","IGASetProcessors",procs,(np=dim,&np),&flg);CHKERRQ(ierr);
@@ -764,6 +1247,10 @@ PetscErrorCode IGASetFromOptions(IGA iga)
         if (n > 0) {ierr = IGASetProcessors(iga,i,n);CHKERRQ(ierr);}
       }
 
+    /* Ghost exchange */
+    ierr = PetscOptionsBool("-iga_halo_exchange","Use neighbor-only halo exchange","IGASetUseHaloExchange",haloexchange,&haloexchange,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = IGASetUseHaloExchange(iga,haloexchange);CHKERRQ(ierr);}
+
     /* Periodicity */
     ierr = PetscOptionsBoolArray("-iga_periodic","Periodicity","IGAAxisSetPeriodic",wraps,(nw=dim,&nw),&flg);CHKERRQ(ierr);
     if (flg && nw==0) for (i=0; i<dim; i++) wraps[i] = PETSC_TRUE;
@@ -824,6 +1311,23 @@ PetscErrorCode IGASetFromOptions(IGA iga)
         PetscInt q = (i<nq) ? quadr[i] : quadr[0];
         if (q > 0) {ierr = IGASetQuadrature(iga,i,q);CHKERRQ(ierr);}
       }
+    ierr = PetscOptionsEnum("-iga_rule_type","Quadrature rule type","IGASetRuleType",IGARuleTypes,(PetscEnum)rtype[0],(PetscEnum*)&rtype[0],&flg);CHKERRQ(ierr);
+    if (flg) for (i=1; i<dim; i++) rtype[i] = rtype[0]; /* XXX */
+    if (flg) for (i=0; i<dim; i++) {
+        ierr = IGASetRuleType(iga,i,rtype[i]);CHKERRQ(ierr);
+      }
+    ierr = PetscOptionsBool("-iga_bezier_extraction","Evaluate bases by Bezier extraction","IGASetUseBezierExtraction",bezier,&bezier,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = IGASetUseBezierExtraction(iga,bezier);CHKERRQ(ierr);}
+    if (!iga->collocation) for (k=0; k<IGA_FORM_KINDS; k++) {
+        char     option[64];
+        PetscInt nf,fquad[3];
+        for (i=0; i<3; i++) fquad[i] = iga->form->quadr[k][i];
+        ierr = PetscSNPrintf(option,sizeof(option),"-iga_form_quadrature_%s",IGAFormKinds[k]);CHKERRQ(ierr);
+        ierr = PetscStrtolower(option);CHKERRQ(ierr);
+        ierr = PetscOptionsIntArray(option,"Quadrature points for a form kind","IGASetFormQuadrature",fquad,(nf=dim,&nf),&flg);CHKERRQ(ierr);
+        if (flg && nf>0) for (i=nf; i<dim; i++) fquad[i] = fquad[0];
+        if (flg) {ierr = IGASetFormQuadrature(iga,(IGAFormKind)k,nf?dim:0,fquad);CHKERRQ(ierr);}
+      }
 
     /* Basis Type */
     ierr = PetscOptionsEnum("-iga_basis_type","Basis type","IGASetBasisType",IGABasisTypes,(PetscEnum)btype[0],(PetscEnum*)&btype[0],&flg);CHKERRQ(ierr);
@@ -832,6 +1336,13 @@ PetscErrorCode IGASetFromOptions(IGA iga)
         ierr = IGASetBasisType(iga,i,btype[i]);CHKERRQ(ierr);
       }
 
+    /* Element traversal order */
+    for (i=0; i<3; i++) etile[i] = iga->elem_tile[i];
+    ierr = PetscOptionsEnum("-iga_element_order","Element traversal order","IGASetElementOrder",IGAElementOrders,(PetscEnum)eorder,(PetscEnum*)&eorder,&flg);CHKERRQ(ierr);
+    ierr = PetscOptionsIntArray("-iga_element_tile","Element tile sizes","IGASetElementOrder",etile,(nt=dim,&nt),NULL);CHKERRQ(ierr);
+    if (nt==1) for (i=1; i<3; i++) etile[i] = etile[0];
+    ierr = IGASetElementOrder(iga,eorder,etile);CHKERRQ(ierr);
+
     /* Matrix and Vector type */
     if (iga->dof == 1) {ierr = PetscStrcpy(mtype,MATAIJ);CHKERRQ(ierr);}
     if (iga->vectype)  {ierr = PetscStrncpy(vtype,iga->vectype,sizeof(vtype));CHKERRQ(ierr);}
@@ -841,12 +1352,18 @@ PetscErrorCode IGASetFromOptions(IGA iga)
     ierr = PetscOptionsFList("-iga_mat_type","Matrix type","IGASetMatType",MatList,mtype,mtype,sizeof(mtype),&flg);CHKERRQ(ierr);
     if (flg) {ierr = IGASetMatType(iga,mtype);CHKERRQ(ierr);}
 
+    /* Assembly profiling */
+    ierr = PetscOptionsBool("-iga_profile","Profile assembly phases","IGASetUseProfile",profile,&profile,NULL);CHKERRQ(ierr);
+    ierr = IGASetUseProfile(iga,profile);CHKERRQ(ierr);
+
     /* View options, handled in IGASetUp() */
     ierr = PetscOptionsName("-iga_view",       "Information on IGA context",      "IGAView",NULL);CHKERRQ(ierr);
     ierr = PetscOptionsName("-iga_view_ascii", "Information on IGA context",      "IGAView",NULL);CHKERRQ(ierr);
     ierr = PetscOptionsName("-iga_view_info",  "Output more detailed information","IGAView",NULL);CHKERRQ(ierr);
     ierr = PetscOptionsName("-iga_view_detail","Output more detailed information","IGAView",NULL);CHKERRQ(ierr);
     ierr = PetscOptionsName("-iga_view_binary","Save to file in binary format",   "IGAView",NULL);CHKERRQ(ierr);
+    /* Balance report, handled in IGADestroy() */
+    ierr = PetscOptionsName("-iga_view_balance","Per-process work and memory",     "IGAViewBalance",NULL);CHKERRQ(ierr);
 
     ierr = PetscObjectProcessOptionsHandlers((PetscObject)iga);CHKERRQ(ierr);
     ierr = PetscOptionsEnd();CHKERRQ(ierr);
@@ -1309,6 +1826,7 @@ static PetscErrorCode IGASetUp_Stage2(IGA iga)
   ierr = VecScatterDestroy(&iga->g2l);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->l2g);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->l2l);CHKERRQ(ierr);
+  ierr = IGA_Halo_Destroy(&iga->halo);CHKERRQ(ierr);
   ierr = VecDestroy(&iga->natural);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->n2g);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&iga->g2n);CHKERRQ(ierr);
@@ -1322,9 +1840,6 @@ static PetscErrorCode IGASetUp_Stage2(IGA iga)
                          iga->dim,iga->dof,iga->node_sizes,
                          iga->node_lstart,iga->node_lwidth,
                          iga->node_gstart,iga->node_gwidth);CHKERRQ(ierr);
-    /* build the application ordering */
-    ierr = IGA_Grid_GetAO(grid,&iga->ao);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)iga->ao);CHKERRQ(ierr);
     /* build the local to global mapping */
     ierr = IGA_Grid_GetLGMap(grid,&iga->lgmap);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)iga->lgmap);CHKERRQ(ierr);
@@ -1336,10 +1851,14 @@ static PetscErrorCode IGASetUp_Stage2(IGA iga)
     ierr = PetscObjectReference((PetscObject)iga->g2l);CHKERRQ(ierr);
     ierr = IGA_Grid_GetScatterL2G(grid,&iga->l2g);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)iga->l2g);CHKERRQ(ierr);
-    /* build global <-> natural vector scatter */
-    ierr = IGA_Grid_NewScatterApp(grid,
-                                  iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,
-                                  &iga->natural,&iga->n2g,&iga->g2n);CHKERRQ(ierr);
+    /* build neighbor-only ghost exchange */
+    if (iga->haloexchange) {
+      PetscBool periodic[3] = {PETSC_FALSE,PETSC_FALSE,PETSC_FALSE};
+      for (i=0; i<iga->dim; i++) periodic[i] = iga->axis[i]->periodic;
+      ierr = IGA_Halo_Create(grid,iga->proc_sizes,iga->proc_ranks,periodic,&iga->halo);CHKERRQ(ierr);
+    }
+    /* the application ordering and the global <-> natural vector
+       scatters are built on demand, see IGAGetAO() and IGAGetNaturalVec() */
     /* destroy the grid context */
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
   }
@@ -1398,6 +1917,50 @@ static PetscErrorCode IGASetUp_View(IGA iga)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetUp_FormBasis"
+static PetscErrorCode IGASetUp_FormBasis(IGA iga)
+{
+  PetscInt       i,j,k,dim = iga->dim;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  for (k=0; k<IGA_FORM_KINDS; k++)
+    for (i=0; i<3; i++)
+      {ierr = IGABasisDestroy(&iga->formbasis[k][i]);CHKERRQ(ierr);}
+  if (iga->collocation) PetscFunctionReturn(0);
+  for (k=0; k<IGA_FORM_KINDS; k++) {
+    PetscInt  *q = iga->form->quadr[k], same = -1;
+    PetscBool own[3] = {PETSC_FALSE,PETSC_FALSE,PETSC_FALSE};
+    for (i=0; i<dim; i++) /* axes whose rule differs from the IGA rule */
+      own[i] = (PetscBool)(q[i] > 0 && (q[i] != iga->rule[i]->nqp || iga->rule[i]->type != IGA_RULE_LEGENDRE));
+    if (!own[0] && !own[1] && !own[2]) continue;
+    for (j=0; j<k && same<0; j++) { /* share the tables of a previous kind */
+      if (!iga->formbasis[j][0]) continue;
+      for (i=0; i<dim; i++) if (iga->form->quadr[j][i] != q[i]) break;
+      if (i == dim) same = j;
+    }
+    for (i=0; i<3; i++) {
+      IGABasis basis = (same >= 0) ? iga->formbasis[same][i] : own[i] ? NULL : iga->basis[i];
+      if (!basis) {
+        IGARule rule;
+        ierr = IGARuleCreate(&rule);CHKERRQ(ierr);
+        ierr = IGARuleInit(rule,q[i]);CHKERRQ(ierr);
+        ierr = IGABasisCreate(&basis);CHKERRQ(ierr);
+        ierr = IGABasisSetType(basis,iga->basis[i]->type);CHKERRQ(ierr);
+        if (iga->bezier) {
+          ierr = IGABasisInitBezier(basis,iga->axis[i],rule,iga->order);CHKERRQ(ierr);
+        } else {
+          ierr = IGABasisInitQuadrature(basis,iga->axis[i],rule,iga->order);CHKERRQ(ierr);
+        }
+        ierr = IGARuleDestroy(&rule);CHKERRQ(ierr);
+      } else {
+        ierr = IGABasisReference(basis);CHKERRQ(ierr);
+      }
+      iga->formbasis[k][i] = basis;
+    }
+  }
+  PetscFunctionReturn(0);
+}
 
 #undef  __FUNCT__
 #define __FUNCT__ "IGASetUp"
@@ -1429,10 +1992,14 @@ PetscErrorCode IGASetUp(IGA iga)
   iga->setup = PETSC_TRUE;
 
   /* --- Stage 1 --- */
+  IGATraceBegin("IGASetUp_Stage1");
   ierr = IGASetUp_Stage1(iga);CHKERRQ(ierr);
+  IGATraceEnd("IGASetUp_Stage1");
 
   /* --- Stage 2 --- */
+  IGATraceBegin("IGASetUp_Stage2");
   ierr = IGASetUp_Stage2(iga);CHKERRQ(ierr);
+  IGATraceEnd("IGASetUp_Stage2");
 
   /* --- Stage 3 --- */
   iga->setupstage = 3;
@@ -1456,12 +2023,19 @@ PetscErrorCode IGASetUp(IGA iga)
       ierr = IGARuleReset(iga->rule[i]);CHKERRQ(ierr);
     }
 
+  if (iga->collocation && iga->bezier)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Bezier extraction not supported with collocation");
+
+  ierr = IGA_Proj_Destroy(&iga->proj);CHKERRQ(ierr);
   for (i=0; i<3; i++)
-    if (!iga->collocation) {
+    if (iga->bezier) {
+      ierr = IGABasisInitBezier(iga->basis[i],iga->axis[i],iga->rule[i],iga->order);CHKERRQ(ierr);
+    } else if (!iga->collocation) {
       ierr = IGABasisInitQuadrature(iga->basis[i],iga->axis[i],iga->rule[i],iga->order);CHKERRQ(ierr);
     } else {
       ierr = IGABasisInitCollocation(iga->basis[i],iga->axis[i],iga->order);CHKERRQ(ierr);
     }
+  ierr = IGASetUp_FormBasis(iga);CHKERRQ(ierr);
 
   ierr = IGAElementInit(iga->iterator,iga);CHKERRQ(ierr);
 
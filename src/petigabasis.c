@@ -50,12 +50,20 @@ PetscErrorCode IGABasisReset(IGABasis basis)
   basis->p   = 0;
   basis->d   = 0;
   ierr = PetscFree(basis->offset);CHKERRQ(ierr);
+  ierr = PetscFree(basis->count);CHKERRQ(ierr);
   ierr = PetscFree(basis->detJ);CHKERRQ(ierr);
   ierr = PetscFree(basis->weight);CHKERRQ(ierr);
   ierr = PetscFree(basis->point);CHKERRQ(ierr);
   ierr = PetscFree(basis->value);CHKERRQ(ierr);
+  basis->nop    = 0;
+  basis->cached = -1;
+  ierr = PetscFree(basis->opid);CHKERRQ(ierr);
+  ierr = PetscFree(basis->extract);CHKERRQ(ierr);
+  ierr = PetscFree(basis->bernstein);CHKERRQ(ierr);
+  ierr = PetscFree(basis->work);CHKERRQ(ierr);
   ierr = PetscFree(basis->bnd_value[0]);CHKERRQ(ierr);
   ierr = PetscFree(basis->bnd_value[1]);CHKERRQ(ierr);
+  basis->mem = 0;
   PetscFunctionReturn(0);
 }
 
@@ -93,15 +101,18 @@ PetscErrorCode IGABasisInitQuadrature(IGABasis basis,IGAAxis axis,IGARule rule,P
 {
   PetscInt       m,p;
   const PetscInt *span;
-  const PetscReal*U,*X,*W;
+  const PetscReal*U;
+  PetscReal      *X,*W;
   PetscInt       iel,nel;
   PetscInt       iqp,nqp;
   PetscInt       nen,ndr;
   PetscInt       *offset;
+  PetscInt       *count;
   PetscReal      *detJ;
   PetscReal      *weight;
   PetscReal      *point;
   PetscReal      *value;
+  PetscLogDouble mem = 0;
   void          (*ComputeBasis)(PetscInt,PetscReal,PetscInt,PetscInt,const PetscReal[],PetscReal[]);
   PetscErrorCode ierr;
   PetscFunctionBegin;
@@ -127,10 +138,6 @@ PetscErrorCode IGABasisInitQuadrature(IGABasis basis,IGAAxis axis,IGARule rule,P
     }
   }
 
-  nqp = rule->nqp;
-  X   = rule->point;
-  W   = rule->weight;
-
   nel  = axis->nel;
   span = axis->span;
   nen  = p+1;
@@ -148,38 +155,67 @@ PetscErrorCode IGABasisInitQuadrature(IGABasis basis,IGAAxis axis,IGARule rule,P
     ComputeBasis = NULL;
   }
 
-  ierr = PetscMalloc1(nel,&offset);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel,&detJ);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nqp,&weight);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel*nqp,&point);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel*nqp*nen*ndr,&value);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&count);CHKERRQ(ierr);
+  if (rule->type == IGA_RULE_REDUCED) {
+    /* patch rule in parametric coordinates, variable number of points per element */
+    ierr = PetscMalloc1(nel*(p+1),&X);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nel*(p+1),&W);CHKERRQ(ierr);
+    ierr = IGARuleComputeReduced(axis,count,X,W);CHKERRQ(ierr);
+    for (nqp=1, iel=0; iel<nel; iel++) nqp = PetscMax(nqp,count[iel]);
+  } else {
+    nqp = rule->nqp;
+    X   = rule->point;
+    W   = rule->weight;
+    for (iel=0; iel<nel; iel++) count[iel] = nqp;
+  }
+
+  ierr = IGAMalloc1(mem,nel,&offset);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&detJ);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&weight);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&point);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp*nen*ndr,&value);CHKERRQ(ierr);
+  ierr = PetscMemzero(weight,nel*nqp*sizeof(PetscReal));CHKERRQ(ierr);
   ierr = PetscMemzero(value,nel*nqp*nen*ndr*sizeof(PetscReal));CHKERRQ(ierr);
 
-  for (iqp=0; iqp<nqp; iqp++) {
-    weight[iqp] = W[iqp];
-  }
-  for (iel=0; iel<nel; iel++) {
-    PetscInt  k = span[iel];
+  for (iqp=0, iel=0; iel<nel; iel++) {
+    PetscInt  q,k = span[iel];
     PetscReal u0 = U[k], u1 = U[k+1];
     PetscReal J = (u1-u0)/2;
     PetscReal *u = &point[iel*nqp];
+    PetscReal *w = &weight[iel*nqp];
     PetscReal *N = &value[iel*nqp*nen*ndr];
     detJ[iel] = J;
-    for (iqp=0; iqp<nqp; iqp++) {
-      u[iqp] = (X[iqp] + 1) * J + u0;
-      ComputeBasis(k,u[iqp],p,d,U,&N[iqp*nen*ndr]);
+    if (rule->type == IGA_RULE_REDUCED) {
+      for (q=0; q<count[iel]; q++, iqp++) {
+        u[q] = X[iqp];
+        w[q] = W[iqp] / J;
+      }
+    } else {
+      for (q=0; q<nqp; q++) {
+        u[q] = (X[q] + 1) * J + u0;
+        w[q] = W[q];
+      }
     }
+    for (q=count[iel]; q<nqp; q++) u[q] = u0; /* unused padding */
+    for (q=0; q<count[iel]; q++)
+      ComputeBasis(k,u[q],p,d,U,&N[q*nen*ndr]);
     offset[iel] = k-p;
   }
+  if (rule->type == IGA_RULE_REDUCED) {
+    ierr = PetscFree(X);CHKERRQ(ierr);
+    ierr = PetscFree(W);CHKERRQ(ierr);
+  }
 
   ierr = IGABasisReset(basis);CHKERRQ(ierr);
 
+  basis->mem    = mem;
   basis->nel    = nel;
   basis->nqp    = nqp;
   basis->nen    = nen;
   basis->p      = p;
   basis->d      = d;
   basis->offset = offset;
+  basis->count  = count;
 
   basis->detJ   = detJ;
   basis->weight = weight;
@@ -190,8 +226,8 @@ PetscErrorCode IGABasisInitQuadrature(IGABasis basis,IGAAxis axis,IGARule rule,P
     PetscInt  o0 = offset[0], o1 = offset[nel-1];
     PetscInt  k0 = span[0],   k1 = span[nel-1];
     PetscReal u0 = U[k0],     u1 = U[k1+1];
-    ierr = PetscMalloc1(nen*ndr,&basis->bnd_value[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*ndr,&basis->bnd_value[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[1]);CHKERRQ(ierr);
     basis->bnd_offset[0] =  o0; basis->bnd_offset[1] =  o1;
     basis->bnd_detJ  [0] = 1.0; basis->bnd_detJ  [1] = 1.0;
     basis->bnd_weight[0] = 1.0; basis->bnd_weight[1] = 1.0;
@@ -218,10 +254,12 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
   PetscInt       iqp,nqp;
   PetscInt       nen,ndr;
   PetscInt       *offset;
+  PetscInt       *count;
   PetscReal      *detJ;
   PetscReal      *weight;
   PetscReal      *point;
   PetscReal      *value;
+  PetscLogDouble mem = 0;
   PetscErrorCode ierr;
   PetscFunctionBegin;
   PetscValidPointer(basis,1);
@@ -238,13 +276,14 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
   nen  = p+1;
   ndr  = d+1;
 
-  ierr = PetscMalloc1(nel,&offset);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel,&detJ);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nqp,&weight);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel*nqp,&point);CHKERRQ(ierr);
-  ierr = PetscMalloc1(nel*nqp*nen*ndr,&value);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&offset);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&count);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&detJ);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&weight);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&point);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp*nen*ndr,&value);CHKERRQ(ierr);
 
-  for (iqp=0; iqp<nqp; iqp++) {
+  for (iqp=0; iqp<nel*nqp; iqp++) {
     weight[iqp] = 1.0;
   }
   for (iel=0; iel<nel; iel++) {
@@ -252,6 +291,7 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
     PetscInt  k = IGA_FindSpan(n,p,u,U);
     PetscReal *N = &value[iel*nen*ndr];
     offset[iel] = k-p;
+    count[iel]  = nqp;
     detJ[iel]   = U[k+1]-U[k];
     point[iel]  = u;
     IGA_Basis_BSpline(k,u,p,d,U,N);
@@ -259,12 +299,14 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
 
   ierr = IGABasisReset(basis);CHKERRQ(ierr);
 
+  basis->mem    = mem;
   basis->nel    = nel;
   basis->nqp    = nqp;
   basis->nen    = nen;
   basis->p      = p;
   basis->d      = d;
   basis->offset = offset;
+  basis->count  = count;
 
   basis->detJ   = detJ;
   basis->weight = weight;
@@ -274,8 +316,8 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
   {
     PetscInt  k0 = p,    k1 = n;
     PetscReal u0 = U[p], u1 = U[n+1];
-    ierr = PetscMalloc1(nen*ndr,&basis->bnd_value[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*ndr,&basis->bnd_value[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[1]);CHKERRQ(ierr);
     basis->bnd_offset[0] = k0-p; basis->bnd_offset[1] =  k1-p;
     basis->bnd_detJ  [0] =  1.0; basis->bnd_detJ  [1] =   1.0;
     basis->bnd_weight[0] =  1.0; basis->bnd_weight[1] =   1.0;
@@ -286,6 +328,180 @@ PetscErrorCode IGABasisInitCollocation(IGABasis basis,IGAAxis axis,PetscInt d)
   PetscFunctionReturn(0);
 }
 
+/* Bernstein coefficients C[a][j] of the functions N_{k-p+a} over [U_k,U_k+1],
+   i.e. blossoms N(U_k^{p-j},U_k+1^j) by de Boor's knot insertion */
+static void BezierExtraction(PetscInt k,PetscInt p,const PetscReal U[],PetscReal C[],PetscReal D[])
+{
+  PetscInt a,i,j,r,n = p+1;
+  for (j=0; j<=p; j++) {
+    for (i=0; i<=p; i++)
+      for (a=0; a<=p; a++)
+        D[i*n+a] = (PetscReal)(i==a);
+    for (r=1; r<=p; r++) {
+      PetscReal x = (r <= p-j) ? U[k] : U[k+1];
+      for (i=p; i>=r; i--) {
+        PetscInt  l = k-p+i;
+        PetscReal alpha = (x - U[l]) / (U[l+p+1-r] - U[l]);
+        for (a=0; a<=p; a++)
+          D[i*n+a] = (1-alpha)*D[(i-1)*n+a] + alpha*D[i*n+a];
+      }
+    }
+    for (a=0; a<=p; a++) C[a*n+j] = D[p*n+a];
+  }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGABasisInitBezier"
+PetscErrorCode IGABasisInitBezier(IGABasis basis,IGAAxis axis,IGARule rule,PetscInt d)
+{
+  PetscInt       p;
+  const PetscInt *span;
+  const PetscReal*U;
+  PetscInt       iel,nel;
+  PetscInt       iqp,nqp;
+  PetscInt       nen,ndr;
+  PetscInt       i,j,nop;
+  PetscInt       *offset;
+  PetscInt       *count;
+  PetscInt       *opid;
+  PetscReal      *detJ;
+  PetscReal      *weight;
+  PetscReal      *point;
+  PetscReal      *extract,*C,*D;
+  PetscReal      *bernstein,*Z;
+  PetscLogDouble mem = 0;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(basis,1);
+  PetscValidPointer(axis,2);
+  PetscValidPointer(rule,3);
+  if (d < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,
+                      "Derivative order must be grather than zero, got %D",d);
+  if (basis->type != IGA_BASIS_BSPLINE && basis->type != IGA_BASIS_BERNSTEIN)
+    SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Bezier extraction not supported for basis type %s",IGABasisTypes[basis->type]);
+  if (rule->type != IGA_RULE_LEGENDRE)
+    SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Bezier extraction not supported for rule type %s",IGARuleTypes[rule->type]);
+
+  p = axis->p;
+  U = axis->U;
+
+  nel  = axis->nel;
+  span = axis->span;
+  nqp  = rule->nqp;
+  nen  = p+1;
+  ndr  = d+1;
+
+  ierr = IGAMalloc1(mem,nel,&offset);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&count);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&opid);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel,&detJ);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&weight);CHKERRQ(ierr);
+  ierr = IGAMalloc1(mem,nel*nqp,&point);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nel*nen*nen,&C);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nen*nen,&D);CHKERRQ(ierr);
+
+  for (nop=0, iel=0; iel<nel; iel++) {
+    PetscInt  q,k = span[iel];
+    PetscReal u0 = U[k], u1 = U[k+1];
+    PetscReal J = (u1-u0)/2;
+    PetscReal *E = &C[nop*nen*nen];
+    for (q=0; q<nqp; q++) {
+      point[iel*nqp+q]  = (rule->point[q] + 1) * J + u0;
+      weight[iel*nqp+q] = rule->weight[q];
+    }
+    count[iel]  = nqp;
+    detJ[iel]   = J;
+    offset[iel] = k-p;
+    BezierExtraction(k,p,U,E,D);
+    /* share the operator with a recent element, interior
+       elements of uniform meshes all have the same one */
+    opid[iel] = nop;
+    for (j=nop-1; j>=0 && j>=nop-4; j--) {
+      const PetscReal *F = &C[j*nen*nen];
+      for (i=0; i<nen*nen; i++)
+        if (PetscAbsReal(E[i]-F[i]) > 1000*PETSC_MACHINE_EPSILON) break;
+      if (i == nen*nen) {opid[iel] = j; break;}
+    }
+    if (opid[iel] == nop) nop++;
+  }
+  ierr = IGAMalloc1(mem,nop*nen*nen,&extract);CHKERRQ(ierr);
+  ierr = PetscMemcpy(extract,C,nop*nen*nen*sizeof(PetscReal));CHKERRQ(ierr);
+  ierr = PetscFree(C);CHKERRQ(ierr);
+  ierr = PetscFree(D);CHKERRQ(ierr);
+
+  /* Bernstein polynomials and their derivatives on [-1,1] */
+  ierr = PetscMalloc1(2*nen,&Z);CHKERRQ(ierr);
+  for (i=0; i<nen; i++) {Z[i] = -1; Z[nen+i] = 1;}
+  ierr = IGAMalloc1(mem,nqp*nen*ndr,&bernstein);CHKERRQ(ierr);
+  for (iqp=0; iqp<nqp; iqp++)
+    IGA_Basis_BSpline(p,rule->point[iqp],p,d,Z,&bernstein[iqp*nen*ndr]);
+  ierr = PetscFree(Z);CHKERRQ(ierr);
+
+  ierr = IGABasisReset(basis);CHKERRQ(ierr);
+
+  basis->mem    = mem;
+  basis->nel    = nel;
+  basis->nqp    = nqp;
+  basis->nen    = nen;
+  basis->p      = p;
+  basis->d      = d;
+  basis->offset = offset;
+  basis->count  = count;
+
+  basis->detJ   = detJ;
+  basis->weight = weight;
+  basis->point  = point;
+  basis->value  = NULL;
+
+  basis->nop       = nop;
+  basis->opid      = opid;
+  basis->extract   = extract;
+  basis->bernstein = bernstein;
+  basis->cached    = -1;
+  ierr = IGAMalloc1(basis->mem,nqp*nen*ndr,&basis->work);CHKERRQ(ierr);
+
+  {
+    PetscInt  o0 = offset[0], o1 = offset[nel-1];
+    PetscInt  k0 = span[0],   k1 = span[nel-1];
+    PetscReal u0 = U[k0],     u1 = U[k1+1];
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(basis->mem,nen*ndr,&basis->bnd_value[1]);CHKERRQ(ierr);
+    basis->bnd_offset[0] =  o0; basis->bnd_offset[1] =  o1;
+    basis->bnd_detJ  [0] = 1.0; basis->bnd_detJ  [1] = 1.0;
+    basis->bnd_weight[0] = 1.0; basis->bnd_weight[1] = 1.0;
+    basis->bnd_point [0] =  u0; basis->bnd_point [1] =  u1;
+    IGA_Basis_BSpline(k0,u0,p,d,U,basis->bnd_value[0]);
+    IGA_Basis_BSpline(k1,u1,p,d,U,basis->bnd_value[1]);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* basis values [nqp][nen][d+1] at the quadrature points of an element */
+const PetscReal *IGABasisGetValues(IGABasis basis,PetscInt iel)
+{
+  PetscInt nqp = basis->nqp, nen = basis->nen, ndr = basis->d+1;
+  if (basis->value) return basis->value + iel*nqp*nen*ndr;
+  if (basis->cached != iel) {
+    const PetscReal *C = basis->extract + basis->opid[iel]*nen*nen;
+    PetscReal       J  = basis->detJ[iel];
+    PetscInt        q,a,b,k;
+    for (q=0; q<nqp; q++) {
+      const PetscReal *B = basis->bernstein + q*nen*ndr;
+      PetscReal       *N = basis->work + q*nen*ndr;
+      for (a=0; a<nen; a++) {
+        PetscReal s = 1;
+        for (k=0; k<ndr; k++, s/=J) {
+          PetscReal v = 0;
+          for (b=0; b<nen; b++) v += C[a*nen+b]*B[b*ndr+k];
+          N[a*ndr+k] = v*s;
+        }
+      }
+    }
+    basis->cached = iel;
+  }
+  return basis->work;
+}
+
 PetscInt IGA_FindSpan(PetscInt n,PetscInt p,PetscReal u, const PetscReal U[])
 {
   PetscInt low,high,span;
@@ -0,0 +1,547 @@
+#include "petiga.h"
+#include "petscts2.h"
+
+/*
+  Checkpoint file layout (all data big-endian, as PETSc binary files):
+
+    PetscInt  IGA_CHECKPOINT_CLASSID, step, nvec
+    PetscReal time
+    nvec x { PetscInt VEC_FILE_CLASSID, N; PetscScalar data[N] }
+
+  Each vector record is exactly what VecView() writes for a vector in
+  natural ordering, so the records can also be read back with
+  IGALoadVec() once the short preamble has been consumed.
+*/
+
+#if defined(PETSC_HAVE_MPIIO)
+#if defined(MPI_VERSION) && (MPI_VERSION > 3 || (MPI_VERSION == 3 && MPI_SUBVERSION >= 1))
+#define IGA_CKPT_IWRITE 1
+#endif
+#endif
+
+typedef struct {
+#if defined(PETSC_HAVE_MPIIO)
+  MPI_File     fh;
+  MPI_Datatype ftype;
+#if defined(IGA_CKPT_IWRITE)
+  MPI_Request  request;
+#endif
+#endif
+  PetscInt     count;
+  PetscInt     size;
+  PetscScalar  *buffer;
+  double       time;
+} IGACkptEntry;
+
+struct _n_IGACheckpoint {
+  IGA          iga;
+  PetscInt     nqueue;
+  PetscInt     head;
+  PetscInt     npending;
+  IGACkptEntry *queue;
+};
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointCreate"
+/*@
+   IGACheckpointCreate - Creates a context for asynchronous checkpoints
+
+   Collective on IGA
+
+   Input Parameter:
+.  iga - the IGA context
+
+   Output Parameter:
+.  ckpt - the checkpoint context
+
+   Options Database Keys:
+.  -iga_checkpoint_queue <n> - maximum number of checkpoints in flight
+
+   Notes:
+   IGACheckpointWrite() copies the vectors to a staging buffer and
+   posts the file write, returning before the data reaches the disk.
+   Once the queue holds the maximum number of pending writes, the
+   next call first waits for the oldest one to complete, which bounds
+   the memory spent in staging buffers.
+
+   Level: normal
+
+.keywords: IGA, checkpoint, create
+@*/
+PetscErrorCode IGACheckpointCreate(IGA iga,IGACheckpoint *ckpt)
+{
+  const char     *prefix = NULL;
+  PetscInt       nqueue = 2;
+  IGACheckpoint  c;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidPointer(ckpt,2);
+  IGACheckSetUp(iga,1);
+
+  ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(prefix,"-iga_checkpoint_queue",&nqueue,NULL);CHKERRQ(ierr);
+  if (nqueue < 1) SETERRQ1(((PetscObject)iga)->comm,PETSC_ERR_ARG_OUTOFRANGE,
+                           "Checkpoint queue size must be positive, got %D",nqueue);
+
+  ierr = PetscMalloc(sizeof(struct _n_IGACheckpoint),&c);CHKERRQ(ierr);
+  ierr = PetscMemzero(c,sizeof(struct _n_IGACheckpoint));CHKERRQ(ierr);
+  ierr = PetscMalloc((size_t)nqueue*sizeof(IGACkptEntry),&c->queue);CHKERRQ(ierr);
+  ierr = PetscMemzero(c->queue,(size_t)nqueue*sizeof(IGACkptEntry));CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)iga);CHKERRQ(ierr);
+  c->iga    = iga;
+  c->nqueue = nqueue;
+
+  *ckpt = c;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointComplete_Private"
+static PetscErrorCode IGACheckpointComplete_Private(IGACheckpoint ckpt)
+{
+  PetscFunctionBegin;
+  if (!ckpt->npending) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_MPIIO)
+  {
+    IGACkptEntry   *entry = &ckpt->queue[ckpt->head];
+    MPI_Comm       comm = ((PetscObject)ckpt->iga)->comm;
+    double         t,tmax,mb;
+    PetscErrorCode ierr;
+#if defined(IGA_CKPT_IWRITE)
+    ierr = MPI_Wait(&entry->request,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+#else
+    ierr = MPI_File_write_all_end(entry->fh,entry->buffer,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+#endif
+    ierr = MPI_File_close(&entry->fh);CHKERRQ(ierr);
+    ierr = MPI_Type_free(&entry->ftype);CHKERRQ(ierr);
+    t = MPI_Wtime() - entry->time;
+    ierr = MPI_Allreduce(&t,&tmax,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    mb = (double)entry->count*(double)sizeof(PetscScalar)/1048576.0;
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&mb,1,MPI_DOUBLE,MPI_SUM,comm);CHKERRQ(ierr);
+    ierr = PetscInfo3(ckpt->iga,"Checkpoint of %g MB completed after %g sec (%g MB/sec)\n",
+                      mb,tmax,(tmax>0.0)?mb/tmax:0.0);CHKERRQ(ierr);
+  }
+#endif
+  ckpt->head = (ckpt->head+1) % ckpt->nqueue;
+  ckpt->npending--;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointFlush"
+/*@
+   IGACheckpointFlush - Waits for all pending checkpoint writes
+
+   Collective on IGA
+
+   Input Parameter:
+.  ckpt - the checkpoint context
+
+   Level: normal
+
+.keywords: IGA, checkpoint
+@*/
+PetscErrorCode IGACheckpointFlush(IGACheckpoint ckpt)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(ckpt,1);
+  while (ckpt->npending) {ierr = IGACheckpointComplete_Private(ckpt);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointDestroy"
+/*@
+   IGACheckpointDestroy - Completes pending writes and destroys the
+   checkpoint context
+
+   Collective on IGA
+
+   Input Parameter:
+.  ckpt - the checkpoint context
+
+   Level: normal
+
+.keywords: IGA, checkpoint, destroy
+@*/
+PetscErrorCode IGACheckpointDestroy(IGACheckpoint *ckpt)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(ckpt,1);
+  if (!*ckpt) PetscFunctionReturn(0);
+  ierr = IGACheckpointFlush(*ckpt);CHKERRQ(ierr);
+  for (i=0; i<(*ckpt)->nqueue; i++) {
+    ierr = PetscFree((*ckpt)->queue[i].buffer);CHKERRQ(ierr);
+  }
+  ierr = PetscFree((*ckpt)->queue);CHKERRQ(ierr);
+  ierr = IGADestroy(&(*ckpt)->iga);CHKERRQ(ierr);
+  ierr = PetscFree(*ckpt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MPIIO)
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointPost_MPIIO"
+/*
+  Every process posts a single collective write of its owned box of
+  all the staged vectors. The file view places each box at its
+  natural-ordering position inside the corresponding vector record,
+  so no global-to-natural scatter is ever performed.
+*/
+static PetscErrorCode IGACheckpointPost_MPIIO(IGACheckpoint ckpt,IGACkptEntry *entry,const char filename[],
+                                              PetscReal t,PetscInt step,PetscInt nvec)
+{
+  IGA            iga = ckpt->iga;
+  MPI_Comm       comm = ((PetscObject)iga)->comm;
+  PetscMPIInt    rank;
+  PetscInt       i,N = iga->dof;
+  MPI_Offset     preamble = 3*(MPI_Offset)sizeof(PetscInt) + (MPI_Offset)sizeof(PetscReal);
+  MPI_Offset     record,header = 2*(MPI_Offset)sizeof(PetscInt);
+  MPI_Datatype   node,box;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  for (i=0; i<iga->dim; i++) N *= iga->node_sizes[i];
+  record = header + (MPI_Offset)N*(MPI_Offset)sizeof(PetscScalar);
+
+  ierr = MPI_File_open(comm,(char*)filename,MPI_MODE_WRONLY|MPI_MODE_CREATE,MPI_INFO_NULL,&entry->fh);CHKERRQ(ierr);
+  ierr = MPI_File_set_size(entry->fh,0);CHKERRQ(ierr);
+  if (!rank) {
+    PetscInt  info[3],vhdr[2];
+    PetscReal time = t;
+    info[0] = IGA_CHECKPOINT_CLASSID; info[1] = step; info[2] = nvec;
+    vhdr[0] = VEC_FILE_CLASSID; vhdr[1] = N;
+#if !defined(PETSC_WORDS_BIGENDIAN)
+    ierr = PetscByteSwap(info,PETSC_INT,3);CHKERRQ(ierr);
+    ierr = PetscByteSwap(&time,PETSC_REAL,1);CHKERRQ(ierr);
+    ierr = PetscByteSwap(vhdr,PETSC_INT,2);CHKERRQ(ierr);
+#endif
+    ierr = MPI_File_write_at(entry->fh,0,info,3*(PetscMPIInt)sizeof(PetscInt),MPI_BYTE,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    ierr = MPI_File_write_at(entry->fh,3*(MPI_Offset)sizeof(PetscInt),&time,(PetscMPIInt)sizeof(PetscReal),MPI_BYTE,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    for (i=0; i<nvec; i++) {
+      ierr = MPI_File_write_at(entry->fh,preamble+i*record,vhdr,2*(PetscMPIInt)sizeof(PetscInt),MPI_BYTE,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    }
+  }
+  { /* file type: one natural-ordering box per vector record */
+    PetscMPIInt  gsizes[3],lsizes[3],starts[3];
+    PetscMPIInt  *blens;
+    MPI_Aint     *displs;
+    MPI_Datatype *types;
+    for (i=0; i<3; i++) { gsizes[i] = lsizes[i] = 1; starts[i] = 0; }
+    for (i=0; i<iga->dim; i++) {
+      gsizes[iga->dim-1-i] = (PetscMPIInt)iga->node_sizes[i];
+      lsizes[iga->dim-1-i] = (PetscMPIInt)iga->node_lwidth[i];
+      starts[iga->dim-1-i] = (PetscMPIInt)iga->node_lstart[i];
+    }
+    ierr = MPI_Type_contiguous((PetscMPIInt)iga->dof,MPIU_SCALAR,&node);CHKERRQ(ierr);
+    ierr = MPI_Type_create_subarray(3,gsizes,lsizes,starts,MPI_ORDER_C,node,&box);CHKERRQ(ierr);
+    ierr = PetscMalloc(nvec*sizeof(PetscMPIInt),&blens);CHKERRQ(ierr);
+    ierr = PetscMalloc(nvec*sizeof(MPI_Aint),&displs);CHKERRQ(ierr);
+    ierr = PetscMalloc(nvec*sizeof(MPI_Datatype),&types);CHKERRQ(ierr);
+    for (i=0; i<nvec; i++) {
+      blens[i]  = 1;
+      displs[i] = (MPI_Aint)(preamble + i*record + header);
+      types[i]  = box;
+    }
+    ierr = MPI_Type_create_struct((PetscMPIInt)nvec,blens,displs,types,&entry->ftype);CHKERRQ(ierr);
+    ierr = MPI_Type_commit(&entry->ftype);CHKERRQ(ierr);
+    ierr = PetscFree(blens);CHKERRQ(ierr);
+    ierr = PetscFree(displs);CHKERRQ(ierr);
+    ierr = PetscFree(types);CHKERRQ(ierr);
+    ierr = MPI_Type_free(&box);CHKERRQ(ierr);
+    ierr = MPI_Type_free(&node);CHKERRQ(ierr);
+  }
+  ierr = MPI_File_set_view(entry->fh,0,MPI_BYTE,entry->ftype,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+#if defined(IGA_CKPT_IWRITE)
+  ierr = MPI_File_iwrite_all(entry->fh,entry->buffer,(PetscMPIInt)entry->count,MPIU_SCALAR,&entry->request);CHKERRQ(ierr);
+#else
+  ierr = MPI_File_write_all_begin(entry->fh,entry->buffer,(PetscMPIInt)entry->count,MPIU_SCALAR);CHKERRQ(ierr);
+#endif
+  PetscFunctionReturn(0);
+}
+#endif
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointWrite"
+/*@
+   IGACheckpointWrite - Snapshots a set of vectors and writes them to
+   a file in the background
+
+   Collective on IGA
+
+   Input Parameters:
++  ckpt - the checkpoint context
+.  filename - the name of the checkpoint file
+.  t - the time of the snapshot
+.  step - the step number of the snapshot
+.  nvec - the number of vectors
+-  vecs - the vectors, created with IGACreateVec()
+
+   Notes:
+   The vectors may be modified as soon as this routine returns. With
+   MPI-IO the write proceeds through a nonblocking (MPI-3.1) or split
+   collective operation; without MPI-IO the write is synchronous.
+
+   Level: normal
+
+.keywords: IGA, checkpoint, write
+.seealso: IGACheckpointRead(), IGACheckpointWriteTS(), IGACheckpointFlush()
+@*/
+PetscErrorCode IGACheckpointWrite(IGACheckpoint ckpt,const char filename[],PetscReal t,PetscInt step,PetscInt nvec,const Vec vecs[])
+{
+  IGA            iga;
+  PetscInt       i,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(ckpt,1);
+  PetscValidCharPointer(filename,2);
+  if (nvec) PetscValidPointer(vecs,6);
+  iga = ckpt->iga;
+  if (nvec < 0) SETERRQ1(((PetscObject)iga)->comm,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors must be nonnegative, got %D",nvec);
+  for (i=0; i<nvec; i++) {
+    PetscValidHeaderSpecific(vecs[i],VEC_CLASSID,6);
+    ierr = VecGetLocalSize(vecs[i],&n);CHKERRQ(ierr);
+    if (n != iga->map->n) SETERRQ3(((PetscObject)iga)->comm,PETSC_ERR_ARG_INCOMP,
+                                   "Vector %D has local size %D, expected %D",i,n,iga->map->n);
+  }
+
+#if defined(PETSC_HAVE_MPIIO)
+  { /* back-pressure: wait for the oldest write if the queue is full */
+    IGACkptEntry *entry;
+    if (ckpt->npending == ckpt->nqueue) {ierr = IGACheckpointComplete_Private(ckpt);CHKERRQ(ierr);}
+    entry = &ckpt->queue[(ckpt->head+ckpt->npending) % ckpt->nqueue];
+    entry->count = nvec*iga->map->n;
+    if (entry->size < entry->count) {
+      ierr = PetscFree(entry->buffer);CHKERRQ(ierr);
+      ierr = PetscMalloc((size_t)entry->count*sizeof(PetscScalar),&entry->buffer);CHKERRQ(ierr);
+      entry->size = entry->count;
+    }
+    for (i=0; i<nvec; i++) {
+      const PetscScalar *array;
+      ierr = VecGetArrayRead(vecs[i],&array);CHKERRQ(ierr);
+      ierr = PetscMemcpy(entry->buffer+i*iga->map->n,array,(size_t)iga->map->n*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(vecs[i],&array);CHKERRQ(ierr);
+    }
+#if !defined(PETSC_WORDS_BIGENDIAN)
+    ierr = PetscByteSwap(entry->buffer,PETSC_SCALAR,entry->count);CHKERRQ(ierr);
+#endif
+    entry->time = MPI_Wtime();
+    ierr = IGACheckpointPost_MPIIO(ckpt,entry,filename,t,step,nvec);CHKERRQ(ierr);
+    ckpt->npending++;
+  }
+#else
+  {
+    MPI_Comm    comm = ((PetscObject)iga)->comm;
+    PetscViewer viewer;
+    PetscInt    info[3];
+    info[0] = IGA_CHECKPOINT_CLASSID; info[1] = step; info[2] = nvec;
+    ierr = PetscViewerCreate(comm,&viewer);CHKERRQ(ierr);
+    ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetMode(viewer,FILE_MODE_WRITE);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryWrite(viewer,info,3,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryWrite(viewer,&t,1,PETSC_REAL,PETSC_TRUE);CHKERRQ(ierr);
+    for (i=0; i<nvec; i++) {ierr = IGASaveVec(iga,vecs[i],viewer);CHKERRQ(ierr);}
+    ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointWriteTS"
+/*@
+   IGACheckpointWriteTS - Writes the complete state of a TS in the
+   background
+
+   Collective on IGA
+
+   Input Parameters:
++  ckpt - the checkpoint context
+.  ts - the TS context
+-  filename - the name of the checkpoint file
+
+   Notes:
+   The time and step number are always saved. For TSALPHA2 the
+   solution, its first and second time derivatives (TSGetSolution2(),
+   TSAlpha2GetAcceleration()) are saved, which is what an exact restart
+   of the generalized-alpha method needs; otherwise only the solution
+   vector is saved. This routine is suitable to be called from a TS
+   monitor.
+
+   Level: normal
+
+.keywords: IGA, checkpoint, TS
+.seealso: IGACheckpointReadTS()
+@*/
+PetscErrorCode IGACheckpointWriteTS(IGACheckpoint ckpt,TS ts,const char filename[])
+{
+  PetscBool      alpha2;
+  PetscReal      t;
+  PetscInt       step,nvec;
+  Vec            vecs[3];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(ckpt,1);
+  PetscValidHeaderSpecific(ts,TS_CLASSID,2);
+  PetscValidCharPointer(filename,3);
+  ierr = TSGetTime(ts,&t);CHKERRQ(ierr);
+  ierr = TSGetTimeStepNumber(ts,&step);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ts,TSALPHA2,&alpha2);CHKERRQ(ierr);
+  if (alpha2) {
+    ierr = TSGetSolution2(ts,&vecs[0],&vecs[1]);CHKERRQ(ierr);
+    ierr = TSAlpha2GetAcceleration(ts,&vecs[2]);CHKERRQ(ierr);
+    nvec = 3;
+  } else {
+    ierr = TSGetSolution(ts,&vecs[0]);CHKERRQ(ierr);
+    nvec = 1;
+  }
+  ierr = IGACheckpointWrite(ckpt,filename,t,step,nvec,vecs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointOpen_Private"
+static PetscErrorCode IGACheckpointOpen_Private(IGA iga,const char filename[],PetscViewer *viewer,
+                                                PetscReal *t,PetscInt *step,PetscInt *nvec)
+{
+  PetscInt       info[3];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerCreate(((PetscObject)iga)->comm,viewer);CHKERRQ(ierr);
+  ierr = PetscViewerSetType(*viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
+  ierr = PetscViewerBinarySkipInfo(*viewer);CHKERRQ(ierr);
+  ierr = PetscViewerFileSetMode(*viewer,FILE_MODE_READ);CHKERRQ(ierr);
+  ierr = PetscViewerFileSetName(*viewer,filename);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryRead(*viewer,info,3,PETSC_INT);CHKERRQ(ierr);
+  if (info[0] != IGA_CHECKPOINT_CLASSID) SETERRQ1(((PetscObject)iga)->comm,PETSC_ERR_FILE_UNEXPECTED,"Not an IGA checkpoint in file %s",filename);
+  ierr = PetscViewerBinaryRead(*viewer,t,1,PETSC_REAL);CHKERRQ(ierr);
+  *step = info[1];
+  *nvec = info[2];
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointRead"
+/*@
+   IGACheckpointRead - Reads a checkpoint written with IGACheckpointWrite()
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  filename - the name of the checkpoint file
+.  nvec - the number of vectors to read
+-  vecs - the vectors, created with IGACreateVec()
+
+   Output Parameters:
++  t - the time of the snapshot (or NULL)
+-  step - the step number of the snapshot (or NULL)
+
+   Level: normal
+
+.keywords: IGA, checkpoint, read
+.seealso: IGACheckpointWrite()
+@*/
+PetscErrorCode IGACheckpointRead(IGA iga,const char filename[],PetscReal *t,PetscInt *step,PetscInt nvec,Vec vecs[])
+{
+  PetscViewer    viewer;
+  PetscReal      time;
+  PetscInt       i,number,count;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidCharPointer(filename,2);
+  if (nvec) PetscValidPointer(vecs,6);
+  IGACheckSetUp(iga,1);
+
+  ierr = IGACheckpointOpen_Private(iga,filename,&viewer,&time,&number,&count);CHKERRQ(ierr);
+  if (nvec > count) SETERRQ3(((PetscObject)iga)->comm,PETSC_ERR_FILE_UNEXPECTED,
+                             "Checkpoint file %s holds %D vectors, requested %D",filename,count,nvec);
+  for (i=0; i<nvec; i++) {ierr = IGALoadVec(iga,vecs[i],viewer);CHKERRQ(ierr);}
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+  if (t)    *t    = time;
+  if (step) *step = number;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGACheckpointReadTS"
+/*@
+   IGACheckpointReadTS - Restores the state of a TS from a checkpoint
+   written with IGACheckpointWriteTS()
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  ts - the TS context
+-  filename - the name of the checkpoint file
+
+   Output Parameter:
+.  step - the step number of the snapshot (or NULL)
+
+   Notes:
+   The TS time is set to the checkpoint time. For TSALPHA2 the
+   solution, velocity and acceleration vectors are restored with
+   TSSetSolution2() and TSAlpha2SetAcceleration().
+
+   Level: normal
+
+.keywords: IGA, checkpoint, TS
+.seealso: IGACheckpointWriteTS()
+@*/
+PetscErrorCode IGACheckpointReadTS(IGA iga,TS ts,const char filename[],PetscInt *step)
+{
+  PetscViewer    viewer;
+  PetscBool      alpha2;
+  PetscReal      t;
+  PetscInt       i,number,count,nvec;
+  Vec            vecs[3];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(ts,TS_CLASSID,2);
+  PetscValidCharPointer(filename,3);
+  IGACheckSetUp(iga,1);
+
+  ierr = PetscObjectTypeCompare((PetscObject)ts,TSALPHA2,&alpha2);CHKERRQ(ierr);
+  ierr = IGACheckpointOpen_Private(iga,filename,&viewer,&t,&number,&count);CHKERRQ(ierr);
+  nvec = PetscMin(count,alpha2 ? 3 : 1);
+  if (nvec < 1) SETERRQ1(((PetscObject)iga)->comm,PETSC_ERR_FILE_UNEXPECTED,"No vectors in checkpoint file %s",filename);
+  for (i=0; i<nvec; i++) {
+    ierr = IGACreateVec(iga,&vecs[i]);CHKERRQ(ierr);
+    ierr = IGALoadVec(iga,vecs[i],viewer);CHKERRQ(ierr);
+  }
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+
+  if (alpha2) {
+    if (nvec < 2) {
+      ierr = IGACreateVec(iga,&vecs[1]);CHKERRQ(ierr);
+      ierr = VecZeroEntries(vecs[1]);CHKERRQ(ierr);
+    }
+    ierr = TSSetSolution2(ts,vecs[0],vecs[1]);CHKERRQ(ierr);
+    if (nvec > 2) {ierr = TSAlpha2SetAcceleration(ts,vecs[2]);CHKERRQ(ierr);}
+    nvec = PetscMax(nvec,2);
+  } else {
+    ierr = TSSetSolution(ts,vecs[0]);CHKERRQ(ierr);
+  }
+  ierr = TSSetTime(ts,t);CHKERRQ(ierr);
+  for (i=0; i<nvec; i++) {ierr = VecDestroy(&vecs[i]);CHKERRQ(ierr);}
+  if (step) *step = number;
+  PetscFunctionReturn(0);
+}
@@ -65,6 +65,7 @@ PetscErrorCode IGAComputeScalarCustom(IGA iga,Vec vecU,
   PetscValidHeaderSpecific(vecU,VEC_CLASSID,2);
   PetscValidScalarPointer(S,3);
   IGACheckSetUp(iga,1);
+  IGATraceBegin(__FUNCT__);
 
   ierr = PetscCalloc1(n,&localS);CHKERRQ(ierr);
   ierr = PetscMalloc1(n,&workS);CHKERRQ(ierr);
@@ -75,6 +76,7 @@ PetscErrorCode IGAComputeScalarCustom(IGA iga,Vec vecU,
   ierr = PetscLogEventBegin(IGA_FormScalar,iga,vecU,0,0);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
@@ -83,12 +85,15 @@ PetscErrorCode IGAComputeScalarCustom(IGA iga,Vec vecU,
     ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
     while (IGAElementNextPoint(element,point)) {
       ierr = PetscMemzero(workS,n*sizeof(PetscScalar));CHKERRQ(ierr);
+      IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
       ierr = Scalar(point,U,n,workS,ctx);CHKERRQ(ierr);
+      IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
       ierr = IGAPointAddArray(point,n,workS,localS);CHKERRQ(ierr);
     }
     ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormScalar,iga,vecU,0,0);CHKERRQ(ierr);
 
@@ -102,5 +107,6 @@ PetscErrorCode IGAComputeScalarCustom(IGA iga,Vec vecU,
   ierr = PetscFree(localS);CHKERRQ(ierr);
   ierr = PetscFree(workS);CHKERRQ(ierr);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
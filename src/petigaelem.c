@@ -1,5 +1,12 @@
 #include "petiga.h"
 
+const char *const IGAElementOrders[] = {
+  "LEXICOGRAPHIC",
+  "TILED",
+  "MORTON",
+  /* */
+  "IGAElementOrder","IGA_ELEMENT_ORDER_",0};
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAElementCreate"
 PetscErrorCode IGAElementCreate(IGAElement *_element)
@@ -97,6 +104,11 @@ PetscErrorCode IGAElementReset(IGAElement element)
   PetscValidPointer(element,1);
   element->count =  0;
   element->index = -1;
+  element->BD    = NULL;
+  element->asmmat   = NULL;
+  element->asmlocal = NULL;
+  element->mem      = 0;
+  ierr = PetscFree(element->order);CHKERRQ(ierr);
 
   if (element->rowmap != element->mapping)
     {ierr = PetscFree(element->rowmap);CHKERRQ(ierr);}
@@ -140,6 +152,72 @@ PetscErrorCode IGAElementReset(IGAElement element)
   PetscFunctionReturn(0);
 }
 
+/* Z-order traversal of the box [lo,hi) by recursive bisection */
+static void MortonOrder(const PetscInt width[3],
+                        const PetscInt lo[3],const PetscInt hi[3],
+                        PetscInt *pos,PetscInt order[])
+{
+  PetscInt i,a,b,c,n[3],L[3][2],R[3][2];
+  for (i=0; i<3; i++) {
+    PetscInt w = hi[i] - lo[i], mid = lo[i] + (w+1)/2;
+    if (w <= 0) return;
+    n[i] = (w > 1) ? 2 : 1;
+    L[i][0] = lo[i]; R[i][0] = (w > 1) ? mid : hi[i];
+    L[i][1] = mid;   R[i][1] = hi[i];
+  }
+  if (n[0]*n[1]*n[2] == 1) {
+    order[(*pos)++] = lo[0] + lo[1]*width[0] + lo[2]*width[0]*width[1];
+    return;
+  }
+  for (c=0; c<n[2]; c++)
+    for (b=0; b<n[1]; b++)
+      for (a=0; a<n[0]; a++) {
+        PetscInt l[3],h[3];
+        l[0] = L[0][a]; h[0] = R[0][a];
+        l[1] = L[1][b]; h[1] = R[1][b];
+        l[2] = L[2][c]; h[2] = R[2][c];
+        MortonOrder(width,l,h,pos,order);
+      }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAElementSetUpOrder"
+static
+PetscErrorCode IGAElementSetUpOrder(IGAElement element,IGAElementOrder type,const PetscInt tile[3])
+{
+  const PetscInt *width = element->width;
+  PetscInt       i,j,k,ti,tj,tk,pos=0,*order;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscFree(element->order);CHKERRQ(ierr);
+  if (type == IGA_ELEMENT_ORDER_LEXICOGRAPHIC) PetscFunctionReturn(0);
+  if (type != IGA_ELEMENT_ORDER_TILED && type != IGA_ELEMENT_ORDER_MORTON)
+    SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Unknown element order %d",(int)type);
+  if (element->count <= 1) PetscFunctionReturn(0);
+  ierr = IGAMalloc1(element->mem,element->count,&order);CHKERRQ(ierr);
+  switch (type) {
+  case IGA_ELEMENT_ORDER_TILED: {
+    PetscInt T[3];
+    for (i=0; i<3; i++) T[i] = PetscMin(PetscMax(tile[i],1),width[i]);
+    for (tk=0; tk<width[2]; tk+=T[2])
+      for (tj=0; tj<width[1]; tj+=T[1])
+        for (ti=0; ti<width[0]; ti+=T[0])
+          for (k=tk; k<PetscMin(tk+T[2],width[2]); k++)
+            for (j=tj; j<PetscMin(tj+T[1],width[1]); j++)
+              for (i=ti; i<PetscMin(ti+T[0],width[0]); i++)
+                order[pos++] = i + j*width[0] + k*width[0]*width[1];
+    } break;
+  case IGA_ELEMENT_ORDER_MORTON: {
+    PetscInt lo[3] = {0,0,0};
+    MortonOrder(width,lo,width,&pos,order);
+    } break;
+  default: break;
+  }
+  if (pos != element->count) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Visited %D elements, expected %D",pos,element->count);
+  element->order = order;
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAElementInit"
 PetscErrorCode IGAElementInit(IGAElement element,IGA iga)
@@ -163,7 +241,7 @@ PetscErrorCode IGAElementInit(IGAElement element,IGA iga)
     PetscInt *width = iga->elem_width;
     PetscInt *sizes = iga->elem_sizes;
     IGABasis *BD    = iga->basis;
-    PetscInt i,dim = element->dim;
+    PetscInt i,k,dim = element->dim;
     PetscInt nel=1,nen=1,nqp=1;
     for (i=0; i<3; i++)
       element->ID[i] = 0;
@@ -180,56 +258,70 @@ PetscErrorCode IGAElementInit(IGAElement element,IGA iga)
       element->width[i] = 1;
       element->sizes[i] = 1;
     }
+    for (k=0; k<IGA_FORM_KINDS; k++) { /* room for every quadrature */
+      IGABasis *FD = iga->formbasis[k];
+      PetscInt n = 1;
+      if (!FD[0]) continue;
+      for (i=0; i<dim; i++) n *= FD[i]->nqp;
+      nqp = PetscMax(nqp,n);
+    }
+    if (!iga->collocation) { /* room for the rule of IGAQuasiInterpolate() */
+      PetscInt n = 1;
+      for (i=0; i<dim; i++) n *= BD[i]->p + 1;
+      nqp = PetscMax(nqp,n);
+    }
     element->index = -1;
     element->count = nel;
     element->nen   = nen;
     element->nqp   = nqp;
+    element->BD    = BD;
   }
+  ierr = IGAElementSetUpOrder(element,iga->elem_order,iga->elem_tile);CHKERRQ(ierr);
   { /**/
     PetscInt nen = element->nen;
     PetscInt nsd = element->nsd;
     PetscInt npd = element->npd;
-    ierr = PetscMalloc1(nen,&element->mapping);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen,&element->mapping);CHKERRQ(ierr);
     if (!element->collocation) {
       element->neq = nen;
       element->rowmap = element->mapping;
     } else {
       element->neq = 1;
-      ierr = PetscMalloc1(1,&element->rowmap);CHKERRQ(ierr);
+      ierr = IGAMalloc1(element->mem,1,&element->rowmap);CHKERRQ(ierr);
     }
     element->colmap = element->mapping;
-    ierr = PetscMalloc1(nen,&element->rationalW);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*nsd,&element->geometryX);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*npd,&element->propertyA);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen,&element->rationalW);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*nsd,&element->geometryX);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*npd,&element->propertyA);CHKERRQ(ierr);
   }
   { /* */
     PetscInt nqp = element->nqp;
     PetscInt nen = element->nen;
     PetscInt dim = element->dim;
 
-    ierr = PetscMalloc1(nqp*dim,&element->point);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp,&element->weight);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp,&element->detJac);CHKERRQ(ierr);
-
-    ierr = PetscMalloc1(nqp*nen,&element->basis[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim,&element->basis[1]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim*dim,&element->basis[2]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim*dim*dim,&element->basis[3]);CHKERRQ(ierr);
-
-    ierr = PetscMalloc1(nqp,&element->detX);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim,&element->gradX[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim,&element->gradX[1]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim*dim,&element->hessX[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim*dim,&element->hessX[1]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim*dim*dim,&element->der3X[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim*dim*dim*dim,&element->der3X[1]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp,&element->detS);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*dim,&element->normal);CHKERRQ(ierr);
-
-    ierr = PetscMalloc1(nqp*nen,&element->shape[0]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim,&element->shape[1]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim*dim,&element->shape[2]);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nqp*nen*dim*dim*dim,&element->shape[3]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim,&element->point);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp,&element->weight);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp,&element->detJac);CHKERRQ(ierr);
+
+    ierr = IGAMalloc1(element->mem,nqp*nen,&element->basis[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim,&element->basis[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim*dim,&element->basis[2]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim*dim*dim,&element->basis[3]);CHKERRQ(ierr);
+
+    ierr = IGAMalloc1(element->mem,nqp,&element->detX);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim,&element->gradX[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim,&element->gradX[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim*dim,&element->hessX[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim*dim,&element->hessX[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim*dim*dim,&element->der3X[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim*dim*dim*dim,&element->der3X[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp,&element->detS);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*dim,&element->normal);CHKERRQ(ierr);
+
+    ierr = IGAMalloc1(element->mem,nqp*nen,&element->shape[0]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim,&element->shape[1]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim*dim,&element->shape[2]);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nqp*nen*dim*dim*dim,&element->shape[3]);CHKERRQ(ierr);
   }
   { /* */
     size_t MAX_WORK_VAL = sizeof(element->wval)/sizeof(PetscScalar*);
@@ -237,22 +329,22 @@ PetscErrorCode IGAElementInit(IGAElement element,IGA iga)
     size_t MAX_WORK_MAT = sizeof(element->wmat)/sizeof(PetscScalar*);
     size_t i, n = element->nen * element->dof;
     for (i=0; i<MAX_WORK_VAL; i++)
-      {ierr = PetscMalloc1(n,&element->wval[i]);CHKERRQ(ierr);}
+      {ierr = IGAMalloc1(element->mem,n,&element->wval[i]);CHKERRQ(ierr);}
     for (i=0; i<MAX_WORK_VEC; i++)
-      {ierr = PetscMalloc1(n,&element->wvec[i]);CHKERRQ(ierr);}
+      {ierr = IGAMalloc1(element->mem,n,&element->wvec[i]);CHKERRQ(ierr);}
     for (i=0; i<MAX_WORK_MAT; i++)
-      {ierr = PetscMalloc1(n*n,&element->wmat[i]);CHKERRQ(ierr);}
+      {ierr = IGAMalloc1(element->mem,n*n,&element->wmat[i]);CHKERRQ(ierr);}
   }
   { /* */
     PetscInt nen = element->nen;
     PetscInt dof = element->dof;
     element->nfix = 0;
-    ierr = PetscMalloc1(nen*dof,&element->ifix);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*dof,&element->vfix);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*dof,&element->ufix);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*dof,&element->ifix);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*dof,&element->vfix);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*dof,&element->ufix);CHKERRQ(ierr);
     element->nflux = 0;
-    ierr = PetscMalloc1(nen*dof,&element->iflux);CHKERRQ(ierr);
-    ierr = PetscMalloc1(nen*dof,&element->vflux);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*dof,&element->iflux);CHKERRQ(ierr);
+    ierr = IGAMalloc1(element->mem,nen*dof,&element->vflux);CHKERRQ(ierr);
   }
   ierr = IGAPointInit(element->iterator,element);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -284,6 +376,9 @@ PetscErrorCode IGABeginElement(IGA iga,IGAElement *_element)
   element->index = -1;
   element->atboundary  = PETSC_FALSE;
   element->boundary_id = -1;
+  element->BD = iga->basis;
+  element->asmmat   = NULL;
+  element->asmlocal = NULL;
 
   if (iga->rational && !iga->rationalW) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,"No geometry set");
   if (iga->geometry && !iga->geometryX) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,"No geometry set");
@@ -296,14 +391,16 @@ PetscErrorCode IGABeginElement(IGA iga,IGAElement *_element)
     PetscInt nsd = iga->geometry ? iga->geometry : iga->dim;
     PetscInt npd = iga->property;
     if (element->nsd != nsd) {
+      element->mem -= (PetscLogDouble)nen*element->nsd*sizeof(PetscReal);
       element->nsd = nsd;
       ierr = PetscFree(element->geometryX);CHKERRQ(ierr);
-      ierr = PetscMalloc1(nen*nsd,&element->geometryX);CHKERRQ(ierr);
+      ierr = IGAMalloc1(element->mem,nen*nsd,&element->geometryX);CHKERRQ(ierr);
     }
     if (element->npd != npd) {
+      element->mem -= (PetscLogDouble)nen*element->npd*sizeof(PetscScalar);
       element->npd = npd;
       ierr = PetscFree(element->propertyA);CHKERRQ(ierr);
-      ierr = PetscMalloc1(nen*npd,&element->propertyA);CHKERRQ(ierr);
+      ierr = IGAMalloc1(element->mem,nen*npd,&element->propertyA);CHKERRQ(ierr);
     }
     ierr = PetscMemzero(element->rationalW,sizeof(PetscReal)*nen);CHKERRQ(ierr);
     ierr = PetscMemzero(element->geometryX,sizeof(PetscReal)*nen*nsd);CHKERRQ(ierr);
@@ -382,6 +479,7 @@ PetscBool IGANextElement(IGA iga,IGAElement element)
     element->index = -1;
     return PETSC_FALSE;
   }
+  if (element->order) index = element->order[index];
   for (i=0; i<dim; i++) {
     coord = index % width[i];
     index = (index - coord) / width[i];
@@ -390,8 +488,10 @@ PetscBool IGANextElement(IGA iga,IGAElement element)
   /* */
 #undef  CHKERRRETURN
 #define CHKERRRETURN(n,r) do { if (PetscUnlikely(n)) { CHKERRCONTINUE(n); return (r);} } while (0)
+  IGAProfileBegin(iga,IGA_PROFILE_CLOSURE);
   ierr = IGAElementBuildClosure(element);CHKERRRETURN(ierr,PETSC_FALSE);
   ierr = IGAElementBuildFix(element);CHKERRRETURN(ierr,PETSC_FALSE);
+  IGAProfileEnd(iga,IGA_PROFILE_CLOSURE);
 #undef  CHKERRRETURN
   return PETSC_TRUE;
 }
@@ -436,6 +536,22 @@ PetscBool IGAElementNextForm(IGAElement element,PetscBool visit[3][2])
   return PETSC_FALSE;
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGAElementUseFormQuadrature"
+PetscErrorCode IGAElementUseFormQuadrature(IGAElement element,IGAFormKind kind)
+{
+  IGA iga;
+  PetscFunctionBegin;
+  PetscValidPointer(element,1);
+  iga = element->parent;
+  if (PetscUnlikely(kind < 0 || kind >= IGA_FORM_KINDS))
+    SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Invalid form kind %D",(PetscInt)kind);
+  if (PetscUnlikely(element->iterator->index != -1))
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot change quadrature during point loop");
+  element->BD = iga->formbasis[kind][0] ? iga->formbasis[kind] : iga->basis;
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAElementGetPoint"
 PetscErrorCode IGAElementGetPoint(IGAElement element,IGAPoint *point)
@@ -447,6 +563,18 @@ PetscErrorCode IGAElementGetPoint(IGAElement element,IGAPoint *point)
   PetscFunctionReturn(0);
 }
 
+/* number of quadrature points of the current element, skipping an axis at boundaries */
+PETSC_STATIC_INLINE
+PetscInt IGAElementQuadratureCount(IGAElement element,PetscInt skip)
+{
+  IGABasis *BD = element->BD;
+  PetscInt *ID = element->ID;
+  PetscInt i,count = 1;
+  for (i=0; i<element->dim; i++)
+    if (i != skip) count *= BD[i]->count[ID[i]];
+  return count;
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAElementBeginPoint"
 PetscErrorCode IGAElementBeginPoint(IGAElement element,IGAPoint *_point)
@@ -461,20 +589,24 @@ PetscErrorCode IGAElementBeginPoint(IGAElement element,IGAPoint *_point)
   point = *_point = element->iterator;
 
   point->index = -1;
-  point->count = element->nqp;
+  point->count = IGAElementQuadratureCount(element,-1);
 
   point->atboundary  = element->atboundary;
   point->boundary_id = element->boundary_id;
 
   if (PetscLikely(!element->atboundary)) {
+    IGAProfileBegin(element->parent,IGA_PROFILE_BASIS);
     ierr = IGAElementBuildQuadrature(element);CHKERRQ(ierr);
+    IGAProfileEnd(element->parent,IGA_PROFILE_BASIS);
     ierr = IGAElementBuildShapeFuns(element);CHKERRQ(ierr);
   } else {
     PetscInt axis = element->boundary_id / 2;
     PetscInt side = element->boundary_id % 2;
-    point->count = element->nqp / element->parent->basis[axis]->nqp;
+    point->count = IGAElementQuadratureCount(element,axis);
+    IGAProfileBegin(element->parent,IGA_PROFILE_BASIS);
     ierr = IGAElementBuildQuadratureAtBoundary(element,axis,side);CHKERRQ(ierr);
     ierr = IGAElementBuildShapeFunsAtBoundary (element,axis,side);CHKERRQ(ierr);
+    IGAProfileEnd(element->parent,IGA_PROFILE_BASIS);
   }
   PetscFunctionReturn(0);
 }
@@ -611,7 +743,11 @@ PetscErrorCode IGAElementGetIndex(IGAElement element,PetscInt *index)
   PetscFunctionBegin;
   PetscValidPointer(element,1);
   PetscValidIntPointer(index,2);
-  *index = element->index;
+  /* lexicographic index in the local box, not the traversal position */
+  if (element->order && element->index >= 0)
+    *index = element->order[element->index];
+  else
+    *index = element->index;
   PetscFunctionReturn(0);
 }
 
@@ -685,7 +821,7 @@ PetscErrorCode IGAElementBuildClosure(IGAElement element)
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call during element loop");
   { /* */
     IGA      iga = element->parent;
-    IGABasis *BD = element->parent->basis;
+    IGABasis *BD = element->BD;
     PetscInt *ID = element->ID;
     PetscInt ia, inen = BD[0]->nen, ioffset = BD[0]->offset[ID[0]];
     PetscInt ja, jnen = BD[1]->nen, joffset = BD[1]->offset[ID[1]];
@@ -785,10 +921,10 @@ extern void IGA_ShapeFuns_3D(PetscInt,PetscInt,PetscInt,const PetscReal[],
 EXTERN_C_END
 
 #define IGA_Quadrature_ARGS(ID,BD,i) \
-  BD[i]->nqp,BD[i]->point+ID[i]*BD[i]->nqp,BD[i]->weight,BD[i]->detJ+ID[i]
+  BD[i]->count[ID[i]],BD[i]->point+ID[i]*BD[i]->nqp,BD[i]->weight+ID[i]*BD[i]->nqp,BD[i]->detJ+ID[i]
 
 #define IGA_BasisFuns_ARGS(ID,BD,i) \
-  BD[i]->nqp,BD[i]->nen,BD[i]->d,BD[i]->value+ID[i]*BD[i]->nqp*BD[i]->nen*(BD[i]->d+1)
+  BD[i]->count[ID[i]],BD[i]->nen,BD[i]->d,IGABasisGetValues(BD[i],ID[i])
 
 #undef  __FUNCT__
 #define __FUNCT__ "IGAElementBuildQuadrature"
@@ -799,7 +935,7 @@ PetscErrorCode IGAElementBuildQuadrature(IGAElement element)
   if (PetscUnlikely(element->index < 0))
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call during element loop");
   {
-    IGABasis *BD = element->parent->basis;
+    IGABasis *BD = element->BD;
     PetscInt *ID = element->ID;
     PetscReal *u = element->point;
     PetscReal *w = element->weight;
@@ -827,8 +963,9 @@ PetscErrorCode IGAElementBuildShapeFuns(IGAElement element)
   PetscValidPointer(element,1);
   if (PetscUnlikely(element->index < 0))
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call during element loop");
+  IGAProfileBegin(element->parent,IGA_PROFILE_BASIS);
   {
-    IGABasis  *BD = element->parent->basis;
+    IGABasis  *BD = element->BD;
     PetscInt  *ID = element->ID;
     PetscInt  ord = element->parent->order;
     PetscInt  rat = element->rational;
@@ -849,12 +986,13 @@ PetscErrorCode IGAElementBuildShapeFuns(IGAElement element)
                              N[0],N[1],N[2],N[3]); break;
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_BASIS);
 
   if (element->dim == element->nsd) /* XXX */
   if (element->geometry) {
     PetscInt q;
     PetscInt ord  = element->parent->order;
-    PetscInt nqp  = element->nqp;
+    PetscInt nqp  = IGAElementQuadratureCount(element,-1);
     PetscInt nen  = element->nen;
     PetscReal *X  = element->geometryX;
     PetscReal **M = element->basis;
@@ -866,6 +1004,7 @@ PetscErrorCode IGAElementBuildShapeFuns(IGAElement element)
     PetscReal *H1 = element->hessX[1];
     PetscReal *I0 = element->der3X[0];
     PetscReal *I1 = element->der3X[1];
+    IGAProfileBegin(element->parent,IGA_PROFILE_GEOMETRY);
     switch (element->dim) {
     case 3: IGA_ShapeFuns_3D(ord,nqp,nen,X,
                              M[0],M[1],M[2],M[3],
@@ -882,6 +1021,7 @@ PetscErrorCode IGAElementBuildShapeFuns(IGAElement element)
     }
     for (q=0; q<nqp; q++)
       element->detJac[q] *= J[q];
+    IGAProfileEnd(element->parent,IGA_PROFILE_GEOMETRY);
   }
   PetscFunctionReturn(0);
 }
@@ -905,7 +1045,7 @@ PetscErrorCode IGAElementBuildQuadratureAtBoundary(IGAElement element,PetscInt a
   if (PetscUnlikely(element->index < 0))
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call during element loop");
   {
-    IGABasis *BD = element->parent->basis;
+    IGABasis *BD = element->BD;
     PetscInt *ID = element->ID;
     PetscReal *u = element->point;
     PetscReal *w = element->weight;
@@ -954,7 +1094,7 @@ PetscErrorCode IGAElementBuildShapeFunsAtBoundary(IGAElement element,PetscInt ax
   if (PetscUnlikely(element->index < 0))
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call during element loop");
   {
-    IGABasis  *BD = element->parent->basis;
+    IGABasis  *BD = element->BD;
     PetscInt  *ID = element->ID;
     PetscInt  ord = element->parent->order;
     PetscInt  rat = element->rational;
@@ -999,7 +1139,7 @@ PetscErrorCode IGAElementBuildShapeFunsAtBoundary(IGAElement element,PetscInt ax
     }
     {
       PetscInt q;
-      PetscInt nqp = element->nqp / element->parent->basis[axis]->nqp;
+      PetscInt nqp = IGAElementQuadratureCount(element,axis);
       PetscInt dim = element->dim;
       PetscReal *S = element->detS;
       PetscReal *n = element->normal;
@@ -1014,7 +1154,7 @@ PetscErrorCode IGAElementBuildShapeFunsAtBoundary(IGAElement element,PetscInt ax
     PetscInt q;
     PetscInt dim  = element->dim;
     PetscInt ord  = element->parent->order;
-    PetscInt nqp  = element->nqp / element->parent->basis[axis]->nqp;
+    PetscInt nqp  = IGAElementQuadratureCount(element,axis);
     PetscInt nen  = element->nen;
     PetscReal *X  = element->geometryX;
     PetscReal **M = element->basis;
@@ -1108,6 +1248,7 @@ PetscErrorCode IGAElementGetValues(IGAElement element,const PetscScalar arrayU[]
   if (PetscUnlikely((size_t)element->nval >= sizeof(element->wval)/sizeof(PetscScalar*)))
     SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Too many work values requested");
   U = *_U = element->wval[element->nval++];
+  IGAProfileBegin(element->parent,IGA_PROFILE_VALUES);
   if (PetscLikely(arrayU)) {
     PetscInt a, nen = element->nen;
     PetscInt i, dof = element->dof;
@@ -1121,6 +1262,7 @@ PetscErrorCode IGAElementGetValues(IGAElement element,const PetscScalar arrayU[]
     size_t n = (size_t)(element->nen * element->dof);
     ierr = PetscMemzero(U,n*sizeof(PetscScalar));CHKERRQ(ierr);
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_VALUES);
   PetscFunctionReturn(0);
 }
 
@@ -1144,7 +1286,7 @@ static PetscReal BoundaryArea(IGAElement element,PetscInt dir,PetscInt side)
 {
   PetscReal A = 1.0;
   PetscInt *ID = element->ID;
-  IGABasis *BD = element->parent->basis;
+  IGABasis *BD = element->BD;
   PetscInt i,dim = element->dim;
   if (dim == 1) return A;
   for (i=0; i<dim; i++)
@@ -1158,16 +1300,17 @@ static PetscReal BoundaryArea(IGAElement element,PetscInt dir,PetscInt side)
   } else {
     PetscInt shape[3] = {1,1,1};
     PetscInt k,nqp[3],nen[3],ndr[3];
-    PetscReal *W[3],*N[3],dS = 1.0;
+    const PetscReal *N[3];
+    PetscReal *W[3],dS = 1.0;
     for (i=0; i<dim; i++)
       shape[i] = BD[i]->nen;
     for (k=0,i=0; i<dim; i++) {
       if (i == dir) continue;
-      nqp[k] = BD[i]->nqp;
+      nqp[k] = BD[i]->count[ID[i]];
       nen[k] = BD[i]->nen;
       ndr[k] = BD[i]->d;
-      W[k]   = BD[i]->weight;
-      N[k]   = BD[i]->value+ID[i]*nqp[k]*nen[k]*(ndr[k]+1);
+      W[k]   = BD[i]->weight+ID[i]*BD[i]->nqp;
+      N[k]   = IGABasisGetValues(BD[i],ID[i]);
       k++;
     }
     switch (dim) {
@@ -1240,7 +1383,7 @@ static void BuildFix(IGAElement element,PetscInt dir,PetscInt side)
   IGAFormBC bcl  = form->load [dir][side];
   if (bcv->count || bcl->count) {
     PetscReal Area = bcl->count ? BoundaryArea(element,dir,side) : 1.0;
-    IGABasis *BD = element->parent->basis;
+    IGABasis *BD = element->BD;
     PetscInt S[3]={0,0,0},E[3]={1,1,1};
     PetscInt ia,ja,ka,jstride,kstride,a;
     PetscInt i,dim = element->dim;
@@ -1322,7 +1465,7 @@ PetscErrorCode IGAElementBuildFix(IGAElement element)
     }
     {
       IGAFormBC (*bc)[2] = element->parent->form->value;
-      IGABasis *BD = element->parent->basis;
+      IGABasis *BD = element->BD;
       PetscInt *ID = element->ID;
       PetscInt ia, inen = BD[0]->nen, ioffset = BD[0]->offset[ID[0]];
       PetscInt ja, jnen = BD[1]->nen, joffset = BD[1]->offset[ID[1]];
@@ -1375,6 +1518,7 @@ PetscErrorCode IGAElementFixSystem(IGAElement element,PetscScalar K[],PetscScala
   PetscValidPointer(element,1);
   PetscValidScalarPointer(K,2);
   PetscValidScalarPointer(F,3);
+  IGAProfileBegin(element->parent,IGA_PROFILE_FIX);
   if (PetscUnlikely(element->collocation)) goto collocation;
   {
     PetscInt M = element->neq * element->dof;
@@ -1398,6 +1542,7 @@ PetscErrorCode IGAElementFixSystem(IGAElement element,PetscScalar K[],PetscScala
       F[k]     = v;
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
  collocation:
   {
@@ -1447,6 +1592,7 @@ PetscErrorCode IGAElementFixSystem(IGAElement element,PetscScalar K[],PetscScala
       }
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
 }
 
@@ -1457,6 +1603,7 @@ PetscErrorCode IGAElementFixFunction(IGAElement element,PetscScalar F[])
   PetscFunctionBegin;
   PetscValidPointer(element,1);
   PetscValidScalarPointer(F,2);
+  IGAProfileBegin(element->parent,IGA_PROFILE_FIX);
   if (PetscUnlikely(element->collocation)) goto collocation;
   {
     PetscInt f,n;
@@ -1474,6 +1621,7 @@ PetscErrorCode IGAElementFixFunction(IGAElement element,PetscScalar F[])
       F[k] = u - v;
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
  collocation:
   {
@@ -1491,6 +1639,7 @@ PetscErrorCode IGAElementFixFunction(IGAElement element,PetscScalar F[])
         }
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
 }
 
@@ -1501,6 +1650,7 @@ PetscErrorCode IGAElementFixJacobian(IGAElement element,PetscScalar J[])
   PetscFunctionBegin;
   PetscValidPointer(element,1);
   PetscValidScalarPointer(J,2);
+  IGAProfileBegin(element->parent,IGA_PROFILE_FIX);
   if (PetscUnlikely(element->collocation)) goto collocation;
   {
     PetscInt M = element->neq * element->dof;
@@ -1514,6 +1664,7 @@ PetscErrorCode IGAElementFixJacobian(IGAElement element,PetscScalar J[])
       J[k*N+k] = 1.0;
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
  collocation:
   {
@@ -1535,6 +1686,7 @@ PetscErrorCode IGAElementFixJacobian(IGAElement element,PetscScalar J[])
         }
     }
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_FIX);
   PetscFunctionReturn(0);
 }
 
@@ -1549,11 +1701,13 @@ PetscErrorCode IGAElementAssembleVec(IGAElement element,const PetscScalar F[],Ve
   PetscValidScalarPointer(F,2);
   PetscValidHeaderSpecific(vec,VEC_CLASSID,3);
   mm = element->neq; ii = element->rowmap;
+  IGAProfileBegin(element->parent,IGA_PROFILE_SETVALUES);
   if (element->dof == 1) {
     ierr = VecSetValuesLocal(vec,mm,ii,F,ADD_VALUES);CHKERRQ(ierr);
   } else {
     ierr = VecSetValuesBlockedLocal(vec,mm,ii,F,ADD_VALUES);CHKERRQ(ierr);
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_SETVALUES);
   PetscFunctionReturn(0);
 }
 
@@ -1570,11 +1724,26 @@ PetscErrorCode IGAElementAssembleMat(IGAElement element,const PetscScalar K[],Ma
   PetscValidHeaderSpecific(mat,MAT_CLASSID,3);
   mm = element->neq; ii = element->rowmap;
   nn = element->nen; jj = element->colmap;
-  if (element->dof == 1) {
+  IGAProfileBegin(element->parent,IGA_PROFILE_SETVALUES);
+  if (PetscUnlikely(mat != element->asmmat)) { /* once per matrix and element loop */
+    PetscBool is;
+    ierr = PetscObjectTypeCompare((PetscObject)mat,MATIS,&is);CHKERRQ(ierr);
+    element->asmmat   = mat;
+    element->asmlocal = NULL;
+    if (is) {ierr = MatISGetLocalMat(mat,&element->asmlocal);CHKERRQ(ierr);}
+  }
+  if (element->asmlocal) { /* MATIS: insert directly into the subdomain matrix */
+    if (element->dof == 1) {
+      ierr = MatSetValues(element->asmlocal,mm,ii,nn,jj,K,ADD_VALUES);CHKERRQ(ierr);
+    } else {
+      ierr = MatSetValuesBlocked(element->asmlocal,mm,ii,nn,jj,K,ADD_VALUES);CHKERRQ(ierr);
+    }
+  } else if (element->dof == 1) {
     ierr = MatSetValuesLocal(mat,mm,ii,nn,jj,K,ADD_VALUES);CHKERRQ(ierr);
   } else {
     ierr = MatSetValuesBlockedLocal(mat,mm,ii,nn,jj,K,ADD_VALUES);CHKERRQ(ierr);
   }
+  IGAProfileEnd(element->parent,IGA_PROFILE_SETVALUES);
   PetscFunctionReturn(0);
 }
 
@@ -1,5 +1,20 @@
 #include "petiga.h"
 
+const char *const IGAFormKinds[] = {
+  "VECTOR",
+  "MATRIX",
+  "SYSTEM",
+  "FUNCTION",
+  "JACOBIAN",
+  "IFUNCTION",
+  "IJACOBIAN",
+  "IEFUNCTION",
+  "IEJACOBIAN",
+  "RHSFUNCTION",
+  "RHSJACOBIAN",
+  /* */
+  "IGAFormKind","IGA_FORM_",0};
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAGetForm"
 PetscErrorCode IGAGetForm(IGA iga,IGAForm *form)
@@ -83,6 +98,7 @@ PetscErrorCode IGAFormReset(IGAForm form)
   ierr = PetscMemzero(form->value,3*2*sizeof(struct _IGAFormBC));CHKERRQ(ierr);
   ierr = PetscMemzero(form->load,3*2*sizeof(struct _IGAFormBC));CHKERRQ(ierr);
   ierr = PetscMemzero(form->visit,3*2*sizeof(PetscBool));CHKERRQ(ierr);
+  ierr = PetscMemzero(form->quadr,IGA_FORM_KINDS*3*sizeof(PetscInt));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -170,6 +186,21 @@ PetscErrorCode IGAFormClearBoundary(IGAForm form,PetscInt axis,PetscInt side)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGAFormSetQuadrature"
+PetscErrorCode IGAFormSetQuadrature(IGAForm form,IGAFormKind kind,PetscInt n,const PetscInt q[])
+{
+  PetscInt i;
+  PetscFunctionBegin;
+  PetscValidPointer(form,1);
+  IGAFormCheckArg(kind,IGA_FORM_KINDS);
+  IGAFormCheckArg(n,4);
+  if (n) PetscValidIntPointer(q,4);
+  for (i=0; i<3; i++) /* nonpositive entries fall back to the IGA rule */
+    form->quadr[kind][i] = (i<n && q[i]>0) ? q[i] : 0;
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAFormSetVector"
 PetscErrorCode IGAFormSetVector(IGAForm form,IGAFormVector Vector,void *VecCtx)
@@ -897,3 +928,49 @@ PetscErrorCode IGASetFormRHSJacobian(IGA iga,IGAFormRHSJacobian RHSJacobian,void
   iga->form->ops->RHSJacCtx   = RHSJacCtx;
   PetscFunctionReturn(0);
 }
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASetFormQuadrature"
+/*@
+   IGASetFormQuadrature - Set the number of quadrature points used when
+   evaluating one kind of form, overriding the rule set with
+   IGASetQuadrature().
+
+   Logically Collective on IGA
+
+   Input Parameter:
++  iga - the IGA context
+.  kind - the kind of form (IGA_FORM_VECTOR, IGA_FORM_RHSFUNCTION, ...)
+.  n - number of entries in q (at most the dimension, 0 to clear)
+-  q - Gauss-Legendre points per element along each axis, nonpositive
+       entries keep the IGA rule
+
+   Options Database Keys:
+.  -iga_form_quadrature_<kind> <q1,q2,q3> - e.g. -iga_form_quadrature_vector 2,2
+
+   Notes:
+   Use this to integrate cheap terms (load vectors, mass matrices, explicit
+   right-hand sides) with fewer points than the worst nonlinear term. The
+   IGACompute*() routines switch to the basis tables of the form kind they
+   evaluate; separate tables are built in IGASetUp(), so calling this
+   routine requires setting up the IGA again. Not supported with
+   collocation.
+
+   Level: advanced
+
+.keywords: IGA, quadrature, form
+@*/
+PetscErrorCode IGASetFormQuadrature(IGA iga,IGAFormKind kind,PetscInt n,const PetscInt q[])
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(iga,kind,2);
+  PetscValidLogicalCollectiveInt(iga,n,3);
+  if (iga->dim > 0) IGAFormCheckArg(n,iga->dim+1);
+  if (iga->collocation && n > 0)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Form quadrature not supported with collocation");
+  ierr = IGAFormSetQuadrature(iga->form,kind,n,q);CHKERRQ(ierr);
+  iga->setup = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
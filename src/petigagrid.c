@@ -1,5 +1,6 @@
 #include "petigagrid.h"
 #include <petsc-private/petscimpl.h>
+#include <petsc-private/aoimpl.h>
 
 #undef  __FUNCT__
 #define __FUNCT__ "IGA_Grid_Create"
@@ -196,20 +197,218 @@ PetscErrorCode IGA_Grid_SetAO(IGA_Grid g,AO ao)
   PetscFunctionReturn(0);
 }
 
+/*
+  Analytic application ordering for a Cartesian partition of the grid.
+  The PETSc ordering numbers the nodes process by process, each box in
+  lexicographic order, while the application (natural) ordering is
+  lexicographic over the whole grid. Both directions of the permutation
+  follow in closed form from the boxes of all processes, so only O(P)
+  integers are stored instead of O(N/P) for AOMEMORYSCALABLE.
+*/
+typedef struct {
+  PetscMPIInt size;
+  PetscInt    sizes[3];
+  PetscInt    *box;      /* [size][6] start and width of each process */
+  PetscInt    *offset;   /* [size+1] first PETSc index of each process */
+  PetscInt    np[3];     /* number of processes along each direction  */
+  PetscInt    *split[3]; /* [np+1] first node of each process slab    */
+  PetscInt    *rank;     /* [np0*np1*np2] owner of each process box   */
+} AO_IGA;
+
+PETSC_STATIC_INLINE
+PetscInt IGA_AO_Locate(PetscInt n,const PetscInt split[],PetscInt i)
+{ /* largest p in [0,n) such that split[p] <= i */
+  PetscInt lo = 0, hi = n;
+  while (hi - lo > 1) {
+    PetscInt mid = (lo + hi) / 2;
+    if (split[mid] <= i) lo = mid; else hi = mid;
+  }
+  return lo;
+}
+
 #undef  __FUNCT__
-#define __FUNCT__ "IGA_Grid_GetAO"
-PetscErrorCode IGA_Grid_GetAO(IGA_Grid g,AO *ao)
+#define __FUNCT__ "AOApplicationToPetsc_IGA"
+static PetscErrorCode AOApplicationToPetsc_IGA(AO ao,PetscInt n,PetscInt ia[])
+{
+  AO_IGA   *aoiga = (AO_IGA*)ao->data;
+  PetscInt *sizes = aoiga->sizes, *np = aoiga->np, N = ao->N;
+  PetscInt a;
+  PetscFunctionBegin;
+  for (a=0; a<n; a++) {
+    PetscInt idx = ia[a],i,j,k,p,r;
+    const PetscInt *b;
+    if (idx < 0) continue;
+    if (idx >= N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Index %D out of range [0,%D)",idx,N);
+    i = idx % sizes[0]; idx /= sizes[0];
+    j = idx % sizes[1]; k = idx / sizes[1];
+    p = IGA_AO_Locate(np[0],aoiga->split[0],i)
+      + np[0]*(IGA_AO_Locate(np[1],aoiga->split[1],j)
+      + np[1]*IGA_AO_Locate(np[2],aoiga->split[2],k));
+    r = aoiga->rank[p]; b = aoiga->box + 6*r;
+    ia[a] = aoiga->offset[r] + (i-b[0]) + b[3]*((j-b[1]) + b[4]*(k-b[2]));
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "AOPetscToApplication_IGA"
+static PetscErrorCode AOPetscToApplication_IGA(AO ao,PetscInt n,PetscInt ia[])
+{
+  AO_IGA   *aoiga = (AO_IGA*)ao->data;
+  PetscInt *sizes = aoiga->sizes, N = ao->N;
+  PetscInt a;
+  PetscFunctionBegin;
+  for (a=0; a<n; a++) {
+    PetscInt idx = ia[a],i,j,k,r;
+    const PetscInt *b;
+    if (idx < 0) continue;
+    if (idx >= N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Index %D out of range [0,%D)",idx,N);
+    r = IGA_AO_Locate((PetscInt)aoiga->size,aoiga->offset,idx);
+    b = aoiga->box + 6*r; idx -= aoiga->offset[r];
+    i = b[0] + idx % b[3]; idx /= b[3];
+    j = b[1] + idx % b[4]; k = b[2] + idx / b[4];
+    ia[a] = i + sizes[0]*(j + sizes[1]*k);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "AOPermuteInt_IGA"
+static PetscErrorCode AOPermuteInt_IGA(AO ao,PetscInt n,PetscInt ia[])
+{
+  PetscFunctionBegin;
+  SETERRQ(((PetscObject)ao)->comm,PETSC_ERR_SUP,"Permutation of arrays not supported");
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "AOPermuteReal_IGA"
+static PetscErrorCode AOPermuteReal_IGA(AO ao,PetscInt n,PetscReal ia[])
 {
+  PetscFunctionBegin;
+  SETERRQ(((PetscObject)ao)->comm,PETSC_ERR_SUP,"Permutation of arrays not supported");
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "AOView_IGA"
+static PetscErrorCode AOView_IGA(AO ao,PetscViewer viewer)
+{
+  AO_IGA         *aoiga = (AO_IGA*)ao->data;
+  PetscBool      isascii;
   PetscErrorCode ierr;
   PetscFunctionBegin;
-  PetscValidPointer(g,1);
-  PetscValidPointer(ao,2);
-  if (!g->ao) {
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&isascii);CHKERRQ(ierr);
+  if (isascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"Analytic ordering: grid %D x %D x %D, processes %D x %D x %D\n",
+                                  aoiga->sizes[0],aoiga->sizes[1],aoiga->sizes[2],
+                                  aoiga->np[0],aoiga->np[1],aoiga->np[2]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "AODestroy_IGA"
+static PetscErrorCode AODestroy_IGA(AO ao)
+{
+  AO_IGA         *aoiga = (AO_IGA*)ao->data;
+  PetscInt       i;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscFree(aoiga->box);CHKERRQ(ierr);
+  ierr = PetscFree(aoiga->offset);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {ierr = PetscFree(aoiga->split[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(aoiga->rank);CHKERRQ(ierr);
+  ierr = PetscFree(aoiga);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Grid_NewAO"
+static PetscErrorCode IGA_Grid_NewAO(IGA_Grid g,AO *ao)
+{
+  AO_IGA         *aoiga;
+  PetscMPIInt    r,size;
+  PetscInt       i,box[6],nbox = 1;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(g->comm,&size);CHKERRQ(ierr);
+  ierr = PetscMalloc(sizeof(AO_IGA),&aoiga);CHKERRQ(ierr);
+  ierr = PetscMemzero(aoiga,sizeof(AO_IGA));CHKERRQ(ierr);
+  aoiga->size = size;
+  for (i=0; i<3; i++) {
+    aoiga->sizes[i] = g->sizes[i];
+    box[i]   = g->local_start[i];
+    box[3+i] = g->local_width[i];
+  }
+  ierr = PetscMalloc(6*size*sizeof(PetscInt),&aoiga->box);CHKERRQ(ierr);
+  ierr = PetscMalloc((size+1)*sizeof(PetscInt),&aoiga->offset);CHKERRQ(ierr);
+  ierr = MPI_Allgather(box,6,MPIU_INT,aoiga->box,6,MPIU_INT,g->comm);CHKERRQ(ierr);
+  for (aoiga->offset[0]=0, r=0; r<size; r++) {
+    const PetscInt *b = aoiga->box + 6*r;
+    aoiga->offset[r+1] = aoiga->offset[r] + b[3]*b[4]*b[5];
+  }
+  /* processor grid from the distinct slab starts along each direction */
+  for (i=0; i<3; i++) {
+    PetscInt n = 0;
+    ierr = PetscMalloc((size+1)*sizeof(PetscInt),&aoiga->split[i]);CHKERRQ(ierr);
+    for (r=0; r<size; r++)
+      if (aoiga->box[6*r+3+i] > 0) aoiga->split[i][n++] = aoiga->box[6*r+i];
+    ierr = PetscSortRemoveDupsInt(&n,aoiga->split[i]);CHKERRQ(ierr);
+    aoiga->split[i][n] = aoiga->sizes[i];
+    aoiga->np[i] = n; nbox *= n;
+  }
+  ierr = PetscMalloc((nbox+1)*sizeof(PetscInt),&aoiga->rank);CHKERRQ(ierr);
+  for (i=0; i<nbox; i++) aoiga->rank[i] = -1;
+  for (r=0; r<size; r++) {
+    const PetscInt *b = aoiga->box + 6*r;
+    PetscInt p;
+    if (!(b[3]*b[4]*b[5])) continue;
+    p = IGA_AO_Locate(aoiga->np[0],aoiga->split[0],b[0])
+      + aoiga->np[0]*(IGA_AO_Locate(aoiga->np[1],aoiga->split[1],b[1])
+      + aoiga->np[1]*IGA_AO_Locate(aoiga->np[2],aoiga->split[2],b[2]));
+    if (aoiga->rank[p] >= 0) break;
+    aoiga->rank[p] = r;
+  }
+  for (i=0; i<nbox; i++) if (aoiga->rank[i] < 0) break;
+  if (r < size || i < nbox) { /* not a Cartesian partition */
     PetscInt napp,*iapp;
+    ierr = PetscFree(aoiga->box);CHKERRQ(ierr);
+    ierr = PetscFree(aoiga->offset);CHKERRQ(ierr);
+    for (i=0; i<3; i++) {ierr = PetscFree(aoiga->split[i]);CHKERRQ(ierr);}
+    ierr = PetscFree(aoiga->rank);CHKERRQ(ierr);
+    ierr = PetscFree(aoiga);CHKERRQ(ierr);
     ierr = IGA_Grid_LocalIndices(g,1,&napp,&iapp);CHKERRQ(ierr);
-    ierr = AOCreateMemoryScalable(g->comm,napp,iapp,NULL,&g->ao);CHKERRQ(ierr);
+    ierr = AOCreateMemoryScalable(g->comm,napp,iapp,NULL,ao);CHKERRQ(ierr);
     ierr = PetscFree(iapp);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
   }
+
+  ierr = AOCreate(g->comm,ao);CHKERRQ(ierr);
+  (*ao)->data = (void*)aoiga;
+  (*ao)->N    = aoiga->offset[size];
+  (*ao)->n    = box[3]*box[4]*box[5];
+  (*ao)->ops->view                          = AOView_IGA;
+  (*ao)->ops->destroy                       = AODestroy_IGA;
+  (*ao)->ops->petsctoapplication            = AOPetscToApplication_IGA;
+  (*ao)->ops->applicationtopetsc            = AOApplicationToPetsc_IGA;
+  (*ao)->ops->petsctoapplicationpermuteint  = AOPermuteInt_IGA;
+  (*ao)->ops->applicationtopetscpermuteint  = AOPermuteInt_IGA;
+  (*ao)->ops->petsctoapplicationpermutereal = AOPermuteReal_IGA;
+  (*ao)->ops->applicationtopetscpermutereal = AOPermuteReal_IGA;
+  ierr = PetscObjectChangeTypeName((PetscObject)*ao,"iga");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Grid_GetAO"
+PetscErrorCode IGA_Grid_GetAO(IGA_Grid g,AO *ao)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(g,1);
+  PetscValidPointer(ao,2);
+  if (!g->ao) {ierr = IGA_Grid_NewAO(g,&g->ao);CHKERRQ(ierr);}
   *ao = g->ao;
   PetscFunctionReturn(0);
 }
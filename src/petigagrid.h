@@ -59,4 +59,19 @@ PETSC_EXTERN PetscErrorCode IGA_Grid_NewScatterApp(IGA_Grid g,
                                                    const PetscInt[],
                                                    Vec*,VecScatter*,VecScatter*);
 
+typedef struct _n_IGA_Halo *IGA_Halo;
+
+PETSC_EXTERN PetscErrorCode IGA_Halo_Create(IGA_Grid,
+                                            const PetscInt[],
+                                            const PetscInt[],
+                                            const PetscBool[],
+                                            IGA_Halo*);
+PETSC_EXTERN PetscErrorCode IGA_Halo_Destroy(IGA_Halo*);
+PETSC_EXTERN PetscErrorCode IGA_Halo_GlobalToLocalBegin(IGA_Halo,Vec,Vec,InsertMode);
+PETSC_EXTERN PetscErrorCode IGA_Halo_GlobalToLocalEnd  (IGA_Halo,Vec,Vec,InsertMode);
+PETSC_EXTERN PetscErrorCode IGA_Halo_LocalToGlobalBegin(IGA_Halo,Vec,Vec,InsertMode);
+PETSC_EXTERN PetscErrorCode IGA_Halo_LocalToGlobalEnd  (IGA_Halo,Vec,Vec,InsertMode);
+PETSC_EXTERN PetscErrorCode IGA_Halo_LocalToLocalBegin (IGA_Halo,Vec,Vec,InsertMode);
+PETSC_EXTERN PetscErrorCode IGA_Halo_LocalToLocalEnd   (IGA_Halo,Vec,Vec,InsertMode);
+
 #endif/*PETIGAGRID_H*/
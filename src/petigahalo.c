@@ -0,0 +1,451 @@
+#include "petigagrid.h"
+#include <petsc-private/petscimpl.h>
+
+/*
+  Structured ghost exchange on a Cartesian processor grid.
+
+  Ranks are laid out lexicographically, rank = i + j*P0 + k*P0*P1, as
+  done by IGA_Partition(). Every process exchanges data only with the
+  (up to 26) processes at offsets {-1,0,+1}^3 in the processor grid.
+  Each message is a box of nodes, packed and unpacked with contiguous
+  copies along the first axis. Messages use persistent MPI requests.
+
+  Boxes are described in the unwrapped coordinates of the local ghosted
+  grid. For a periodic axis, the owned box of a neighbor across the
+  boundary is shifted by the grid size so that it becomes adjacent.
+*/
+
+struct _n_IGA_Halo {
+  MPI_Comm    comm;
+  PetscInt    dof;
+  PetscInt    lstart[3],lwidth[3]; /* owned box   */
+  PetscInt    gstart[3],gwidth[3]; /* ghosted box */
+  PetscInt    nn;                  /* number of neighbor messages */
+  PetscMPIInt *rank;               /* [nn] neighbor ranks */
+  PetscInt    (*sbox)[6];          /* [nn] owned boxes sent to neighbors */
+  PetscInt    (*rbox)[6];          /* [nn] ghost boxes received from neighbors */
+  PetscInt    *soff,*roff;         /* [nn+1] buffer offsets */
+  PetscScalar *sbuf,*rbuf;
+  MPI_Request *fwd;                /* [2*nn] owned -> ghost */
+  MPI_Request *rev;                /* [2*nn] ghost -> owned */
+  PetscInt    active;              /* exchange in flight: 0, 1 (fwd), 2 (rev) */
+};
+
+/* requests and buffers are shared, one exchange at a time */
+#define IGA_HALO_FWD 1
+#define IGA_HALO_REV 2
+
+PETSC_STATIC_INLINE
+PetscErrorCode HaloStart(IGA_Halo h,PetscInt mode)
+{
+  if (PetscUnlikely(h->active))
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Halo exchange already in progress, call the matching End first");
+  h->active = mode;
+  return 0;
+}
+
+PETSC_STATIC_INLINE
+PetscErrorCode HaloFinish(IGA_Halo h,PetscInt mode)
+{
+  if (PetscUnlikely(h->active != mode))
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Halo exchange End without a matching Begin");
+  h->active = 0;
+  return 0;
+}
+
+PETSC_STATIC_INLINE
+PetscInt BoxSize(const PetscInt box[6])
+{
+  return box[3]*box[4]*box[5];
+}
+
+PETSC_STATIC_INLINE
+PetscBool BoxIntersect(const PetscInt astart[3],const PetscInt awidth[3],
+                       const PetscInt bstart[3],const PetscInt bwidth[3],
+                       PetscInt box[6])
+{
+  PetscInt i;
+  for (i=0; i<3; i++) {
+    PetscInt s = PetscMax(astart[i],bstart[i]);
+    PetscInt e = PetscMin(astart[i]+awidth[i],bstart[i]+bwidth[i]);
+    box[i] = s; box[3+i] = PetscMax(e-s,0);
+  }
+  return BoxSize(box) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+/* copy box from array x (laid out over start/width) to buffer b, or back */
+static void BoxPack(PetscInt bs,const PetscInt box[6],
+                    const PetscInt start[3],const PetscInt width[3],
+                    const PetscScalar x[],PetscScalar b[])
+{
+  PetscInt j,k,n = box[3]*bs;
+  for (k=0; k<box[5]; k++)
+    for (j=0; j<box[4]; j++, b += n) {
+      const PetscScalar *xrow = x + bs*((box[0]-start[0]) +
+                                        (box[1]+j-start[1])*width[0] +
+                                        (box[2]+k-start[2])*width[0]*width[1]);
+      (void)PetscMemcpy(b,xrow,n*sizeof(PetscScalar));
+    }
+}
+
+static void BoxUnpack(PetscInt bs,const PetscInt box[6],
+                      const PetscInt start[3],const PetscInt width[3],
+                      const PetscScalar b[],PetscScalar x[],InsertMode addv)
+{
+  PetscInt i,j,k,n = box[3]*bs;
+  for (k=0; k<box[5]; k++)
+    for (j=0; j<box[4]; j++, b += n) {
+      PetscScalar *xrow = x + bs*((box[0]-start[0]) +
+                                  (box[1]+j-start[1])*width[0] +
+                                  (box[2]+k-start[2])*width[0]*width[1]);
+      if (addv == ADD_VALUES)
+        for (i=0; i<n; i++) xrow[i] += b[i];
+      else
+        (void)PetscMemcpy(xrow,b,n*sizeof(PetscScalar));
+    }
+}
+
+/* copy the owned box between arrays laid out over different boxes */
+static void BoxCopy(PetscInt bs,const PetscInt box[6],
+                    const PetscInt xstart[3],const PetscInt xwidth[3],const PetscScalar x[],
+                    const PetscInt ystart[3],const PetscInt ywidth[3],PetscScalar y[],
+                    InsertMode addv)
+{
+  PetscInt i,j,k,n = box[3]*bs;
+  for (k=0; k<box[5]; k++)
+    for (j=0; j<box[4]; j++) {
+      const PetscScalar *xrow = x + bs*((box[0]-xstart[0]) +
+                                        (box[1]+j-xstart[1])*xwidth[0] +
+                                        (box[2]+k-xstart[2])*xwidth[0]*xwidth[1]);
+      PetscScalar *yrow = y + bs*((box[0]-ystart[0]) +
+                                  (box[1]+j-ystart[1])*ywidth[0] +
+                                  (box[2]+k-ystart[2])*ywidth[0]*ywidth[1]);
+      if (addv == ADD_VALUES)
+        for (i=0; i<n; i++) yrow[i] += xrow[i];
+      else
+        (void)PetscMemcpy(yrow,xrow,n*sizeof(PetscScalar));
+    }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_Create"
+/*
+  IGA_Halo_Create - Create a neighbor-only ghost exchange for a grid.
+
+  Returns a NULL halo (on every process) if the ghosted boxes cannot
+  be filled from the immediate neighbors in the processor grid, e.g.
+  when ghost regions are wider than the owned boxes of the neighbors.
+*/
+PetscErrorCode IGA_Halo_Create(IGA_Grid g,
+                               const PetscInt procs[],
+                               const PetscInt ranks[],
+                               const PetscBool periodic[],
+                               IGA_Halo *halo)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(g,1);
+  PetscValidIntPointer(procs,2);
+  PetscValidIntPointer(ranks,3);
+  PetscValidPointer(periodic,4);
+  PetscValidPointer(halo,5);
+  *halo = NULL;
+#if !defined(PETSC_HAVE_MPIUNI)
+  {
+    IGA_Halo    h;
+    MPI_Comm    comm;
+    PetscInt    d[3],i,n,m,nn=0;
+    PetscMPIInt nrank[26],tag[26];
+    PetscInt    shift[26][3],info[26][12],mine[12];
+    MPI_Request req[52];
+    PetscInt    sbox[26][6],rbox[26][6];
+    PetscInt    covered;
+    PetscBool   complete;
+
+    ierr = MPI_Comm_dup(g->comm,&comm);CHKERRQ(ierr);
+
+    /* enumerate neighbors */
+    for (d[2]=-1; d[2]<=1; d[2]++)
+      for (d[1]=-1; d[1]<=1; d[1]++)
+        for (d[0]=-1; d[0]<=1; d[0]++) {
+          PetscInt c[3],r;
+          if (!d[0] && !d[1] && !d[2]) continue;
+          for (i=0; i<3; i++) {
+            c[i] = ranks[i] + d[i]; shift[nn][i] = 0;
+            if (c[i] < 0) {
+              if (!periodic[i]) break;
+              c[i] += procs[i]; shift[nn][i] = -g->sizes[i];
+            } else if (c[i] >= procs[i]) {
+              if (!periodic[i]) break;
+              c[i] -= procs[i]; shift[nn][i] = +g->sizes[i];
+            }
+          }
+          if (i < 3) continue;
+          r = c[0] + c[1]*procs[0] + c[2]*procs[0]*procs[1];
+          nrank[nn] = (PetscMPIInt)r;
+          /* tag of the messages received from this neighbor */
+          tag[nn] = (PetscMPIInt)((d[0]+1) + 3*(d[1]+1) + 9*(d[2]+1));
+          nn++;
+        }
+
+    /* exchange owned and ghosted boxes with neighbors */
+    for (i=0; i<3; i++) {
+      mine[0+i] = g->local_start[i]; mine[3+i] = g->local_width[i];
+      mine[6+i] = g->ghost_start[i]; mine[9+i] = g->ghost_width[i];
+    }
+    for (n=0; n<nn; n++) {
+      PetscMPIInt stag = 26 - tag[n]; /* tag seen by the neighbor */
+      ierr = MPI_Irecv(info[n],12,MPIU_INT,nrank[n],tag[n],comm,&req[n]);CHKERRQ(ierr);
+      ierr = MPI_Isend(mine,12,MPIU_INT,nrank[n],stag,comm,&req[nn+n]);CHKERRQ(ierr);
+    }
+    ierr = MPI_Waitall((PetscMPIInt)(2*nn),req,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+
+    /* intersect boxes */
+    covered = g->local_width[0]*g->local_width[1]*g->local_width[2];
+    for (n=0; n<nn; n++) {
+      PetscInt ostart[3],gstart[3];
+      for (i=0; i<3; i++) {
+        ostart[i] = info[n][0+i] + shift[n][i];
+        gstart[i] = info[n][6+i] + shift[n][i];
+      }
+      (void)BoxIntersect(g->ghost_start,g->ghost_width,ostart,&info[n][3],rbox[n]);
+      (void)BoxIntersect(g->local_start,g->local_width,gstart,&info[n][9],sbox[n]);
+      covered += BoxSize(rbox[n]);
+    }
+    complete = (covered == g->ghost_width[0]*g->ghost_width[1]*g->ghost_width[2]) ? PETSC_TRUE : PETSC_FALSE;
+    ierr = MPI_Allreduce(MPI_IN_PLACE,&complete,1,MPIU_BOOL,MPI_LAND,comm);CHKERRQ(ierr);
+    if (!complete) {ierr = MPI_Comm_free(&comm);CHKERRQ(ierr); PetscFunctionReturn(0);}
+
+    ierr = PetscMalloc(sizeof(*h),&h);CHKERRQ(ierr);
+    ierr = PetscMemzero(h,sizeof(*h));CHKERRQ(ierr);
+    h->comm = comm;
+    h->dof  = g->dof;
+    for (i=0; i<3; i++) {
+      h->lstart[i] = g->local_start[i]; h->lwidth[i] = g->local_width[i];
+      h->gstart[i] = g->ghost_start[i]; h->gwidth[i] = g->ghost_width[i];
+    }
+    /* keep only neighbors with data to exchange */
+    for (h->nn=0, n=0; n<nn; n++)
+      if (BoxSize(sbox[n]) || BoxSize(rbox[n])) h->nn++;
+    ierr = PetscMalloc((h->nn)*sizeof(*h->rank),&h->rank);CHKERRQ(ierr);
+    ierr = PetscMalloc((h->nn)*sizeof(*h->sbox),&h->sbox);CHKERRQ(ierr);
+    ierr = PetscMalloc((h->nn)*sizeof(*h->rbox),&h->rbox);CHKERRQ(ierr);
+    ierr = PetscMalloc((h->nn+1)*sizeof(*h->soff),&h->soff);CHKERRQ(ierr);
+    ierr = PetscMalloc((h->nn+1)*sizeof(*h->roff),&h->roff);CHKERRQ(ierr);
+    ierr = PetscMalloc((2*h->nn)*sizeof(*h->fwd),&h->fwd);CHKERRQ(ierr);
+    ierr = PetscMalloc((2*h->nn)*sizeof(*h->rev),&h->rev);CHKERRQ(ierr);
+    h->soff[0] = h->roff[0] = 0;
+    {
+      PetscMPIInt *rtag;
+      ierr = PetscMalloc((h->nn)*sizeof(*rtag),&rtag);CHKERRQ(ierr);
+      for (m=0, n=0; n<nn; n++) {
+        if (!BoxSize(sbox[n]) && !BoxSize(rbox[n])) continue;
+        h->rank[m] = nrank[n];
+        rtag[m] = tag[n];
+        ierr = PetscMemcpy(h->sbox[m],sbox[n],sizeof(sbox[n]));CHKERRQ(ierr);
+        ierr = PetscMemcpy(h->rbox[m],rbox[n],sizeof(rbox[n]));CHKERRQ(ierr);
+        h->soff[m+1] = h->soff[m] + h->dof*BoxSize(sbox[n]);
+        h->roff[m+1] = h->roff[m] + h->dof*BoxSize(rbox[n]);
+        m++;
+      }
+      ierr = PetscMalloc((h->soff[h->nn])*sizeof(*h->sbuf),&h->sbuf);CHKERRQ(ierr);
+      ierr = PetscMalloc((h->roff[h->nn])*sizeof(*h->rbuf),&h->rbuf);CHKERRQ(ierr);
+      for (n=0; n<h->nn; n++) {
+        PetscMPIInt stag = 26 - rtag[n];
+        PetscMPIInt scount = (PetscMPIInt)(h->soff[n+1]-h->soff[n]);
+        PetscMPIInt rcount = (PetscMPIInt)(h->roff[n+1]-h->roff[n]);
+        PetscScalar *sbuf = h->sbuf + h->soff[n];
+        PetscScalar *rbuf = h->rbuf + h->roff[n];
+        /* forward: owned data to neighbor ghosts */
+        ierr = MPI_Send_init(sbuf,scount,MPIU_SCALAR,h->rank[n],stag,comm,&h->fwd[n]);CHKERRQ(ierr);
+        ierr = MPI_Recv_init(rbuf,rcount,MPIU_SCALAR,h->rank[n],rtag[n],comm,&h->fwd[h->nn+n]);CHKERRQ(ierr);
+        /* reverse: ghost data back to neighbor owners */
+        ierr = MPI_Send_init(rbuf,rcount,MPIU_SCALAR,h->rank[n],27+stag,comm,&h->rev[n]);CHKERRQ(ierr);
+        ierr = MPI_Recv_init(sbuf,scount,MPIU_SCALAR,h->rank[n],27+rtag[n],comm,&h->rev[h->nn+n]);CHKERRQ(ierr);
+      }
+      ierr = PetscFree(rtag);CHKERRQ(ierr);
+    }
+    *halo = h;
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_Destroy"
+PetscErrorCode IGA_Halo_Destroy(IGA_Halo *halo)
+{
+  IGA_Halo       h;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(halo,1);
+  h = *halo; *halo = NULL;
+  if (!h) PetscFunctionReturn(0);
+  if (h->active) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot destroy a halo with an exchange in progress");
+#if !defined(PETSC_HAVE_MPIUNI)
+  {
+    PetscInt n;
+    for (n=0; n<2*h->nn; n++) {
+      ierr = MPI_Request_free(&h->fwd[n]);CHKERRQ(ierr);
+      ierr = MPI_Request_free(&h->rev[n]);CHKERRQ(ierr);
+    }
+  }
+  ierr = MPI_Comm_free(&h->comm);CHKERRQ(ierr);
+#endif
+  ierr = PetscFree(h->rank);CHKERRQ(ierr);
+  ierr = PetscFree(h->sbox);CHKERRQ(ierr);
+  ierr = PetscFree(h->rbox);CHKERRQ(ierr);
+  ierr = PetscFree(h->soff);CHKERRQ(ierr);
+  ierr = PetscFree(h->roff);CHKERRQ(ierr);
+  ierr = PetscFree(h->sbuf);CHKERRQ(ierr);
+  ierr = PetscFree(h->rbuf);CHKERRQ(ierr);
+  ierr = PetscFree(h->fwd);CHKERRQ(ierr);
+  ierr = PetscFree(h->rev);CHKERRQ(ierr);
+  ierr = PetscFree(h);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_UpdateBegin"
+static PetscErrorCode IGA_Halo_UpdateBegin(IGA_Halo h,
+                                           const PetscInt xstart[3],const PetscInt xwidth[3],
+                                           Vec x,Vec y,InsertMode addv)
+{
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscInt          n;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  ierr = HaloStart(h,IGA_HALO_FWD);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(x,&xx);CHKERRQ(ierr);
+  for (n=0; n<h->nn; n++)
+    BoxPack(h->dof,h->sbox[n],xstart,xwidth,xx,h->sbuf+h->soff[n]);
+  if (h->nn) {ierr = MPI_Startall((PetscMPIInt)(2*h->nn),h->fwd);CHKERRQ(ierr);}
+  if (x != y) {
+    PetscInt box[6];
+    (void)BoxIntersect(h->lstart,h->lwidth,h->lstart,h->lwidth,box);
+    ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+    BoxCopy(h->dof,box,xstart,xwidth,xx,h->gstart,h->gwidth,yy,addv);
+    ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(x,&xx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_UpdateEnd"
+static PetscErrorCode IGA_Halo_UpdateEnd(IGA_Halo h,Vec y,InsertMode addv)
+{
+  PetscScalar    *yy;
+  PetscInt       n;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = HaloFinish(h,IGA_HALO_FWD);CHKERRQ(ierr);
+  if (h->nn) {ierr = MPI_Waitall((PetscMPIInt)(2*h->nn),h->fwd,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+  for (n=0; n<h->nn; n++)
+    BoxUnpack(h->dof,h->rbox[n],h->gstart,h->gwidth,h->rbuf+h->roff[n],yy,addv);
+  ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_GlobalToLocalBegin"
+PetscErrorCode IGA_Halo_GlobalToLocalBegin(IGA_Halo h,Vec gvec,Vec lvec,InsertMode addv)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
+  ierr = IGA_Halo_UpdateBegin(h,h->lstart,h->lwidth,gvec,lvec,addv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_GlobalToLocalEnd"
+PetscErrorCode IGA_Halo_GlobalToLocalEnd(IGA_Halo h,Vec gvec,Vec lvec,InsertMode addv)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
+  ierr = IGA_Halo_UpdateEnd(h,lvec,addv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_LocalToLocalBegin"
+PetscErrorCode IGA_Halo_LocalToLocalBegin(IGA_Halo h,Vec lvec1,Vec lvec2,InsertMode addv)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(lvec1,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(lvec2,VEC_CLASSID,3);
+  ierr = IGA_Halo_UpdateBegin(h,h->gstart,h->gwidth,lvec1,lvec2,addv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_LocalToLocalEnd"
+PetscErrorCode IGA_Halo_LocalToLocalEnd(IGA_Halo h,Vec lvec1,Vec lvec2,InsertMode addv)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(lvec1,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(lvec2,VEC_CLASSID,3);
+  ierr = IGA_Halo_UpdateEnd(h,lvec2,addv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_LocalToGlobalBegin"
+PetscErrorCode IGA_Halo_LocalToGlobalBegin(IGA_Halo h,Vec lvec,Vec gvec,InsertMode addv)
+{
+  const PetscScalar *ll;
+  PetscScalar       *gg;
+  PetscInt          n,box[6];
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(lvec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(gvec,VEC_CLASSID,3);
+  if (addv != INSERT_VALUES && addv != ADD_VALUES) SETERRQ(h->comm,PETSC_ERR_SUP,"Not yet implemented");
+  ierr = VecGetArrayRead(lvec,&ll);CHKERRQ(ierr);
+  if (addv == ADD_VALUES) {
+    ierr = HaloStart(h,IGA_HALO_REV);CHKERRQ(ierr);
+    for (n=0; n<h->nn; n++)
+      BoxPack(h->dof,h->rbox[n],h->gstart,h->gwidth,ll,h->rbuf+h->roff[n]);
+    if (h->nn) {ierr = MPI_Startall((PetscMPIInt)(2*h->nn),h->rev);CHKERRQ(ierr);}
+  }
+  (void)BoxIntersect(h->lstart,h->lwidth,h->lstart,h->lwidth,box);
+  ierr = VecGetArray(gvec,&gg);CHKERRQ(ierr);
+  BoxCopy(h->dof,box,h->gstart,h->gwidth,ll,h->lstart,h->lwidth,gg,addv);
+  ierr = VecRestoreArray(gvec,&gg);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(lvec,&ll);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Halo_LocalToGlobalEnd"
+PetscErrorCode IGA_Halo_LocalToGlobalEnd(IGA_Halo h,Vec lvec,Vec gvec,InsertMode addv)
+{
+  PetscScalar    *gg;
+  PetscInt       n;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(h,1);
+  PetscValidHeaderSpecific(lvec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(gvec,VEC_CLASSID,3);
+  if (addv != ADD_VALUES) PetscFunctionReturn(0);
+  ierr = HaloFinish(h,IGA_HALO_REV);CHKERRQ(ierr);
+  if (h->nn) {ierr = MPI_Waitall((PetscMPIInt)(2*h->nn),h->rev,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  ierr = VecGetArray(gvec,&gg);CHKERRQ(ierr);
+  for (n=0; n<h->nn; n++)
+    BoxUnpack(h->dof,h->sbox[n],h->lstart,h->lwidth,h->sbuf+h->soff[n],gg,ADD_VALUES);
+  ierr = VecRestoreArray(gvec,&gg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
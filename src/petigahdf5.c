@@ -0,0 +1,627 @@
+#include "petiga.h"
+#include "petigagrid.h"
+
+#if defined(PETSC_HAVE_HDF5)
+#include <petscviewerhdf5.h>
+
+extern PetscReal IGA_Greville(PetscInt i,PetscInt p,const PetscReal U[]);
+
+/*
+  HDF5 file layout:
+
+    /iga                 attributes: dim, dof
+    /iga/knots<i>        knot vector of axis i, attributes: degree, periodic
+    /iga/greville<i>     Greville abscissae of axis i (length 1 for i >= dim)
+    /iga/geometry        homogeneous control points [G2][G1][G0][nsd+1]
+    /iga/points          control point coordinates  [G2][G1][G0][3]
+    /iga/property        property values            [G2][G1][G0][npd]
+    /fields/<name>       field values [N2][N1][N0][dof], or [T][N2][N1][N0][dof]
+                         when the viewer has a timestep set (time series)
+    /time                physical time of each step [T] (IGASaveVecTime)
+
+  Every array is stored in natural ordering as a multidimensional
+  dataset; each process writes or reads the hyperslab of its owned box
+  collectively, straight from/to the global vector array. Datasets are
+  chunked, and -iga_hdf5_compress <level> enables deflate compression.
+  An XDMF file <name>.xmf is rewritten next to the HDF5 file after
+  every save, describing the mesh and every field (and time step).
+  Small replicated arrays are written by the first process only.
+*/
+
+#define IGACHKH5(e) do { \
+    if ((e) < 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in HDF5 call"); \
+  } while (0)
+
+#if defined(PETSC_USE_REAL_SINGLE)
+#define IGA_H5T_REAL H5T_NATIVE_FLOAT
+#else
+#define IGA_H5T_REAL H5T_NATIVE_DOUBLE
+#endif
+#if defined(PETSC_USE_64BIT_INDICES)
+#define IGA_H5T_INT H5T_NATIVE_LLONG
+#else
+#define IGA_H5T_INT H5T_NATIVE_INT
+#endif
+#if defined(PETSC_USE_COMPLEX)
+#define IGA_H5_NCOMP 2
+#else
+#define IGA_H5_NCOMP 1
+#endif
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5GetGroup"
+static PetscErrorCode IGA_H5GetGroup(hid_t file,const char name[],hid_t *group)
+{
+  htri_t exists;
+  PetscFunctionBegin;
+  exists = H5Lexists(file,name,H5P_DEFAULT);IGACHKH5(exists);
+  if (exists) *group = H5Gopen2(file,name,H5P_DEFAULT);
+  else        *group = H5Gcreate2(file,name,H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  IGACHKH5(*group);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5WriteAttribute"
+static PetscErrorCode IGA_H5WriteAttribute(hid_t obj,const char name[],PetscInt value)
+{
+  hid_t  space,attr;
+  htri_t exists;
+  herr_t status;
+  PetscFunctionBegin;
+  exists = H5Aexists(obj,name);IGACHKH5(exists);
+  if (exists) {status = H5Adelete(obj,name);IGACHKH5(status);}
+  space = H5Screate(H5S_SCALAR);IGACHKH5(space);
+  attr = H5Acreate2(obj,name,IGA_H5T_INT,space,H5P_DEFAULT,H5P_DEFAULT);IGACHKH5(attr);
+  status = H5Awrite(attr,IGA_H5T_INT,&value);IGACHKH5(status);
+  status = H5Aclose(attr);IGACHKH5(status);
+  status = H5Sclose(space);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5WriteRoot"
+/* write the selection of filespace from the first process only; the
+   other processes take part in the collective call with no data */
+static PetscErrorCode IGA_H5WriteRoot(MPI_Comm comm,hid_t dset,hid_t memspace,hid_t filespace,const PetscReal a[])
+{
+  PetscMPIInt    rank;
+  hid_t          plist;
+  herr_t         status;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (rank) {
+    status = H5Sselect_none(memspace);IGACHKH5(status);
+    status = H5Sselect_none(filespace);IGACHKH5(status);
+  }
+  plist = H5Pcreate(H5P_DATASET_XFER);IGACHKH5(plist);
+#if defined(PETSC_HAVE_H5PSET_FAPL_MPIO)
+  status = H5Pset_dxpl_mpio(plist,H5FD_MPIO_COLLECTIVE);IGACHKH5(status);
+#endif
+  status = H5Dwrite(dset,IGA_H5T_REAL,memspace,filespace,plist,a);IGACHKH5(status);
+  status = H5Pclose(plist);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5WriteArray"
+/* small replicated 1D array */
+static PetscErrorCode IGA_H5WriteArray(MPI_Comm comm,hid_t loc,const char name[],PetscInt n,const PetscReal a[])
+{
+  hsize_t        dims[1];
+  hid_t          space,memspace,dset;
+  htri_t         exists;
+  herr_t         status;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  exists = H5Lexists(loc,name,H5P_DEFAULT);IGACHKH5(exists);
+  if (exists) {status = H5Ldelete(loc,name,H5P_DEFAULT);IGACHKH5(status);}
+  dims[0] = (hsize_t)n;
+  space = H5Screate_simple(1,dims,NULL);IGACHKH5(space);
+  memspace = H5Screate_simple(1,dims,NULL);IGACHKH5(memspace);
+  dset = H5Dcreate2(loc,name,IGA_H5T_REAL,space,H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);IGACHKH5(dset);
+  ierr = IGA_H5WriteRoot(comm,dset,memspace,space,a);CHKERRQ(ierr);
+  status = H5Dclose(dset);IGACHKH5(status);
+  status = H5Sclose(memspace);IGACHKH5(status);
+  status = H5Sclose(space);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5WriteTime"
+/* physical time of a step, in the extendible dataset /time */
+static PetscErrorCode IGA_H5WriteTime(MPI_Comm comm,hid_t file,PetscInt step,PetscReal time)
+{
+  hsize_t        dims[1],maxdims[1],chunk[1],start[1],count[1];
+  hid_t          space,memspace,dset,plist;
+  htri_t         exists;
+  herr_t         status;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  dims[0] = (hsize_t)step+1; maxdims[0] = H5S_UNLIMITED; chunk[0] = 64;
+  exists = H5Lexists(file,"/time",H5P_DEFAULT);IGACHKH5(exists);
+  if (exists) {
+    hsize_t cdims[1];
+    dset = H5Dopen2(file,"/time",H5P_DEFAULT);IGACHKH5(dset);
+    space = H5Dget_space(dset);IGACHKH5(space);
+    status = H5Sget_simple_extent_dims(space,cdims,NULL);IGACHKH5(status);
+    status = H5Sclose(space);IGACHKH5(status);
+    if (cdims[0] < dims[0]) {status = H5Dset_extent(dset,dims);IGACHKH5(status);}
+  } else {
+    plist = H5Pcreate(H5P_DATASET_CREATE);IGACHKH5(plist);
+    status = H5Pset_chunk(plist,1,chunk);IGACHKH5(status);
+    space = H5Screate_simple(1,dims,maxdims);IGACHKH5(space);
+    dset = H5Dcreate2(file,"/time",IGA_H5T_REAL,space,H5P_DEFAULT,plist,H5P_DEFAULT);IGACHKH5(dset);
+    status = H5Sclose(space);IGACHKH5(status);
+    status = H5Pclose(plist);IGACHKH5(status);
+  }
+  start[0] = (hsize_t)step; count[0] = 1;
+  space = H5Dget_space(dset);IGACHKH5(space);
+  status = H5Sselect_hyperslab(space,H5S_SELECT_SET,start,NULL,count,NULL);IGACHKH5(status);
+  memspace = H5Screate_simple(1,count,NULL);IGACHKH5(memspace);
+  ierr = IGA_H5WriteRoot(comm,dset,memspace,space,&time);CHKERRQ(ierr);
+  status = H5Sclose(memspace);IGACHKH5(status);
+  status = H5Sclose(space);IGACHKH5(status);
+  status = H5Dclose(dset);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5BoxIO"
+/*
+  Collective write/read of the owned box of a global vector to/from
+  dataset 'name', with dimensions [T][S2][S1][S0][bs][ncomp] in C
+  order. The leading time dimension is present (and unlimited) only
+  when step >= 0.
+*/
+static PetscErrorCode IGA_H5BoxIO(IGA iga,hid_t loc,const char name[],
+                                  PetscInt bs,const PetscInt sizes[],
+                                  const PetscInt lstart[],const PetscInt lwidth[],
+                                  PetscInt step,PetscScalar array[],PetscBool write)
+{
+  MPI_Comm       comm = ((PetscObject)iga)->comm;
+  hsize_t        dims[6],maxdims[6],chunk[6],start[6],count[6];
+  hid_t          filespace,memspace,dset,plist;
+  htri_t         exists;
+  herr_t         status;
+  int            i,rank = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (step >= 0) {
+    dims[rank] = (hsize_t)step+1; maxdims[rank] = H5S_UNLIMITED;
+    chunk[rank] = 1; start[rank] = (hsize_t)step; count[rank] = 1; rank++;
+  }
+  for (i=2; i>=0; i--, rank++) {
+    PetscInt width = (i < iga->dim) ? lwidth[i] : 1, wmax;
+    ierr = MPI_Allreduce(&width,&wmax,1,MPIU_INT,MPI_MAX,comm);CHKERRQ(ierr);
+    dims[rank]  = maxdims[rank] = (i < iga->dim) ? (hsize_t)sizes[i] : 1;
+    chunk[rank] = (hsize_t)wmax;
+    start[rank] = (i < iga->dim) ? (hsize_t)lstart[i] : 0;
+    count[rank] = (hsize_t)width;
+  }
+  dims[rank] = maxdims[rank] = chunk[rank] = count[rank] = (hsize_t)bs; start[rank] = 0; rank++;
+  if (IGA_H5_NCOMP > 1) {
+    dims[rank] = maxdims[rank] = chunk[rank] = count[rank] = IGA_H5_NCOMP; start[rank] = 0; rank++;
+  }
+
+  exists = H5Lexists(loc,name,H5P_DEFAULT);IGACHKH5(exists);
+  if (exists) {
+    dset = H5Dopen2(loc,name,H5P_DEFAULT);IGACHKH5(dset);
+    if (write && step >= 0) {
+      hsize_t cdims[6];
+      filespace = H5Dget_space(dset);IGACHKH5(filespace);
+      status = H5Sget_simple_extent_dims(filespace,cdims,NULL);IGACHKH5(status);
+      status = H5Sclose(filespace);IGACHKH5(status);
+      if (cdims[0] < dims[0]) {status = H5Dset_extent(dset,dims);IGACHKH5(status);}
+    }
+  } else {
+    const char *prefix = NULL;
+    PetscInt   level = 0;
+    if (!write) SETERRQ1(comm,PETSC_ERR_FILE_UNEXPECTED,"Dataset %s not found in HDF5 file",name);
+    ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(prefix,"-iga_hdf5_compress",&level,NULL);CHKERRQ(ierr);
+    plist = H5Pcreate(H5P_DATASET_CREATE);IGACHKH5(plist);
+    status = H5Pset_chunk(plist,rank,chunk);IGACHKH5(status);
+    if (level > 0) {
+#if H5_VERSION_GE(1,10,2)
+      status = H5Pset_deflate(plist,(unsigned)PetscMin(level,9));IGACHKH5(status);
+#else
+      ierr = PetscInfo(iga,"HDF5 older than 1.10.2 cannot compress in parallel, ignoring -iga_hdf5_compress\n");CHKERRQ(ierr);
+#endif
+    }
+    filespace = H5Screate_simple(rank,dims,maxdims);IGACHKH5(filespace);
+    dset = H5Dcreate2(loc,name,IGA_H5T_REAL,filespace,H5P_DEFAULT,plist,H5P_DEFAULT);IGACHKH5(dset);
+    status = H5Sclose(filespace);IGACHKH5(status);
+    status = H5Pclose(plist);IGACHKH5(status);
+  }
+
+  filespace = H5Dget_space(dset);IGACHKH5(filespace);
+  if (!write) {
+    hsize_t cdims[6];
+    int     crank = H5Sget_simple_extent_ndims(filespace);IGACHKH5(crank);
+    if (crank != rank) SETERRQ1(comm,PETSC_ERR_FILE_UNEXPECTED,"Dataset %s has wrong dimensions",name);
+    status = H5Sget_simple_extent_dims(filespace,cdims,NULL);IGACHKH5(status);
+    for (i=(step>=0)?1:0; i<rank; i++)
+      if (cdims[i] != dims[i]) SETERRQ1(comm,PETSC_ERR_FILE_UNEXPECTED,"Dataset %s has wrong dimensions",name);
+    if (step >= 0 && cdims[0] <= (hsize_t)step)
+      SETERRQ2(comm,PETSC_ERR_FILE_UNEXPECTED,"Dataset %s has no timestep %D",name,step);
+  }
+  status = H5Sselect_hyperslab(filespace,H5S_SELECT_SET,start,NULL,count,NULL);IGACHKH5(status);
+  memspace = H5Screate_simple(rank,count,NULL);IGACHKH5(memspace);
+  plist = H5Pcreate(H5P_DATASET_XFER);IGACHKH5(plist);
+#if defined(PETSC_HAVE_H5PSET_FAPL_MPIO)
+  status = H5Pset_dxpl_mpio(plist,H5FD_MPIO_COLLECTIVE);IGACHKH5(status);
+#endif
+  if (write) {status = H5Dwrite(dset,IGA_H5T_REAL,memspace,filespace,plist,array);IGACHKH5(status);}
+  else       {status = H5Dread (dset,IGA_H5T_REAL,memspace,filespace,plist,array);IGACHKH5(status);}
+  status = H5Pclose(plist);IGACHKH5(status);
+  status = H5Sclose(memspace);IGACHKH5(status);
+  status = H5Sclose(filespace);IGACHKH5(status);
+  status = H5Dclose(dset);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5WriteMesh"
+static PetscErrorCode IGA_H5WriteMesh(IGA iga,hid_t file)
+{
+  MPI_Comm       comm = ((PetscObject)iga)->comm;
+  hid_t          group;
+  herr_t         status;
+  PetscInt       i,a;
+  char           name[64];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = IGA_H5GetGroup(file,"/iga",&group);CHKERRQ(ierr);
+  ierr = IGA_H5WriteAttribute(group,"dim",iga->dim);CHKERRQ(ierr);
+  ierr = IGA_H5WriteAttribute(group,"dof",iga->dof);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {
+    PetscInt  n = (i < iga->dim) ? iga->node_sizes[i] : 1;
+    PetscReal *G;
+    ierr = PetscMalloc1(n,&G);CHKERRQ(ierr);
+    if (i < iga->dim) {
+      IGAAxis axis = iga->axis[i];
+      for (a=0; a<n; a++) G[a] = IGA_Greville(a,axis->p,axis->U);
+    } else G[0] = 0.0;
+    ierr = PetscSNPrintf(name,sizeof(name),"greville%D",i);CHKERRQ(ierr);
+    ierr = IGA_H5WriteArray(comm,group,name,n,G);CHKERRQ(ierr);
+    ierr = PetscFree(G);CHKERRQ(ierr);
+  }
+  for (i=0; i<iga->dim; i++) {
+    IGAAxis axis = iga->axis[i];
+    hid_t   dset;
+    ierr = PetscSNPrintf(name,sizeof(name),"knots%D",i);CHKERRQ(ierr);
+    ierr = IGA_H5WriteArray(comm,group,name,axis->m+1,axis->U);CHKERRQ(ierr);
+    dset = H5Dopen2(group,name,H5P_DEFAULT);IGACHKH5(dset);
+    ierr = IGA_H5WriteAttribute(dset,"degree",axis->p);CHKERRQ(ierr);
+    ierr = IGA_H5WriteAttribute(dset,"periodic",(PetscInt)axis->periodic);CHKERRQ(ierr);
+    status = H5Dclose(dset);IGACHKH5(status);
+  }
+  status = H5Gclose(group);IGACHKH5(status);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_XDMFWriteItem"
+static PetscErrorCode IGA_XDMFWriteItem(FILE *fp,const char h5name[],const char dset[],
+                                        PetscInt step,PetscInt nsteps,const hsize_t dims[],PetscInt ndims)
+{
+  PetscInt       i;
+  const char     *type = "Float";
+  int            prec = (int)sizeof(PetscReal);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (step < 0) {
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"        <DataItem Dimensions=\"");CHKERRQ(ierr);
+    for (i=0; i<ndims; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"%s%D",i?" ":"",(PetscInt)dims[i]);CHKERRQ(ierr);}
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"\" NumberType=\"%s\" Precision=\"%d\" Format=\"HDF\">%s:%s</DataItem>\n",type,prec,h5name,dset);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"        <DataItem ItemType=\"HyperSlab\" Dimensions=\"");CHKERRQ(ierr);
+  for (i=0; i<ndims; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"%s%D",i?" ":"",(PetscInt)dims[i]);CHKERRQ(ierr);}
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"\">\n          <DataItem Dimensions=\"3 %D\" Format=\"XML\">%D",ndims+1,step);CHKERRQ(ierr);
+  for (i=0; i<ndims; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp," 0");CHKERRQ(ierr);}
+  for (i=0; i<ndims+1; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp," 1");CHKERRQ(ierr);}
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp," 1");CHKERRQ(ierr);
+  for (i=0; i<ndims; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp," %D",(PetscInt)dims[i]);CHKERRQ(ierr);}
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"</DataItem>\n          <DataItem Dimensions=\"%D",nsteps);CHKERRQ(ierr);
+  for (i=0; i<ndims; i++) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp," %D",(PetscInt)dims[i]);CHKERRQ(ierr);}
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"\" NumberType=\"%s\" Precision=\"%d\" Format=\"HDF\">%s:%s</DataItem>\n",type,prec,h5name,dset);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"        </DataItem>\n");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_XDMFWrite"
+/*
+  Rewrite the XDMF sidecar from the contents of the HDF5 file. With the
+  MPI-IO driver opening groups and datasets is collective, so every
+  process queries the dataset shapes and times; only the first process
+  then writes the sidecar.
+*/
+static PetscErrorCode IGA_XDMFWrite(IGA iga,PetscViewer viewer,hid_t file)
+{
+  MPI_Comm       comm = ((PetscObject)iga)->comm;
+  PetscMPIInt    rank;
+  const char     *filename = NULL;
+  char           *h5name,xmfname[PETSC_MAX_PATH_LEN],*base,*dot;
+  hsize_t        mdims[4];
+  PetscInt       i,f,k,nfields = 0,nsteps = 0;
+  char           (*names)[256] = NULL;
+  PetscInt       *tsteps = NULL;
+  PetscInt       ntimes = 0;
+  PetscReal      *times = NULL;
+  PetscBool      points = PETSC_FALSE;
+  FILE           *fp;
+  herr_t         status;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+#if PETSC_VERSION_LT(3,4,0)
+  ierr = PetscViewerFileGetName(viewer,(char**)&filename);CHKERRQ(ierr);
+#else
+  ierr = PetscViewerFileGetName(viewer,&filename);CHKERRQ(ierr);
+#endif
+  if (!filename) PetscFunctionReturn(0);
+  ierr = PetscStrncpy(xmfname,filename,sizeof(xmfname)-4);CHKERRQ(ierr);
+  ierr = PetscStrrchr(xmfname,'/',&base);CHKERRQ(ierr);
+  ierr = PetscStrrchr(base,'.',&dot);CHKERRQ(ierr);
+  if (dot != base) dot[-1] = 0;
+  ierr = PetscStrcat(xmfname,".xmf");CHKERRQ(ierr);
+  ierr = PetscStrrchr(filename,'/',&h5name);CHKERRQ(ierr);
+
+  for (i=0; i<3; i++) mdims[2-i] = (i < iga->dim) ? (hsize_t)iga->node_sizes[i] : 1;
+  mdims[3] = 3;
+  { /* use the control net if it matches the node grid */
+    htri_t exists = H5Lexists(file,"/iga/points",H5P_DEFAULT);IGACHKH5(exists);
+    if (exists) {
+      points = PETSC_TRUE;
+      for (i=0; i<iga->dim; i++)
+        if (iga->geom_sizes[i] != iga->node_sizes[i]) points = PETSC_FALSE;
+    }
+  }
+  { /* collect fields and their number of timesteps */
+    htri_t exists = H5Lexists(file,"/fields",H5P_DEFAULT);IGACHKH5(exists);
+    if (exists) {
+      H5G_info_t info;
+      hid_t      group = H5Gopen2(file,"/fields",H5P_DEFAULT);IGACHKH5(group);
+      status = H5Gget_info(group,&info);IGACHKH5(status);
+      nfields = (PetscInt)info.nlinks;
+      ierr = PetscMalloc(PetscMax(nfields,1)*sizeof(*names),&names);CHKERRQ(ierr);
+      ierr = PetscMalloc1(PetscMax(nfields,1),&tsteps);CHKERRQ(ierr);
+      for (f=0; f<nfields; f++) {
+        hsize_t cdims[6];
+        hid_t   dset,space;
+        int     ndims;
+        ssize_t len = H5Lget_name_by_idx(group,".",H5_INDEX_NAME,H5_ITER_INC,(hsize_t)f,names[f],sizeof(names[f]),H5P_DEFAULT);IGACHKH5(len);
+        dset  = H5Dopen2(group,names[f],H5P_DEFAULT);IGACHKH5(dset);
+        space = H5Dget_space(dset);IGACHKH5(space);
+        ndims = H5Sget_simple_extent_dims(space,cdims,NULL);IGACHKH5(ndims);
+        tsteps[f] = (ndims == 4 + (IGA_H5_NCOMP>1)) ? -1 : (PetscInt)cdims[0];
+        nsteps = PetscMax(nsteps,tsteps[f]);
+        status = H5Sclose(space);IGACHKH5(status);
+        status = H5Dclose(dset);IGACHKH5(status);
+      }
+      status = H5Gclose(group);IGACHKH5(status);
+    }
+  }
+  { /* physical time of the steps saved with IGASaveVecTime() */
+    htri_t exists = H5Lexists(file,"/time",H5P_DEFAULT);IGACHKH5(exists);
+    if (exists) {
+      hsize_t cdims[1];
+      hid_t   dset,space;
+      dset  = H5Dopen2(file,"/time",H5P_DEFAULT);IGACHKH5(dset);
+      space = H5Dget_space(dset);IGACHKH5(space);
+      status = H5Sget_simple_extent_dims(space,cdims,NULL);IGACHKH5(status);
+      ntimes = (PetscInt)cdims[0];
+      ierr = PetscMalloc1(PetscMax(ntimes,1),&times);CHKERRQ(ierr);
+      status = H5Dread(dset,IGA_H5T_REAL,H5S_ALL,H5S_ALL,H5P_DEFAULT,times);IGACHKH5(status);
+      status = H5Sclose(space);IGACHKH5(status);
+      status = H5Dclose(dset);IGACHKH5(status);
+    }
+  }
+
+  if (!rank) { /* sidecar */
+    ierr = PetscFOpen(PETSC_COMM_SELF,xmfname,"w",&fp);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"<?xml version=\"1.0\" ?>\n<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"<Xdmf Version=\"2.0\">\n  <Domain>\n");CHKERRQ(ierr);
+    if (nsteps > 0) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"  <Grid Name=\"IGA\" GridType=\"Collection\" CollectionType=\"Temporal\">\n");CHKERRQ(ierr);}
+    for (k=0; k<PetscMax(nsteps,1); k++) {
+      ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"    <Grid Name=\"IGA\" GridType=\"Uniform\">\n");CHKERRQ(ierr);
+      if (nsteps > 0) { /* the step index when no physical time was saved */
+        double t = (k < ntimes) ? (double)times[k] : (double)k;
+        ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      <Time Value=\"%.16g\"/>\n",t);CHKERRQ(ierr);
+      }
+      ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      <Topology TopologyType=\"%s\" Dimensions=\"%D %D %D\"/>\n",
+                          points?"3DSMesh":"3DRectMesh",(PetscInt)mdims[0],(PetscInt)mdims[1],(PetscInt)mdims[2]);CHKERRQ(ierr);
+      if (points) {
+        ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      <Geometry GeometryType=\"XYZ\">\n");CHKERRQ(ierr);
+        ierr = IGA_XDMFWriteItem(fp,h5name,"/iga/points",-1,0,mdims,4);CHKERRQ(ierr);
+      } else {
+        ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      <Geometry GeometryType=\"VXVYVZ\">\n");CHKERRQ(ierr);
+        for (i=0; i<3; i++) {
+          char dset[32];
+          ierr = PetscSNPrintf(dset,sizeof(dset),"/iga/greville%D",i);CHKERRQ(ierr);
+          ierr = IGA_XDMFWriteItem(fp,h5name,dset,-1,0,&mdims[2-i],1);CHKERRQ(ierr);
+        }
+      }
+      ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      </Geometry>\n");CHKERRQ(ierr);
+      for (f=0; f<nfields; f++) {
+        char    dset[300];
+        hsize_t fdims[4];
+        if (tsteps[f] >= 0 && k >= tsteps[f]) continue;
+        for (i=0; i<3; i++) fdims[i] = mdims[i];
+        fdims[3] = (hsize_t)iga->dof;
+        ierr = PetscSNPrintf(dset,sizeof(dset),"/fields/%s",names[f]);CHKERRQ(ierr);
+        ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      <Attribute Name=\"%s\" AttributeType=\"%s\" Center=\"Node\">\n",
+                            names[f],(iga->dof>1)?"Matrix":"Scalar");CHKERRQ(ierr);
+        ierr = IGA_XDMFWriteItem(fp,h5name,dset,(tsteps[f]>=0)?k:-1,tsteps[f],fdims,4);CHKERRQ(ierr);
+        ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"      </Attribute>\n");CHKERRQ(ierr);
+      }
+      ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"    </Grid>\n");CHKERRQ(ierr);
+    }
+    if (nsteps > 0) {ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"  </Grid>\n");CHKERRQ(ierr);}
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"  </Domain>\n</Xdmf>\n");CHKERRQ(ierr);
+    ierr = PetscFClose(PETSC_COMM_SELF,fp);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree(names);CHKERRQ(ierr);
+  ierr = PetscFree(tsteps);CHKERRQ(ierr);
+  ierr = PetscFree(times);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5SaveGeom"
+/* homogeneous control points (and their coordinates) or property values */
+static PetscErrorCode IGA_H5SaveGeom(IGA iga,hid_t group,PetscBool property)
+{
+  MPI_Comm       comm = ((PetscObject)iga)->comm;
+  PetscInt       bs = property ? iga->property : iga->geometry+1;
+  IGA_Grid       grid;
+  Vec            gvec,lvec;
+  VecScatter     l2g;
+  PetscScalar    *A;
+  PetscInt       n,a,i,pos;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = IGA_Grid_Create(comm,&grid);CHKERRQ(ierr);
+  ierr = IGA_Grid_Init(grid,iga->dim,bs,iga->geom_sizes,
+                       iga->geom_lstart,iga->geom_lwidth,
+                       iga->geom_gstart,iga->geom_gwidth);CHKERRQ(ierr);
+  ierr = IGA_Grid_GetVecGlobal(grid,iga->vectype,&gvec);CHKERRQ(ierr);
+  ierr = IGA_Grid_GetVecLocal (grid,iga->vectype,&lvec);CHKERRQ(ierr);
+  ierr = IGA_Grid_GetScatterL2G(grid,&l2g);CHKERRQ(ierr);
+
+  ierr = VecGetSize(lvec,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(lvec,&A);CHKERRQ(ierr);
+  if (property) {
+    ierr = PetscMemcpy(A,iga->propertyA,n*sizeof(PetscScalar));CHKERRQ(ierr);
+  } else {
+    PetscInt nsd = iga->geometry;
+    for (pos=0,a=0; a<n/bs; a++) {
+      PetscReal w = iga->rationalW[a];
+      for (i=0; i<nsd; i++) A[pos++] = iga->geometryX[i+a*nsd] * ((w != 0.0) ? w : 1.0);
+      A[pos++] = w;
+    }
+  }
+  ierr = VecRestoreArray(lvec,&A);CHKERRQ(ierr);
+  ierr = VecScatterBegin(l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd  (l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+
+  ierr = VecGetArray(gvec,&A);CHKERRQ(ierr);
+  ierr = IGA_H5BoxIO(iga,group,property?"property":"geometry",bs,iga->geom_sizes,
+                     iga->geom_lstart,iga->geom_lwidth,-1,A,PETSC_TRUE);CHKERRQ(ierr);
+  if (!property) {
+    PetscInt    nsd = iga->geometry,m;
+    PetscScalar *X;
+    ierr = VecGetLocalSize(gvec,&m);CHKERRQ(ierr);
+    m /= bs;
+    ierr = PetscMalloc1(3*m,&X);CHKERRQ(ierr);
+    for (a=0; a<m; a++) {
+      PetscReal w = PetscRealPart(A[a*bs+nsd]);
+      for (i=0; i<3; i++) X[3*a+i] = (i < nsd) ? A[a*bs+i]/((w != 0.0) ? w : 1.0) : 0.0;
+    }
+    ierr = IGA_H5BoxIO(iga,group,"points",3,iga->geom_sizes,
+                       iga->geom_lstart,iga->geom_lwidth,-1,X,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = PetscFree(X);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(gvec,&A);CHKERRQ(ierr);
+  ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASave_HDF5"
+PetscErrorCode IGASave_HDF5(IGA iga,PetscViewer viewer)
+{
+  hid_t          file,group;
+  herr_t         status;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerHDF5GetFileId(viewer,&file);CHKERRQ(ierr);
+  ierr = IGA_H5WriteMesh(iga,file);CHKERRQ(ierr);
+  ierr = IGA_H5GetGroup(file,"/iga",&group);CHKERRQ(ierr);
+  if (iga->geometry) {ierr = IGA_H5SaveGeom(iga,group,PETSC_FALSE);CHKERRQ(ierr);}
+  if (iga->property) {ierr = IGA_H5SaveGeom(iga,group,PETSC_TRUE);CHKERRQ(ierr);}
+  status = H5Gclose(group);IGACHKH5(status);
+  ierr = IGA_XDMFWrite(iga,viewer,file);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_H5VecIO"
+static PetscErrorCode IGA_H5VecIO(IGA iga,Vec vec,PetscViewer viewer,const PetscReal *time,PetscBool write)
+{
+  hid_t          file,group;
+  herr_t         status;
+  const char     *name;
+  PetscInt       n,step = -1;
+  PetscScalar    *array;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(vec,&n);CHKERRQ(ierr);
+  if (n != iga->map->n) SETERRQ2(((PetscObject)iga)->comm,PETSC_ERR_ARG_INCOMP,
+                                 "Vector local size %D, expected %D",n,iga->map->n);
+  ierr = PetscObjectGetName((PetscObject)vec,&name);CHKERRQ(ierr);
+  ierr = PetscViewerHDF5GetTimestep(viewer,&step);CHKERRQ(ierr);
+  ierr = PetscViewerHDF5GetFileId(viewer,&file);CHKERRQ(ierr);
+  if (write) {
+    htri_t exists = H5Lexists(file,"/iga",H5P_DEFAULT);IGACHKH5(exists);
+    if (!exists) {ierr = IGA_H5WriteMesh(iga,file);CHKERRQ(ierr);}
+    if (time) {
+      if (step < 0) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,"Set a timestep with PetscViewerHDF5SetTimestep()");
+      ierr = IGA_H5WriteTime(((PetscObject)iga)->comm,file,step,*time);CHKERRQ(ierr);
+    }
+    ierr = IGA_H5GetGroup(file,"/fields",&group);CHKERRQ(ierr);
+  } else {
+    group = H5Gopen2(file,"/fields",H5P_DEFAULT);IGACHKH5(group);
+  }
+  ierr = VecGetArray(vec,&array);CHKERRQ(ierr);
+  ierr = IGA_H5BoxIO(iga,group,name,iga->dof,iga->node_sizes,
+                     iga->node_lstart,iga->node_lwidth,step,array,write);CHKERRQ(ierr);
+  ierr = VecRestoreArray(vec,&array);CHKERRQ(ierr);
+  status = H5Gclose(group);IGACHKH5(status);
+  if (write) {ierr = IGA_XDMFWrite(iga,viewer,file);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASaveVec_HDF5"
+PetscErrorCode IGASaveVec_HDF5(IGA iga,Vec vec,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_H5VecIO(iga,vec,viewer,NULL,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGASaveVecTime_HDF5"
+PetscErrorCode IGASaveVecTime_HDF5(IGA iga,Vec vec,PetscReal time,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_H5VecIO(iga,vec,viewer,&time,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGALoadVec_HDF5"
+PetscErrorCode IGALoadVec_HDF5(IGA iga,Vec vec,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_H5VecIO(iga,vec,viewer,NULL,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#endif
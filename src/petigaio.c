@@ -1,8 +1,23 @@
 #include "petiga.h"
 #include "petigagrid.h"
 
+#if defined(PETSC_HAVE_UNISTD_H) && !defined(PETSC_HAVE_WINDOWS_H)
+#define IGA_HAVE_MMAP 1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
 PETSC_EXTERN PetscErrorCode IGASetUp_Basic(IGA);
-static       PetscErrorCode VecLoad_Binary_SkipHeader(Vec,PetscViewer);
+#if defined(PETSC_HAVE_HDF5)
+PETSC_EXTERN PetscErrorCode IGASave_HDF5(IGA,PetscViewer);
+PETSC_EXTERN PetscErrorCode IGASaveVec_HDF5(IGA,Vec,PetscViewer);
+PETSC_EXTERN PetscErrorCode IGALoadVec_HDF5(IGA,Vec,PetscViewer);
+PETSC_EXTERN PetscErrorCode IGASaveVecTime_HDF5(IGA,Vec,PetscReal,PetscViewer);
+#endif
 
 #undef  __FUNCT__
 #define __FUNCT__ "IGALoad"
@@ -91,6 +106,13 @@ PetscErrorCode IGASave(IGA iga,PetscViewer viewer)
     viewer = PETSC_VIEWER_BINARY_(comm);
     if (!viewer) PetscFunctionReturn(PETSC_ERR_PLIB);
   }
+#if defined(PETSC_HAVE_HDF5)
+  {
+    PetscBool ishdf5;
+    ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERHDF5,&ishdf5);CHKERRQ(ierr);
+    if (ishdf5) {ierr = IGASave_HDF5(iga,viewer);CHKERRQ(ierr); PetscFunctionReturn(0);}
+  }
+#endif
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
   if (!isbinary) SETERRQ(((PetscObject)viewer)->comm,PETSC_ERR_ARG_WRONG,"Only for binary viewers");
   ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
@@ -160,6 +182,282 @@ static PetscErrorCode IGA_NewGridIO(IGA iga,PetscInt bs,IGA_Grid *grid)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_ViewerBinaryGetMPIIO"
+static PetscErrorCode IGA_ViewerBinaryGetMPIIO(PetscViewer viewer,PetscBool *mpiio)
+{
+  PetscFunctionBegin;
+  *mpiio = PETSC_FALSE;
+#if defined(PETSC_HAVE_MPIIO)
+  {
+    PetscErrorCode ierr;
+    ierr = PetscViewerBinaryGetMPIIO(viewer,mpiio);CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_ViewerBinarySetMPIIO"
+static PetscErrorCode IGA_ViewerBinarySetMPIIO(IGA iga,PetscViewer viewer)
+{
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_MPIIO)
+  {
+    PetscErrorCode ierr;
+    const char *prefix = NULL;
+    PetscBool  mpiio = PETSC_TRUE;
+    ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+    ierr = PetscOptionsGetBool(prefix,"-iga_io_mpiio",&mpiio,NULL);CHKERRQ(ierr);
+    if (mpiio) {ierr = PetscViewerBinarySetMPIIO(viewer);CHKERRQ(ierr);}
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MPIIO)
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_BoxIO_MPIIO"
+/*
+  Collective read/write of the box [lstart,lstart+lwidth) of a grid of
+  the given sizes with bs entries of the given type per node, stored in
+  lexicographic order at the current MPI-IO offset of the viewer. Each
+  process sets a file view selecting its own box and all of them access
+  the file at once, with no funneling through rank 0.
+*/
+static PetscErrorCode IGA_BoxIO_MPIIO(PetscViewer viewer,void *array,MPI_Datatype type,
+                                      PetscInt dim,PetscInt bs,
+                                      const PetscInt sizes[],
+                                      const PetscInt lstart[],
+                                      const PetscInt lwidth[],
+                                      PetscBool write)
+{
+  MPI_Comm       comm;
+  MPI_File       mfdes;
+  MPI_Offset     off;
+  MPI_Datatype   node,box;
+  PetscMPIInt    gsizes[3],lsizes[3],starts[3],tsize;
+  PetscInt       i,n = bs,N = bs;
+  double         t,tmax;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  for (i=0; i<dim; i++) { n *= lwidth[i]; N *= sizes[i]; }
+
+  for (i=0; i<3; i++) { gsizes[i] = lsizes[i] = 1; starts[i] = 0; }
+  for (i=0; i<dim; i++) { /* MPI_ORDER_C: last axis runs fastest */
+    gsizes[dim-1-i] = (PetscMPIInt)sizes[i];
+    lsizes[dim-1-i] = (PetscMPIInt)lwidth[i];
+    starts[dim-1-i] = (PetscMPIInt)lstart[i];
+  }
+  ierr = MPI_Type_contiguous((PetscMPIInt)bs,type,&node);CHKERRQ(ierr);
+  if (n > 0) {
+    ierr = MPI_Type_create_subarray(3,gsizes,lsizes,starts,MPI_ORDER_C,node,&box);CHKERRQ(ierr);
+  } else { /* nothing to access on this process */
+    ierr = MPI_Type_contiguous(0,node,&box);CHKERRQ(ierr);
+  }
+  ierr = MPI_Type_commit(&box);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&node);CHKERRQ(ierr);
+
+  ierr = PetscViewerBinaryGetMPIIODescriptor(viewer,&mfdes);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetMPIIOOffset(viewer,&off);CHKERRQ(ierr);
+  ierr = MPI_File_set_view(mfdes,off,type,box,(char*)"native",MPI_INFO_NULL);CHKERRQ(ierr);
+  t = MPI_Wtime();
+  if (write) {
+    ierr = MPIU_File_write_all(mfdes,array,(PetscMPIInt)n,type,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  } else {
+    ierr = MPIU_File_read_all(mfdes,array,(PetscMPIInt)n,type,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  }
+  t = MPI_Wtime() - t;
+  ierr = MPI_Type_size(type,&tsize);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryAddMPIIOOffset(viewer,(MPI_Offset)N*(MPI_Offset)tsize);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&box);CHKERRQ(ierr);
+
+  ierr = MPI_Allreduce(&t,&tmax,1,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+  {
+    double mb = (double)N*(double)tsize/1048576.0;
+    ierr = PetscInfo4(viewer,"MPI-IO %s %g MB in %g sec (%g MB/sec aggregate)\n",
+                      write?"wrote":"read",mb,tmax,(tmax>0.0)?mb/tmax:0.0);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#endif
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_BoxIO_Binary"
+/*
+  Read/write of the box [lstart,lstart+lwidth) through the first
+  process of a plain binary viewer, with bs entries of the given type
+  per node. The boxes of all processes follow from the processor grid,
+  so the first process seeks to each row (or contiguous run of rows)
+  of every box in the natural ordering of the file and ships it to its
+  owner; memory use is bounded by the largest local box and no natural
+  vector or application ordering is involved.
+*/
+static PetscErrorCode IGA_BoxIO_Binary(PetscViewer viewer,void *array,PetscDataType type,
+                                       PetscInt dim,PetscInt bs,
+                                       const PetscInt sizes[],
+                                       const PetscInt lstart[],
+                                       const PetscInt lwidth[],
+                                       PetscBool write)
+{
+  MPI_Comm       comm;
+  MPI_Datatype   mtype;
+  PetscMPIInt    rank,size,tag,r;
+  PetscInt       i,n = bs,N = bs;
+  PetscInt       box[6] = {0,0,0,1,1,1},*boxes = NULL;
+  PetscInt       s[3] = {1,1,1};
+  size_t         tsize;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = PetscDataTypeToMPIDataType(type,&mtype);CHKERRQ(ierr);
+  ierr = PetscDataTypeGetSize(type,&tsize);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(comm,&tag);CHKERRQ(ierr);
+  for (i=0; i<dim; i++) {
+    box[i] = lstart[i]; box[3+i] = lwidth[i]; s[i] = sizes[i];
+    n *= lwidth[i]; N *= sizes[i];
+  }
+  if (!rank) {ierr = PetscMalloc1(6*(size_t)size,&boxes);CHKERRQ(ierr);}
+  ierr = MPI_Gather(box,6,MPIU_INT,boxes,6,MPIU_INT,0,comm);CHKERRQ(ierr);
+
+  if (!rank) {
+    int         fd;
+    off_t       base,pos;
+    PetscInt    nmax = 0;
+    char        *work = NULL;
+    ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+    ierr = PetscBinarySeek(fd,0,PETSC_BINARY_SEEK_CUR,&base);CHKERRQ(ierr);
+    for (r=1; r<size; r++) nmax = PetscMax(nmax,bs*boxes[6*r+3]*boxes[6*r+4]*boxes[6*r+5]);
+    ierr = PetscMalloc((size_t)(nmax+1)*tsize,&work);CHKERRQ(ierr);
+    for (r=0; r<size; r++) {
+      const PetscInt *start = boxes+6*r, *width = boxes+6*r+3;
+      PetscInt    nr = bs*width[0]*width[1]*width[2];
+      PetscInt    run = width[0], nj = width[1], nk = width[2], j, k;
+      char        *buf = r ? work : (char*)array;
+      PetscBool   istemp = r ? PETSC_TRUE : PETSC_FALSE;
+      if (!nr) continue;
+      if (write && r) {ierr = MPI_Recv(buf,(PetscMPIInt)nr,mtype,r,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);}
+      if (width[0] == s[0]) { /* merge contiguous rows */
+        run *= nj; nj = 1;
+        if (width[1] == s[1]) { run *= nk; nk = 1; }
+      }
+      for (k=0; k<nk; k++) {
+        for (j=0; j<nj; j++) {
+          PetscInt g = ((start[2]+k)*s[1] + (start[1]+j))*s[0] + start[0];
+          PetscInt l = (k*width[1] + j)*width[0];
+          off_t    off = base + (off_t)g*(off_t)(bs*tsize);
+          ierr = PetscBinarySeek(fd,off,PETSC_BINARY_SEEK_SET,&pos);CHKERRQ(ierr);
+          if (write) {
+            ierr = PetscBinaryWrite(fd,buf+(size_t)(l*bs)*tsize,run*bs,type,istemp);CHKERRQ(ierr);
+          } else {
+            ierr = PetscBinaryRead(fd,buf+(size_t)(l*bs)*tsize,run*bs,type);CHKERRQ(ierr);
+          }
+        }
+      }
+      if (!write && r) {ierr = MPI_Send(buf,(PetscMPIInt)nr,mtype,r,tag,comm);CHKERRQ(ierr);}
+    }
+    ierr = PetscBinarySeek(fd,base+(off_t)N*(off_t)tsize,PETSC_BINARY_SEEK_SET,&pos);CHKERRQ(ierr);
+    ierr = PetscFree(work);CHKERRQ(ierr);
+    ierr = PetscFree(boxes);CHKERRQ(ierr);
+  } else if (n) {
+    if (write) {
+      ierr = MPI_Send(array,(PetscMPIInt)n,mtype,0,tag,comm);CHKERRQ(ierr);
+    } else {
+      ierr = MPI_Recv(array,(PetscMPIInt)n,mtype,0,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_VecBoxIO"
+/*
+  Read/write of the owned box of a global vector. The file keeps the
+  natural (lexicographic) ordering written by VecView(), and the box
+  of each process follows from the processor grid, so no application
+  ordering and no global-to-natural scatter are needed. A file written
+  on any number of processes can be read back on any other number.
+*/
+static PetscErrorCode IGA_VecBoxIO(Vec vec,PetscInt dim,PetscInt bs,
+                                   const PetscInt sizes[],
+                                   const PetscInt lstart[],
+                                   const PetscInt lwidth[],
+                                   PetscViewer viewer,PetscBool write)
+{
+  MPI_Comm       comm;
+  PetscInt       i,N = bs;
+  PetscBool      skipheader,mpiio;
+  PetscScalar    *array;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
+  ierr = IGA_ViewerBinaryGetMPIIO(viewer,&mpiio);CHKERRQ(ierr);
+  for (i=0; i<dim; i++) N *= sizes[i];
+
+  if (!skipheader) {
+    PetscInt header[2];
+    if (write) {
+      header[0] = VEC_FILE_CLASSID; header[1] = N;
+      ierr = PetscViewerBinaryWrite(viewer,header,2,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerBinaryRead(viewer,header,2,PETSC_INT);CHKERRQ(ierr);
+      if (header[0] != VEC_FILE_CLASSID) SETERRQ(comm,PETSC_ERR_ARG_WRONG,"Not a vector next in file");
+      if (header[1] != N) SETERRQ2(comm,PETSC_ERR_FILE_UNEXPECTED,"Vector in file has size %D, expected %D",header[1],N);
+    }
+  }
+  if (write) {
+    FILE *info = NULL;
+    ierr = PetscViewerBinaryGetInfoPointer(viewer,&info);CHKERRQ(ierr);
+    if (info && bs > 1) {ierr = PetscFPrintf(comm,info,"-vecload_block_size %D\n",bs);CHKERRQ(ierr);}
+  }
+
+  if (write) {ierr = VecGetArrayRead(vec,(const PetscScalar**)&array);CHKERRQ(ierr);}
+  else       {ierr = VecGetArray(vec,&array);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_MPIIO)
+  if (mpiio) {
+    ierr = IGA_BoxIO_MPIIO(viewer,array,MPIU_SCALAR,dim,bs,sizes,lstart,lwidth,write);CHKERRQ(ierr);
+  }
+#endif
+  if (!mpiio) {
+    ierr = IGA_BoxIO_Binary(viewer,array,PETSC_SCALAR,dim,bs,sizes,lstart,lwidth,write);CHKERRQ(ierr);
+  }
+  if (write) {ierr = VecRestoreArrayRead(vec,(const PetscScalar**)&array);CHKERRQ(ierr);}
+  else       {ierr = VecRestoreArray(vec,&array);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_VecLoadBox"
+static PetscErrorCode IGA_VecLoadBox(Vec vec,PetscInt dim,PetscInt bs,
+                                     const PetscInt sizes[],const PetscInt lstart[],const PetscInt lwidth[],
+                                     PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_VecBoxIO(vec,dim,bs,sizes,lstart,lwidth,viewer,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_VecViewBox"
+static PetscErrorCode IGA_VecViewBox(Vec vec,PetscInt dim,PetscInt bs,
+                                     const PetscInt sizes[],const PetscInt lstart[],const PetscInt lwidth[],
+                                     PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_VecBoxIO(vec,dim,bs,sizes,lstart,lwidth,viewer,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGASetGeometryDim"
 /*@
@@ -203,16 +501,277 @@ PetscErrorCode IGAGetGeometryDim(IGA iga,PetscInt *dim)
   PetscFunctionReturn(0);
 }
 
+#if defined(IGA_HAVE_MMAP)
+/*
+  Decoded geometry cache used by -iga_geometry_mmap. The file holds this
+  header followed by the control net in natural ordering, one record
+  [X/w,w] of nsd+1 native PetscReal values per node.
+*/
+#define IGA_GEOMCACHE_MAGIC 0x49474147454F4D31LL /* "IGAGEOM1" */
+typedef struct {
+  long long magic;
+  long long realsize;
+  long long nsd;
+  long long nnodes;
+  long long srcsize;   /* size and modification time of the source file */
+  long long srcmtime;
+  long long srcoffset; /* offset of the control net in the source file */
+  long long reserved;
+  PetscReal wrange[2]; /* minimum and maximum weight */
+} IGA_GeomCache;
+
+static int IGA_WriteAll(int fd,const void *buf,size_t n)
+{
+  const char *p = (const char*)buf;
+  while (n > 0) {
+    ssize_t k = write(fd,p,n);
+    if (k < 0) { if (errno == EINTR) continue; return -1; }
+    p += k; n -= (size_t)k;
+  }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_GeomCacheUpdate"
+/*
+  Make sure cachename holds the decoded control net stored at offset in
+  filename, writing it if it is missing or was built from a different
+  file. The new cache is written to a private temporary file and then
+  renamed, so concurrent runs never see a partial cache. Not collective,
+  failures are returned in status.
+*/
+static PetscErrorCode IGA_GeomCacheUpdate(const char filename[],const char cachename[],long long offset,
+                                          PetscInt nsd,PetscInt nnodes,int *status)
+{
+  struct stat   st;
+  IGA_GeomCache head;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *status = 0;
+  if (stat(filename,&st)) {*status = 1; PetscFunctionReturn(0);}
+  ierr = PetscMemzero(&head,sizeof(head));CHKERRQ(ierr);
+  head.magic     = IGA_GEOMCACHE_MAGIC;
+  head.realsize  = (long long)sizeof(PetscReal);
+  head.nsd       = (long long)nsd;
+  head.nnodes    = (long long)nnodes;
+  head.srcsize   = (long long)st.st_size;
+  head.srcmtime  = (long long)st.st_mtime;
+  head.srcoffset = offset;
+  { /* reuse a cache built from the same file */
+    IGA_GeomCache cached;
+    int fd = open(cachename,O_RDONLY);
+    if (fd >= 0) {
+      ssize_t k = read(fd,&cached,sizeof(cached));
+      (void)close(fd);
+      if (k == (ssize_t)sizeof(cached) &&
+          cached.magic     == head.magic    &&
+          cached.realsize  == head.realsize &&
+          cached.nsd       == head.nsd      &&
+          cached.nnodes    == head.nnodes   &&
+          cached.srcsize   == head.srcsize  &&
+          cached.srcmtime  == head.srcmtime &&
+          cached.srcoffset == head.srcoffset) PetscFunctionReturn(0);
+    }
+  }
+  {
+    char        tmpname[PETSC_MAX_PATH_LEN];
+    long        pgsz = sysconf(_SC_PAGESIZE);
+    off_t       base = (off_t)(offset - offset % pgsz);
+    size_t      len  = (size_t)(offset - (long long)base) + (size_t)nnodes*(size_t)(nsd+1)*sizeof(PetscScalar);
+    int         fd,cfd,failed = 0;
+    void        *addr;
+    const char  *data;
+    PetscScalar Xw[4];
+    PetscReal   buf[4*256],w_min = PETSC_MAX_REAL,w_max = -PETSC_MAX_REAL;
+    PetscInt    a,b,c,nb,bs = nsd+1;
+
+    fd = open(filename,O_RDONLY);
+    if (fd < 0) {*status = 1; PetscFunctionReturn(0);}
+    addr = mmap(NULL,len,PROT_READ,MAP_SHARED,fd,base);
+    (void)close(fd);
+    if (addr == MAP_FAILED) {*status = 2; PetscFunctionReturn(0);}
+    data = (const char*)addr + (offset - (long long)base);
+
+    ierr = PetscSNPrintf(tmpname,sizeof(tmpname),"%s.%d",cachename,(int)getpid());CHKERRQ(ierr);
+    cfd = open(tmpname,O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if (cfd < 0) {(void)munmap(addr,len); *status = 3; PetscFunctionReturn(0);}
+    failed = IGA_WriteAll(cfd,&head,sizeof(head));
+    for (a=0; a<nnodes && !failed; a+=nb) {
+      nb = PetscMin(256,nnodes-a);
+      for (b=0; b<nb; b++) {
+        PetscReal w;
+        ierr = PetscMemcpy(Xw,data+(size_t)(a+b)*bs*sizeof(PetscScalar),bs*sizeof(PetscScalar));CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+        ierr = PetscByteSwap(Xw,PETSC_SCALAR,bs);CHKERRQ(ierr);
+#endif
+        w = PetscRealPart(Xw[nsd]);
+        for (c=0; c<nsd; c++)
+          buf[c+b*bs] = (w != 0.0) ? PetscRealPart(Xw[c])/w : PetscRealPart(Xw[c]);
+        buf[nsd+b*bs] = w;
+        w_min = PetscMin(w_min,w);
+        w_max = PetscMax(w_max,w);
+      }
+      failed = IGA_WriteAll(cfd,buf,(size_t)(nb*bs)*sizeof(PetscReal));
+    }
+    (void)munmap(addr,len);
+    head.wrange[0] = w_min;
+    head.wrange[1] = w_max;
+    if (!failed) failed = (lseek(cfd,0,SEEK_SET) < 0) || IGA_WriteAll(cfd,&head,sizeof(head));
+    if (close(cfd)) failed = 1;
+    if (!failed) failed = rename(tmpname,cachename);
+    if (failed) {(void)unlink(tmpname); *status = 3;}
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_LoadGeometry_MMap"
+/*
+  Load the geometry through a decoded cache of the control net next to
+  the file, <filename>.mmap. The first run that needs it decodes the
+  net once (byte order and homogeneous coordinates) on its first rank.
+  Every process then maps the cache read-only and copies its ghosted
+  box straight into rationalW/geometryX, with periodic wrapping, so no
+  process parses the whole net and the natural->global->local scatters
+  with their temporary vectors are skipped. The mapped pages live in
+  the page cache and are shared by all the processes on a node, across
+  independent runs of an ensemble that read the same file.
+*/
+static PetscErrorCode IGA_LoadGeometry_MMap(IGA iga,PetscViewer viewer)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    rank;
+  int            status = 0,gstatus = 0;
+  PetscBool      skipheader,mpiio;
+  const char     *filename = NULL;
+  char           cachename[PETSC_MAX_PATH_LEN];
+  PetscInt       i,nsd,bs,nnodes;
+  long long      offset = 0;
+  size_t         nbytes;
+  PetscReal      tol_w = 100*PETSC_MACHINE_EPSILON;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
+  ierr = IGA_ViewerBinaryGetMPIIO(viewer,&mpiio);CHKERRQ(ierr);
+#if PETSC_VERSION_LT(3,4,0)
+  ierr = PetscViewerFileGetName(viewer,(char**)&filename);CHKERRQ(ierr);
+#else
+  ierr = PetscViewerFileGetName(viewer,&filename);CHKERRQ(ierr);
+#endif
+  ierr = PetscSNPrintf(cachename,sizeof(cachename),"%s.mmap",filename);CHKERRQ(ierr);
+
+  ierr = IGAGetGeometryDim(iga,&nsd);CHKERRQ(ierr);
+  bs = nsd+1;
+  for (nnodes=1, i=0; i<iga->dim; i++) nnodes *= iga->geom_sizes[i];
+  nbytes = (size_t)nnodes*(size_t)bs*sizeof(PetscScalar);
+
+  /* read the header and skip the data in the viewer */
+  if (!skipheader) {
+    PetscInt header[2];
+    ierr = PetscViewerBinaryRead(viewer,header,2,PETSC_INT);CHKERRQ(ierr);
+    if (header[0] != VEC_FILE_CLASSID) SETERRQ(comm,PETSC_ERR_ARG_WRONG,"Not a vector next in file");
+    if (header[1] != nnodes*bs) SETERRQ2(comm,PETSC_ERR_FILE_UNEXPECTED,"Vector in file has size %D, expected %D",header[1],nnodes*bs);
+  }
+#if defined(PETSC_HAVE_MPIIO)
+  if (mpiio) {
+    MPI_Offset off;
+    ierr = PetscViewerBinaryGetMPIIOOffset(viewer,&off);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryAddMPIIOOffset(viewer,(MPI_Offset)nbytes);CHKERRQ(ierr);
+    offset = (long long)off;
+  }
+#endif
+  if (!mpiio) {
+    if (!rank) {
+      int   fd;
+      off_t pos;
+      ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
+      ierr = PetscBinarySeek(fd,0,PETSC_BINARY_SEEK_CUR,&pos);CHKERRQ(ierr);
+      offset = (long long)pos;
+      ierr = PetscBinarySeek(fd,(off_t)nbytes,PETSC_BINARY_SEEK_CUR,&pos);CHKERRQ(ierr);
+    }
+    ierr = MPI_Bcast(&offset,1,MPI_LONG_LONG_INT,0,comm);CHKERRQ(ierr);
+  }
+
+  /* decode the net once, unless a cache for this file is already there */
+  if (!rank) {ierr = IGA_GeomCacheUpdate(filename,cachename,offset,nsd,nnodes,&status);CHKERRQ(ierr);}
+  ierr = MPI_Bcast(&status,1,MPI_INT,0,comm);CHKERRQ(ierr);
+  if (status == 1) SETERRQ1(comm,PETSC_ERR_FILE_OPEN,"Cannot open file %s for memory mapping",filename);
+  if (status == 2) SETERRQ1(comm,PETSC_ERR_SYS,"Cannot memory map file %s",filename);
+  if (status == 3) SETERRQ1(comm,PETSC_ERR_FILE_WRITE,"Cannot write geometry cache %s",cachename);
+
+  ierr = PetscFree(iga->geometryX);CHKERRQ(ierr);
+  ierr = PetscFree(iga->rationalW);CHKERRQ(ierr);
+  {
+    int                 fd;
+    size_t              len = sizeof(IGA_GeomCache) + (size_t)nnodes*(size_t)bs*sizeof(PetscReal);
+    void                *addr = MAP_FAILED;
+    const IGA_GeomCache *head;
+    const PetscReal     *data;
+    PetscReal           *X,*W;
+    PetscInt            *sizes = iga->geom_sizes;
+    PetscInt            *start = iga->geom_gstart;
+    PetscInt            *width = iga->geom_gwidth;
+    PetscInt            a,c,ia,ja,ka,n = width[0]*width[1]*width[2];
+
+    fd = open(cachename,O_RDONLY);
+    if (fd >= 0) {
+      struct stat st;
+      if (!fstat(fd,&st) && (size_t)st.st_size >= len)
+        addr = mmap(NULL,len,PROT_READ,MAP_SHARED,fd,0);
+      (void)close(fd);
+    }
+    if (addr == MAP_FAILED) status = 1;
+    else {
+      head = (const IGA_GeomCache*)addr;
+      if (head->magic != IGA_GEOMCACHE_MAGIC || head->nsd != nsd || head->nnodes != nnodes) status = 2;
+    }
+    /* every rank learns whether some rank failed before raising the error */
+    ierr = MPI_Allreduce(&status,&gstatus,1,MPI_INT,MPI_MAX,comm);CHKERRQ(ierr);
+    if (gstatus) {
+      if (addr != MAP_FAILED) (void)munmap(addr,len);
+      if (gstatus == 1) SETERRQ1(comm,PETSC_ERR_FILE_OPEN,"Cannot memory map geometry cache %s",cachename);
+      SETERRQ1(comm,PETSC_ERR_FILE_UNEXPECTED,"Geometry cache %s does not match the IGA",cachename);
+    }
+    head = (const IGA_GeomCache*)addr;
+    data = (const PetscReal*)(head + 1);
+
+    ierr = PetscMalloc1(n*nsd,&iga->geometryX);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n,&iga->rationalW);CHKERRQ(ierr);
+    X = iga->geometryX; W = iga->rationalW;
+    for (a=0, ka=start[2]; ka<start[2]+width[2]; ka++) {
+      PetscInt kg = (ka<0) ? sizes[2]+ka : ka % sizes[2];
+      for (ja=start[1]; ja<start[1]+width[1]; ja++) {
+        PetscInt jg = (ja<0) ? sizes[1]+ja : ja % sizes[1];
+        for (ia=start[0]; ia<start[0]+width[0]; ia++, a++) {
+          PetscInt ig = (ia<0) ? sizes[0]+ia : ia % sizes[0];
+          size_t   g  = (size_t)(ig + sizes[0]*(jg + sizes[1]*kg));
+          for (c=0; c<nsd; c++) X[c+a*nsd] = data[c+g*bs];
+          W[a] = data[nsd+g*bs];
+        }
+      }
+    }
+    iga->rational = ((head->wrange[1]-head->wrange[0])>tol_w) ? PETSC_TRUE : PETSC_FALSE;
+    if (munmap(addr,len)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"Cannot unmap file %s",cachename);
+  }
+
+  ierr = PetscInfo2(iga,"Loaded geometry from memory mapped cache %s (%D nodes)\n",cachename,nnodes);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGALoadGeometry"
 PetscErrorCode IGALoadGeometry(IGA iga,PetscViewer viewer)
 {
   PetscBool      isbinary;
-  PetscBool      skipheader;
   PetscInt       nsd;
   PetscReal      min_w,max_w,tol_w = 100*PETSC_MACHINE_EPSILON;
-  Vec            nvec,gvec,lvec;
-  VecScatter     g2n,g2l;
+  Vec            gvec,lvec;
+  VecScatter     g2l;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -223,35 +782,37 @@ PetscErrorCode IGALoadGeometry(IGA iga,PetscViewer viewer)
 
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
   if (!isbinary) SETERRQ(((PetscObject)viewer)->comm,PETSC_ERR_ARG_WRONG,"Only for binary viewers");
-  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
 
   ierr = IGAGetGeometryDim(iga,&nsd);CHKERRQ(ierr);
   if (nsd < 1) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,
                        "Must call IGASetGeometryDim() first");
+  {
+    const char *prefix = NULL;
+    PetscBool  usemmap = PETSC_FALSE;
+    ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+    ierr = PetscOptionsGetBool(prefix,"-iga_geometry_mmap",&usemmap,NULL);CHKERRQ(ierr);
+    if (usemmap) {
+#if defined(IGA_HAVE_MMAP)
+      ierr = IGA_LoadGeometry_MMap(iga,viewer);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+#else
+      SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"-iga_geometry_mmap requires mmap() support");
+#endif
+    }
+  }
   {
     IGA_Grid grid;
     ierr = IGA_NewGridIO(iga,nsd+1,&grid);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetVecNatural(grid,iga->vectype,&nvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecGlobal (grid,iga->vectype,&gvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecLocal  (grid,iga->vectype,&lvec);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetScatterG2N(grid,&g2n);CHKERRQ(ierr);
     ierr = IGA_Grid_GetScatterG2L(grid,&g2l);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)nvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)gvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)lvec);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)g2n);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)g2l);CHKERRQ(ierr);
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
   }
-  /* viewer -> natural*/
-  if (!skipheader) {
-    ierr = VecLoad(nvec,viewer);CHKERRQ(ierr);
-  } else {
-    ierr = VecLoad_Binary_SkipHeader(nvec,viewer);CHKERRQ(ierr);
-  }
-  /* natural -> global */
-  ierr = VecScatterBegin(g2n,nvec,gvec,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-  ierr = VecScatterEnd  (g2n,nvec,gvec,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  /* viewer -> global */
+  ierr = IGA_VecLoadBox(gvec,iga->dim,nsd+1,iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,viewer);CHKERRQ(ierr);
   /* global -> local */
   ierr = VecScatterBegin(g2l,gvec,lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (g2l,gvec,lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -283,11 +844,9 @@ PetscErrorCode IGALoadGeometry(IGA iga,PetscViewer viewer)
     ierr = VecRestoreArrayRead(lvec,&Xw);CHKERRQ(ierr);
   }
 
-  ierr = VecScatterDestroy(&g2n);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&g2l);CHKERRQ(ierr);
   ierr = VecDestroy(&lvec);CHKERRQ(ierr);
   ierr = VecDestroy(&gvec);CHKERRQ(ierr);
-  ierr = VecDestroy(&nvec);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -297,10 +856,9 @@ PetscErrorCode IGALoadGeometry(IGA iga,PetscViewer viewer)
 PetscErrorCode IGASaveGeometry(IGA iga,PetscViewer viewer)
 {
   PetscBool      isbinary;
-  PetscBool      skipheader;
   PetscInt       nsd;
-  Vec            nvec,gvec,lvec;
-  VecScatter     l2g,g2n;
+  Vec            gvec,lvec;
+  VecScatter     l2g;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -312,22 +870,17 @@ PetscErrorCode IGASaveGeometry(IGA iga,PetscViewer viewer)
 
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
   if (!isbinary) SETERRQ(((PetscObject)viewer)->comm,PETSC_ERR_ARG_WRONG,"Only for binary viewers");
-  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
 
   ierr = IGAGetGeometryDim(iga,&nsd);CHKERRQ(ierr);
   {
     IGA_Grid grid;
     ierr = IGA_NewGridIO(iga,nsd+1,&grid);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetVecNatural(grid,iga->vectype,&nvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecGlobal (grid,iga->vectype,&gvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecLocal  (grid,iga->vectype,&lvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetScatterL2G(grid,&l2g);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetScatterG2N(grid,&g2n);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)nvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)gvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)lvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)l2g);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)g2n);CHKERRQ(ierr);
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
   }
   {
@@ -349,17 +902,12 @@ PetscErrorCode IGASaveGeometry(IGA iga,PetscViewer viewer)
   /* local -> global */
   ierr = VecScatterBegin(l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  /* global -> natural */
-  ierr = VecScatterBegin(g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  ierr = VecScatterEnd  (g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  /* natural -> viewer */
-  ierr = VecView(nvec,viewer);CHKERRQ(ierr);
+  /* global -> viewer */
+  ierr = IGA_VecViewBox(gvec,iga->dim,nsd+1,iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,viewer);CHKERRQ(ierr);
 
-  ierr = VecScatterDestroy(&g2n);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&l2g);CHKERRQ(ierr);
   ierr = VecDestroy(&lvec);CHKERRQ(ierr);
   ierr = VecDestroy(&gvec);CHKERRQ(ierr);
-  ierr = VecDestroy(&nvec);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -409,10 +957,9 @@ PetscErrorCode IGAGetPropertyDim(IGA iga,PetscInt *dim)
 PetscErrorCode IGALoadProperty(IGA iga,PetscViewer viewer)
 {
   PetscBool      isbinary;
-  PetscBool      skipheader;
   PetscInt       npd;
-  Vec            nvec,gvec,lvec;
-  VecScatter     g2n,g2l;
+  Vec            gvec,lvec;
+  VecScatter     g2l;
 
   PetscErrorCode ierr;
   PetscFunctionBegin;
@@ -423,7 +970,6 @@ PetscErrorCode IGALoadProperty(IGA iga,PetscViewer viewer)
 
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
   if (!isbinary) SETERRQ(((PetscObject)viewer)->comm,PETSC_ERR_ARG_WRONG,"Only for binary viewers");
-  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
 
   ierr = IGAGetPropertyDim(iga,&npd);CHKERRQ(ierr);
   if (npd < 1) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_WRONGSTATE,
@@ -431,27 +977,16 @@ PetscErrorCode IGALoadProperty(IGA iga,PetscViewer viewer)
   {
     IGA_Grid grid;
     ierr = IGA_NewGridIO(iga,npd,&grid);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetVecNatural(grid,iga->vectype,&nvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecGlobal (grid,iga->vectype,&gvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecLocal  (grid,iga->vectype,&lvec);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetScatterG2N(grid,&g2n);CHKERRQ(ierr);
     ierr = IGA_Grid_GetScatterG2L(grid,&g2l);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)nvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)gvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)lvec);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)g2n);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)g2l);CHKERRQ(ierr);
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
   }
-  /* viewer -> natural*/
-  if (!skipheader) {
-    ierr = VecLoad(nvec,viewer);CHKERRQ(ierr);
-  } else {
-    ierr = VecLoad_Binary_SkipHeader(nvec,viewer);CHKERRQ(ierr);
-  }
-  /* natural -> global */
-  ierr = VecScatterBegin(g2n,nvec,gvec,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-  ierr = VecScatterEnd  (g2n,nvec,gvec,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  /* viewer -> global */
+  ierr = IGA_VecLoadBox(gvec,iga->dim,npd,iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,viewer);CHKERRQ(ierr);
   /* global -> local */
   ierr = VecScatterBegin(g2l,gvec,lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (g2l,gvec,lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -466,11 +1001,9 @@ PetscErrorCode IGALoadProperty(IGA iga,PetscViewer viewer)
     ierr = VecRestoreArrayRead(lvec,&A);CHKERRQ(ierr);
   }
 
-  ierr = VecScatterDestroy(&g2n);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&g2l);CHKERRQ(ierr);
   ierr = VecDestroy(&lvec);CHKERRQ(ierr);
   ierr = VecDestroy(&gvec);CHKERRQ(ierr);
-  ierr = VecDestroy(&nvec);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -480,10 +1013,9 @@ PetscErrorCode IGALoadProperty(IGA iga,PetscViewer viewer)
 PetscErrorCode IGASaveProperty(IGA iga,PetscViewer viewer)
 {
   PetscBool      isbinary;
-  PetscBool      skipheader;
   PetscInt       npd;
-  Vec            nvec,gvec,lvec;
-  VecScatter     l2g,g2n;
+  Vec            gvec,lvec;
+  VecScatter     l2g;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -495,22 +1027,17 @@ PetscErrorCode IGASaveProperty(IGA iga,PetscViewer viewer)
 
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
   if (!isbinary) SETERRQ(((PetscObject)viewer)->comm,PETSC_ERR_ARG_WRONG,"Only for binary viewers");
-  ierr = PetscViewerBinaryGetSkipHeader(viewer,&skipheader);CHKERRQ(ierr);
 
   ierr = IGAGetPropertyDim(iga,&npd);CHKERRQ(ierr);
   {
     IGA_Grid grid;
     ierr = IGA_NewGridIO(iga,npd,&grid);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetVecNatural(grid,iga->vectype,&nvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecGlobal (grid,iga->vectype,&gvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetVecLocal  (grid,iga->vectype,&lvec);CHKERRQ(ierr);
     ierr = IGA_Grid_GetScatterL2G(grid,&l2g);CHKERRQ(ierr);
-    ierr = IGA_Grid_GetScatterG2N(grid,&g2n);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)nvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)gvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)lvec);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)l2g);CHKERRQ(ierr);
-    ierr = PetscObjectReference((PetscObject)g2n);CHKERRQ(ierr);
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
   }
   {
@@ -523,17 +1050,12 @@ PetscErrorCode IGASaveProperty(IGA iga,PetscViewer viewer)
   /* local -> global */
   ierr = VecScatterBegin(l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  /* global -> natural */
-  ierr = VecScatterBegin(g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  ierr = VecScatterEnd  (g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  /* natural -> viewer */
-  ierr = VecView(nvec,viewer);CHKERRQ(ierr);
+  /* global -> viewer */
+  ierr = IGA_VecViewBox(gvec,iga->dim,npd,iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,viewer);CHKERRQ(ierr);
 
-  ierr = VecScatterDestroy(&g2n);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&l2g);CHKERRQ(ierr);
   ierr = VecDestroy(&lvec);CHKERRQ(ierr);
   ierr = VecDestroy(&gvec);CHKERRQ(ierr);
-  ierr = VecDestroy(&nvec);CHKERRQ(ierr);
 
   PetscFunctionReturn(0);
 }
@@ -549,6 +1071,16 @@ PetscErrorCode IGASaveProperty(IGA iga,PetscViewer viewer)
 +  iga - the IGA context
 -  filename - the file name which contains the IGA information
 
+   Options Database Keys:
+.  -iga_geometry_mmap - load the control net through a memory mapped cache
+
+   Notes:
+   With -iga_geometry_mmap the control net is decoded once into the cache
+   file <filename>.mmap, next to the IGA file, and every process copies
+   its part out of a read-only mapping of the cache. Independent runs
+   reading the same file on a node share the mapped pages. The cache is
+   rebuilt when the size or the modification time of the file changes.
+
    Level: normal
 
 .keywords: IGA, read
@@ -568,6 +1100,7 @@ PetscErrorCode IGARead(IGA iga,const char filename[])
   ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
   ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
   /*ierr = PetscViewerBinarySetSkipHeader(viewer,PETSC_TRUE);CHKERRQ(ierr);*/
+  ierr = IGA_ViewerBinarySetMPIIO(iga,viewer);CHKERRQ(ierr);
   ierr = PetscViewerFileSetMode(viewer,FILE_MODE_READ);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
   ierr = IGALoad(iga,viewer);CHKERRQ(ierr);
@@ -606,6 +1139,7 @@ PetscErrorCode IGAWrite(IGA iga,const char filename[])
   ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
   ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
   /*ierr = PetscViewerBinarySetSkipHeader(viewer,PETSC_TRUE);CHKERRQ(ierr);*/
+  ierr = IGA_ViewerBinarySetMPIIO(iga,viewer);CHKERRQ(ierr);
   ierr = PetscViewerFileSetMode(viewer,FILE_MODE_WRITE);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
   ierr = IGASave(iga,viewer);CHKERRQ(ierr);
@@ -616,56 +1150,12 @@ PetscErrorCode IGAWrite(IGA iga,const char filename[])
 }
 
 
-#undef  __FUNCT__
-#define __FUNCT__ "VecLoad_Binary_SkipHeader"
-static PetscErrorCode VecLoad_Binary_SkipHeader(Vec vec,PetscViewer viewer)
-{
-  MPI_Comm       comm;
-  PetscMPIInt    i,rank,size,tag;
-  int            fd;
-  PetscInt       n;
-  const PetscInt *range;
-  PetscScalar    *array,*work;
-  PetscErrorCode ierr;
-  PetscFunctionBegin;
-
-  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
-  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
-  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
-  ierr = PetscCommGetNewTag(comm,&tag);CHKERRQ(ierr);
-  ierr = PetscViewerBinaryGetDescriptor(viewer,&fd);CHKERRQ(ierr);
-
-  ierr = VecGetLocalSize(vec,&n);CHKERRQ(ierr);
-  ierr = VecGetArray(vec,&array);CHKERRQ(ierr);
-  if (!rank) {
-    ierr = PetscBinaryRead(fd,array,n,PETSC_SCALAR);CHKERRQ(ierr);
-    if (size > 1) {
-      ierr = VecGetOwnershipRanges(vec,&range);CHKERRQ(ierr);
-      n = 1;
-      for (i=1; i<size; i++)
-        n = PetscMax(n,range[i+1] - range[i]);
-      ierr = PetscMalloc(n*sizeof(PetscScalar),&work);CHKERRQ(ierr);
-      for (i=1; i<size; i++) {
-        n   = range[i+1] - range[i];
-        ierr = PetscBinaryRead(fd,work,n,PETSC_SCALAR);CHKERRQ(ierr);
-        ierr = MPI_Send(work,n,MPIU_SCALAR,i,tag,comm);CHKERRQ(ierr);
-      }
-      ierr = PetscFree(work);CHKERRQ(ierr);
-    }
-  } else {
-    MPI_Status status;
-    ierr = MPI_Recv(array,n,MPIU_SCALAR,0,tag,comm,&status);CHKERRQ(ierr);
-  }
-  ierr = VecRestoreArray(vec,&array);CHKERRQ(ierr);
-
-  PetscFunctionReturn(0);
-}
-
 #undef  __FUNCT__
 #define __FUNCT__ "IGALoadVec"
 PetscErrorCode IGALoadVec(IGA iga,Vec vec,PetscViewer viewer)
 {
   Vec            natural;
+  PetscBool      isbinary;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -676,6 +1166,24 @@ PetscErrorCode IGALoadVec(IGA iga,Vec vec,PetscViewer viewer)
   PetscCheckSameComm(iga,1,viewer,3);
   IGACheckSetUpStage2(iga,1);
 
+#if defined(PETSC_HAVE_HDF5)
+  {
+    PetscBool ishdf5;
+    ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERHDF5,&ishdf5);CHKERRQ(ierr);
+    if (ishdf5) {ierr = IGALoadVec_HDF5(iga,vec,viewer);CHKERRQ(ierr); PetscFunctionReturn(0);}
+  }
+#endif
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
+  if (isbinary) {
+    PetscInt n;
+    ierr = VecGetLocalSize(vec,&n);CHKERRQ(ierr);
+    if (n != iga->map->n) isbinary = PETSC_FALSE;
+  }
+  if (isbinary) {
+    ierr = IGA_VecLoadBox(vec,iga->dim,iga->dof,iga->node_sizes,iga->node_lstart,iga->node_lwidth,viewer);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   ierr = IGAGetNaturalVec(iga,&natural);CHKERRQ(ierr);
   ierr = VecLoad(natural,viewer);CHKERRQ(ierr);
   ierr = IGANaturalToGlobal(iga,natural,vec);CHKERRQ(ierr);
@@ -688,6 +1196,7 @@ PetscErrorCode IGALoadVec(IGA iga,Vec vec,PetscViewer viewer)
 PetscErrorCode IGASaveVec(IGA iga,Vec vec,PetscViewer viewer)
 {
   Vec            natural;
+  PetscBool      isbinary;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -698,6 +1207,24 @@ PetscErrorCode IGASaveVec(IGA iga,Vec vec,PetscViewer viewer)
   PetscCheckSameComm(iga,1,viewer,3);
   IGACheckSetUpStage2(iga,1);
 
+#if defined(PETSC_HAVE_HDF5)
+  {
+    PetscBool ishdf5;
+    ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERHDF5,&ishdf5);CHKERRQ(ierr);
+    if (ishdf5) {ierr = IGASaveVec_HDF5(iga,vec,viewer);CHKERRQ(ierr); PetscFunctionReturn(0);}
+  }
+#endif
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERBINARY,&isbinary);CHKERRQ(ierr);
+  if (isbinary) {
+    PetscInt n;
+    ierr = VecGetLocalSize(vec,&n);CHKERRQ(ierr);
+    if (n != iga->map->n) isbinary = PETSC_FALSE;
+  }
+  if (isbinary) {
+    ierr = IGA_VecViewBox(vec,iga->dim,iga->dof,iga->node_sizes,iga->node_lstart,iga->node_lwidth,viewer);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   ierr = IGAGetNaturalVec(iga,&natural);CHKERRQ(ierr);
   ierr = IGAGlobalToNatural(iga,vec,natural);CHKERRQ(ierr);
   ierr = PetscObjectSetName((PetscObject)natural,((PetscObject)vec)->name);CHKERRQ(ierr);
@@ -706,6 +1233,52 @@ PetscErrorCode IGASaveVec(IGA iga,Vec vec,PetscViewer viewer)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGASaveVecTime"
+/*@
+   IGASaveVecTime - Saves a vector as a step of a time series, together
+   with its physical time.
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  vec - the vector to save
+.  time - the physical time of the step
+-  viewer - an HDF5 viewer with a timestep set
+
+   Notes:
+   The vector is saved as with IGASaveVec() at the timestep of the
+   viewer (see PetscViewerHDF5SetTimestep()), and the time is stored at
+   the same position of the /time dataset, from which the XDMF file
+   takes the time values of its temporal collection.
+
+   Level: normal
+
+.keywords: IGA, output, vector, time series
+@*/
+PetscErrorCode IGASaveVecTime(IGA iga,Vec vec,PetscReal time,PetscViewer viewer)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(vec,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,4);
+  PetscCheckSameComm(iga,1,vec,2);
+  PetscCheckSameComm(iga,1,viewer,4);
+  IGACheckSetUpStage2(iga,1);
+
+#if defined(PETSC_HAVE_HDF5)
+  {
+    PetscBool      ishdf5;
+    PetscErrorCode ierr;
+    ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERHDF5,&ishdf5);CHKERRQ(ierr);
+    if (ishdf5) {ierr = IGASaveVecTime_HDF5(iga,vec,time,viewer);CHKERRQ(ierr); PetscFunctionReturn(0);}
+  }
+#endif
+  SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Time series are only supported with HDF5 viewers");
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAReadVec"
 PetscErrorCode IGAReadVec(IGA iga,Vec vec,const char filename[])
@@ -726,6 +1299,7 @@ PetscErrorCode IGAReadVec(IGA iga,Vec vec,const char filename[])
   ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
   ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
   /*ierr = PetscViewerBinarySetSkipHeader(viewer,PETSC_TRUE);CHKERRQ(ierr);*/
+  ierr = IGA_ViewerBinarySetMPIIO(iga,viewer);CHKERRQ(ierr);
   ierr = PetscViewerFileSetMode(viewer,FILE_MODE_READ);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
   ierr = IGALoadVec(iga,vec,viewer);CHKERRQ(ierr);
@@ -754,6 +1328,7 @@ PetscErrorCode IGAWriteVec(IGA iga,Vec vec,const char filename[])
   ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
   ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
   /*ierr = PetscViewerBinarySetSkipHeader(viewer,PETSC_TRUE);CHKERRQ(ierr);*/
+  ierr = IGA_ViewerBinarySetMPIIO(iga,viewer);CHKERRQ(ierr);
   ierr = PetscViewerFileSetMode(viewer,FILE_MODE_WRITE);CHKERRQ(ierr);
   ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
   ierr = IGASaveVec(iga,vec,viewer);CHKERRQ(ierr);
@@ -762,3 +1337,222 @@ PetscErrorCode IGAWriteVec(IGA iga,Vec vec,const char filename[])
 
   PetscFunctionReturn(0);
 }
+
+EXTERN_C_BEGIN
+extern PetscReal IGA_Greville(PetscInt i,PetscInt p,const PetscReal U[]);
+EXTERN_C_END
+
+/* copy a value of n bytes in big-endian byte order */
+static void IGA_BigEndianCopy(unsigned char *dst,const void *src,size_t n)
+{
+  const unsigned char *b = (const unsigned char*)src;
+  size_t i;
+#if defined(PETSC_WORDS_BIGENDIAN)
+  for (i=0; i<n; i++) dst[i] = b[i];
+#else
+  for (i=0; i<n; i++) dst[i] = b[n-1-i];
+#endif
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAWriteVecSubset"
+/*@
+   IGAWriteVecSubset - Writes selected fields of a vector on a subset of
+   the nodes, possibly in single precision, for visualization dumps.
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  vec - the vector to write
+-  filename - the name of the file
+
+   Options Database Keys:
++  -iga_subset_fields <name,...> - fields to write, by name (see IGASetFieldName()) or number
+.  -iga_subset_precision <double,single> - precision of the stored values
+.  -iga_subset_stride <k,...> - write every k-th node along each direction
+-  -iga_subset_box <u0,u1,...> - restrict output to nodes whose Greville abscissae are in the parametric box
+
+   Notes:
+   The file is a PETSc binary file containing the integers
+   IGA_SUBSET_FILE_CLASSID, dim, the subset sizes M[0..dim-1], the
+   number of fields nf and the number of bytes per value (4 or 8), then
+   the nf field numbers, then for each direction the M[i] Greville
+   abscissae (in double precision) of the selected nodes, and finally the real part of the
+   values in lexicographic order (first direction running fastest) with
+   the fields interleaved. Like every other number in a PETSc binary
+   file, the values are stored big-endian, as IEEE single or double
+   precision. With MPI-IO (see -iga_io_mpiio) all processes write their
+   part at once; otherwise the first process writes the file.
+
+   Level: normal
+
+.keywords: IGA, output, vector, subset
+@*/
+PetscErrorCode IGAWriteVecSubset(IGA iga,Vec vec,const char filename[])
+{
+  MPI_Comm       comm;
+  const char     *prefix = NULL;
+  PetscInt       i,c,dim,dof;
+  PetscInt       nf,field[64];
+  PetscInt       stride[3] = {1,1,1};
+  PetscReal      bbox[3][2] = {{0,0},{0,0},{0,0}};
+  PetscInt       lo[3] = {0,0,0},hi[3] = {0,0,0};
+  PetscInt       sizes[3] = {1,1,1},lstart[3] = {0,0,0},lwidth[3] = {1,1,1};
+  PetscBool      single = PETSC_FALSE,box = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(vec,VEC_CLASSID,2);
+  PetscCheckSameComm(iga,1,vec,2);
+  PetscValidCharPointer(filename,3);
+  IGACheckSetUpStage2(iga,1);
+
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+  dim = iga->dim; dof = iga->dof;
+  if (dof > (PetscInt)(sizeof(field)/sizeof(field[0])))
+    SETERRQ1(comm,PETSC_ERR_SUP,"Not supported for more than %D fields",(PetscInt)(sizeof(field)/sizeof(field[0])));
+
+  /* fields */
+  for (nf=0; nf<dof; nf++) field[nf] = nf;
+  {
+    char      *names[64];
+    PetscInt  n = dof;
+    PetscBool flg = PETSC_FALSE;
+    ierr = PetscOptionsGetStringArray(prefix,"-iga_subset_fields",names,&n,&flg);CHKERRQ(ierr);
+    if (flg && n > 0) {
+      for (nf=0; nf<n; nf++) {
+        int      num = -1;
+        PetscInt f;
+        for (f=0; f<dof; f++) {
+          PetscBool match = PETSC_FALSE;
+          if (!iga->fieldname || !iga->fieldname[f]) continue;
+          ierr = PetscStrcmp(names[nf],iga->fieldname[f],&match);CHKERRQ(ierr);
+          if (match) break;
+        }
+        if (f == dof && sscanf(names[nf],"%d",&num) == 1) f = (PetscInt)num;
+        if (f < 0 || f >= dof) SETERRQ1(comm,PETSC_ERR_ARG_WRONG,"Unknown field %s",names[nf]);
+        field[nf] = f;
+      }
+      for (i=0; i<n; i++) {ierr = PetscFree(names[i]);CHKERRQ(ierr);}
+    }
+  }
+  /* precision */
+  {
+    const char *const precision[] = {"double","single"};
+    PetscInt   which = 0;
+    ierr = PetscOptionsGetEList(prefix,"-iga_subset_precision",precision,2,&which,NULL);CHKERRQ(ierr);
+    single = (which == 1) ? PETSC_TRUE : PETSC_FALSE;
+  }
+  /* stride */
+  {
+    PetscInt  n = 3;
+    PetscBool flg = PETSC_FALSE;
+    ierr = PetscOptionsGetIntArray(prefix,"-iga_subset_stride",stride,&n,&flg);CHKERRQ(ierr);
+    if (flg && n > 0) for (i=n; i<3; i++) stride[i] = stride[0];
+    for (i=0; i<3; i++)
+      if (stride[i] < 1) SETERRQ1(comm,PETSC_ERR_ARG_OUTOFRANGE,"Stride must be positive, got %D",stride[i]);
+  }
+  /* parametric box */
+  {
+    PetscInt  n = 2*dim;
+    ierr = PetscOptionsGetRealArray(prefix,"-iga_subset_box",&bbox[0][0],&n,&box);CHKERRQ(ierr);
+    if (box && n != 2*dim) SETERRQ2(comm,PETSC_ERR_ARG_WRONG,"Expecting %D values for -iga_subset_box, got %D",2*dim,n);
+  }
+
+  /* node range and subset sizes along each direction */
+  for (i=0; i<dim; i++) {
+    IGAAxis   axis = iga->axis[i];
+    PetscInt  N = iga->node_sizes[i];
+    PetscInt  s = iga->node_lstart[i], e = s + iga->node_lwidth[i];
+    PetscInt  a,k = stride[i];
+    lo[i] = 0; hi[i] = N-1;
+    if (box) {
+      PetscReal tol = 100*PETSC_MACHINE_EPSILON*(axis->U[axis->m]-axis->U[0]);
+      lo[i] = N; hi[i] = -1;
+      for (a=0; a<N; a++) {
+        PetscReal u = IGA_Greville(a,axis->p,axis->U);
+        if (u < bbox[i][0]-tol || u > bbox[i][1]+tol) continue;
+        lo[i] = PetscMin(lo[i],a); hi[i] = PetscMax(hi[i],a);
+      }
+      if (hi[i] < lo[i]) SETERRQ1(comm,PETSC_ERR_ARG_OUTOFRANGE,"No nodes in -iga_subset_box along direction %D",i);
+    }
+    sizes[i] = (hi[i]-lo[i])/k + 1;
+    s = PetscMax(s,lo[i]); e = PetscMin(e,hi[i]+1);
+    lstart[i] = (s - lo[i] + k - 1)/k;
+    lwidth[i] = (e > s) ? PetscMax((e - 1 - lo[i])/k - lstart[i] + 1,0) : 0;
+  }
+
+  {
+    PetscViewer       viewer;
+    PetscInt          header[3+3+1];
+    PetscInt          n = nf,ii,jj,kk,pos;
+    PetscInt          *nw = iga->node_lwidth, *ns = iga->node_lstart;
+    size_t            vsize = single ? sizeof(float) : sizeof(double);
+    unsigned char     *buffer;
+    PetscBool         mpiio = PETSC_FALSE;
+    const PetscScalar *array;
+
+    ierr = PetscViewerCreate(comm,&viewer);CHKERRQ(ierr);
+    ierr = PetscViewerSetType(viewer,PETSCVIEWERBINARY);CHKERRQ(ierr);
+    ierr = PetscViewerBinarySkipInfo(viewer);CHKERRQ(ierr);
+    ierr = IGA_ViewerBinarySetMPIIO(iga,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetMode(viewer,FILE_MODE_WRITE);CHKERRQ(ierr);
+    ierr = PetscViewerFileSetName(viewer,filename);CHKERRQ(ierr);
+
+    pos = 0;
+    header[pos++] = IGA_SUBSET_FILE_CLASSID;
+    header[pos++] = dim;
+    for (i=0; i<dim; i++) header[pos++] = sizes[i];
+    header[pos++] = nf;
+    header[pos++] = single ? 4 : 8;
+    ierr = PetscViewerBinaryWrite(viewer,header,pos,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryWrite(viewer,field,nf,PETSC_INT,PETSC_TRUE);CHKERRQ(ierr);
+    for (i=0; i<dim; i++) {
+      IGAAxis   axis = iga->axis[i];
+      double    *X;
+      PetscInt  a;
+      ierr = PetscMalloc1(sizes[i],&X);CHKERRQ(ierr);
+      for (a=0; a<sizes[i]; a++) X[a] = (double)IGA_Greville(lo[i]+a*stride[i],axis->p,axis->U);
+      ierr = PetscViewerBinaryWrite(viewer,X,sizes[i],PETSC_DOUBLE,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = PetscFree(X);CHKERRQ(ierr);
+    }
+
+    for (i=0; i<dim; i++) n *= lwidth[i];
+    ierr = PetscMalloc((size_t)(n+1)*vsize,&buffer);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(vec,&array);CHKERRQ(ierr);
+    pos = 0;
+    for (kk=0; kk<lwidth[2]; kk++) {
+      PetscInt a2 = (dim > 2) ? lo[2] + (lstart[2]+kk)*stride[2] - ns[2] : 0;
+      for (jj=0; jj<lwidth[1]; jj++) {
+        PetscInt a1 = (dim > 1) ? lo[1] + (lstart[1]+jj)*stride[1] - ns[1] : 0;
+        for (ii=0; ii<lwidth[0]; ii++) {
+          PetscInt a0 = lo[0] + (lstart[0]+ii)*stride[0] - ns[0];
+          const PetscScalar *u = array + (a0 + (a1 + a2*nw[1])*nw[0])*dof;
+          for (c=0; c<nf; c++, pos++) {
+            PetscReal v = PetscRealPart(u[field[c]]);
+            float     f = (float)v;
+            double    d = (double)v;
+            IGA_BigEndianCopy(buffer+(size_t)pos*vsize,single?(void*)&f:(void*)&d,vsize);
+          }
+        }
+      }
+    }
+    ierr = VecRestoreArrayRead(vec,&array);CHKERRQ(ierr);
+    /* the values are already big-endian bytes, written untouched */
+    ierr = IGA_ViewerBinaryGetMPIIO(viewer,&mpiio);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPIIO)
+    if (mpiio) {
+      ierr = IGA_BoxIO_MPIIO(viewer,buffer,MPI_CHAR,dim,nf*(PetscInt)vsize,sizes,lstart,lwidth,PETSC_TRUE);CHKERRQ(ierr);
+    }
+#endif
+    if (!mpiio) {
+      ierr = IGA_BoxIO_Binary(viewer,buffer,PETSC_CHAR,dim,nf*(PetscInt)vsize,sizes,lstart,lwidth,PETSC_TRUE);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(buffer);CHKERRQ(ierr);
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
@@ -46,13 +46,16 @@ PetscErrorCode IGAComputeVector(IGA iga,Vec vecB)
   PetscValidHeaderSpecific(vecB,VEC_CLASSID,2);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,Vector);
+  IGATraceBegin(__FUNCT__);
 
   ierr = VecZeroEntries(vecB);CHKERRQ(ierr);
 
   ierr = PetscLogEventBegin(IGA_FormVector,iga,vecB,0,0);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_VECTOR);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&B);CHKERRQ(ierr);
     /* FormVector loop */
@@ -61,7 +64,9 @@ PetscErrorCode IGAComputeVector(IGA iga,Vec vecB)
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&F);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = Vector(point,F,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,F,B);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -69,12 +74,18 @@ PetscErrorCode IGAComputeVector(IGA iga,Vec vecB)
     ierr = IGAElementAssembleVec(element,B,vecB);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormVector,iga,vecB,0,0);CHKERRQ(ierr);
 
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecB);CHKERRQ(ierr);
   ierr = VecAssemblyEnd  (vecB);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -94,13 +105,16 @@ PetscErrorCode IGAComputeMatrix(IGA iga,Mat matA)
   PetscValidHeaderSpecific(matA,MAT_CLASSID,2);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,Matrix);
+  IGATraceBegin(__FUNCT__);
 
   ierr = MatZeroEntries(matA);CHKERRQ(ierr);
 
   ierr = PetscLogEventBegin(IGA_FormMatrix,iga,matA,0,0);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_MATRIX);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&A);CHKERRQ(ierr);
     /* FormMatrix loop */
@@ -109,7 +123,9 @@ PetscErrorCode IGAComputeMatrix(IGA iga,Mat matA)
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = Matrix(point,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,A);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -117,12 +133,18 @@ PetscErrorCode IGAComputeMatrix(IGA iga,Mat matA)
     ierr = IGAElementAssembleMat(element,A,matA);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormMatrix,iga,matA,0,0);CHKERRQ(ierr);
 
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matA,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matA,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -166,6 +188,7 @@ PetscErrorCode IGAComputeSystem(IGA iga,Mat matA,Vec vecB)
   PetscValidHeaderSpecific(vecB,VEC_CLASSID,3);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,System);
+  IGATraceBegin(__FUNCT__);
 
   ierr = MatZeroEntries(matA);CHKERRQ(ierr);
   ierr = VecZeroEntries(vecB);CHKERRQ(ierr);
@@ -173,7 +196,9 @@ PetscErrorCode IGAComputeSystem(IGA iga,Mat matA,Vec vecB)
   ierr = PetscLogEventBegin(IGA_FormSystem,iga,matA,vecB,0);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_SYSTEM);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&A);CHKERRQ(ierr);
     ierr = IGAElementGetWorkVec(element,&B);CHKERRQ(ierr);
@@ -184,7 +209,9 @@ PetscErrorCode IGAComputeSystem(IGA iga,Mat matA,Vec vecB)
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
         ierr = IGAPointGetWorkVec(point,&F);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = System(point,K,F,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,A);CHKERRQ(ierr);
         ierr = IGAPointAddVec(point,F,B);CHKERRQ(ierr);
       }
@@ -195,14 +222,22 @@ PetscErrorCode IGAComputeSystem(IGA iga,Mat matA,Vec vecB)
     ierr = IGAElementAssembleVec(element,B,vecB);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormSystem,iga,matA,vecB,0);CHKERRQ(ierr);
 
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matA,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matA,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecB);CHKERRQ(ierr);
   ierr = VecAssemblyEnd  (vecB);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -11,6 +11,7 @@ typedef const char* MatType;
 #endif
 
 PETSC_EXTERN PetscErrorCode MatHeaderReplace(Mat,Mat);
+PETSC_EXTERN PetscErrorCode MatIGASetUp_IGA(Mat,IGA);
 static       PetscErrorCode MatView_MPI_IGA(Mat,PetscViewer);
 static       PetscErrorCode MatLoad_MPI_IGA(Mat,PetscViewer);
 
@@ -22,6 +23,7 @@ static PetscErrorCode MatView_MPI_IGA(Mat A,PetscViewer viewer)
   MPI_Comm          comm;
   IGA               iga;
   Mat               Anatural;
+  AO                ao;
   IS                is;
   PetscInt          bs,rstart,rend;
   const char        *prefix;
@@ -43,7 +45,8 @@ static PetscErrorCode MatView_MPI_IGA(Mat A,PetscViewer viewer)
   ierr = IGAGetDof(iga,&bs);CHKERRQ(ierr);
   ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
   ierr = ISCreateStride(comm,(rend-rstart)/bs,rstart/bs,1,&is);CHKERRQ(ierr);
-  ierr = AOApplicationToPetscIS(iga->ao,is);CHKERRQ(ierr);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = AOApplicationToPetscIS(ao,is);CHKERRQ(ierr);
   if (bs > 1) {
     IS isb;
     PetscInt n;
@@ -79,6 +82,7 @@ static PetscErrorCode MatLoad_MPI_IGA(Mat A,PetscViewer viewer)
   PetscInt       rbs,cbs,m,n,M,N;
   Mat            Anatural,Apetsc;
   PetscInt       bs,rstart,rend;
+  AO             ao;
   IS             is;
   PetscErrorCode ierr;
 
@@ -106,7 +110,8 @@ static PetscErrorCode MatLoad_MPI_IGA(Mat A,PetscViewer viewer)
   ierr = IGAGetDof(iga,&bs);CHKERRQ(ierr);
   ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
   ierr = ISCreateStride(comm,(rend-rstart)/bs,rstart/bs,1,&is);CHKERRQ(ierr);
-  ierr = AOPetscToApplicationIS(iga->ao,is);CHKERRQ(ierr);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = AOPetscToApplicationIS(ao,is);CHKERRQ(ierr);
   if (bs > 1) {
     IS isb;
     PetscInt n;
@@ -293,7 +298,7 @@ PetscErrorCode FilterLowerTriangular(PetscInt row,PetscInt *cnt,PetscInt col[])
 PetscErrorCode IGACreateMat(IGA iga,Mat *mat)
 {
   MPI_Comm       comm;
-  PetscBool      is,aij,baij,sbaij;
+  PetscBool      is,stencil,aij,baij,sbaij;
   PetscInt       i,dim;
   PetscInt       *lstart,*lwidth;
   PetscInt       gstart[3] = {0,0,0};
@@ -308,6 +313,7 @@ PetscErrorCode IGACreateMat(IGA iga,Mat *mat)
   PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
   PetscValidPointer(mat,2);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
 
   ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
   ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
@@ -328,11 +334,17 @@ PetscErrorCode IGACreateMat(IGA iga,Mat *mat)
     is = f ? PETSC_TRUE: PETSC_FALSE;
   }
 
+  { /* Check for MATIGA stencil matrix */
+    ierr = PetscObjectTypeCompare((PetscObject)A,MATIGA,&stencil);CHKERRQ(ierr);
+    if (stencil) {ierr = MatIGASetUp_IGA(A,iga);CHKERRQ(ierr);}
+  }
+
   if (is) {ierr = MatSetUp(A);CHKERRQ(ierr);}
   ierr = MatSetLocalToGlobalMapping(A,rmap->mapping,cmap->mapping);CHKERRQ(ierr);
 #if PETSC_VERSION_LT(3,5,0)
   ierr = MatSetLocalToGlobalMappingBlock(A,rmap->bmapping,cmap->bmapping);CHKERRQ(ierr);
 #endif
+  if (stencil) {IGATraceEnd(__FUNCT__); PetscFunctionReturn(0);}
   if (is) {
     const MatType mtype = (bs > 1) ? MATBAIJ : MATAIJ;
     ierr = MatISGetLocalMat(A,&A);CHKERRQ(ierr);
@@ -361,10 +373,12 @@ PetscErrorCode IGACreateMat(IGA iga,Mat *mat)
     }
     if (aij || baij || sbaij) {
       IGA_Grid  grid;
+      AO        ao;
       PetscInt *sizes = iga->node_sizes;
+      ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
       ierr = IGA_Grid_Create(comm,&grid);CHKERRQ(ierr);
       ierr = IGA_Grid_Init(grid,iga->dim,1,sizes,lstart,lwidth,gstart,gwidth);CHKERRQ(ierr);
-      ierr = IGA_Grid_SetAO(grid,iga->ao);CHKERRQ(ierr);
+      ierr = IGA_Grid_SetAO(grid,ao);CHKERRQ(ierr);
       ierr = IGA_Grid_GetLGMap(grid,&ltog);CHKERRQ(ierr);
       ierr = PetscObjectReference((PetscObject)ltog);CHKERRQ(ierr);
       ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
@@ -495,5 +509,6 @@ PetscErrorCode IGACreateMat(IGA iga,Mat *mat)
 
   ierr = ISLocalToGlobalMappingDestroy(&ltog);CHKERRQ(ierr);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
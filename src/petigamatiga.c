@@ -0,0 +1,795 @@
+#include "petiga.h"
+#include "petigagrid.h"
+#include <petsc-private/matimpl.h>
+
+#if PETSC_VERSION_LE(3,3,0)
+#undef MatType
+typedef const char* MatType;
+#endif
+
+#if PETSC_VERSION_LE(3,3,0)
+#define PetscObjectComposeFunction(obj,name,f) \
+        PetscObjectComposeFunction(obj,name,"",(void(*)(void))(f))
+#endif
+
+PETSC_EXTERN PetscErrorCode MatHeaderReplace(Mat,Mat);
+
+/*
+  MATIGA stores, for every locally owned node, the (2p+1)^dim blocks of
+  size dof x dof coupling the node with its tensor-product neighbors.
+  Column indices are never stored, they are implied by the grid.
+
+  Element contributions to rows owned by other processes are
+  accumulated in a buffer of ghost rows and sent to the owners at
+  assembly time. Products with vectors scatter the values needed by
+  the stencil of the owned rows into a ghosted column box.
+*/
+
+typedef struct {
+  IGA         iga;
+  PetscInt    dim,bs,bs2;
+  PetscBool   roworiented;     /* layout of values in MatSetValues */
+  PetscInt    sizes[3];
+  PetscBool   periodic[3];
+  PetscInt    p[3],sw[3],ns;   /* stencil half-width, width, size */
+  PetscInt    lstart[3];       /* locally owned rows */
+  PetscInt    lwidth[3];
+  PetscInt    gstart[3];       /* rows touched by local elements */
+  PetscInt    gwidth[3];
+  PetscInt    xstart[3];       /* columns touched by owned rows */
+  PetscInt    xwidth[3];
+
+  PetscInt    nrows;           /* number of owned rows */
+  PetscScalar *values;         /* [nrows][ns][bs][bs]  */
+  PetscInt    nghost;          /* number of ghost rows */
+  PetscScalar *gvalues;        /* [nghost][ns][bs][bs] */
+  PetscInt    *slot;           /* [gwidth] owned row, or -(ghost row+1) */
+  Vec         vvalues,vghost;
+  VecScatter  assembly;        /* ghost rows -> owned rows */
+
+  IGA_Grid    xgrid;           /* ghosted column box */
+  Vec         xlocal;
+  VecScatter  g2x;
+} Mat_IGA;
+
+PETSC_STATIC_INLINE
+PetscInt StencilIndex(const Mat_IGA *a,const PetscInt r[3],const PetscInt c[3])
+{
+  PetscInt i,o[3];
+  for (i=0; i<3; i++) {
+    o[i] = c[i] - r[i] + a->p[i];
+    if (PetscUnlikely(o[i] < 0 || o[i] >= a->sw[i])) return -1;
+  }
+  return o[0] + o[1]*a->sw[0] + o[2]*a->sw[0]*a->sw[1];
+}
+
+PETSC_STATIC_INLINE
+void GhostCoords(const Mat_IGA *a,PetscInt index,PetscInt ijk[3])
+{
+  ijk[0] = a->gstart[0] + index % a->gwidth[0]; index /= a->gwidth[0];
+  ijk[1] = a->gstart[1] + index % a->gwidth[1]; index /= a->gwidth[1];
+  ijk[2] = a->gstart[2] + index;
+}
+
+PETSC_STATIC_INLINE
+PetscScalar* RowValues(const Mat_IGA *a,PetscInt row)
+{
+  PetscInt slot = a->slot[row];
+  PetscInt size = a->ns*a->bs2;
+  return (slot >= 0) ? a->values + slot*size : a->gvalues + (-slot-1)*size;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatSetValuesBlockedLocal_IGA"
+static PetscErrorCode MatSetValuesBlockedLocal_IGA(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscInt       bs = a->bs, bs2 = a->bs2;
+  PetscInt       ldv = a->roworiented ? n*bs : m*bs;
+  PetscInt       i,j,r,c,s,rc[3],cc[3];
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    PetscScalar *row;
+    if (im[i] < 0) continue;
+    GhostCoords(a,im[i],rc);
+    row = RowValues(a,im[i]);
+    for (j=0; j<n; j++) {
+      const PetscScalar *blk;
+      PetscScalar *V;
+      if (in[j] < 0) continue;
+      GhostCoords(a,in[j],cc);
+      s = StencilIndex(a,rc,cc);
+      if (PetscUnlikely(s < 0))
+        SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry (%D,%D) is outside the stencil",im[i],in[j]);
+      V = row + s*bs2;
+      if (a->roworiented) {
+        blk = v + i*bs*ldv + j*bs;
+        if (addv == ADD_VALUES) {
+          for (r=0; r<bs; r++) for (c=0; c<bs; c++) V[r*bs+c] += blk[r*ldv+c];
+        } else {
+          for (r=0; r<bs; r++) for (c=0; c<bs; c++) V[r*bs+c]  = blk[r*ldv+c];
+        }
+      } else {
+        blk = v + j*bs*ldv + i*bs;
+        if (addv == ADD_VALUES) {
+          for (r=0; r<bs; r++) for (c=0; c<bs; c++) V[r*bs+c] += blk[c*ldv+r];
+        } else {
+          for (r=0; r<bs; r++) for (c=0; c<bs; c++) V[r*bs+c]  = blk[c*ldv+r];
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatSetValuesLocal_IGA"
+static PetscErrorCode MatSetValuesLocal_IGA(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscInt       bs = a->bs, bs2 = a->bs2;
+  PetscInt       i,j,s,rc[3],cc[3];
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    PetscInt    rnode = im[i]/bs, rcomp = im[i]%bs;
+    PetscScalar *row;
+    if (im[i] < 0) continue;
+    GhostCoords(a,rnode,rc);
+    row = RowValues(a,rnode);
+    for (j=0; j<n; j++) {
+      PetscInt    cnode = in[j]/bs, ccomp = in[j]%bs;
+      PetscScalar *V,value = a->roworiented ? v[i*n+j] : v[i+j*m];
+      if (in[j] < 0) continue;
+      GhostCoords(a,cnode,cc);
+      s = StencilIndex(a,rc,cc);
+      if (PetscUnlikely(s < 0))
+        SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry (%D,%D) is outside the stencil",im[i],in[j]);
+      V = row + s*bs2 + rcomp*bs + ccomp;
+      if (addv == ADD_VALUES) *V += value;
+      else                    *V  = value;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatZeroEntries_IGA"
+static PetscErrorCode MatZeroEntries_IGA(Mat A)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscMemzero(a->values, a->nrows *a->ns*a->bs2*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscMemzero(a->gvalues,a->nghost*a->ns*a->bs2*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatAssemblyBegin_IGA"
+static PetscErrorCode MatAssemblyBegin_IGA(Mat A,MatAssemblyType type)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(a->assembly,a->vghost,a->vvalues,ADD_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatAssemblyEnd_IGA"
+static PetscErrorCode MatAssemblyEnd_IGA(Mat A,MatAssemblyType type)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = VecScatterEnd(a->assembly,a->vghost,a->vvalues,ADD_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscMemzero(a->gvalues,a->nghost*a->ns*a->bs2*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* y[row] (+)= sum_s V[row][s] x[col(row,s)], x is the ghosted column box */
+static void MatMultKernel_IGA(const Mat_IGA *a,const PetscScalar x[],PetscScalar y[])
+{
+  const PetscInt bs = a->bs, bs2 = a->bs2;
+  const PetscInt *lw = a->lwidth, *sw = a->sw, *xw = a->xwidth;
+  const PetscInt xs1 = xw[0], xs2 = xw[0]*xw[1];
+  const PetscScalar *V = a->values;
+  PetscInt ii,jj,kk,b,c,s,q,r;
+  for (kk=0; kk<lw[2]; kk++)
+    for (jj=0; jj<lw[1]; jj++)
+      for (ii=0; ii<lw[0]; ii++, y += bs) {
+        for (c=0; c<sw[2]; c++)
+          for (b=0; b<sw[1]; b++) {
+            const PetscScalar *xc = x + bs*(ii + (jj+b)*xs1 + (kk+c)*xs2);
+            if (bs == 1) {
+              PetscScalar sum = 0;
+              for (s=0; s<sw[0]; s++) sum += V[s] * xc[s];
+              y[0] += sum; V += sw[0];
+            } else {
+              for (s=0; s<sw[0]; s++, V += bs2, xc += bs)
+                for (r=0; r<bs; r++)
+                  for (q=0; q<bs; q++)
+                    y[r] += V[r*bs+q] * xc[q];
+            }
+          }
+      }
+}
+
+/* y[col(row,s)] += V[row][s]^T x[row], y is the ghosted column box */
+static void MatMultTransposeKernel_IGA(const Mat_IGA *a,const PetscScalar x[],PetscScalar y[])
+{
+  const PetscInt bs = a->bs, bs2 = a->bs2;
+  const PetscInt *lw = a->lwidth, *sw = a->sw, *xw = a->xwidth;
+  const PetscInt xs1 = xw[0], xs2 = xw[0]*xw[1];
+  const PetscScalar *V = a->values;
+  PetscInt ii,jj,kk,b,c,s,q,r;
+  for (kk=0; kk<lw[2]; kk++)
+    for (jj=0; jj<lw[1]; jj++)
+      for (ii=0; ii<lw[0]; ii++, x += bs) {
+        for (c=0; c<sw[2]; c++)
+          for (b=0; b<sw[1]; b++) {
+            PetscScalar *yc = y + bs*(ii + (jj+b)*xs1 + (kk+c)*xs2);
+            if (bs == 1) {
+              const PetscScalar xr = x[0];
+              for (s=0; s<sw[0]; s++) yc[s] += V[s] * xr;
+              V += sw[0];
+            } else {
+              for (s=0; s<sw[0]; s++, V += bs2, yc += bs)
+                for (r=0; r<bs; r++)
+                  for (q=0; q<bs; q++)
+                    yc[q] += V[r*bs+q] * x[r];
+            }
+          }
+      }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatMultAdd_IGA"
+static PetscErrorCode MatMultAdd_IGA(Mat A,Vec x,Vec z,Vec y)
+{
+  Mat_IGA           *a = (Mat_IGA*)A->data;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(a->g2x,x,a->xlocal,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd  (a->g2x,x,a->xlocal,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  if (z) {
+    if (z != y) {ierr = VecCopy(z,y);CHKERRQ(ierr);}
+  } else {
+    ierr = VecZeroEntries(y);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(a->xlocal,&xx);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+  MatMultKernel_IGA(a,xx,yy);
+  ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(a->xlocal,&xx);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nrows*a->ns*a->bs2);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatMult_IGA"
+static PetscErrorCode MatMult_IGA(Mat A,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MatMultAdd_IGA(A,x,NULL,y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatMultTransposeAdd_IGA"
+static PetscErrorCode MatMultTransposeAdd_IGA(Mat A,Vec x,Vec z,Vec y)
+{
+  Mat_IGA           *a = (Mat_IGA*)A->data;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  ierr = VecZeroEntries(a->xlocal);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(x,&xx);CHKERRQ(ierr);
+  ierr = VecGetArray(a->xlocal,&yy);CHKERRQ(ierr);
+  MatMultTransposeKernel_IGA(a,xx,yy);
+  ierr = VecRestoreArray(a->xlocal,&yy);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(x,&xx);CHKERRQ(ierr);
+  if (z) {
+    if (z != y) {ierr = VecCopy(z,y);CHKERRQ(ierr);}
+  } else {
+    ierr = VecZeroEntries(y);CHKERRQ(ierr);
+  }
+  ierr = VecScatterBegin(a->g2x,a->xlocal,y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecScatterEnd  (a->g2x,a->xlocal,y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nrows*a->ns*a->bs2);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatMultTranspose_IGA"
+static PetscErrorCode MatMultTranspose_IGA(Mat A,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MatMultTransposeAdd_IGA(A,x,NULL,y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatGetDiagonal_IGA"
+static PetscErrorCode MatGetDiagonal_IGA(Mat A,Vec d)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscInt       i,r,bs = a->bs,bs2 = a->bs2,s0 = (a->ns-1)/2;
+  PetscScalar    *dd;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = VecGetArray(d,&dd);CHKERRQ(ierr);
+  for (i=0; i<a->nrows; i++) {
+    const PetscScalar *V = a->values + (i*a->ns + s0)*bs2;
+    for (r=0; r<bs; r++) dd[i*bs+r] = V[r*bs+r];
+  }
+  ierr = VecRestoreArray(d,&dd);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatScale_IGA"
+static PetscErrorCode MatScale_IGA(Mat A,PetscScalar alpha)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscInt       i,n = a->nrows*a->ns*a->bs2;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) a->values[i] *= alpha;
+  ierr = PetscLogFlops(n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatShift_IGA"
+static PetscErrorCode MatShift_IGA(Mat A,PetscScalar alpha)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscInt       i,r,bs = a->bs,bs2 = a->bs2,s0 = (a->ns-1)/2;
+  PetscFunctionBegin;
+  for (i=0; i<a->nrows; i++) {
+    PetscScalar *V = a->values + (i*a->ns + s0)*bs2;
+    for (r=0; r<bs; r++) V[r*bs+r] += alpha;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* One Gauss-Seidel sweep over the owned rows, ghost values are frozen */
+static void MatSORSweep_IGA(const Mat_IGA *a,PetscBool forward,PetscReal omega,PetscReal fshift,
+                            const PetscScalar b[],PetscScalar x[])
+{
+  const PetscInt bs = a->bs, bs2 = a->bs2, ns = a->ns, s0 = (ns-1)/2;
+  const PetscInt *lw = a->lwidth, *sw = a->sw, *xw = a->xwidth, *p = a->p;
+  const PetscInt xs1 = xw[0], xs2 = xw[0]*xw[1];
+  const PetscInt nrows = a->nrows;
+  PetscInt n,t,ii,jj,kk,b0,c0,s,q,r,rr;
+  for (t=0; t<nrows; t++) {
+    const PetscScalar *V;
+    PetscScalar *xr;
+    n  = forward ? t : nrows-1-t;
+    ii = n % lw[0]; jj = (n / lw[0]) % lw[1]; kk = n / (lw[0]*lw[1]);
+    xr = x + bs*((ii+p[0]) + (jj+p[1])*xs1 + (kk+p[2])*xs2);
+    for (rr=0; rr<bs; rr++) {
+      PetscScalar sum = b[n*bs+(r = forward ? rr : bs-1-rr)];
+      V = a->values + n*ns*bs2;
+      for (c0=0; c0<sw[2]; c0++)
+        for (b0=0; b0<sw[1]; b0++) {
+          const PetscScalar *xc = x + bs*(ii + (jj+b0)*xs1 + (kk+c0)*xs2);
+          for (s=0; s<sw[0]; s++, V += bs2, xc += bs)
+            for (q=0; q<bs; q++)
+              sum -= V[r*bs+q] * xc[q];
+        }
+      V = a->values + (n*ns + s0)*bs2;
+      xr[r] += omega * sum / (V[r*bs+r] + fshift);
+    }
+  }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatSOR_IGA"
+static PetscErrorCode MatSOR_IGA(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_IGA           *a = (Mat_IGA*)A->data;
+  const PetscInt    bs = a->bs, *lw = a->lwidth, *xw = a->xwidth, *p = a->p;
+  const PetscScalar *b;
+  PetscScalar       *x,*xl;
+  PetscInt          it,lit,ii,jj,kk,r,n;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  if (flag & SOR_EISENSTAT) SETERRQ(((PetscObject)A)->comm,PETSC_ERR_SUP,"No support for Eisenstat");
+  if ((flag & SOR_APPLY_UPPER) || (flag & SOR_APPLY_LOWER))
+    SETERRQ(((PetscObject)A)->comm,PETSC_ERR_SUP,"No support for applying upper or lower triangular parts");
+  if (its <= 0 || lits <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Relaxation requires global its %D and local its %D both positive",its,lits);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecZeroEntries(xx);CHKERRQ(ierr);}
+
+  for (it=0; it<its; it++) {
+    ierr = VecScatterBegin(a->g2x,xx,a->xlocal,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd  (a->g2x,xx,a->xlocal,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+    ierr = VecGetArray(a->xlocal,&xl);CHKERRQ(ierr);
+    for (lit=0; lit<lits; lit++) {
+      if (flag & SOR_FORWARD_SWEEP  || flag & SOR_LOCAL_FORWARD_SWEEP)
+        MatSORSweep_IGA(a,PETSC_TRUE, omega,fshift,b,xl);
+      if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP)
+        MatSORSweep_IGA(a,PETSC_FALSE,omega,fshift,b,xl);
+    }
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    /* copy the updated owned values back */
+    ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+    for (n=0, kk=0; kk<lw[2]; kk++)
+      for (jj=0; jj<lw[1]; jj++)
+        for (ii=0; ii<lw[0]; ii++, n++) {
+          const PetscScalar *xr = xl + bs*((ii+p[0]) + (jj+p[1])*xw[0] + (kk+p[2])*xw[0]*xw[1]);
+          for (r=0; r<bs; r++) x[n*bs+r] = xr[r];
+        }
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArray(a->xlocal,&xl);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatConvert_IGA_AIJ"
+static PetscErrorCode MatConvert_IGA_AIJ(Mat A,MatType newtype,MatReuse reuse,Mat *newmat)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  IGA            iga = a->iga;
+  MPI_Comm       comm;
+  Mat            B;
+  PetscInt       bs = a->bs, bs2 = a->bs2, ns = a->ns;
+  PetscInt       m,n,M,N,rstart,cstart,cend;
+  PetscInt       nx,*xidx,*cols,*dnz,*onz;
+  PetscBool      *inside;
+  PetscScalar    *vals;
+  PetscInt       row,ii,jj,kk,s,i;
+  AO             ao;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(A,&m,&n);CHKERRQ(ierr);
+  ierr = MatGetSize(A,&M,&N);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRangeColumn(A,&cstart,&cend);CHKERRQ(ierr);
+  rstart /= bs; cstart /= bs; cend /= bs;
+
+  /* global block indices of the column box */
+  ierr = IGA_Grid_GhostIndices(a->xgrid,1,&nx,&xidx);CHKERRQ(ierr);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = AOApplicationToPetsc(ao,nx,xidx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nx,&inside);CHKERRQ(ierr);
+  for (kk=0; kk<a->xwidth[2]; kk++)
+    for (jj=0; jj<a->xwidth[1]; jj++)
+      for (ii=0; ii<a->xwidth[0]; ii++) {
+        PetscInt c[3],k; PetscBool in = PETSC_TRUE;
+        c[0] = a->xstart[0]+ii; c[1] = a->xstart[1]+jj; c[2] = a->xstart[2]+kk;
+        for (k=0; k<3; k++)
+          if (!a->periodic[k] && (c[k] < 0 || c[k] >= a->sizes[k])) in = PETSC_FALSE;
+        inside[ii + jj*a->xwidth[0] + kk*a->xwidth[0]*a->xwidth[1]] = in;
+      }
+
+#define ColumnPosition(ii,jj,kk,s) \
+  ((ii) + (s)%a->sw[0] + ((jj) + ((s)/a->sw[0])%a->sw[1])*a->xwidth[0] + \
+   ((kk) + (s)/(a->sw[0]*a->sw[1]))*a->xwidth[0]*a->xwidth[1])
+
+  if (reuse == MAT_REUSE_MATRIX && *newmat != A) {
+    B = *newmat;
+    ierr = MatZeroEntries(B);CHKERRQ(ierr);
+  } else {
+    ierr = PetscCalloc1(a->nrows,&dnz);CHKERRQ(ierr);
+    ierr = PetscCalloc1(a->nrows,&onz);CHKERRQ(ierr);
+    for (row=0, kk=0; kk<a->lwidth[2]; kk++)
+      for (jj=0; jj<a->lwidth[1]; jj++)
+        for (ii=0; ii<a->lwidth[0]; ii++, row++)
+          for (s=0; s<ns; s++) {
+            PetscInt pos = ColumnPosition(ii,jj,kk,s);
+            if (!inside[pos]) continue;
+            if (xidx[pos] >= cstart && xidx[pos] < cend) dnz[row]++; else onz[row]++;
+          }
+    ierr = MatCreate(comm,&B);CHKERRQ(ierr);
+    ierr = MatSetSizes(B,m,n,M,N);CHKERRQ(ierr);
+    ierr = MatSetBlockSizes(B,bs,bs);CHKERRQ(ierr);
+    ierr = MatSetType(B,newtype);CHKERRQ(ierr);
+    ierr = MatXAIJSetPreallocation(B,bs,dnz,onz,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscFree(dnz);CHKERRQ(ierr);
+    ierr = PetscFree(onz);CHKERRQ(ierr);
+  }
+
+  ierr = PetscMalloc1(ns,&cols);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ns*bs2,&vals);CHKERRQ(ierr);
+  for (row=0, kk=0; kk<a->lwidth[2]; kk++)
+    for (jj=0; jj<a->lwidth[1]; jj++)
+      for (ii=0; ii<a->lwidth[0]; ii++, row++) {
+        const PetscScalar *V = a->values + row*ns*bs2;
+        PetscInt r,q,count = 0,grow = rstart + row;
+        for (s=0; s<ns; s++) {
+          PetscInt pos = ColumnPosition(ii,jj,kk,s);
+          if (inside[pos]) cols[count++] = xidx[pos];
+        }
+        for (i=0, s=0; s<ns; s++) {
+          PetscInt pos = ColumnPosition(ii,jj,kk,s);
+          if (!inside[pos]) continue;
+          for (r=0; r<bs; r++)
+            for (q=0; q<bs; q++)
+              vals[r*count*bs + i*bs + q] = V[s*bs2 + r*bs + q];
+          i++;
+        }
+        ierr = MatSetValuesBlocked(B,1,&grow,count,cols,vals,ADD_VALUES);CHKERRQ(ierr);
+      }
+#undef ColumnPosition
+  ierr = PetscFree(cols);CHKERRQ(ierr);
+  ierr = PetscFree(vals);CHKERRQ(ierr);
+  ierr = PetscFree(inside);CHKERRQ(ierr);
+  ierr = PetscFree(xidx);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd  (B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  if (reuse == MAT_REUSE_MATRIX && *newmat == A) {
+    ierr = MatHeaderReplace(A,B);CHKERRQ(ierr);
+  } else {
+    *newmat = B;
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatView_IGA"
+static PetscErrorCode MatView_IGA(Mat A,PetscViewer viewer)
+{
+  Mat_IGA           *a = (Mat_IGA*)A->data;
+  PetscBool         isascii;
+  PetscViewerFormat format;
+  Mat               B;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&isascii);CHKERRQ(ierr);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (isascii && (format == PETSC_VIEWER_ASCII_INFO || format == PETSC_VIEWER_ASCII_INFO_DETAIL)) {
+    ierr = PetscViewerASCIIPrintf(viewer,"stencil: %D x %D x %D blocks of size %D\n",
+                                  a->sw[0],a->sw[1],a->sw[2],a->bs);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatConvert_IGA_AIJ(A,MATAIJ,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject)B,((PetscObject)A)->name);CHKERRQ(ierr);
+  ierr = MatView(B,viewer);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatDuplicate_IGA"
+static PetscErrorCode MatDuplicate_IGA(Mat A,MatDuplicateOption op,Mat *B)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGACreateMat(a->iga,B);CHKERRQ(ierr);
+  if (op == MAT_COPY_VALUES) {
+    Mat_IGA *b = (Mat_IGA*)(*B)->data;
+    ierr = PetscMemcpy(b->values,a->values,a->nrows*a->ns*a->bs2*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatSetOption_IGA"
+static PetscErrorCode MatSetOption_IGA(Mat A,MatOption op,PetscBool flg)
+{
+  Mat_IGA *a = (Mat_IGA*)A->data;
+  PetscFunctionBegin;
+  switch (op) {
+  case MAT_ROW_ORIENTED:
+    a->roworiented = flg; break;
+  case MAT_NEW_NONZERO_LOCATIONS:
+  case MAT_NEW_NONZERO_LOCATION_ERR:
+  case MAT_NEW_NONZERO_ALLOCATION_ERR:
+  case MAT_UNUSED_NONZERO_LOCATION_ERR:
+  case MAT_KEEP_NONZERO_PATTERN:
+    /* the stencil is fixed, entries outside it always error */
+    break;
+  case MAT_NO_OFF_PROC_ENTRIES:
+    /* ghost rows are always sent to their owners at assembly */
+    break;
+  case MAT_SYMMETRIC:
+  case MAT_STRUCTURALLY_SYMMETRIC:
+  case MAT_HERMITIAN:
+  case MAT_SYMMETRY_ETERNAL:
+  case MAT_SPD:
+    /* recorded by MatSetOption() itself */
+    break;
+  default:
+    SETERRQ1(((PetscObject)A)->comm,PETSC_ERR_SUP,"Option %d not supported by matrix type " MATIGA,(int)op);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatSetUp_IGA"
+static PetscErrorCode MatSetUp_IGA(Mat A)
+{
+  PetscFunctionBegin;
+  SETERRQ(((PetscObject)A)->comm,PETSC_ERR_ARG_WRONGSTATE,"Matrices of type " MATIGA " must be created with IGACreateMat()");
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatDestroy_IGA"
+static PetscErrorCode MatDestroy_IGA(Mat A)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscFree(a->values);CHKERRQ(ierr);
+  ierr = PetscFree(a->gvalues);CHKERRQ(ierr);
+  ierr = PetscFree(a->slot);CHKERRQ(ierr);
+  ierr = VecDestroy(&a->vvalues);CHKERRQ(ierr);
+  ierr = VecDestroy(&a->vghost);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&a->assembly);CHKERRQ(ierr);
+  ierr = VecDestroy(&a->xlocal);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&a->g2x);CHKERRQ(ierr);
+  ierr = IGA_Grid_Destroy(&a->xgrid);CHKERRQ(ierr);
+  ierr = IGADestroy(&a->iga);CHKERRQ(ierr);
+  ierr = PetscFree(A->data);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_aij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_baij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_seqbaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_mpibaij_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+EXTERN_C_BEGIN
+#undef  __FUNCT__
+#define __FUNCT__ "MatCreate_IGA"
+PetscErrorCode MatCreate_IGA(Mat A)
+{
+  Mat_IGA        *a;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+#if PETSC_VERSION_LT(3,5,0)
+  ierr = PetscNewLog(A,Mat_IGA,&a);CHKERRQ(ierr);
+#else
+  ierr = PetscNewLog(A,&a);CHKERRQ(ierr);
+#endif
+  A->data = (void*)a;
+  a->roworiented = PETSC_TRUE;
+  ierr = PetscMemzero(A->ops,sizeof(struct _MatOps));CHKERRQ(ierr);
+  A->ops->setup                 = MatSetUp_IGA;
+  A->ops->destroy               = MatDestroy_IGA;
+  A->ops->view                  = MatView_IGA;
+  A->ops->setoption             = MatSetOption_IGA;
+  A->ops->duplicate             = MatDuplicate_IGA;
+  A->ops->zeroentries           = MatZeroEntries_IGA;
+  A->ops->setvalueslocal        = MatSetValuesLocal_IGA;
+  A->ops->setvaluesblockedlocal = MatSetValuesBlockedLocal_IGA;
+  A->ops->assemblybegin         = MatAssemblyBegin_IGA;
+  A->ops->assemblyend           = MatAssemblyEnd_IGA;
+  A->ops->mult                  = MatMult_IGA;
+  A->ops->multadd               = MatMultAdd_IGA;
+  A->ops->multtranspose         = MatMultTranspose_IGA;
+  A->ops->multtransposeadd      = MatMultTransposeAdd_IGA;
+  A->ops->getdiagonal           = MatGetDiagonal_IGA;
+  A->ops->scale                 = MatScale_IGA;
+  A->ops->shift                 = MatShift_IGA;
+  A->ops->sor                   = MatSOR_IGA;
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_aij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_seqaij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_mpiaij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_baij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_seqbaij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_iga_mpibaij_C",MatConvert_IGA_AIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATIGA);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+EXTERN_C_END
+
+PETSC_EXTERN PetscErrorCode MatIGASetUp_IGA(Mat,IGA);
+
+#undef  __FUNCT__
+#define __FUNCT__ "MatIGASetUp_IGA"
+PetscErrorCode MatIGASetUp_IGA(Mat A,IGA iga)
+{
+  Mat_IGA        *a = (Mat_IGA*)A->data;
+  MPI_Comm       comm;
+  PetscInt       i,bs,B,nlocal,*iglobal;
+  AO             ao;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,2);
+  IGACheckSetUpStage2(iga,2);
+  if (iga->collocation)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Matrix type " MATIGA " does not support collocation");
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+
+  ierr = PetscObjectReference((PetscObject)iga);CHKERRQ(ierr);
+  a->iga = iga;
+  a->dim = iga->dim;
+  a->bs  = bs = iga->dof;
+  a->bs2 = bs*bs;
+  a->ns  = 1;
+  for (i=0; i<3; i++) {
+    PetscBool w = (i < iga->dim) ? iga->axis[i]->periodic : PETSC_FALSE;
+    PetscInt  p = (i < iga->dim) ? iga->axis[i]->p : 0;
+    a->sizes[i]    = iga->node_sizes[i];
+    a->periodic[i] = w;
+    a->p[i]        = p;
+    a->sw[i]       = 2*p + 1;
+    a->ns         *= 2*p + 1;
+    a->lstart[i]   = iga->node_lstart[i];
+    a->lwidth[i]   = iga->node_lwidth[i];
+    a->gstart[i]   = iga->node_gstart[i];
+    a->gwidth[i]   = iga->node_gwidth[i];
+    a->xstart[i]   = a->lstart[i] - p;
+    a->xwidth[i]   = a->lwidth[i] + 2*p;
+  }
+  B = a->ns*a->bs2;
+
+  { /* owned rows and ghost rows */
+    PetscInt ii,jj,kk,pos=0,nghost=0,nrows=1,*natural;
+    for (i=0; i<3; i++) nrows *= a->lwidth[i];
+    nlocal = a->gwidth[0]*a->gwidth[1]*a->gwidth[2];
+    ierr = PetscMalloc1(nlocal,&a->slot);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nlocal,&natural);CHKERRQ(ierr);
+    for (kk=0; kk<a->gwidth[2]; kk++)
+      for (jj=0; jj<a->gwidth[1]; jj++)
+        for (ii=0; ii<a->gwidth[0]; ii++, pos++) {
+          PetscInt c[3],o[3],k,owned = 1;
+          c[0] = a->gstart[0]+ii; c[1] = a->gstart[1]+jj; c[2] = a->gstart[2]+kk;
+          for (k=0; k<3; k++) {
+            o[k] = c[k] - a->lstart[k];
+            if (o[k] < 0 || o[k] >= a->lwidth[k]) owned = 0;
+          }
+          if (owned) {
+            a->slot[pos] = o[0] + o[1]*a->lwidth[0] + o[2]*a->lwidth[0]*a->lwidth[1];
+          } else {
+            for (k=0; k<3; k++) { /* account for periodicity */
+              if (c[k] < 0) c[k] += a->sizes[k]; else if (c[k] >= a->sizes[k]) c[k] %= a->sizes[k];
+            }
+            natural[nghost] = c[0] + c[1]*a->sizes[0] + c[2]*a->sizes[0]*a->sizes[1];
+            a->slot[pos] = -(++nghost);
+          }
+        }
+    ierr = AOApplicationToPetsc(ao,nghost,natural);CHKERRQ(ierr);
+    iglobal = natural;
+    a->nrows  = nrows;
+    a->nghost = nghost;
+  }
+  ierr = PetscCalloc1(a->nrows*B,&a->values);CHKERRQ(ierr);
+  ierr = PetscCalloc1(a->nghost*B,&a->gvalues);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(a->nrows+a->nghost)*B*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(comm,B,a->nrows*B,PETSC_DECIDE,a->values,&a->vvalues);CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF,B,a->nghost*B,a->gvalues,&a->vghost);CHKERRQ(ierr);
+  { /* scatter ghost rows to their owners */
+    IS isowner;
+    ierr = ISCreateBlock(comm,B,a->nghost,iglobal,PETSC_COPY_VALUES,&isowner);CHKERRQ(ierr);
+    ierr = VecScatterCreate(a->vghost,NULL,a->vvalues,isowner,&a->assembly);CHKERRQ(ierr);
+    ierr = ISDestroy(&isowner);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(iglobal);CHKERRQ(ierr);
+
+  { /* ghosted column box */
+    Vec xlocal; VecScatter g2x;
+    ierr = IGA_Grid_Create(comm,&a->xgrid);CHKERRQ(ierr);
+    ierr = IGA_Grid_Init(a->xgrid,3,bs,a->sizes,a->lstart,a->lwidth,a->xstart,a->xwidth);CHKERRQ(ierr);
+    ierr = IGA_Grid_SetAO(a->xgrid,ao);CHKERRQ(ierr);
+    ierr = IGA_Grid_GetVecLocal(a->xgrid,VECSTANDARD,&xlocal);CHKERRQ(ierr);
+    ierr = IGA_Grid_GetScatterG2L(a->xgrid,&g2x);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)xlocal);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)g2x);CHKERRQ(ierr);
+    a->xlocal = xlocal; a->g2x = g2x;
+  }
+
+  A->preallocated = PETSC_TRUE;
+  A->assembled    = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
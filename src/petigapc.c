@@ -202,6 +202,64 @@ PetscErrorCode IGAComputeBDDCBoundary(PetscInt dim,PetscInt bs,const PetscInt sh
   PetscFunctionReturn(0);
 }
 
+/*
+  Primal vertices are the corners of the subdomain interfaces. Along a
+  partitioned direction the interface with a neighbor is located at
+  the first node owned by the upper process, which both processes can
+  compute without communication. Along a direction that is not
+  partitioned the corners are at the (non-periodic) patch boundaries.
+*/
+static
+#undef  __FUNCT__
+#define __FUNCT__ "IGAComputeBDDCVertices"
+PetscErrorCode IGAComputeBDDCVertices(PetscInt dim,PetscInt bs,const PetscInt shape[3],
+                                      const PetscInt lstart[3],const PetscInt lwidth[3],
+                                      const PetscInt gstart[3],
+                                      const PetscInt ranks[3],const PetscInt sizes[3],
+                                      IGAAxis axis[3],
+                                      PetscInt *_nvertex,PetscInt *_ivertex[])
+{
+  PetscInt       c,dir,count[3]={1,1,1},coord[3][2]={{0,0},{0,0},{0,0}};
+  PetscInt       i,j,k,pos=0,nvertex=0,*ivertex=NULL;
+  PetscBool      split = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidIntPointer(_nvertex,10);
+  PetscValidPointer(_ivertex,11);
+
+  for (dir=0; dir<dim; dir++) {
+    PetscBool wrap = axis[dir]->periodic;
+    count[dir] = 0;
+    if (sizes[dir] > 1) {
+      PetscInt lo = lstart[dir] - gstart[dir];
+      PetscInt hi = lo + lwidth[dir];
+      split = PETSC_TRUE;
+      if (wrap || ranks[dir] > 0)
+        coord[dir][count[dir]++] = lo;
+      if ((wrap || ranks[dir] < sizes[dir]-1) && hi < shape[dir])
+        coord[dir][count[dir]++] = hi;
+    } else if (!wrap) {
+      coord[dir][count[dir]++] = 0;
+      if (shape[dir] > 1) coord[dir][count[dir]++] = shape[dir]-1;
+    }
+  }
+  if (split) nvertex = bs*count[0]*count[1]*count[2];
+
+  ierr = PetscMalloc(nvertex*sizeof(PetscInt),&ivertex);CHKERRQ(ierr);
+  if (split)
+    for (k=0; k<count[2]; k++)
+      for (j=0; j<count[1]; j++)
+        for (i=0; i<count[0]; i++) {
+          PetscInt index = Index(shape,coord[0][i],coord[1][j],coord[2][k]);
+          for (c=0; c<bs; c++) ivertex[pos++] = c + bs*index;
+        }
+
+  *_nvertex = nvertex;
+  *_ivertex = ivertex;
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAPreparePCBDDC"
 PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc)
@@ -212,6 +270,7 @@ PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc)
   PetscBool      graph = PETSC_TRUE;
   PetscBool      boundary = PETSC_TRUE;
   PetscBool      nullspace = PETSC_TRUE;
+  PetscBool      vertices = PETSC_FALSE;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -238,6 +297,7 @@ PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc)
   ierr = PetscOptionsGetBool(prefix,"-iga_set_bddc_graph",&graph,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsGetBool(prefix,"-iga_set_bddc_boundary",&boundary,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsGetBool(prefix,"-iga_set_bddc_nullspace",&nullspace,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(prefix,"-iga_set_bddc_vertices",&vertices,NULL);CHKERRQ(ierr);
 
   if (graph) {
     PetscInt i,dim,dof;
@@ -313,6 +373,33 @@ PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc)
     ierr = ISDestroy(&isn);CHKERRQ(ierr);
   }
 
+  if (vertices) {
+    PetscInt  i,dim,dof;
+    PetscInt  shape[3] = {1,1,1};
+    PetscInt  nv=0,*iv=NULL;
+    MPI_Comm  comm;
+    IS        isv;
+    ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
+    ierr = IGAGetDof(iga,&dof);CHKERRQ(ierr);
+    for (i=0; i<dim; i++) shape[i] = iga->node_gwidth[i];
+    ierr = IGAComputeBDDCVertices(dim,dof,shape,
+                                  iga->node_lstart,iga->node_lwidth,iga->node_gstart,
+                                  iga->proc_ranks,iga->proc_sizes,iga->axis,
+                                  &nv,&iv);CHKERRQ(ierr);
+#if PETSC_VERSION_LT(3,5,0)
+    comm = PETSC_COMM_SELF;
+#else
+    ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
+#endif
+    ierr = ISCreateGeneral(comm,nv,iv,PETSC_OWN_POINTER,&isv);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_PCBDDC) /* XXX */
+#if PETSC_VERSION_GE(3,5,0)
+    ierr = PCBDDCSetPrimalVerticesLocalIS(pc,isv);CHKERRQ(ierr);
+#endif
+#endif
+    ierr = ISDestroy(&isv);CHKERRQ(ierr);
+  }
+
   if (nullspace) {
     MatNullSpace nsp;
     ierr = MatGetNullSpace(mat,&nsp);CHKERRQ(ierr);
@@ -328,6 +415,131 @@ PetscErrorCode IGAPreparePCBDDC(IGA iga,PC pc)
 
 /* ---------------------------------------------------------------- */
 
+/*
+  Split the locally owned node box into nsub[0]*nsub[1]*nsub[2]
+  subdomains and extend each of them by overlap[i] node layers along
+  axis i (one layer per element for maximal continuity splines).
+  Opt-in with -iga_set_asm_subdomains; the overlap defaults to the
+  -pc_asm_overlap value, or 1 if that is not set.
+*/
+#undef  __FUNCT__
+#define __FUNCT__ "IGAPreparePCASM"
+PetscErrorCode IGAPreparePCASM(IGA iga,PC pc)
+{
+  Mat            mat;
+  void           (*f)(void);
+  const char     *prefix;
+  PetscBool      match,subdomains = PETSC_FALSE;
+  PetscInt       i,dim,dof,n,nsub[3] = {1,1,1},overlap[3] = {1,1,1};
+  IS             *is,*is_local;
+  AO             ao;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(pc,PC_CLASSID,2);
+  IGACheckSetUpStage2(iga,1);
+
+  ierr = PetscObjectTypeCompare((PetscObject)pc,PCASM,&match);CHKERRQ(ierr);
+  if (!match) PetscFunctionReturn(0);
+  ierr = PCGetOperators(pc,NULL,&mat);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)mat,"MatISGetLocalMat_C",&f);CHKERRQ(ierr);
+  if (f) PetscFunctionReturn(0);
+
+  ierr = IGAGetOptionsPrefix(iga,&prefix);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(prefix,"-iga_set_asm_subdomains",&subdomains,NULL);CHKERRQ(ierr);
+  if (!subdomains) PetscFunctionReturn(0);
+
+  ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
+  ierr = IGAGetDof(iga,&dof);CHKERRQ(ierr);
+  { /* the overlap is built into the index sets, so PCASM's own becomes the default */
+    const char *pcprefix;
+    PetscInt   ovl;
+    ierr = PCGetOptionsPrefix(pc,&pcprefix);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(pcprefix,"-pc_asm_overlap",&ovl,&match);CHKERRQ(ierr);
+    if (match) for (i=0; i<3; i++) overlap[i] = ovl;
+  }
+  n = dim; ierr = PetscOptionsGetIntArray(prefix,"-iga_asm_subdomains",nsub,&n,&match);CHKERRQ(ierr);
+  if (match && n == 1) for (i=1; i<dim; i++) nsub[i] = nsub[0];
+  n = dim; ierr = PetscOptionsGetIntArray(prefix,"-iga_asm_overlap",overlap,&n,&match);CHKERRQ(ierr);
+  if (match && n == 1) for (i=1; i<dim; i++) overlap[i] = overlap[0];
+  for (i=0; i<dim; i++) {
+    if (nsub[i] < 1) SETERRQ2(((PetscObject)iga)->comm,PETSC_ERR_ARG_OUTOFRANGE,
+                              "Number of subdomains must be positive, got %D in direction %D",nsub[i],i);
+    if (overlap[i] < 0) SETERRQ2(((PetscObject)iga)->comm,PETSC_ERR_ARG_OUTOFRANGE,
+                                 "Overlap must be nonnegative, got %D in direction %D",overlap[i],i);
+    nsub[i] = PetscMin(nsub[i],iga->node_lwidth[i]);
+  }
+  for (i=dim; i<3; i++) {nsub[i] = 1; overlap[i] = 0;}
+
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  n = nsub[0]*nsub[1]*nsub[2];
+  ierr = PetscMalloc1(n,&is);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&is_local);CHKERRQ(ierr);
+  {
+    PetscInt  *sizes  = iga->node_sizes;
+    PetscInt  *lstart = iga->node_lstart;
+    PetscInt  *lwidth = iga->node_lwidth;
+    PetscBool wrap[3] = {PETSC_FALSE,PETSC_FALSE,PETSC_FALSE};
+    PetscInt  s[3],sub = 0;
+    for (i=0; i<dim; i++) wrap[i] = iga->axis[i]->periodic;
+    for (s[2]=0; s[2]<nsub[2]; s[2]++)
+      for (s[1]=0; s[1]<nsub[1]; s[1]++)
+        for (s[0]=0; s[0]<nsub[0]; s[0]++, sub++) {
+          PetscInt a[3],b[3],A[3],B[3],ijk[3];
+          PetscInt m = 1, mloc = 1, *idx, *iloc;
+          for (i=0; i<3; i++) {
+            PetscInt q = lwidth[i] / nsub[i], r = lwidth[i] % nsub[i];
+            a[i] = lstart[i] + s[i]*q + PetscMin(s[i],r);
+            b[i] = a[i] + q + ((s[i] < r) ? 1 : 0);
+            A[i] = a[i] - overlap[i];
+            B[i] = b[i] + overlap[i];
+            if (!wrap[i]) {
+              A[i] = PetscMax(A[i],0);
+              B[i] = PetscMin(B[i],sizes[i]);
+            } else if (B[i]-A[i] >= sizes[i]) {
+              A[i] = 0;
+              B[i] = sizes[i];
+            }
+            m    *= B[i] - A[i];
+            mloc *= b[i] - a[i];
+          }
+          ierr = PetscMalloc1(m,&idx);CHKERRQ(ierr);
+          ierr = PetscMalloc1(mloc,&iloc);CHKERRQ(ierr);
+          m = mloc = 0;
+          for (ijk[2]=A[2]; ijk[2]<B[2]; ijk[2]++)
+            for (ijk[1]=A[1]; ijk[1]<B[1]; ijk[1]++)
+              for (ijk[0]=A[0]; ijk[0]<B[0]; ijk[0]++) {
+                PetscInt c[3],inside = 1;
+                for (i=0; i<3; i++) {
+                  c[i] = ijk[i];
+                  if (c[i] < 0) c[i] += sizes[i]; else if (c[i] >= sizes[i]) c[i] -= sizes[i];
+                  if (ijk[i] < a[i] || ijk[i] >= b[i]) inside = 0;
+                }
+                idx[m] = Index(sizes,c[0],c[1],c[2]);
+                if (inside) iloc[mloc++] = idx[m];
+                m++;
+              }
+          ierr = AOApplicationToPetsc(ao,m,idx);CHKERRQ(ierr);
+          ierr = AOApplicationToPetsc(ao,mloc,iloc);CHKERRQ(ierr);
+          ierr = ISCreateBlock(PETSC_COMM_SELF,dof,m,idx,PETSC_OWN_POINTER,&is[sub]);CHKERRQ(ierr);
+          ierr = ISCreateBlock(PETSC_COMM_SELF,dof,mloc,iloc,PETSC_OWN_POINTER,&is_local[sub]);CHKERRQ(ierr);
+        }
+  }
+  /* the overlap is already built in, do not let PCASM extend it */
+  ierr = PCASMSetOverlap(pc,0);CHKERRQ(ierr);
+  ierr = PCASMSetLocalSubdomains(pc,n,is,is_local);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = ISDestroy(&is[i]);CHKERRQ(ierr);
+    ierr = ISDestroy(&is_local[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(is);CHKERRQ(ierr);
+  ierr = PetscFree(is_local);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* ---------------------------------------------------------------- */
+
 
 #undef  __FUNCT__
 #define __FUNCT__ "IGA_OptionsHandler_PC"
@@ -349,6 +561,7 @@ static PetscErrorCode IGA_OptionsHandler_PC(PetscObject obj,void *ctx)
   PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
   /* */
   ierr = IGAPreparePCBDDC(iga,pc);CHKERRQ(ierr);
+  ierr = IGAPreparePCASM(iga,pc);CHKERRQ(ierr);
   /* */
   PetscFunctionReturn(0);
 }
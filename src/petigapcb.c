@@ -129,6 +129,7 @@ static PetscErrorCode PCSetUp_BBB(PC pc)
   Mat            A,B;
   PetscErrorCode ierr;
   PetscFunctionBegin;
+  IGATraceBegin(__FUNCT__);
 
   A = pc->pmat;
   ierr = PetscObjectQuery((PetscObject)A,"IGA",(PetscObject*)&iga);CHKERRQ(ierr);
@@ -138,6 +139,7 @@ static PetscErrorCode PCSetUp_BBB(PC pc)
   if (!pc->setupcalled) {
     MPI_Comm comm;
     IGA_Grid grid;
+    AO       ao;
     PetscInt i, dim = iga->dim;
     const PetscInt *sizes = iga->node_sizes;
     const PetscInt *lstart = iga->node_lstart;
@@ -171,7 +173,8 @@ static PetscErrorCode PCSetUp_BBB(PC pc)
     ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
     ierr = IGA_Grid_Create(comm,&grid);CHKERRQ(ierr);
     ierr = IGA_Grid_Init(grid,iga->dim,1,sizes,lstart,lwidth,gstart,gwidth);CHKERRQ(ierr);
-    ierr = IGA_Grid_SetAO(grid,iga->ao);CHKERRQ(ierr);
+    ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+    ierr = IGA_Grid_SetAO(grid,ao);CHKERRQ(ierr);
     ierr = IGA_Grid_GetLGMap(grid,&bbb->lgmap);CHKERRQ(ierr);
     ierr = PetscObjectReference((PetscObject)bbb->lgmap);CHKERRQ(ierr);
     ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
@@ -266,6 +269,7 @@ static PetscErrorCode PCSetUp_BBB(PC pc)
   ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -103,6 +103,7 @@ static PetscErrorCode PCSetUp_EBE(PC pc)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  IGATraceBegin(__FUNCT__);
   A = pc->pmat;
   ierr = PetscObjectQuery((PetscObject)A,"IGA",(PetscObject*)&iga);CHKERRQ(ierr);
   if (!iga) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Matrix is missing the IGA context");
@@ -186,6 +187,7 @@ static PetscErrorCode PCSetUp_EBE(PC pc)
   ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
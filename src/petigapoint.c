@@ -60,6 +60,7 @@ PetscErrorCode IGAPointFreeWork(IGAPoint point)
       {ierr = PetscFree(point->wmat[i]);CHKERRQ(ierr);}
     point->nmat = 0;
   }
+  point->mem = 0;
   PetscFunctionReturn(0);
 }
 
@@ -104,9 +105,9 @@ PetscErrorCode IGAPointInit(IGAPoint point,IGAElement element)
     size_t MAX_WORK_MAT = sizeof(point->wmat)/sizeof(PetscScalar*);
     size_t i, nv = element->nen * element->dof, nm = nv*nv;
     for (i=0; i<MAX_WORK_VEC; i++)
-      {ierr = PetscMalloc1(nv,&point->wvec[i]);CHKERRQ(ierr);}
+      {ierr = IGAMalloc1(point->mem,nv,&point->wvec[i]);CHKERRQ(ierr);}
     for (i=0; i<MAX_WORK_MAT; i++)
-      {ierr = PetscMalloc1(nm,&point->wmat[i]);CHKERRQ(ierr);}
+      {ierr = IGAMalloc1(point->mem,nm,&point->wmat[i]);CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -252,7 +253,7 @@ static PetscErrorCode IGAPointFormScale(IGAPoint p,PetscReal L[])
     PetscInt i;
     PetscInt dim = p->dim;
     PetscInt *ID = p->parent->ID;
-    IGABasis *BD = p->parent->parent->basis;
+    IGABasis *BD = p->parent->BD;
     for (i=0; i<dim; i++)
       L[i] = BD[i]->detJ[ID[i]];
   }
@@ -518,7 +519,9 @@ PetscErrorCode IGAPointAddVec(IGAPoint point,const PetscScalar f[],PetscScalar F
   PetscValidScalarPointer(f,2);
   PetscValidScalarPointer(F,3);
   m = point->neq * point->dof;
+  IGAProfileBegin(point->parent->parent,IGA_PROFILE_ADDPOINT);
   ierr = IGAPointAddArray(point,m,f,F);CHKERRQ(ierr);
+  IGAProfileEnd(point->parent->parent,IGA_PROFILE_ADDPOINT);
   PetscFunctionReturn(0);
 }
 
@@ -534,6 +537,8 @@ PetscErrorCode IGAPointAddMat(IGAPoint point,const PetscScalar k[],PetscScalar K
   PetscValidScalarPointer(K,3);
   m = point->neq * point->dof;
   n = point->nen * point->dof;
+  IGAProfileBegin(point->parent->parent,IGA_PROFILE_ADDPOINT);
   ierr = IGAPointAddArray(point,m*n,k,K);CHKERRQ(ierr);
+  IGAProfileEnd(point->parent->parent,IGA_PROFILE_ADDPOINT);
   PetscFunctionReturn(0);
 }
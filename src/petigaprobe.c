@@ -47,6 +47,115 @@ extern void IGA_GetHess   (PetscInt nen,PetscInt dof,PetscInt dim,const PetscRea
 extern void IGA_GetDer3   (PetscInt nen,PetscInt dof,PetscInt dim,const PetscReal N[],const PetscScalar U[],PetscScalar u[]);
 EXTERN_C_END
 
+static void IGAProbe_Closure(IGAProbe prb)
+{
+  PetscInt a,nen = prb->nen;
+  PetscInt i,dim = prb->dim;
+  PetscInt c,dof = prb->dof;
+  PetscInt *map  = prb->map;
+  {
+    PetscInt *ID = prb->ID, *p = prb->p, *s = prb->s, *w = prb->w;
+    PetscInt ia, inen = p[0]+1, ioffset = ID[0]-p[0], istart = s[0];
+    PetscInt ja, jnen = p[1]+1, joffset = ID[1]-p[1], jstart = s[1];
+    PetscInt ka, knen = p[2]+1, koffset = ID[2]-p[2], kstart = s[2];
+    PetscInt pos = 0, jstride = w[0], kstride = w[0]*w[1];
+    for (ka=0; ka<knen; ka++) {
+      for (ja=0; ja<jnen; ja++) {
+        for (ia=0; ia<inen; ia++) {
+          PetscInt iA = (ioffset + ia) - istart;
+          PetscInt jA = (joffset + ja) - jstart;
+          PetscInt kA = (koffset + ka) - kstart;
+          map[pos++] = iA + jA*jstride + kA*kstride;
+        }
+      }
+    }
+  }
+  if (prb->arrayW)
+    for (a=0; a<nen; a++)
+      prb->W[a] = prb->arrayW[map[a]];
+  if (prb->arrayX)
+    for (a=0; a<nen; a++)
+      for (i=0; i<dim; i++)
+        prb->X[i + a*dim] = prb->arrayX[i + map[a]*dim];
+  if (prb->arrayA)
+    for (a=0; a<nen; a++)
+      for (c=0; c<dof; c++)
+        prb->A[c + a*dof] = prb->arrayA[c + map[a]*dof];
+}
+
+static void IGAProbe_Basis1D(IGAProbe prb,PetscInt i,PetscInt ID,PetscReal u,PetscReal BD[])
+{
+  void (*ComputeBasis)(PetscInt,PetscReal,PetscInt,PetscInt,const PetscReal[],PetscReal[]);
+  switch (prb->iga->basis[i]->type)
+    {
+    case IGA_BASIS_BSPLINE:
+    case IGA_BASIS_BERNSTEIN:
+      ComputeBasis = IGA_Basis_BSpline;  break;
+    case IGA_BASIS_LAGRANGE:
+      ComputeBasis = IGA_Basis_Lagrange; break;
+    default:
+      ComputeBasis = IGA_Basis_BSpline;
+    }
+  ComputeBasis(ID,u,prb->p[i],prb->order,prb->U[i],BD);
+}
+
+static void IGAProbe_Shape(IGAProbe prb,PetscReal *BD[3])
+{
+  /* Tensor product 1D basis functions */
+  {
+    PetscInt  rational = prb->arrayW ? 1 : 0;
+    PetscReal **M = prb->basis;
+    switch (prb->dim) {
+    case 3: IGA_BasisFuns_3D(prb->order,rational,prb->W,
+                             1,prb->p[0]+1,prb->order,BD[0],
+                             1,prb->p[1]+1,prb->order,BD[1],
+                             1,prb->p[2]+1,prb->order,BD[2],
+                             M[0],M[1],M[2],M[3]); break;
+    case 2: IGA_BasisFuns_2D(prb->order,rational,prb->W,
+                             1,prb->p[0]+1,prb->order,BD[0],
+                             1,prb->p[1]+1,prb->order,BD[1],
+                             M[0],M[1],M[2],M[3]); break;
+    case 1: IGA_BasisFuns_1D(prb->order,rational,prb->W,
+                             1,prb->p[0]+1,prb->order,BD[0],
+                             M[0],M[1],M[2],M[3]); break;
+    }
+  }
+  /* Geometry mapping */
+  if (prb->arrayX) {
+    PetscReal **M = prb->basis;
+    PetscReal **N = prb->shape;
+    PetscReal *J  = prb->detX;
+    PetscReal *G0 = prb->gradX[0], *G1 = prb->gradX[1];
+    PetscReal *H0 = prb->hessX[0], *H1 = prb->hessX[1];
+    PetscReal *I0 = prb->der3X[0], *I1 = prb->der3X[1];
+    switch (prb->dim) {
+    case 3: IGA_ShapeFuns_3D(prb->order,1,prb->nen,prb->X,
+                             M[0],M[1],M[2],M[3],
+                             N[0],N[1],N[2],N[3],
+                             J,G0,G1,H0,H1,I0,I1); break;
+    case 2: IGA_ShapeFuns_2D(prb->order,1,prb->nen,prb->X,
+                             M[0],M[1],M[2],M[3],
+                             N[0],N[1],N[2],N[3],
+                             J,G0,G1,H0,H1,I0,I1); break;
+    case 1: IGA_ShapeFuns_1D(prb->order,1,prb->nen,prb->X,
+                             M[0],M[1],M[2],M[3],
+                             N[0],N[1],N[2],N[3],
+                             J,G0,G1,H0,H1,I0,I1); break;
+    }
+  }
+}
+
+static void IGAProbe_Eval(IGAProbe prb,PetscInt der,PetscScalar A[])
+{
+  PetscReal *shape = prb->arrayX ? prb->shape[der] : prb->basis[der];
+  switch (der) {
+  case 0: IGA_GetValue(prb->nen,prb->dof,/*     */shape,prb->A,A); break;
+  case 1: IGA_GetGrad (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
+  case 2: IGA_GetHess (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
+  case 3: IGA_GetDer3 (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
+  }
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAProbeCreate"
 PetscErrorCode IGAProbeCreate(IGA iga,Vec A,IGAProbe *_prb)
@@ -125,6 +234,7 @@ PetscErrorCode IGAProbeCreate(IGA iga,Vec A,IGAProbe *_prb)
       G0[i*(dim+1)] = G1[i*(dim+1)] = 1.0;
   }
 
+  prb->ptsorder = -1;
   ierr = IGAGetOrder(iga,&prb->order);CHKERRQ(ierr);
   ierr = IGAProbeSetOrder(prb,prb->order);CHKERRQ(ierr);
   ierr = IGAProbeSetCollective(prb,PETSC_TRUE);CHKERRQ(ierr);
@@ -178,6 +288,18 @@ PetscErrorCode IGAProbeDestroy(IGAProbe *_prb)
   ierr = PetscFree(prb->shape[2]);CHKERRQ(ierr);
   ierr = PetscFree(prb->shape[3]);CHKERRQ(ierr);
 
+  ierr = PetscFree(prb->pts);CHKERRQ(ierr);
+  ierr = PetscFree(prb->ptsID);CHKERRQ(ierr);
+  ierr = PetscFree(prb->ptsown);CHKERRQ(ierr);
+  ierr = PetscFree(prb->ptsBD[0]);CHKERRQ(ierr);
+  ierr = PetscFree(prb->ptsBD[1]);CHKERRQ(ierr);
+  ierr = PetscFree(prb->ptsBD[2]);CHKERRQ(ierr);
+
+  ierr = PetscFree(prb->box);CHKERRQ(ierr);
+  ierr = PetscFree(prb->boxID);CHKERRQ(ierr);
+  ierr = PetscFree(prb->celloff);CHKERRQ(ierr);
+  ierr = PetscFree(prb->cellbox);CHKERRQ(ierr);
+
   ierr = PetscFree(prb);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -215,6 +337,7 @@ PetscErrorCode IGAProbeSetCollective(IGAProbe prb,PetscBool collective)
   PetscValidPointer(prb,1);
   PetscValidLogicalCollectiveBool(prb->iga,collective,2);
   prb->collective = collective;
+  prb->ptsorder = -1; /* point owners depend on the mode */
   if (prb->collective) {
     ierr = IGAGetComm(prb->iga,&comm);CHKERRQ(ierr);
     ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
@@ -280,40 +403,7 @@ PetscErrorCode IGAProbeSetPoint(IGAProbe prb,const PetscReal u[])
   if (prb->offprocess && !prb->collective) PetscFunctionReturn(0);
 
   /* Span closure */
-  if (!prb->offprocess) {
-    PetscInt a,nen = prb->nen;
-    PetscInt i,dim = prb->dim;
-    PetscInt c,dof = prb->dof;
-    PetscInt *map  = prb->map;
-    {
-      PetscInt *ID = prb->ID, *p = prb->p, *s = prb->s, *w = prb->w;
-      PetscInt ia, inen = p[0]+1, ioffset = ID[0]-p[0], istart = s[0];
-      PetscInt ja, jnen = p[1]+1, joffset = ID[1]-p[1], jstart = s[1];
-      PetscInt ka, knen = p[2]+1, koffset = ID[2]-p[2], kstart = s[2];
-      PetscInt pos = 0, jstride = w[0], kstride = w[0]*w[1];
-      for (ka=0; ka<knen; ka++) {
-        for (ja=0; ja<jnen; ja++) {
-          for (ia=0; ia<inen; ia++) {
-            PetscInt iA = (ioffset + ia) - istart;
-            PetscInt jA = (joffset + ja) - jstart;
-            PetscInt kA = (koffset + ka) - kstart;
-            map[pos++] = iA + jA*jstride + kA*kstride;
-          }
-        }
-      }
-    }
-    if (prb->arrayW)
-      for (a=0; a<nen; a++)
-        prb->W[a] = prb->arrayW[map[a]];
-    if (prb->arrayX)
-      for (a=0; a<nen; a++)
-        for (i=0; i<dim; i++)
-          prb->X[i + a*dim] = prb->arrayX[i + map[a]*dim];
-    if (prb->arrayA)
-      for (a=0; a<nen; a++)
-        for (c=0; c<dof; c++)
-          prb->A[c + a*dof] = prb->arrayA[c + map[a]*dof];
-  }
+  if (!prb->offprocess) IGAProbe_Closure(prb);
   if (prb->collective) {
     MPI_Comm    comm;
     PetscMPIInt nen = (PetscMPIInt)prb->nen;
@@ -329,67 +419,11 @@ PetscErrorCode IGAProbeSetPoint(IGAProbe prb,const PetscReal u[])
   }
 
   /* Compute 1D basis functions */
-  {
-    IGABasis *basis = prb->iga->basis;
-    void (*ComputeBasis)(PetscInt,PetscReal,PetscInt,PetscInt,const PetscReal[],PetscReal[]);
-    for (i=0; i<prb->dim; i++) {
-      switch (basis[i]->type)
-        {
-        case IGA_BASIS_BSPLINE:
-        case IGA_BASIS_BERNSTEIN:
-          ComputeBasis = IGA_Basis_BSpline;  break;
-        case IGA_BASIS_LAGRANGE:
-          ComputeBasis = IGA_Basis_Lagrange; break;
-        default:
-          ComputeBasis = IGA_Basis_BSpline;
-        }
-      ComputeBasis(prb->ID[i],prb->point[i],prb->p[i],prb->order,prb->U[i],prb->BD[i]);
-    }
-  }
-
-  /* Tensor product 1D basis functions */
-  {
-    PetscInt  rational = prb->arrayW ? 1 : 0;
-    PetscReal **M = prb->basis;
-    switch (prb->dim) {
-    case 3: IGA_BasisFuns_3D(prb->order,rational,prb->W,
-                             1,prb->p[0]+1,prb->order,prb->BD[0],
-                             1,prb->p[1]+1,prb->order,prb->BD[1],
-                             1,prb->p[2]+1,prb->order,prb->BD[2],
-                             M[0],M[1],M[2],M[3]); break;
-    case 2: IGA_BasisFuns_2D(prb->order,rational,prb->W,
-                             1,prb->p[0]+1,prb->order,prb->BD[0],
-                             1,prb->p[1]+1,prb->order,prb->BD[1],
-                             M[0],M[1],M[2],M[3]); break;
-    case 1: IGA_BasisFuns_1D(prb->order,rational,prb->W,
-                             1,prb->p[0]+1,prb->order,prb->BD[0],
-                             M[0],M[1],M[2],M[3]); break;
-    }
-  }
+  for (i=0; i<prb->dim; i++)
+    IGAProbe_Basis1D(prb,i,prb->ID[i],prb->point[i],prb->BD[i]);
 
-  /* Geometry mapping */
-  if (prb->arrayX) {
-    PetscReal **M = prb->basis;
-    PetscReal **N = prb->shape;
-    PetscReal *J  = prb->detX;
-    PetscReal *G0 = prb->gradX[0], *G1 = prb->gradX[1];
-    PetscReal *H0 = prb->hessX[0], *H1 = prb->hessX[1];
-    PetscReal *I0 = prb->der3X[0], *I1 = prb->der3X[1];
-    switch (prb->dim) {
-    case 3: IGA_ShapeFuns_3D(prb->order,1,prb->nen,prb->X,
-                             M[0],M[1],M[2],M[3],
-                             N[0],N[1],N[2],N[3],
-                             J,G0,G1,H0,H1,I0,I1); break;
-    case 2: IGA_ShapeFuns_2D(prb->order,1,prb->nen,prb->X,
-                             M[0],M[1],M[2],M[3],
-                             N[0],N[1],N[2],N[3],
-                             J,G0,G1,H0,H1,I0,I1); break;
-    case 1: IGA_ShapeFuns_1D(prb->order,1,prb->nen,prb->X,
-                             M[0],M[1],M[2],M[3],
-                             N[0],N[1],N[2],N[3],
-                             J,G0,G1,H0,H1,I0,I1); break;
-    }
-  }
+  /* Tensor product basis and geometry mapping */
+  IGAProbe_Shape(prb,prb->BD);
 
   PetscFunctionReturn(0);
 }
@@ -427,14 +461,7 @@ PetscErrorCode IGAProbeEvaluate(IGAProbe prb,PetscInt der,PetscScalar A[])
     size_t n = (size_t)prb->dof * intpow[prb->dim][der];
     ierr = PetscMemzero(A,n*sizeof(PetscScalar));CHKERRQ(ierr);
   } else {
-    PetscReal *shape = prb->arrayX ? prb->shape[der] : prb->basis[der];
-    switch (der) {
-    case 0: IGA_GetValue(prb->nen,prb->dof,/*     */shape,prb->A,A); break;
-    case 1: IGA_GetGrad (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
-    case 2: IGA_GetHess (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
-    case 3: IGA_GetDer3 (prb->nen,prb->dof,prb->dim,shape,prb->A,A); break;
-    default: PetscFunctionReturn(PETSC_ERR_ARG_OUTOFRANGE);
-    }
+    IGAProbe_Eval(prb,der,A);
   }
   PetscFunctionReturn(0);
 }
@@ -478,3 +505,387 @@ PetscErrorCode IGAProbeFormDer3(IGAProbe prb,PetscScalar A[])
   ierr = IGAProbeEvaluate(prb,3,A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+static PetscInt IGAProbe_SpanElement(IGAAxis axis,PetscInt ID)
+{
+  PetscInt lo = 0, hi = axis->nel-1;
+  while (lo < hi) {
+    PetscInt mid = (lo+hi)/2;
+    if (axis->span[mid] < ID) lo = mid+1; else hi = mid;
+  }
+  return lo;
+}
+
+static void IGAProbe_SetUpPoint(IGAProbe prb,PetscInt k)
+{
+  IGA       iga = prb->iga;
+  PetscInt  i,dim = prb->dim;
+  PetscReal *u  = prb->pts + k*dim;
+  PetscInt  *ID = prb->ptsID + k*3;
+  PetscBool own = PETSC_TRUE;
+  for (i=0; i<dim; i++) {
+    size_t    nb = (size_t)(prb->p[i]+1)*4;
+    PetscReal *BD = prb->ptsBD[i] + (size_t)k*nb;
+    ID[i] = IGA_FindSpan(prb->n[i]-1,prb->p[i],u[i],prb->U[i]);
+    IGAProbe_Basis1D(prb,i,ID[i],u[i],BD);
+    if (prb->collective) { /* the rank owning the element evaluates */
+      PetscInt e = IGAProbe_SpanElement(iga->axis[i],ID[i]);
+      if (e < iga->elem_start[i] || e >= iga->elem_start[i]+iga->elem_width[i]) own = PETSC_FALSE;
+    } else { /* any rank with the span closure in its ghosted box */
+      PetscInt first = ID[i]-prb->p[i], last = first + prb->p[i];
+      PetscInt start = prb->s[i], end = prb->s[i] + prb->w[i];
+      if (first < start || last >= end) own = PETSC_FALSE;
+    }
+  }
+  for (i=dim; i<3; i++) ID[i] = 0;
+  prb->ptsown[k] = own;
+}
+
+/*
+ * Span indices, 1D basis functions and owners of the batched points are
+ * cached; points that did not move since the previous call are reused.
+ * In collective mode all ranks pass the same points, and each point is
+ * evaluated by the rank owning the element that contains it.
+ */
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbeSetPoints"
+PetscErrorCode IGAProbeSetPoints(IGAProbe prb,PetscInt npts,const PetscReal u[])
+{
+  PetscInt       i,k,dim,nold;
+  PetscBool      reuse;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(prb,1);
+  if (npts) PetscValidRealPointer(u,3);
+  if (PetscUnlikely(npts < 0)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of points must be nonnegative, got %D",npts);
+  if (prb->collective) PetscValidLogicalCollectiveInt(prb->iga,npts,2);
+  dim = prb->dim;
+#if defined(PETSC_USE_DEBUG)
+  for (k=0; k<npts; k++) {
+    for (i=0; i<dim; i++) {
+      PetscReal *U = prb->U[i];
+      PetscInt   a = prb->p[i];
+      PetscInt   b = prb->n[i];
+      if (PetscUnlikely(u[i+k*dim] < U[a] || u[i+k*dim] > U[b]))
+        SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,
+                 "Expecting %g <= u[%D][%D]=%g <= %g",(double)U[a],k,i,(double)u[i+k*dim],(double)U[b]);
+    }
+  }
+#endif
+
+  nold  = prb->npts;
+  reuse = (prb->ptsorder == prb->order) ? PETSC_TRUE : PETSC_FALSE;
+  if (npts > prb->maxpts) {
+    ierr = PetscFree(prb->pts);CHKERRQ(ierr);
+    ierr = PetscFree(prb->ptsID);CHKERRQ(ierr);
+    ierr = PetscFree(prb->ptsown);CHKERRQ(ierr);
+    ierr = PetscMalloc1((size_t)(npts*dim),&prb->pts);CHKERRQ(ierr);
+    ierr = PetscMalloc1((size_t)(npts*3),&prb->ptsID);CHKERRQ(ierr);
+    ierr = PetscMalloc1((size_t)npts,&prb->ptsown);CHKERRQ(ierr);
+    for (i=0; i<dim; i++) {
+      size_t nb = (size_t)(prb->p[i]+1)*4;
+      ierr = PetscFree(prb->ptsBD[i]);CHKERRQ(ierr);
+      ierr = PetscMalloc1((size_t)npts*nb,&prb->ptsBD[i]);CHKERRQ(ierr);
+    }
+    prb->maxpts = npts;
+    reuse = PETSC_FALSE;
+  }
+  prb->npts = npts;
+  prb->ptsorder = prb->order;
+  for (k=0; k<npts; k++) {
+    PetscBool moved = (reuse && k < nold) ? PETSC_FALSE : PETSC_TRUE;
+    for (i=0; i<dim; i++) {
+      if (!moved && prb->pts[i+k*dim] != u[i+k*dim]) moved = PETSC_TRUE;
+      prb->pts[i+k*dim] = u[i+k*dim];
+    }
+    if (moved) IGAProbe_SetUpPoint(prb,k);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbe_SweepMany"
+static PetscErrorCode IGAProbe_SweepMany(IGAProbe prb,PetscInt der,PetscScalar A[],PetscReal x[])
+{
+  PetscInt       i,k,dim = prb->dim;
+  size_t         ncomp = (size_t)prb->dof * intpow[dim][der];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (prb->ptsorder != prb->order) { /* order changed, refresh the basis */
+    prb->ptsorder = prb->order;
+    for (k=0; k<prb->npts; k++) IGAProbe_SetUpPoint(prb,k);
+  }
+  if (A) {ierr = PetscMemzero(A,(size_t)prb->npts*ncomp*sizeof(PetscScalar));CHKERRQ(ierr);}
+  if (x) {ierr = PetscMemzero(x,(size_t)(prb->npts*dim)*sizeof(PetscReal));CHKERRQ(ierr);}
+  for (k=0; k<prb->npts; k++) {
+    PetscReal *BD[3] = {NULL,NULL,NULL};
+    if (!prb->ptsown[k]) continue;
+    for (i=0; i<3; i++) prb->ID[i] = prb->ptsID[i+k*3];
+    for (i=0; i<dim; i++) prb->point[i] = prb->pts[i+k*dim];
+    for (i=0; i<dim; i++) BD[i] = prb->ptsBD[i] + (size_t)k*(size_t)(prb->p[i]+1)*4;
+    IGAProbe_Closure(prb);
+    IGAProbe_Shape(prb,BD);
+    if (A) IGAProbe_Eval(prb,der,A+(size_t)k*ncomp);
+    if (x) IGA_GetGeomMap(prb->nen,dim,prb->shape[0],prb->X,x+k*dim);
+  }
+  prb->offprocess = PETSC_TRUE; /* single point state is no longer valid */
+  if (prb->collective) {
+    MPI_Comm comm;
+    ierr = IGAGetComm(prb->iga,&comm);CHKERRQ(ierr);
+    if (A) {
+      PetscMPIInt n = (PetscMPIInt)((size_t)prb->npts*ncomp);
+      ierr = MPI_Allreduce(MPI_IN_PLACE,A,n,MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+    }
+    if (x) {
+      PetscMPIInt n = (PetscMPIInt)(prb->npts*dim);
+      ierr = MPI_Allreduce(MPI_IN_PLACE,x,n,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbeGeomMapMany"
+PetscErrorCode IGAProbeGeomMapMany(IGAProbe prb,PetscReal x[])
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(prb,1);
+  if (prb->npts) PetscValidRealPointer(x,2);
+  if (!prb->arrayX) {
+    ierr = PetscMemcpy(x,prb->pts,(size_t)(prb->npts*prb->dim)*sizeof(PetscReal));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = IGAProbe_SweepMany(prb,0,NULL,x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+ * Results are [npts][dof*dim^der], gathered with a single reduction in
+ * collective mode. The single point state is invalidated, call
+ * IGAProbeSetPoint() again before using IGAProbeEvaluate().
+ */
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbeEvaluateMany"
+PetscErrorCode IGAProbeEvaluateMany(IGAProbe prb,PetscInt der,PetscScalar A[])
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(prb,1);
+  if (prb->npts) PetscValidScalarPointer(A,3);
+  if (PetscUnlikely(der < 0 || der > prb->order)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Expecting 0<=der<=%D, got der=%D",prb->order,der);
+  if (PetscUnlikely(!prb->arrayA)) SETERRQ(((PetscObject)prb->iga)->comm,PETSC_ERR_ARG_WRONGSTATE,"Must call IGAProbeSetVec() first");
+  ierr = IGAProbe_SweepMany(prb,der,A,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbe_SetUpLocate"
+static PetscErrorCode IGAProbe_SetUpLocate(IGAProbe prb)
+{
+  IGA            iga = prb->iga;
+  PetscInt       i,b,c,dim = prb->dim;
+  PetscInt       nbox = 1,ncells = 1;
+  PetscReal      lo[3] = {0,0,0},hi[3] = {0,0,0};
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<dim; i++) nbox *= iga->elem_width[i];
+  ierr = PetscMalloc1((size_t)(nbox*2*dim),&prb->box);CHKERRQ(ierr);
+  ierr = PetscMalloc1((size_t)(nbox*3),&prb->boxID);CHKERRQ(ierr);
+  prb->nbox = nbox;
+
+  /* bounding boxes of the control hull of the local elements */
+  for (b=0; b<nbox; b++) {
+    PetscInt  *ID = prb->boxID + b*3;
+    PetscReal *box = prb->box + b*2*dim;
+    PetscInt  a,e = b;
+    for (i=0; i<dim; i++) {
+      IGAAxis axis = iga->axis[i];
+      ID[i] = axis->span[iga->elem_start[i] + e % iga->elem_width[i]];
+      e /= iga->elem_width[i];
+    }
+    for (i=dim; i<3; i++) ID[i] = 0;
+    for (i=0; i<3; i++) prb->ID[i] = ID[i];
+    IGAProbe_Closure(prb);
+    for (i=0; i<dim; i++) box[i] = box[i+dim] = prb->X[i];
+    for (a=1; a<prb->nen; a++)
+      for (i=0; i<dim; i++) {
+        box[i]     = PetscMin(box[i],    prb->X[i+a*dim]);
+        box[i+dim] = PetscMax(box[i+dim],prb->X[i+a*dim]);
+      }
+    for (i=0; i<dim; i++) {
+      lo[i] = b ? PetscMin(lo[i],box[i])     : box[i];
+      hi[i] = b ? PetscMax(hi[i],box[i+dim]) : box[i+dim];
+    }
+  }
+
+  /* uniform hash grid with about one box per cell */
+  for (i=0; i<3; i++) {
+    prb->cells[i]  = 1;
+    prb->origin[i] = lo[i];
+    prb->delta[i]  = 1;
+  }
+  for (i=0; i<dim; i++) {
+    PetscInt n = (PetscInt)ceil(pow((double)nbox,1./(double)dim));
+    prb->cells[i] = PetscMax(n,1);
+    if (hi[i] > lo[i]) prb->delta[i] = (hi[i]-lo[i])/(PetscReal)prb->cells[i];
+    ncells *= prb->cells[i];
+  }
+  ierr = PetscCalloc1((size_t)(ncells+1),&prb->celloff);CHKERRQ(ierr);
+  for (c=0; c<2; c++) { /* count, then fill */
+    if (c) {
+      for (i=0; i<ncells; i++) prb->celloff[i+1] += prb->celloff[i];
+      ierr = PetscMalloc1((size_t)prb->celloff[ncells]+1,&prb->cellbox);CHKERRQ(ierr);
+    }
+    for (b=0; b<nbox; b++) {
+      PetscReal *box = prb->box + b*2*dim;
+      PetscInt  first[3] = {0,0,0},last[3] = {0,0,0},ijk[3];
+      for (i=0; i<dim; i++) {
+        first[i] = (PetscInt)floor((box[i]    -prb->origin[i])/prb->delta[i]);
+        last[i]  = (PetscInt)floor((box[i+dim]-prb->origin[i])/prb->delta[i]);
+        first[i] = PetscMin(PetscMax(first[i],0),prb->cells[i]-1);
+        last[i]  = PetscMin(PetscMax(last[i], 0),prb->cells[i]-1);
+      }
+      for (ijk[2]=first[2]; ijk[2]<=last[2]; ijk[2]++)
+        for (ijk[1]=first[1]; ijk[1]<=last[1]; ijk[1]++)
+          for (ijk[0]=first[0]; ijk[0]<=last[0]; ijk[0]++) {
+            PetscInt cell = ijk[0] + prb->cells[0]*(ijk[1] + prb->cells[1]*ijk[2]);
+            if (c) prb->cellbox[prb->celloff[cell]++] = b;
+            else   prb->celloff[cell+1]++;
+          }
+    }
+  }
+  for (i=ncells; i>0; i--) prb->celloff[i] = prb->celloff[i-1];
+  prb->celloff[0] = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscBool IGAProbe_Invert(IGAProbe prb,const PetscInt ID[],const PetscReal box[],const PetscReal x[],PetscReal u[])
+{
+  const PetscInt maxit = 50;
+  PetscInt       i,j,it,dim = prb->dim;
+  PetscReal      a[3],b[3],tol = 0;
+  for (i=0; i<dim; i++) {
+    a[i] = prb->U[i][ID[i]];
+    b[i] = prb->U[i][ID[i]+1];
+    u[i] = (a[i]+b[i])/2;
+    tol  = PetscMax(tol,box[i+dim]-box[i]);
+  }
+  tol *= 100*PETSC_MACHINE_EPSILON;
+  for (i=0; i<3; i++) prb->ID[i] = ID[i];
+  IGAProbe_Closure(prb);
+  for (it=0; it<maxit; it++) {
+    PetscReal xu[3],r[3],norm = 0;
+    for (i=0; i<dim; i++)
+      IGAProbe_Basis1D(prb,i,ID[i],u[i],prb->BD[i]);
+    IGAProbe_Shape(prb,prb->BD);
+    IGA_GetGeomMap(prb->nen,dim,prb->shape[0],prb->X,xu);
+    for (i=0; i<dim; i++) {r[i] = x[i] - xu[i]; norm = PetscMax(norm,PetscAbsReal(r[i]));}
+    if (norm <= tol) return PETSC_TRUE;
+    if (prb->detX[0] == 0) break;
+    for (norm=0, i=0; i<dim; i++) { /* u += inv(dx/du) * r */
+      PetscReal du = 0, ui = u[i];
+      for (j=0; j<dim; j++) du += prb->gradX[1][i*dim+j]*r[j];
+      u[i] = PetscMin(PetscMax(u[i]+du,a[i]),b[i]);
+      norm = PetscMax(norm,PetscAbsReal(u[i]-ui));
+    }
+    if (norm == 0) break; /* stuck at the element boundary */
+  }
+  return PETSC_FALSE;
+}
+
+/*
+ * Locates physical points x[npts][dim] and returns their parametric
+ * coordinates u[npts][dim], ready for IGAProbeSetPoints(). Candidate
+ * elements come from a uniform hash grid over the bounding boxes of the
+ * local element control hulls, and each candidate is inverted with a
+ * Newton iteration seeded at the element center. In collective mode all
+ * ranks pass the same points and the lowest rank that finds a point
+ * provides its coordinates.
+ */
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProbeLocatePoints"
+PetscErrorCode IGAProbeLocatePoints(IGAProbe prb,PetscInt npts,const PetscReal x[],PetscReal u[],PetscBool found[])
+{
+  PetscInt       i,k,c,dim,order;
+  PetscMPIInt    rank = 0,size = 1,*owner;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(prb,1);
+  if (npts) PetscValidRealPointer(x,3);
+  if (npts) PetscValidRealPointer(u,4);
+  if (prb->collective) PetscValidLogicalCollectiveInt(prb->iga,npts,2);
+  dim = prb->dim;
+
+  if (!prb->arrayX) { /* identity geometry */
+    for (k=0; k<npts; k++) {
+      PetscBool inside = PETSC_TRUE;
+      for (i=0; i<dim; i++) {
+        PetscReal *U = prb->U[i];
+        u[i+k*dim] = x[i+k*dim];
+        if (x[i+k*dim] < U[prb->p[i]] || x[i+k*dim] > U[prb->n[i]]) inside = PETSC_FALSE;
+      }
+      if (found) found[k] = inside;
+    }
+    PetscFunctionReturn(0);
+  }
+  if (!prb->box) {ierr = IGAProbe_SetUpLocate(prb);CHKERRQ(ierr);}
+
+  if (prb->collective) {
+    MPI_Comm comm;
+    ierr = IGAGetComm(prb->iga,&comm);CHKERRQ(ierr);
+    ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+    ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  }
+  ierr = PetscMalloc1((size_t)npts,&owner);CHKERRQ(ierr);
+  order = prb->order; prb->order = PetscMax(order,1);
+  for (k=0; k<npts; k++) {
+    const PetscReal *xk = x + k*dim;
+    PetscReal       *uk = u + k*dim;
+    PetscInt        ijk[3] = {0,0,0},cell;
+    PetscBool       outside = PETSC_FALSE;
+    owner[k] = size;
+    for (i=0; i<dim; i++) uk[i] = 0;
+    for (i=0; i<dim; i++) {
+      PetscReal t = (xk[i]-prb->origin[i])/prb->delta[i];
+      PetscReal eps = PETSC_SQRT_MACHINE_EPSILON*(PetscReal)prb->cells[i];
+      if (t < -eps || t > (PetscReal)prb->cells[i]+eps) outside = PETSC_TRUE;
+      ijk[i] = PetscMin(PetscMax((PetscInt)floor(t),0),prb->cells[i]-1);
+    }
+    if (outside) continue;
+    cell = ijk[0] + prb->cells[0]*(ijk[1] + prb->cells[1]*ijk[2]);
+    for (c=prb->celloff[cell]; c<prb->celloff[cell+1]; c++) {
+      PetscInt  b = prb->cellbox[c];
+      PetscReal *box = prb->box + b*2*dim;
+      PetscBool inside = PETSC_TRUE;
+      for (i=0; i<dim; i++) {
+        PetscReal eps = PETSC_SQRT_MACHINE_EPSILON*(box[i+dim]-box[i]);
+        if (xk[i] < box[i]-eps || xk[i] > box[i+dim]+eps) inside = PETSC_FALSE;
+      }
+      if (!inside) continue;
+      if (IGAProbe_Invert(prb,prb->boxID+b*3,box,xk,uk)) {owner[k] = rank; break;}
+    }
+    if (owner[k] != rank) for (i=0; i<dim; i++) uk[i] = 0;
+  }
+  prb->order = order;
+  prb->offprocess = PETSC_TRUE; /* single point state is no longer valid */
+
+  if (prb->collective) {
+    MPI_Comm    comm;
+    PetscMPIInt n = (PetscMPIInt)npts;
+    ierr = IGAGetComm(prb->iga,&comm);CHKERRQ(ierr);
+    ierr = MPI_Allreduce(MPI_IN_PLACE,owner,n,MPI_INT,MPI_MIN,comm);CHKERRQ(ierr);
+    for (k=0; k<npts; k++)
+      if (owner[k] != rank)
+        for (i=0; i<dim; i++) u[i+k*dim] = 0;
+    n = (PetscMPIInt)(npts*dim);
+    ierr = MPI_Allreduce(MPI_IN_PLACE,u,n,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+  }
+  if (found) for (k=0; k<npts; k++) found[k] = (owner[k] < size) ? PETSC_TRUE : PETSC_FALSE;
+  ierr = PetscFree(owner);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,547 @@
+#include "petiga.h"
+
+#if PETSC_VERSION_LT(3,5,0)
+#define KSPSetOperators(ksp,A,B) KSPSetOperators(ksp,A,B,SAME_NONZERO_PATTERN)
+#endif
+
+/*
+  L2 projection onto the discrete space. Without a geometry map and
+  rational weights the mass matrix is the Kronecker product of the
+  mass matrices of the axes; its inverse is applied one axis at a
+  time, redistributing the vector in full grid lines along the axis
+  and solving with the Cholesky factor of the axis mass matrix. With
+  a geometry map or rational weights the mass matrix is applied
+  matrix-free and CG is preconditioned with the Kronecker inverse,
+  diagonally scaled to the actual mass matrix.
+*/
+
+struct _n_IGA_Proj {
+  PetscInt   n[3];       /* nodes along each axis */
+  PetscInt   *first[3];  /* first column of each row of the envelope */
+  PetscInt   *ptr[3];    /* start of each row of the factor */
+  PetscReal  *L[3];      /* Cholesky factor of the axis mass matrix */
+  PetscReal  *diag[3];   /* diagonal of the axis mass matrix */
+  PetscInt   nlines[3];  /* grid lines owned along each axis */
+  Vec        lines[3];   /* [nlines][n][dof] */
+  VecScatter scatter[3];
+  Mat        mass;
+  KSP        ksp;
+  Vec        scale;
+};
+typedef struct _n_IGA_Proj *IGA_Proj;
+
+/* Cholesky factorization in envelope storage, row i holds the
+   columns first[i],...,i starting at L[ptr[i]]; the envelope
+   accommodates the corner blocks of periodic axes */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_EnvelopeFactor"
+static PetscErrorCode IGA_EnvelopeFactor(PetscInt n,const PetscInt first[],const PetscInt ptr[],PetscReal L[])
+{
+  PetscInt i,j,k;
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    PetscReal *Li = L + ptr[i] - first[i];
+    for (j=first[i]; j<=i; j++) {
+      PetscReal *Lj = L + ptr[j] - first[j];
+      PetscReal s = Li[j];
+      for (k=PetscMax(first[i],first[j]); k<j; k++) s -= Li[k]*Lj[k];
+      if (j < i) {Li[j] = s/Lj[j]; continue;}
+      if (s <= 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MAT_CH_ZRPVT,"Mass matrix not positive definite in row %D",i);
+      Li[i] = PetscSqrtReal(s);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static void IGA_EnvelopeSolve(PetscInt n,const PetscInt first[],const PetscInt ptr[],const PetscReal L[],
+                              PetscInt stride,PetscScalar x[])
+{
+  PetscInt i,k;
+  for (i=0; i<n; i++) {
+    const PetscReal *Li = L + ptr[i] - first[i];
+    PetscScalar s = x[i*stride];
+    for (k=first[i]; k<i; k++) s -= Li[k]*x[k*stride];
+    x[i*stride] = s/Li[i];
+  }
+  for (i=n-1; i>=0; i--) {
+    const PetscReal *Li = L + ptr[i] - first[i];
+    PetscScalar s = (x[i*stride] /= Li[i]);
+    for (k=first[i]; k<i; k++) x[k*stride] -= Li[k]*s;
+  }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_AxisMass"
+static PetscErrorCode IGA_Proj_AxisMass(IGA_Proj proj,PetscInt i,IGABasis basis,PetscInt n)
+{
+  PetscInt       nel = basis->nel, nqp = basis->nqp;
+  PetscInt       nen = basis->nen, ndr = basis->d+1;
+  PetscInt       e,q,a,b,*first,*ptr;
+  PetscReal      *L,*diag;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&first);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n+1,&ptr);CHKERRQ(ierr);
+  for (a=0; a<n; a++) first[a] = a;
+  for (e=0; e<nel; e++) {
+    PetscInt o = basis->offset[e];
+    for (a=0; a<nen; a++)
+      for (b=0; b<nen; b++) {
+        PetscInt ia = (o+a) % n, ja = (o+b) % n;
+        if (ja < first[ia]) first[ia] = ja;
+      }
+  }
+  ptr[0] = 0;
+  for (a=0; a<n; a++) ptr[a+1] = ptr[a] + (a - first[a] + 1);
+  ierr = PetscCalloc1(ptr[n],&L);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&diag);CHKERRQ(ierr);
+  for (e=0; e<nel; e++) {
+    const PetscReal *N = IGABasisGetValues(basis,e);
+    PetscInt        o  = basis->offset[e];
+    for (q=0; q<basis->count[e]; q++) {
+      const PetscReal *Nq = N + q*nen*ndr;
+      PetscReal       JW  = basis->weight[e*nqp+q] * basis->detJ[e];
+      for (a=0; a<nen; a++)
+        for (b=0; b<nen; b++) {
+          PetscInt ia = (o+a) % n, ja = (o+b) % n;
+          if (ja <= ia) L[ptr[ia]+ja-first[ia]] += JW * Nq[a*ndr] * Nq[b*ndr];
+        }
+    }
+  }
+  for (a=0; a<n; a++) diag[a] = L[ptr[a]+a-first[a]];
+  ierr = IGA_EnvelopeFactor(n,first,ptr,L);CHKERRQ(ierr);
+  proj->n[i]     = n;
+  proj->first[i] = first;
+  proj->ptr[i]   = ptr;
+  proj->L[i]     = L;
+  proj->diag[i]  = diag;
+  PetscFunctionReturn(0);
+}
+
+/* The grid lines along an axis crossing the local box are split among
+   the processes of the row of the processor grid along that axis */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_AxisLines"
+static PetscErrorCode IGA_Proj_AxisLines(IGA iga,IGA_Proj proj,PetscInt i,Vec x)
+{
+  MPI_Comm       comm;
+  AO             ao;
+  IS             is;
+  PetscInt       j = (i == 0) ? 1 : 0, k = (i == 2) ? 1 : 2;
+  PetscInt       *sizes  = iga->node_sizes;
+  PetscInt       *lstart = iga->node_lstart;
+  PetscInt       *lwidth = iga->node_lwidth;
+  PetscInt       size = iga->proc_sizes[i], rank = iga->proc_ranks[i];
+  PetscInt       nlines = lwidth[j]*lwidth[k];
+  PetscInt       start,count,line,a,pos = 0,*index;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  start = rank*(nlines/size) + PetscMin(rank,nlines%size);
+  count = nlines/size + ((rank < nlines%size) ? 1 : 0);
+  ierr = PetscMalloc1(count*sizes[i],&index);CHKERRQ(ierr);
+  for (line=start; line<start+count; line++) {
+    PetscInt c[3];
+    c[j] = lstart[j] + line % lwidth[j];
+    c[k] = lstart[k] + line / lwidth[j];
+    for (a=0; a<sizes[i]; a++) {
+      c[i] = a;
+      index[pos++] = c[0] + sizes[0]*(c[1] + sizes[1]*c[2]);
+    }
+  }
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = AOApplicationToPetsc(ao,pos,index);CHKERRQ(ierr);
+  ierr = ISCreateBlock(comm,iga->dof,pos,index,PETSC_COPY_VALUES,&is);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF,pos*iga->dof,&proj->lines[i]);CHKERRQ(ierr);
+  ierr = VecScatterCreate(x,is,proj->lines[i],NULL,&proj->scatter[i]);CHKERRQ(ierr);
+  ierr = ISDestroy(&is);CHKERRQ(ierr);
+  ierr = PetscFree(index);CHKERRQ(ierr);
+  proj->nlines[i] = count;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_Create"
+static PetscErrorCode IGA_Proj_Create(IGA iga,Vec x,IGA_Proj *_proj)
+{
+  IGA_Proj       proj;
+  PetscInt       i;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscCalloc1(1,&proj);CHKERRQ(ierr);
+  *_proj = proj;
+  for (i=0; i<iga->dim; i++) {
+    ierr = IGA_Proj_AxisMass(proj,i,iga->basis[i],iga->node_sizes[i]);CHKERRQ(ierr);
+    ierr = IGA_Proj_AxisLines(iga,proj,i,x);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode IGA_Proj_Destroy(IGA_Proj*);
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_Destroy"
+PetscErrorCode IGA_Proj_Destroy(IGA_Proj *_proj)
+{
+  IGA_Proj       proj;
+  PetscInt       i;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(_proj,1);
+  proj = *_proj; *_proj = NULL;
+  if (!proj) PetscFunctionReturn(0);
+  for (i=0; i<3; i++) {
+    ierr = PetscFree(proj->first[i]);CHKERRQ(ierr);
+    ierr = PetscFree(proj->ptr[i]);CHKERRQ(ierr);
+    ierr = PetscFree(proj->L[i]);CHKERRQ(ierr);
+    ierr = PetscFree(proj->diag[i]);CHKERRQ(ierr);
+    ierr = VecDestroy(&proj->lines[i]);CHKERRQ(ierr);
+    ierr = VecScatterDestroy(&proj->scatter[i]);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&proj->mass);CHKERRQ(ierr);
+  ierr = KSPDestroy(&proj->ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&proj->scale);CHKERRQ(ierr);
+  ierr = PetscFree(proj);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* x <- (M_0 x M_1 x M_2)^{-1} x */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_Kronecker"
+static PetscErrorCode IGA_Proj_Kronecker(IGA iga,IGA_Proj proj,Vec x)
+{
+  PetscInt       i,line,c,dof = iga->dof;
+  PetscScalar    *v;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  for (i=0; i<iga->dim; i++) {
+    PetscInt n = proj->n[i];
+    ierr = VecScatterBegin(proj->scatter[i],x,proj->lines[i],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd  (proj->scatter[i],x,proj->lines[i],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGetArray(proj->lines[i],&v);CHKERRQ(ierr);
+    for (line=0; line<proj->nlines[i]; line++)
+      for (c=0; c<dof; c++)
+        IGA_EnvelopeSolve(n,proj->first[i],proj->ptr[i],proj->L[i],dof,v+line*n*dof+c);
+    ierr = VecRestoreArray(proj->lines[i],&v);CHKERRQ(ierr);
+    ierr = PetscLogFlops(4.0*proj->nlines[i]*dof*proj->ptr[i][n]);CHKERRQ(ierr);
+    ierr = VecScatterBegin(proj->scatter[i],proj->lines[i],x,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    ierr = VecScatterEnd  (proj->scatter[i],proj->lines[i],x,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* y <- M x, or the diagonal of M if x is NULL */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_Mass"
+static PetscErrorCode IGA_Proj_Mass(IGA iga,Vec x,Vec y)
+{
+  IGAElement        element;
+  IGAPoint          point;
+  Vec               localX;
+  const PetscScalar *arrayX = NULL;
+  PetscScalar       *X,*Y;
+  PetscErrorCode    ierr;
+  PetscFunctionBegin;
+  ierr = VecZeroEntries(y);CHKERRQ(ierr);
+  if (x) {ierr = IGAGetLocalVecArray(iga,x,&localX,&arrayX);CHKERRQ(ierr);}
+  ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  while (IGANextElement(iga,element)) {
+    if (x) {ierr = IGAElementGetValues(element,arrayX,&X);CHKERRQ(ierr);}
+    ierr = IGAElementGetWorkVec(element,&Y);CHKERRQ(ierr);
+    ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
+    while (IGAElementNextPoint(element,point)) {
+      PetscInt        a,c,nen = point->nen,dof = point->dof;
+      PetscReal       JW = point->weight[0] * point->detJac[0];
+      const PetscReal *N = point->shape[0];
+      for (c=0; c<dof; c++) {
+        if (x) {
+          PetscScalar u = 0;
+          for (a=0; a<nen; a++) u += N[a] * X[a*dof+c];
+          for (a=0; a<nen; a++) Y[a*dof+c] += N[a] * u * JW;
+        } else {
+          for (a=0; a<nen; a++) Y[a*dof+c] += N[a] * N[a] * JW;
+        }
+      }
+    }
+    ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
+    ierr = IGAElementAssembleVec(element,Y,y);CHKERRQ(ierr);
+  }
+  ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  if (x) {ierr = IGARestoreLocalVecArray(iga,x,&localX,&arrayX);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(y);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd  (y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_MatMult"
+static PetscErrorCode IGA_Proj_MatMult(Mat A,Vec x,Vec y)
+{
+  IGA            iga;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&iga);CHKERRQ(ierr);
+  ierr = IGA_Proj_Mass(iga,x,y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_PCApply"
+static PetscErrorCode IGA_Proj_PCApply(PC pc,Vec x,Vec y)
+{
+  IGA            iga;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PCShellGetContext(pc,(void**)&iga);CHKERRQ(ierr);
+  ierr = VecPointwiseMult(y,iga->proj->scale,x);CHKERRQ(ierr);
+  ierr = IGA_Proj_Kronecker(iga,iga->proj,y);CHKERRQ(ierr);
+  ierr = VecPointwiseMult(y,iga->proj->scale,y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* With D the diagonal of M and K the Kronecker product of the axis
+   mass matrices, the preconditioner is S K^{-1} S, S = (diag(K)/D)^{1/2} */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_Proj_SetUpKSP"
+static PetscErrorCode IGA_Proj_SetUpKSP(IGA iga,IGA_Proj proj,Vec x)
+{
+  PetscInt       *lstart = iga->node_lstart;
+  PetscInt       *lwidth = iga->node_lwidth;
+  PetscInt       i,j,k,c,dof = iga->dof,pos = 0;
+  PetscScalar    *S;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  if (!proj->ksp) {
+    MPI_Comm   comm;
+    PC         pc;
+    const char *prefix;
+    PetscInt   m,M;
+    ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(x,&m);CHKERRQ(ierr);
+    ierr = VecGetSize(x,&M);CHKERRQ(ierr);
+    ierr = MatCreateShell(comm,m,m,M,M,iga,&proj->mass);CHKERRQ(ierr);
+    ierr = MatShellSetOperation(proj->mass,MATOP_MULT,(void(*)(void))IGA_Proj_MatMult);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&proj->scale);CHKERRQ(ierr);
+    ierr = KSPCreate(comm,&proj->ksp);CHKERRQ(ierr);
+    ierr = PetscObjectGetOptionsPrefix((PetscObject)iga,&prefix);CHKERRQ(ierr);
+    ierr = KSPSetOptionsPrefix(proj->ksp,prefix);CHKERRQ(ierr);
+    ierr = KSPAppendOptionsPrefix(proj->ksp,"iga_project_");CHKERRQ(ierr);
+    ierr = KSPSetType(proj->ksp,KSPCG);CHKERRQ(ierr);
+    ierr = KSPSetOperators(proj->ksp,proj->mass,proj->mass);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(proj->ksp,1e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+    ierr = KSPGetPC(proj->ksp,&pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCSHELL);CHKERRQ(ierr);
+    ierr = PCShellSetContext(pc,iga);CHKERRQ(ierr);
+    ierr = PCShellSetApply(pc,IGA_Proj_PCApply);CHKERRQ(ierr);
+    ierr = PCShellSetName(pc,"Kronecker product of axis mass matrices");CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(proj->ksp);CHKERRQ(ierr);
+  }
+  /* the geometry may change between calls, rebuild the scaling */
+  ierr = IGA_Proj_Mass(iga,NULL,proj->scale);CHKERRQ(ierr);
+  ierr = VecGetArray(proj->scale,&S);CHKERRQ(ierr);
+  for (k=lstart[2]; k<lstart[2]+lwidth[2]; k++)
+    for (j=lstart[1]; j<lstart[1]+lwidth[1]; j++)
+      for (i=lstart[0]; i<lstart[0]+lwidth[0]; i++) {
+        PetscReal d = proj->diag[0][i];
+        if (iga->dim > 1) d *= proj->diag[1][j];
+        if (iga->dim > 2) d *= proj->diag[2][k];
+        for (c=0; c<dof; c++, pos++)
+          S[pos] = PetscSqrtReal(d/PetscRealPart(S[pos]));
+      }
+  ierr = VecRestoreArray(proj->scale,&S);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAProject"
+/*@
+   IGAProject - Solves M x = b, with M the mass matrix of the
+   discrete space, giving the L2 projection x of a field whose
+   moments against the basis functions are b.
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+-  b - the moments, e.g. computed with IGAComputeVector()
+
+   Output Parameter:
+.  x - the coefficients of the projection
+
+   Options Database Keys:
+.  -iga_project_ksp_* - options of the solver used with a geometry map or rational weights
+
+   Notes:
+   Without a geometry map and rational weights M is the Kronecker
+   product of the mass matrices of the axes and its inverse is applied
+   directly, at the cost of one banded solve per grid line and axis.
+   Otherwise M is applied matrix-free and inverted with CG (relative
+   tolerance 1e-8), preconditioned with the Kronecker inverse scaled
+   to the diagonal of M. The mass matrix is integrated with the
+   quadrature of the IGA; boundary conditions are not applied.
+
+   The factorizations and communication patterns are built on the
+   first call and kept until the next IGASetUp() or IGAReset().
+
+   Level: normal
+
+.keywords: IGA, projection, mass matrix
+@*/
+PetscErrorCode IGAProject(IGA iga,Vec b,Vec x)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(b,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  IGACheckSetUp(iga,1);
+  if (iga->collocation)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"L2 projection not supported with collocation");
+  if (b == x)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_ARG_IDN,"b and x must be different vectors");
+  IGATraceBegin(__FUNCT__);
+
+  if (!iga->proj) {ierr = IGA_Proj_Create(iga,x,&iga->proj);CHKERRQ(ierr);}
+  if (!iga->geometry && !iga->rational) {
+    ierr = VecCopy(b,x);CHKERRQ(ierr);
+    ierr = IGA_Proj_Kronecker(iga,iga->proj,x);CHKERRQ(ierr);
+  } else {
+    KSPConvergedReason reason;
+    ierr = IGA_Proj_SetUpKSP(iga,iga->proj,x);CHKERRQ(ierr);
+    ierr = KSPSolve(iga->proj->ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(iga->proj->ksp,&reason);CHKERRQ(ierr);
+    if (reason < 0)
+      SETERRQ1(((PetscObject)iga)->comm,PETSC_ERR_CONV_FAILED,"L2 projection did not converge, reason %D",(PetscInt)reason);
+  }
+
+  IGATraceEnd(__FUNCT__);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAQuasiInterpolate"
+/*@
+   IGAQuasiInterpolate - Computes a local quasi-interpolant of a field,
+   without any global solve.
+
+   Collective on IGA
+
+   Input Parameter:
+.  iga - the IGA context
+
+   Output Parameter:
+.  x - the coefficients of the quasi-interpolant
+
+   Notes:
+   The field is given by the form set with IGASetFormVector(), which
+   must compute the moments F[a] = N_a f at each quadrature point, as
+   for IGAProject(). The field is L2-projected on every element
+   separately, and the coefficients of a basis function are averaged
+   over its support weighted by the measure of the elements. Fields in
+   the discrete space are reproduced exactly, and the approximation
+   order is that of the global L2 projection.
+
+   The element projections always use a Gauss-Legendre rule with p+1
+   points per axis, independent of the rule of the IGA and of
+   IGASetFormQuadrature(); the reduced rule or fewer points would leave
+   the element mass matrices singular.
+
+   Level: normal
+
+.keywords: IGA, quasi-interpolation
+@*/
+PetscErrorCode IGAQuasiInterpolate(IGA iga,Vec x)
+{
+  IGAElement     element;
+  IGAPoint       point;
+  IGAFormVector  Vector;
+  void           *ctx;
+  Vec            w;
+  IGABasis       QB[3] = {NULL,NULL,NULL};
+  PetscInt       i,a,b,c,nen,dof,*first,*ptr;
+  PetscReal      *M;
+  PetscScalar    *B,*W,*F;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,2);
+  IGACheckSetUp(iga,1);
+  IGACheckFormOp(iga,1,Vector);
+  if (iga->collocation)
+    SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Quasi-interpolation not supported with collocation");
+  IGATraceBegin(__FUNCT__);
+
+  Vector = iga->form->ops->Vector;
+  ctx    = iga->form->ops->VecCtx;
+  ierr = VecZeroEntries(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecZeroEntries(w);CHKERRQ(ierr);
+
+  for (i=0; i<3; i++) { /* (p+1)-point Gauss-Legendre tables */
+    IGARule rule;
+    if (i >= iga->dim) {
+      QB[i] = iga->basis[i];
+      ierr = IGABasisReference(QB[i]);CHKERRQ(ierr);
+      continue;
+    }
+    ierr = IGARuleCreate(&rule);CHKERRQ(ierr);
+    ierr = IGARuleInit(rule,iga->axis[i]->p+1);CHKERRQ(ierr);
+    ierr = IGABasisCreate(&QB[i]);CHKERRQ(ierr);
+    ierr = IGABasisSetType(QB[i],iga->basis[i]->type);CHKERRQ(ierr);
+    if (iga->bezier) {
+      ierr = IGABasisInitBezier(QB[i],iga->axis[i],rule,iga->order);CHKERRQ(ierr);
+    } else {
+      ierr = IGABasisInitQuadrature(QB[i],iga->axis[i],rule,iga->order);CHKERRQ(ierr);
+    }
+    ierr = IGARuleDestroy(&rule);CHKERRQ(ierr);
+  }
+
+  ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  element->BD = QB;
+  nen = element->nen; dof = element->dof;
+  /* dense element mass matrix in envelope storage */
+  ierr = PetscMalloc1(nen,&first);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nen+1,&ptr);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nen*(nen+1)/2,&M);CHKERRQ(ierr);
+  for (a=0; a<=nen; a++) ptr[a] = a*(a+1)/2;
+  for (a=0; a<nen; a++) first[a] = 0;
+  while (IGANextElement(iga,element)) {
+    PetscReal measure = 0;
+    ierr = IGAElementGetWorkVec(element,&B);CHKERRQ(ierr);
+    ierr = IGAElementGetWorkVec(element,&W);CHKERRQ(ierr);
+    ierr = PetscMemzero(M,(size_t)ptr[nen]*sizeof(PetscReal));CHKERRQ(ierr);
+    ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
+    while (IGAElementNextPoint(element,point)) {
+      PetscReal       JW = point->weight[0] * point->detJac[0];
+      const PetscReal *N = point->shape[0];
+      ierr = IGAPointGetWorkVec(point,&F);CHKERRQ(ierr);
+      ierr = Vector(point,F,ctx);CHKERRQ(ierr);
+      ierr = IGAPointAddVec(point,F,B);CHKERRQ(ierr);
+      for (a=0; a<nen; a++)
+        for (b=0; b<=a; b++)
+          M[ptr[a]+b] += N[a] * N[b] * JW;
+      measure += JW;
+    }
+    ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
+    ierr = IGA_EnvelopeFactor(nen,first,ptr,M);CHKERRQ(ierr);
+    for (c=0; c<dof; c++) IGA_EnvelopeSolve(nen,first,ptr,M,dof,B+c);
+    for (a=0; a<nen*dof; a++) {B[a] *= measure; W[a] = measure;}
+    ierr = IGAElementAssembleVec(element,B,x);CHKERRQ(ierr);
+    ierr = IGAElementAssembleVec(element,W,w);CHKERRQ(ierr);
+  }
+  ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {ierr = IGABasisDestroy(&QB[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(first);CHKERRQ(ierr);
+  ierr = PetscFree(ptr);CHKERRQ(ierr);
+  ierr = PetscFree(M);CHKERRQ(ierr);
+
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd  (x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(w);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd  (w);CHKERRQ(ierr);
+  ierr = VecPointwiseDivide(x,x,w);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+
+  IGATraceEnd(__FUNCT__);
+  PetscFunctionReturn(0);
+}
@@ -6,9 +6,11 @@
 #endif
 
 #if PETSC_VERSION_LE(3,3,0)
+#define MatRegisterAll() MatRegisterAll(0)
 #define PCRegisterAll() PCRegisterAll(0)
 #define TSRegisterAll() TSRegisterAll(0)
 #define DMRegisterAll() DMRegisterAll(0)
+#define MatRegister(s,f) MatRegister(s,0,0,f)
 #define PCRegister(s,f) PCRegister(s,0,0,f)
 #define TSRegister(s,f) TSRegister(s,0,0,f)
 #define DMRegister(s,f) DMRegister(s,0,0,f)
@@ -17,10 +19,15 @@
 PETSC_EXTERN PetscBool IGAPackageInitialized;
 PETSC_EXTERN PetscBool IGARegisterAllCalled;
 
+PETSC_EXTERN PetscFunctionList MatList;
 PETSC_EXTERN PetscFunctionList PCList;
 PETSC_EXTERN PetscFunctionList TSList;
 PETSC_EXTERN PetscFunctionList DMList;
 
+EXTERN_C_BEGIN
+extern PetscErrorCode MatCreate_IGA(Mat);
+EXTERN_C_END
+
 EXTERN_C_BEGIN
 extern PetscErrorCode PCCreate_IGAEBE(PC);
 extern PetscErrorCode PCCreate_IGABBB(PC);
@@ -55,6 +62,8 @@ PetscErrorCode IGARegisterAll(void)
   PetscErrorCode ierr;
   PetscFunctionBegin;
   IGARegisterAllCalled = PETSC_TRUE;
+  ierr = MatRegisterAll();CHKERRQ(ierr);
+  ierr = MatRegister(MATIGA,MatCreate_IGA);CHKERRQ(ierr);
   ierr = PCRegisterAll();CHKERRQ(ierr);
   ierr = PCRegister(PCIGAEBE,PCCreate_IGAEBE);CHKERRQ(ierr);
   ierr = PCRegister(PCIGABBB,PCCreate_IGABBB);CHKERRQ(ierr);
@@ -71,6 +80,8 @@ PetscErrorCode IGAFinalizePackage(void)
 {
   PetscErrorCode ierr;
   PetscFunctionBegin;
+  ierr = IGATraceFinalize();CHKERRQ(ierr);
+  if (MatList) {ierr = PetscFunctionListDestroy(&MatList);CHKERRQ(ierr);}
   if (PCList) {ierr = PetscFunctionListDestroy(&PCList);CHKERRQ(ierr);}
   if (TSList) {ierr = PetscFunctionListDestroy(&TSList);CHKERRQ(ierr);}
   if (DMList) {ierr = PetscFunctionListDestroy(&DMList);CHKERRQ(ierr);}
@@ -106,6 +117,8 @@ PetscErrorCode IGAInitializePackage(void)
   ierr = PetscLogEventRegister("IGAFormJacobian",IGA_CLASSID,&IGA_FormJacobian);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("IGAFormIFunction",IGA_CLASSID,&IGA_FormIFunction);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("IGAFormIJacobian",IGA_CLASSID,&IGA_FormIJacobian);CHKERRQ(ierr);
+  /* Timeline tracer */
+  ierr = IGATraceInitialize();CHKERRQ(ierr);
 #if PETSC_VERSION_LE(3,3,0)
   /* Additional SNES option handler to support -snes_fd_color */
   ierr = SNESAddOptionsChecker(SNESSetFromOptions_FDColor);CHKERRQ(ierr);
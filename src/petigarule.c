@@ -1,5 +1,11 @@
 #include "petiga.h"
 
+const char *const IGARuleTypes[] = {
+  "LEGENDRE",
+  "REDUCED",
+  /* */
+  "IGARuleType","IGA_RULE_",0};
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGARuleCreate"
 PetscErrorCode IGARuleCreate(IGARule *rule)
@@ -63,6 +69,7 @@ PetscErrorCode IGARuleCopy(IGARule base,IGARule rule)
   PetscValidPointer(rule,2);
   if (base == rule) PetscFunctionReturn(0);
 
+  rule->type = base->type;
   rule->nqp = base->nqp;
   ierr = PetscFree(rule->point);CHKERRQ(ierr);
   if (base->point && base->nqp > 0) {
@@ -91,6 +98,27 @@ PetscErrorCode IGARuleDuplicate(IGARule base,IGARule *rule)
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGARuleSetType"
+PetscErrorCode IGARuleSetType(IGARule rule,IGARuleType type)
+{
+  PetscFunctionBegin;
+  PetscValidPointer(rule,1);
+  rule->type = type;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGARuleGetType"
+PetscErrorCode IGARuleGetType(IGARule rule,IGARuleType *type)
+{
+  PetscFunctionBegin;
+  PetscValidPointer(rule,1);
+  PetscValidPointer(type,2);
+  *type = rule->type;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode GaussLegendreRule(PetscInt q,PetscReal X[],PetscReal W[]);
 /*
 static PetscErrorCode GaussLobattoRule(PetscInt q,PetscReal X[],PetscReal W[]);
@@ -159,6 +187,288 @@ PetscErrorCode IGARuleGetRule(IGARule rule,PetscInt *q,PetscReal *x[],PetscReal
   PetscFunctionReturn(0);
 }
 
+EXTERN_C_BEGIN
+extern void     IGA_Basis_BSpline(PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+extern PetscInt IGA_FindSpan(PetscInt n,PetscInt p,PetscReal u,const PetscReal U[]);
+EXTERN_C_END
+
+/*
+  Reduced quadrature for smooth splines. For an axis of degree p the
+  mass and stiffness integrands live in the spline space of degree 2p
+  whose continuity at a knot of multiplicity s is p-s-1. The axis is
+  split into macro-elements at the knots where that space is
+  discontinuous (and into chunks of at most IGA_RULE_MACRO elements, to
+  keep the dense solves small); on each macro-element the rule that
+  integrates the B-splines of the target space exactly is found by node
+  elimination: starting from Gauss-Legendre with p+1 points per element,
+  the node of smallest weight is removed and the remaining nodes and
+  weights are corrected with minimum-norm Gauss-Newton steps, until
+  ceil(N/2) nodes are left (N the dimension of the target space) or no
+  node can be removed. Every intermediate rule is exact, so the result
+  is never worse than Gauss-Legendre. Macro-elements with the same
+  normalized knots (e.g. uniform meshes) reuse the previous rule.
+*/
+
+#define IGA_RULE_MACRO 8
+
+typedef struct {
+  PetscInt  q,N;       /* target degree and dimension */
+  PetscReal *T,*I;     /* [N+q+1] target knots in [0,1], [N] B-spline integrals */
+  PetscReal *R,*S,*J;  /* [N] residual and work, [N][2n] jacobian */
+  PetscReal *A,*D,*B;  /* [N][N] normal matrix, [2n] step, [q+1][2] basis */
+  PetscReal *xt,*wt;   /* [n] trial nodes and weights */
+  PetscInt  *order;    /* [n] elimination order */
+} ReducedCtx;
+
+static PetscReal Reduced_Residual(ReducedCtx *ctx,PetscInt n,const PetscReal x[],const PetscReal w[],PetscReal R[],PetscReal J[])
+{
+  PetscInt  i,j,r,q = ctx->q,N = ctx->N;
+  PetscReal *B = ctx->B,res = 0;
+  if (J) (void)PetscMemzero(J,(size_t)(N*2*n)*sizeof(PetscReal));
+  for (i=0; i<N; i++) R[i] = -ctx->I[i];
+  for (j=0; j<n; j++) {
+    PetscInt k = IGA_FindSpan(N-1,q,x[j],ctx->T);
+    IGA_Basis_BSpline(k,x[j],q,1,ctx->T,B);
+    for (r=0; r<=q; r++) {
+      i = k-q+r;
+      R[i] += w[j]*B[2*r];
+      if (J) {J[i*2*n+j] = B[2*r]; J[i*2*n+n+j] = w[j]*B[2*r+1];}
+    }
+  }
+  for (i=0; i<N; i++) res = PetscMax(res,PetscAbsReal(R[i])/ctx->I[i]);
+  return res;
+}
+
+static PetscBool Reduced_Solve(PetscInt n,PetscReal A[],PetscReal b[])
+{
+  PetscInt i,j,k;
+  for (k=0; k<n; k++) {
+    PetscInt p = k;
+    for (i=k+1; i<n; i++) if (PetscAbsReal(A[i*n+k]) > PetscAbsReal(A[p*n+k])) p = i;
+    if (A[p*n+k] == 0) return PETSC_FALSE;
+    if (p != k) {
+      PetscReal t;
+      for (j=k; j<n; j++) {t = A[k*n+j]; A[k*n+j] = A[p*n+j]; A[p*n+j] = t;}
+      t = b[k]; b[k] = b[p]; b[p] = t;
+    }
+    for (i=k+1; i<n; i++) {
+      PetscReal f = A[i*n+k]/A[k*n+k];
+      for (j=k; j<n; j++) A[i*n+j] -= f*A[k*n+j];
+      b[i] -= f*b[k];
+    }
+  }
+  for (k=n-1; k>=0; k--) {
+    PetscReal t = b[k];
+    for (j=k+1; j<n; j++) t -= A[k*n+j]*b[j];
+    b[k] = t/A[k*n+k];
+  }
+  return PETSC_TRUE;
+}
+
+/* Gauss-Newton with minimum-norm steps J^T (J J^T)^{-1} R; nodes stay ordered in (0,1) with positive weights */
+static PetscBool Reduced_Newton(ReducedCtx *ctx,PetscInt n,PetscReal x[],PetscReal w[])
+{
+  PetscInt  i,j,k,it,N = ctx->N,m = 2*n;
+  PetscReal *R = ctx->R,*J = ctx->J,*A = ctx->A,*D = ctx->D;
+  PetscReal *xt = ctx->xt,*wt = ctx->wt;
+  PetscReal res,tol = 1000*PETSC_MACHINE_EPSILON;
+  res = Reduced_Residual(ctx,n,x,w,R,J);
+  for (it=0; it<50; it++) {
+    PetscReal t;
+    if (res < tol) return PETSC_TRUE;
+    for (i=0; i<N; i++)
+      for (k=i; k<N; k++) {
+        PetscReal a = 0;
+        for (j=0; j<m; j++) a += J[i*m+j]*J[k*m+j];
+        A[i*N+k] = A[k*N+i] = a;
+      }
+    if (!Reduced_Solve(N,A,R)) return PETSC_FALSE;
+    for (j=0; j<m; j++) {
+      PetscReal d = 0;
+      for (i=0; i<N; i++) d += J[i*m+j]*R[i];
+      D[j] = d;
+    }
+    for (t=1; t>=(PetscReal)1/1024; t/=2) {
+      PetscBool ok = PETSC_TRUE;
+      for (j=0; j<n && ok; j++) {
+        wt[j] = w[j] - t*D[j];
+        xt[j] = x[j] - t*D[n+j];
+        if (!(wt[j] > 0 && xt[j] > 0 && xt[j] < 1)) ok = PETSC_FALSE;
+        if (j > 0 && !(xt[j] > xt[j-1])) ok = PETSC_FALSE;
+      }
+      if (ok && Reduced_Residual(ctx,n,xt,wt,ctx->S,NULL) < res) break;
+    }
+    if (t < (PetscReal)1/1024) return PETSC_FALSE;
+    (void)PetscMemcpy(x,xt,(size_t)n*sizeof(PetscReal));
+    (void)PetscMemcpy(w,wt,(size_t)n*sizeof(PetscReal));
+    res = Reduced_Residual(ctx,n,x,w,R,J);
+  }
+  return PETSC_FALSE;
+}
+
+/* Node elimination from an exact rule x[n],w[n]; xb,wb are [n] work arrays */
+static PetscInt Reduced_Eliminate(ReducedCtx *ctx,PetscInt n,PetscReal x[],PetscReal w[],PetscReal xb[],PetscReal wb[])
+{
+  PetscInt *order = ctx->order,target = (ctx->N+1)/2;
+  while (n > target) {
+    PetscInt  i,j,k;
+    PetscBool removed = PETSC_FALSE;
+    (void)PetscMemcpy(xb,x,(size_t)n*sizeof(PetscReal));
+    (void)PetscMemcpy(wb,w,(size_t)n*sizeof(PetscReal));
+    /* try the nodes in order of increasing weight */
+    for (i=0; i<n; i++) {
+      for (j=i; j>0 && wb[order[j-1]] > wb[i]; j--) order[j] = order[j-1];
+      order[j] = i;
+    }
+    for (i=0; i<n && !removed; i++) {
+      PetscInt jm = order[i];
+      for (k=0,j=0; j<n; j++) if (j != jm) {x[k] = xb[j]; w[k] = wb[j]; k++;}
+      if (jm == 0)        w[0]   += wb[jm];
+      else if (jm == n-1) w[n-2] += wb[jm];
+      else               {w[jm-1] += wb[jm]/2; w[jm] += wb[jm]/2;}
+      removed = Reduced_Newton(ctx,n-1,x,w);
+    }
+    if (!removed) {
+      (void)PetscMemcpy(x,xb,(size_t)n*sizeof(PetscReal));
+      (void)PetscMemcpy(w,wb,(size_t)n*sizeof(PetscReal));
+      break;
+    }
+    n--;
+  }
+  return n;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGARuleComputeReduced"
+/*
+  Reduced rule for the whole knot vector of an axis: count[nel] points
+  per element, and their parametric coordinates and weights (including
+  the element Jacobian) element by element in point[] and weight[],
+  which must have room for nel*(p+1) entries. The rule depends on the
+  knots only, so all processes compute the same one.
+*/
+PetscErrorCode IGARuleComputeReduced(IGAAxis axis,PetscInt count[],PetscReal point[],PetscReal weight[])
+{
+  PetscInt        p,q,nel,nmax,Nmax,Tmax;
+  const PetscInt  *span;
+  const PetscReal *U;
+  PetscInt        e0,e1,iel,j,np = 0;
+  PetscInt        nc = 0,Nc = 0;
+  PetscReal       *gx,*gw,*x,*w,*xb,*wb,*xc,*wc,*Tc;
+  IGARule         gauss;
+  ReducedCtx      ctx;
+  PetscErrorCode  ierr;
+  PetscFunctionBegin;
+  PetscValidPointer(axis,1);
+  PetscValidIntPointer(count,2);
+  PetscValidRealPointer(point,3);
+  PetscValidRealPointer(weight,4);
+
+  p = axis->p; q = 2*p;
+  U = axis->U;
+  nel  = axis->nel;
+  span = axis->span;
+  nmax = IGA_RULE_MACRO*(p+1);
+  Nmax = (q+1) + (IGA_RULE_MACRO-1)*q;
+  Tmax = Nmax + q + 1;
+
+  ierr = IGARuleCreate(&gauss);CHKERRQ(ierr);
+  ierr = IGARuleInit(gauss,p+1);CHKERRQ(ierr);
+  gx = gauss->point; gw = gauss->weight;
+
+  ctx.q = q;
+  ierr = PetscMalloc1(Tmax,&ctx.T);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nmax,&ctx.I);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nmax,&ctx.R);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nmax,&ctx.S);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nmax*2*nmax,&ctx.J);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nmax*Nmax,&ctx.A);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2*nmax,&ctx.D);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2*(q+1),&ctx.B);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&ctx.xt);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&ctx.wt);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&ctx.order);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&x);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&w);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&xb);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&wb);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&xc);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nmax,&wc);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Tmax,&Tc);CHKERRQ(ierr);
+
+  for (iel=0; iel<nel; iel++) count[iel] = 0;
+  for (e0=0; e0<nel; e0=e1) {
+    PetscInt  M,nchunk,m = 0,n = 0,N;
+    PetscReal a,b,L;
+    PetscBool same;
+    /* run of elements joined at knots where the integrands are at least C^0 */
+    for (e1=e0+1; e1<nel; e1++)
+      if (p - (span[e1]-span[e1-1]) - 1 < 0) break;
+    M = e1 - e0;
+    nchunk = (M + IGA_RULE_MACRO - 1)/IGA_RULE_MACRO;
+    e1 = e0 + (M + nchunk - 1)/nchunk;
+
+    a = U[span[e0]]; b = U[span[e1-1]+1]; L = b - a;
+    for (j=0; j<=q; j++) ctx.T[m++] = 0;
+    for (iel=e0+1; iel<e1; iel++) {
+      PetscInt  s = span[iel]-span[iel-1];
+      PetscReal t = (U[span[iel]] - a)/L;
+      for (j=0; j<p+s+1; j++) ctx.T[m++] = t;
+    }
+    for (j=0; j<=q; j++) ctx.T[m++] = 1;
+    N = ctx.N = m - q - 1;
+
+    same = (PetscBool)(N == Nc);
+    for (j=0; j<m && same; j++)
+      if (PetscAbsReal(ctx.T[j] - Tc[j]) > 100*PETSC_MACHINE_EPSILON) same = PETSC_FALSE;
+    if (!same) {
+      for (iel=e0; iel<e1; iel++) {
+        PetscReal u0 = U[span[iel]], h = U[span[iel]+1] - u0;
+        for (j=0; j<=p; j++) {
+          x[n] = ((gx[j]+1)*h/2 + u0 - a)/L;
+          w[n] = gw[j]*h/2/L;
+          n++;
+        }
+      }
+      for (j=0; j<N; j++) ctx.I[j] = (ctx.T[j+q+1] - ctx.T[j])/(q+1);
+      n = Reduced_Eliminate(&ctx,n,x,w,xb,wb);
+      ierr = PetscMemcpy(xc,x,n*sizeof(PetscReal));CHKERRQ(ierr);
+      ierr = PetscMemcpy(wc,w,n*sizeof(PetscReal));CHKERRQ(ierr);
+      ierr = PetscMemcpy(Tc,ctx.T,m*sizeof(PetscReal));CHKERRQ(ierr);
+      nc = n; Nc = N;
+    }
+
+    for (iel=e0, j=0; j<nc; j++) {
+      PetscReal u = a + xc[j]*L;
+      while (iel < e1-1 && u >= U[span[iel]+1]) iel++;
+      point[np]  = u;
+      weight[np] = wc[j]*L;
+      count[iel]++; np++;
+    }
+  }
+
+  ierr = PetscFree(ctx.T);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.I);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.R);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.S);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.J);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.A);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.D);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.B);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.xt);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.wt);CHKERRQ(ierr);
+  ierr = PetscFree(ctx.order);CHKERRQ(ierr);
+  ierr = PetscFree(x);CHKERRQ(ierr);
+  ierr = PetscFree(w);CHKERRQ(ierr);
+  ierr = PetscFree(xb);CHKERRQ(ierr);
+  ierr = PetscFree(wb);CHKERRQ(ierr);
+  ierr = PetscFree(xc);CHKERRQ(ierr);
+  ierr = PetscFree(wc);CHKERRQ(ierr);
+  ierr = PetscFree(Tc);CHKERRQ(ierr);
+  ierr = IGARuleDestroy(&gauss);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #if   defined(PETSC_USE_REAL_SINGLE)
 #define Q(constant) constant##f
 #elif defined(PETSC_USE_REAL_DOUBLE)
@@ -38,6 +38,7 @@ PetscErrorCode IGAComputeFunction(IGA iga,Vec vecU,Vec vecF)
   PetscValidHeaderSpecific(vecF,VEC_CLASSID,3);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,Function);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global vector F*/
   ierr = VecZeroEntries(vecF);CHKERRQ(ierr);
@@ -48,7 +49,9 @@ PetscErrorCode IGAComputeFunction(IGA iga,Vec vecU,Vec vecF)
   ierr = PetscLogEventBegin(IGA_FormFunction,iga,vecU,vecF,0);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_FUNCTION);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&F);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
@@ -59,7 +62,9 @@ PetscErrorCode IGAComputeFunction(IGA iga,Vec vecU,Vec vecF)
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&R);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = Function(point,U,R,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,R,F);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -68,6 +73,7 @@ PetscErrorCode IGAComputeFunction(IGA iga,Vec vecU,Vec vecF)
     ierr = IGAElementAssembleVec(element,F,vecF);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormFunction,iga,vecU,vecF,0);CHKERRQ(ierr);
 
@@ -75,9 +81,14 @@ PetscErrorCode IGAComputeFunction(IGA iga,Vec vecU,Vec vecF)
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global vector F */
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecF);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vecF);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -99,6 +110,7 @@ PetscErrorCode IGAComputeJacobian(IGA iga,Vec vecU,Mat matJ)
   PetscValidHeaderSpecific(matJ,MAT_CLASSID,3);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,Jacobian);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global matrix J */
   ierr = MatZeroEntries(matJ);CHKERRQ(ierr);
@@ -109,7 +121,9 @@ PetscErrorCode IGAComputeJacobian(IGA iga,Vec vecU,Mat matJ)
   ierr = PetscLogEventBegin(IGA_FormJacobian,iga,vecU,matJ,0);CHKERRQ(ierr);
 
   /* Element Loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_JACOBIAN);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&J);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
@@ -120,7 +134,9 @@ PetscErrorCode IGAComputeJacobian(IGA iga,Vec vecU,Mat matJ)
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = Jacobian(point,U,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,J);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -129,6 +145,7 @@ PetscErrorCode IGAComputeJacobian(IGA iga,Vec vecU,Mat matJ)
     ierr = IGAElementAssembleMat(element,J,matJ);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormJacobian,iga,vecU,matJ,0);CHKERRQ(ierr);
 
@@ -136,9 +153,14 @@ PetscErrorCode IGAComputeJacobian(IGA iga,Vec vecU,Mat matJ)
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global matrix J*/
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,206 @@
+#include "petiga.h"
+
+/*
+  Lightweight timeline tracer. Begin/end records of IGA phases are kept
+  in a per-rank ring buffer (the oldest records are overwritten) and
+  dumped at IGAFinalizePackage() as a single Chrome trace-event JSON
+  file (chrome://tracing, Perfetto) with one process per MPI rank.
+  Names are not copied and must be string literals (e.g. __FUNCT__).
+*/
+
+typedef struct {
+  const char     *name;
+  PetscLogDouble time;
+  char           phase;
+} IGATraceEvent;
+
+PetscBool IGATraceActive = PETSC_FALSE;
+
+static IGATraceEvent  *trace_buffer = NULL;
+static size_t         trace_size    = 0;
+static size_t         trace_count   = 0;
+static PetscLogDouble trace_origin  = 0;
+static char           trace_file[PETSC_MAX_PATH_LEN] = "";
+
+void IGATraceRecord(const char name[],char phase)
+{
+  IGATraceEvent *event = &trace_buffer[trace_count % trace_size];
+  event->name  = name;
+  event->time  = MPI_Wtime();
+  event->phase = phase;
+  trace_count++;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGATraceInitialize"
+/*@
+   IGATraceInitialize - Starts recording the timeline of IGA phases
+   if requested in the options database.
+
+   Not Collective
+
+   Options Database Keys:
++  -iga_trace [filename] - dump a Chrome trace-event JSON file at PetscFinalize() (default iga-trace.json)
+-  -iga_trace_size <n> - number of records kept per rank (default 100000)
+
+   Notes:
+   This routine is called by IGAInitializePackage(). The phases traced
+   are the IGASetUp() stages, IGACreateMat(), the IGACompute*() routines,
+   ghost updates, final Vec/Mat assembly, PCSetUp() for PCIGAEBE and
+   PCIGABBB, and time steps of TS solvers created with IGACreateTS().
+   User code may add its own phases with IGATraceBegin()/IGATraceEnd().
+
+   Timestamps come from MPI_Wtime(); they are only comparable across
+   ranks if the clocks of the nodes are synchronized.
+
+   Level: advanced
+
+.keywords: IGA, trace, timeline
+@*/
+PetscErrorCode IGATraceInitialize(void)
+{
+  PetscBool      flg = PETSC_FALSE;
+  PetscInt       size = 100000;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  if (trace_buffer) PetscFunctionReturn(0);
+  ierr = PetscOptionsGetString(NULL,"-iga_trace",trace_file,sizeof(trace_file),&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  if (!trace_file[0]) {ierr = PetscStrcpy(trace_file,"iga-trace.json");CHKERRQ(ierr);}
+  ierr = PetscOptionsGetInt(NULL,"-iga_trace_size",&size,NULL);CHKERRQ(ierr);
+  if (size < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Trace size must be positive, got %D",size);
+  ierr = PetscMalloc1((size_t)size,&trace_buffer);CHKERRQ(ierr);
+  trace_size   = (size_t)size;
+  trace_count  = 0;
+  trace_origin = MPI_Wtime();
+  IGATraceActive = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGATraceFinalize"
+/*@
+   IGATraceFinalize - Dumps the recorded timeline and stops tracing.
+
+   Collective on PETSC_COMM_WORLD
+
+   Notes:
+   This routine is called by IGAFinalizePackage().
+
+   Level: advanced
+
+.keywords: IGA, trace, timeline
+@*/
+PetscErrorCode IGATraceFinalize(void)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  if (!trace_buffer) PetscFunctionReturn(0);
+  ierr = IGATraceDump(PETSC_COMM_WORLD,trace_file);CHKERRQ(ierr);
+  IGATraceActive = PETSC_FALSE;
+  ierr = PetscFree(trace_buffer);CHKERRQ(ierr);
+  trace_size = trace_count = 0;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGATrace_Format"
+static PetscErrorCode IGATrace_Format(PetscMPIInt rank,PetscLogDouble origin,char **text,size_t *length)
+{
+  size_t         i,n,start,len = 0,cap = 0,depth = 0;
+  char           *buf;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  n     = PetscMin(trace_count,trace_size);
+  start = (trace_count > trace_size) ? trace_count % trace_size : 0;
+  for (i=0; i<n; i++) {
+    size_t namelen;
+    ierr = PetscStrlen(trace_buffer[(start+i)%trace_size].name,&namelen);CHKERRQ(ierr);
+    cap += namelen + 128;
+  }
+  cap += 128;
+  ierr = PetscMalloc1(cap,&buf);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(buf,cap,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"rank %d\"}}",
+                       rank ? ",\n" : "",(int)rank,(int)rank);CHKERRQ(ierr);
+  ierr = PetscStrlen(buf,&len);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    IGATraceEvent *event = &trace_buffer[(start+i)%trace_size];
+    size_t        m;
+    if (event->phase == 'E') { /* begin record lost to wrap-around */
+      if (!depth) continue;
+      depth--;
+    } else depth++;
+    ierr = PetscSNPrintf(buf+len,cap-len,",\n{\"name\":\"%s\",\"cat\":\"IGA\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":0}",
+                         event->name,event->phase,(double)((event->time-origin)*1e6),(int)rank);CHKERRQ(ierr);
+    ierr = PetscStrlen(buf+len,&m);CHKERRQ(ierr);
+    len += m;
+  }
+  *text = buf; *length = len;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGATraceDump"
+/*@
+   IGATraceDump - Writes the timeline recorded so far on every rank of a
+   communicator to a Chrome trace-event JSON file.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - the MPI communicator
+-  filename - the name of the file
+
+   Notes:
+   Each rank appears as a separate process of the trace. The ranks send
+   their records to the first rank one at a time, so the memory needed
+   there is bounded by the largest per-rank buffer. Tracing must have
+   been started with -iga_trace on every rank of the communicator.
+
+   Level: advanced
+
+.keywords: IGA, trace, timeline
+@*/
+PetscErrorCode IGATraceDump(MPI_Comm comm,const char filename[])
+{
+  PetscMPIInt    rank,size,r;
+  PetscLogDouble origin;
+  unsigned long  dropped,total = 0;
+  char           *text = NULL;
+  size_t         length = 0;
+  FILE           *fp = NULL;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidCharPointer(filename,2);
+  if (!trace_buffer) SETERRQ(comm,PETSC_ERR_ORDER,"Tracing not active, use -iga_trace");
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&trace_origin,&origin,1,MPI_DOUBLE,MPI_MIN,comm);CHKERRQ(ierr);
+  dropped = (unsigned long)((trace_count > trace_size) ? trace_count - trace_size : 0);
+  ierr = MPI_Reduce(&dropped,&total,1,MPI_UNSIGNED_LONG,MPI_SUM,0,comm);CHKERRQ(ierr);
+
+  ierr = IGATrace_Format(rank,origin,&text,&length);CHKERRQ(ierr);
+  ierr = PetscFOpen(comm,filename,"w",&fp);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"{\"traceEvents\":[\n");CHKERRQ(ierr);
+    if (length) fwrite(text,1,length,fp);
+    ierr = PetscFree(text);CHKERRQ(ierr);
+    for (r=1; r<size; r++) {
+      unsigned long n;
+      MPI_Status    status;
+      ierr = MPI_Recv(&n,1,MPI_UNSIGNED_LONG,r,0,comm,&status);CHKERRQ(ierr);
+      ierr = PetscMalloc1((size_t)n+1,&text);CHKERRQ(ierr);
+      ierr = MPI_Recv(text,(PetscMPIInt)n,MPI_CHAR,r,0,comm,&status);CHKERRQ(ierr);
+      if (n) fwrite(text,1,(size_t)n,fp);
+      ierr = PetscFree(text);CHKERRQ(ierr);
+    }
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%lu}}\n",total);CHKERRQ(ierr);
+  } else {
+    unsigned long n = (unsigned long)length;
+    ierr = MPI_Send(&n,1,MPI_UNSIGNED_LONG,0,0,comm);CHKERRQ(ierr);
+    ierr = MPI_Send(text,(PetscMPIInt)n,MPI_CHAR,0,0,comm);CHKERRQ(ierr);
+    ierr = PetscFree(text);CHKERRQ(ierr);
+  }
+  ierr = PetscFClose(comm,fp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -44,6 +44,7 @@ PetscErrorCode IGAComputeIFunction(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(vecF,VEC_CLASSID,7);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IFunction);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global vector F */
   ierr = VecZeroEntries(vecF);CHKERRQ(ierr);
@@ -55,7 +56,9 @@ PetscErrorCode IGAComputeIFunction(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IFUNCTION);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&F);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayV,&V);CHKERRQ(ierr);
@@ -67,7 +70,9 @@ PetscErrorCode IGAComputeIFunction(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&R);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IFunction(point,dt,a,V,t,U,R,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,R,F);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -76,6 +81,7 @@ PetscErrorCode IGAComputeIFunction(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleVec(element,F,vecF);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
@@ -84,9 +90,14 @@ PetscErrorCode IGAComputeIFunction(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global vector F */
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecF);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vecF);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -114,6 +125,7 @@ PetscErrorCode IGAComputeIJacobian(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(matJ,MAT_CLASSID,7);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IJacobian);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global matrix J*/
   ierr = MatZeroEntries(matJ);CHKERRQ(ierr);
@@ -125,7 +137,9 @@ PetscErrorCode IGAComputeIJacobian(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
   /* Element Loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IJACOBIAN);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&J);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayV,&V);CHKERRQ(ierr);
@@ -137,7 +151,9 @@ PetscErrorCode IGAComputeIJacobian(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IJacobian(point,dt,a,V,t,U,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,J);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -146,6 +162,7 @@ PetscErrorCode IGAComputeIJacobian(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleMat(element,J,matJ);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
@@ -154,9 +171,14 @@ PetscErrorCode IGAComputeIJacobian(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global matrix J*/
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -209,6 +231,7 @@ PetscErrorCode IGAComputeIEFunction(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(vecF,VEC_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IEFunction);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global vector F */
   ierr = VecZeroEntries(vecF);CHKERRQ(ierr);
@@ -221,7 +244,9 @@ PetscErrorCode IGAComputeIEFunction(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IEFUNCTION);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&F);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayV,&V);CHKERRQ(ierr);
@@ -235,7 +260,9 @@ PetscErrorCode IGAComputeIEFunction(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&R);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IEFunction(point,dt,a,V,t,U,t0,U0,R,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,R,F);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -244,6 +271,7 @@ PetscErrorCode IGAComputeIEFunction(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleVec(element,F,vecF);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
@@ -253,9 +281,14 @@ PetscErrorCode IGAComputeIEFunction(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU0,&localU0,&arrayU0);CHKERRQ(ierr);
 
   /* Assemble global vector F */
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecF);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vecF);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -287,6 +320,7 @@ PetscErrorCode IGAComputeIEJacobian(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(matJ,MAT_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IEJacobian);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global matrix J*/
   ierr = MatZeroEntries(matJ);CHKERRQ(ierr);
@@ -299,7 +333,9 @@ PetscErrorCode IGAComputeIEJacobian(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
   /* Element Loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IEJACOBIAN);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&J);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayV,&V);CHKERRQ(ierr);
@@ -313,7 +349,9 @@ PetscErrorCode IGAComputeIEJacobian(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IEJacobian(point,dt,a,V,t,U,t0,U0,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,J);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -322,6 +360,7 @@ PetscErrorCode IGAComputeIEJacobian(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleMat(element,J,matJ);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
@@ -331,9 +370,14 @@ PetscErrorCode IGAComputeIEJacobian(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU0,&localU0,&arrayU0);CHKERRQ(ierr);
 
   /* Assemble global matrix J*/
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -378,6 +422,7 @@ PetscErrorCode IGAComputeRHSFunction(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(vecF,VEC_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,RHSFunction);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global vector F */
   ierr = VecZeroEntries(vecF);CHKERRQ(ierr);
@@ -388,7 +433,9 @@ PetscErrorCode IGAComputeRHSFunction(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIFunction,iga,vecU,vecF,NULL);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_RHSFUNCTION);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&F);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
@@ -399,7 +446,9 @@ PetscErrorCode IGAComputeRHSFunction(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&R);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = RHSFunction(point,dt,t,U,R,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,R,F);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -408,6 +457,7 @@ PetscErrorCode IGAComputeRHSFunction(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleVec(element,F,vecF);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIFunction,iga,vecU,vecF,NULL);CHKERRQ(ierr);
 
@@ -415,9 +465,14 @@ PetscErrorCode IGAComputeRHSFunction(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global vector F */
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecF);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vecF);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -441,6 +496,7 @@ PetscErrorCode IGAComputeRHSJacobian(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(matJ,MAT_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,RHSJacobian);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global matrix J */
   ierr = MatZeroEntries(matJ);CHKERRQ(ierr);
@@ -451,7 +507,9 @@ PetscErrorCode IGAComputeRHSJacobian(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIJacobian,iga,vecU,matJ,NULL);CHKERRQ(ierr);
 
   /* Element Loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_RHSJACOBIAN);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&J);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
@@ -462,7 +520,9 @@ PetscErrorCode IGAComputeRHSJacobian(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = RHSJacobian(point,dt,t,U,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,J);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -471,6 +531,7 @@ PetscErrorCode IGAComputeRHSJacobian(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleMat(element,J,matJ);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIJacobian,iga,vecU,matJ,NULL);CHKERRQ(ierr);
 
@@ -478,9 +539,14 @@ PetscErrorCode IGAComputeRHSJacobian(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global matrix J*/
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -621,6 +687,20 @@ static PetscErrorCode IGA_OptionsHandler_TS(PetscObject obj,void *ctx)
 static PetscErrorCode OptHdlDel(PetscObject obj,void *ctx) {return 0;}
 */
 
+/* marks each time step as a phase of the timeline, see -iga_trace */
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_TraceMonitor_TS"
+static PetscErrorCode IGA_TraceMonitor_TS(TS ts,PetscInt step,PetscReal t,Vec U,void *ctx)
+{
+  PetscBool *open = (PetscBool*)ctx;
+  PetscFunctionBegin;
+  if (*open) IGATraceEnd("TSStep");
+  IGATraceBegin("TSStep");
+  *open = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+static PetscErrorCode IGA_TraceMonitorDestroy_TS(void **ctx) {return PetscFree(*ctx);}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGASetOptionsHandlerTS"
 PetscErrorCode IGASetOptionsHandlerTS(TS ts)
@@ -632,5 +712,11 @@ PetscErrorCode IGASetOptionsHandlerTS(TS ts)
   /*ierr = PetscObjectAddOptionsHandler((PetscObject)ts,IGA_OptionsHandler_TS,OptHdlDel,NULL);CHKERRQ(ierr);*/
   ierr = TSGetSNES(ts,&snes);CHKERRQ(ierr);
   ierr = IGASetOptionsHandlerSNES(snes);CHKERRQ(ierr);
+  if (IGATraceActive) {
+    PetscBool *open;
+    ierr = PetscMalloc1(1,&open);CHKERRQ(ierr);
+    *open = PETSC_FALSE;
+    ierr = TSMonitorSet(ts,IGA_TraceMonitor_TS,open,IGA_TraceMonitorDestroy_TS);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
@@ -49,6 +49,7 @@ PetscErrorCode IGAComputeIFunction2(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(vecF,VEC_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IFunction2);
+  IGATraceBegin(__FUNCT__);
 
   /* Clear global vector F */
   ierr = VecZeroEntries(vecF);CHKERRQ(ierr);
@@ -61,7 +62,9 @@ PetscErrorCode IGAComputeIFunction2(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
   /* Element loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IFUNCTION);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkVec(element,&F);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayA,&A);CHKERRQ(ierr);
@@ -73,7 +76,9 @@ PetscErrorCode IGAComputeIFunction2(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkVec(point,&R);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IFunction(point,dt,a,A,v,V,t,U,R,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddVec(point,R,F);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -82,6 +87,7 @@ PetscErrorCode IGAComputeIFunction2(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleVec(element,F,vecF);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIFunction,iga,vecV,vecU,vecF);CHKERRQ(ierr);
 
@@ -91,9 +97,14 @@ PetscErrorCode IGAComputeIFunction2(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global vector F */
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("VecAssembly");
   ierr = VecAssemblyBegin(vecF);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(vecF);CHKERRQ(ierr);
+  IGATraceEnd("VecAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -125,6 +136,7 @@ PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
   PetscValidHeaderSpecific(matJ,MAT_CLASSID,9);
   IGACheckSetUp(iga,1);
   IGACheckFormOp(iga,1,IJacobian2);
+  IGATraceBegin(__FUNCT__);
   IJacobian = iga->form->ops->IJacobian2;
   ctx       = iga->form->ops->IJacCtx;
 
@@ -139,7 +151,9 @@ PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
   ierr = PetscLogEventBegin(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
   /* Element Loop */
+  iga->elem_tic = MPI_Wtime();
   ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGAElementUseFormQuadrature(element,IGA_FORM_IJACOBIAN);CHKERRQ(ierr);
   while (IGANextElement(iga,element)) {
     ierr = IGAElementGetWorkMat(element,&J);CHKERRQ(ierr);
     ierr = IGAElementGetValues(element,arrayA,&A);CHKERRQ(ierr);
@@ -151,7 +165,9 @@ PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
       ierr = IGAElementBeginPoint(element,&point);CHKERRQ(ierr);
       while (IGAElementNextPoint(element,point)) {
         ierr = IGAPointGetWorkMat(point,&K);CHKERRQ(ierr);
+        IGAProfileBegin(iga,IGA_PROFILE_KERNEL);
         ierr = IJacobian(point,dt,a,A,v,V,t,U,K,ctx);CHKERRQ(ierr);
+        IGAProfileEnd(iga,IGA_PROFILE_KERNEL);
         ierr = IGAPointAddMat(point,K,J);CHKERRQ(ierr);
       }
       ierr = IGAElementEndPoint(element,&point);CHKERRQ(ierr);
@@ -160,6 +176,7 @@ PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
     ierr = IGAElementAssembleMat(element,J,matJ);CHKERRQ(ierr);
   }
   ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  iga->elem_time = MPI_Wtime() - iga->elem_tic;
 
   ierr = PetscLogEventEnd(IGA_FormIJacobian,iga,vecV,vecU,matJ);CHKERRQ(ierr);
 
@@ -169,9 +186,14 @@ PetscErrorCode IGAComputeIJacobian2(IGA iga,PetscReal dt,
   ierr = IGARestoreLocalVecArray(iga,vecU,&localU,&arrayU);CHKERRQ(ierr);
 
   /* Assemble global matrix J*/
+  IGAProfileBegin(iga,IGA_PROFILE_ASSEMBLY);
+  IGATraceBegin("MatAssembly");
   ierr = MatAssemblyBegin(matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd  (matJ,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  IGATraceEnd("MatAssembly");
+  IGAProfileEnd(iga,IGA_PROFILE_ASSEMBLY);
 
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
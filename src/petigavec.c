@@ -1,4 +1,5 @@
 #include "petiga.h"
+#include "petigagrid.h"
 #include <petsc-private/vecimpl.h>
 
 #if PETSC_VERSION_LE(3,3,0)
@@ -205,7 +206,14 @@ PetscErrorCode IGAGlobalToLocalBegin(IGA iga,Vec gvec,Vec lvec,InsertMode addv)
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_GlobalToLocalBegin(iga->halo,gvec,lvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   ierr = VecScatterBegin(iga->g2l,gvec,lvec,addv,SCATTER_FORWARD);CHKERRQ(ierr);
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -219,7 +227,14 @@ PetscErrorCode IGAGlobalToLocalEnd(IGA iga,Vec gvec,Vec lvec,InsertMode addv)
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_GlobalToLocalEnd(iga->halo,gvec,lvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   ierr = VecScatterEnd(iga->g2l,gvec,lvec,addv,SCATTER_FORWARD);CHKERRQ(ierr);
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -244,11 +259,18 @@ PetscErrorCode IGALocalToGlobalBegin(IGA iga,Vec lvec,Vec gvec,InsertMode addv)
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_LocalToGlobalBegin(iga->halo,lvec,gvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   if (addv == ADD_VALUES) {
     ierr = VecScatterBegin(iga->g2l,lvec,gvec,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
   } else if (addv == INSERT_VALUES) {
     ierr = VecScatterBegin(iga->l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   } else SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Not yet implemented");
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -262,11 +284,18 @@ PetscErrorCode IGALocalToGlobalEnd(IGA iga,Vec lvec,Vec gvec,InsertMode addv)
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_LocalToGlobalEnd(iga->halo,lvec,gvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   if (addv == ADD_VALUES) {
     ierr = VecScatterEnd(iga->g2l,lvec,gvec,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
   } else if (addv == INSERT_VALUES) {
     ierr = VecScatterEnd(iga->l2g,lvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   } else SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Not yet implemented");
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -291,8 +320,15 @@ PetscErrorCode IGALocalToLocalBegin(IGA iga,Vec gvec,Vec lvec,InsertMode addv)
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_LocalToLocalBegin(iga->halo,gvec,lvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   if (!iga->l2l) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Not implemented");
   ierr = VecScatterBegin(iga->l2l,gvec,lvec,addv,SCATTER_FORWARD);CHKERRQ(ierr);
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -306,8 +342,15 @@ PetscErrorCode IGALocalToLocalEnd(IGA iga,Vec gvec,Vec lvec,InsertMode addv)
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(lvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  IGATraceBegin(__FUNCT__);
+  if (iga->halo) {
+    ierr = IGA_Halo_LocalToLocalEnd(iga->halo,gvec,lvec,addv);CHKERRQ(ierr);
+    IGATraceEnd(__FUNCT__);
+    PetscFunctionReturn(0);
+  }
   if (!iga->l2l) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Not implemented");
   ierr = VecScatterEnd(iga->l2l,gvec,lvec,addv,SCATTER_FORWARD);CHKERRQ(ierr);
+  IGATraceEnd(__FUNCT__);
   PetscFunctionReturn(0);
 }
 
@@ -356,14 +399,89 @@ PetscErrorCode IGARestoreLocalVecArray(IGA iga,Vec gvec,Vec *lvec,const PetscSca
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_NewGridNode"
+static PetscErrorCode IGA_NewGridNode(IGA iga,IGA_Grid *grid)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGA_Grid_Create(((PetscObject)iga)->comm,grid);CHKERRQ(ierr);
+  ierr = IGA_Grid_Init(*grid,
+                       iga->dim,iga->dof,iga->node_sizes,
+                       iga->node_lstart,iga->node_lwidth,
+                       iga->node_gstart,iga->node_gwidth);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAGetAO"
+/*@
+   IGAGetAO - Gets the application ordering mapping the natural
+   (lexicographic) numbering of the nodes to the PETSc numbering.
+
+   Collective on IGA the first time it is called
+
+   Input Parameter:
+.  iga - the IGA context
+
+   Output Parameter:
+.  ao - the application ordering
+
+   Notes:
+   The mapping is computed in closed form from the processor grid and
+   is created the first time it is requested.
+
+   Level: developer
+
+.keywords: IGA, application ordering
+@*/
+PetscErrorCode IGAGetAO(IGA iga,AO *ao)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidPointer(ao,2);
+  IGACheckSetUpStage2(iga,1);
+  if (!iga->ao) {
+    IGA_Grid grid;
+    ierr = IGA_NewGridNode(iga,&grid);CHKERRQ(ierr);
+    ierr = IGA_Grid_GetAO(grid,&iga->ao);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)iga->ao);CHKERRQ(ierr);
+    ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
+  }
+  *ao = iga->ao;
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_SetUpNatural"
+static PetscErrorCode IGA_SetUpNatural(IGA iga)
+{
+  IGA_Grid       grid;
+  AO             ao;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  if (iga->natural) PetscFunctionReturn(0);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = IGA_NewGridNode(iga,&grid);CHKERRQ(ierr);
+  ierr = IGA_Grid_SetAO(grid,ao);CHKERRQ(ierr); /* reuse, do not rebuild */
+  ierr = IGA_Grid_NewScatterApp(grid,
+                                iga->geom_sizes,iga->geom_lstart,iga->geom_lwidth,
+                                &iga->natural,&iga->n2g,&iga->g2n);CHKERRQ(ierr);
+  ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #undef  __FUNCT__
 #define __FUNCT__ "IGAGetNaturalVec"
 PetscErrorCode IGAGetNaturalVec(IGA iga,Vec *nvec)
 {
+  PetscErrorCode ierr;
   PetscFunctionBegin;
   PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
   PetscValidPointer(nvec,2);
   IGACheckSetUpStage2(iga,1);
+  ierr = IGA_SetUpNatural(iga);CHKERRQ(ierr);
   *nvec = iga->natural;
   PetscFunctionReturn(0);
 }
@@ -378,6 +496,7 @@ PetscErrorCode IGANaturalToGlobal(IGA iga,Vec nvec,Vec gvec)
   PetscValidHeaderSpecific(nvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  ierr = IGA_SetUpNatural(iga);CHKERRQ(ierr);
   ierr = VecScatterBegin(iga->n2g,nvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (iga->n2g,nvec,gvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -393,6 +512,7 @@ PetscErrorCode IGAGlobalToNatural(IGA iga,Vec gvec,Vec nvec)
   PetscValidHeaderSpecific(gvec,VEC_CLASSID,2);
   PetscValidHeaderSpecific(nvec,VEC_CLASSID,3);
   IGACheckSetUpStage2(iga,1);
+  ierr = IGA_SetUpNatural(iga);CHKERRQ(ierr);
   ierr = VecScatterBegin(iga->g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = VecScatterEnd  (iga->g2n,gvec,nvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -0,0 +1,357 @@
+#include "petiga.h"
+
+EXTERN_C_BEGIN
+extern void IGA_Basis_BSpline (PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+extern void IGA_Basis_Lagrange(PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal L[]);
+EXTERN_C_END
+
+/* VTK cell types, see vtkCellType.h */
+#define IGA_VTK_LAGRANGE_CURVE         68
+#define IGA_VTK_LAGRANGE_QUADRILATERAL 70
+#define IGA_VTK_LAGRANGE_HEXAHEDRON    72
+
+/*
+  Local point index of the (i,j,k) node of a Lagrange cell of orders
+  n[0],n[1],n[2] in VTK ordering: vertices, edges, faces, interior.
+  This follows vtkHigherOrder{Curve,Quadrilateral,Hexahedron} with the
+  edge ordering of VTK file format version 2.2: the k-direction edges
+  come in the order of the linear hexahedron, {0,4},{1,5},{2,6},{3,7},
+  so vertex 2 is (1,1) and vertex 3 is (0,1). Files older than 2.2 swap
+  the last two of them, and VTK readers convert those on input.
+*/
+static PetscInt IGA_VTKPointIndex(PetscInt dim,const PetscInt n[],PetscInt i,PetscInt j,PetscInt k)
+{
+  PetscInt ib = (i == 0 || i == n[0]);
+  PetscInt jb = (j == 0 || j == n[1]);
+  PetscInt kb = (k == 0 || k == n[2]);
+  PetscInt n0 = n[0]-1, n1 = n[1]-1, n2 = n[2]-1;
+  PetscInt offset;
+  switch (dim) {
+  case 1:
+    if (ib) return i ? 1 : 0;
+    return i + 1;
+  case 2:
+    if (ib && jb) return (i ? (j ? 2 : 1) : (j ? 3 : 0));
+    offset = 4;
+    if (jb) return (i-1) + (j ? n0 + n1 : 0) + offset;
+    if (ib) return (j-1) + (i ? n0 : 2*n0 + n1) + offset;
+    offset += 2*(n0 + n1);
+    return offset + (i-1) + n0*(j-1);
+  case 3:
+    if (ib && jb && kb) return (i ? (j ? 2 : 1) : (j ? 3 : 0)) + (k ? 4 : 0);
+    offset = 8;
+    if (!ib && jb && kb) return (i-1) + (j ? n0 + n1 : 0) + (k ? 2*(n0 + n1) : 0) + offset;
+    if (ib && !jb && kb) return (j-1) + (i ? n0 : 2*n0 + n1) + (k ? 2*(n0 + n1) : 0) + offset;
+    if (ib && jb && !kb) return (k-1) + n2*(i ? (j ? 2 : 1) : (j ? 3 : 0)) + 4*(n0 + n1) + offset;
+    offset += 4*(n0 + n1 + n2);
+    if (ib) return (j-1) + n1*(k-1) + (i ? n1*n2 : 0) + offset;
+    offset += 2*n1*n2;
+    if (jb) return (i-1) + n0*(k-1) + (j ? n2*n0 : 0) + offset;
+    offset += 2*n2*n0;
+    if (kb) return (i-1) + n0*(j-1) + (k ? n0*n1 : 0) + offset;
+    offset += 2*n0*n1;
+    return offset + (i-1) + n0*((j-1) + n1*(k-1));
+  }
+  return -1;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGA_VTKWriteBlock"
+static PetscErrorCode IGA_VTKWriteBlock(FILE *fp,const void *data,size_t size,size_t count)
+{
+  unsigned long long nbytes = (unsigned long long)(size*count);
+  PetscFunctionBegin;
+  if (fwrite(&nbytes,sizeof(nbytes),1,fp) != 1)
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Error writing VTK appended data");
+  if (count && fwrite(data,size,count,fp) != count)
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Error writing VTK appended data");
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "IGAWriteVecVTK"
+/*@
+   IGAWriteVecVTK - Writes a vector and the IGA geometry to a parallel
+   VTK unstructured grid file using higher-order Lagrange cells.
+
+   Collective on IGA
+
+   Input Parameters:
++  iga - the IGA context
+.  vec - the vector to write
+-  filename - the name of the .pvtu file
+
+   Options Database Keys:
+.  -iga_vtk_order <n> - Lagrange order of the output cells
+
+   Notes:
+   Each element is written as one VTK Lagrange curve, quadrilateral or
+   hexahedron. Geometry and field are evaluated on an equispaced lattice
+   of element-local parameters, which for polynomial splines represents
+   the element exactly when the order is not less than the spline degree.
+   By default the order in each direction is the spline degree; passing a
+   larger order subsamples each element more finely.
+
+   Each process writes its local elements to a piece file named
+   <base>-<rank>.vtu with appended raw binary data, and the first process
+   writes the <base>.pvtu file referencing all the pieces.
+
+   Only the VTK XML format is written; there is no HDF5/XDMF output of
+   these cells.
+
+   Level: normal
+
+.keywords: IGA, output, VTK
+@*/
+PetscErrorCode IGAWriteVecVTK(IGA iga,Vec vec,const char filename[])
+{
+  MPI_Comm          comm;
+  PetscMPIInt       rank,size;
+  const char        *vecname = NULL;
+  char              base[PETSC_MAX_PATH_LEN],piece[PETSC_MAX_PATH_LEN];
+  const char        *pbase = NULL;
+  char              *ext = NULL;
+  PetscInt          i,j,k,c,a,dim,dof,nsd;
+  PetscInt          order[3] = {1,1,1},n[3] = {1,1,1},norder = 3;
+  PetscBool         flg;
+  PetscInt          npe,nel,npts;
+  PetscReal         *B[3] = {NULL,NULL,NULL};
+  PetscInt          *perm;
+  double            *xyz,*val;
+  long long         *conn,*offs;
+  unsigned char     *type;
+  Vec               localU;
+  const PetscScalar *arrayU;
+  IGAElement        element;
+  PetscScalar       *U;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(iga,IGA_CLASSID,1);
+  PetscValidHeaderSpecific(vec,VEC_CLASSID,2);
+  PetscValidCharPointer(filename,3);
+  IGACheckSetUp(iga,1);
+  if (iga->collocation) SETERRQ(((PetscObject)iga)->comm,PETSC_ERR_SUP,"Not supported for collocation");
+
+  ierr = IGAGetComm(iga,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscObjectGetName((PetscObject)vec,&vecname);CHKERRQ(ierr);
+
+  dim = iga->dim;
+  dof = iga->dof;
+  nsd = iga->geometry ? iga->geometry : 0;
+  for (i=0; i<dim; i++) order[i] = PetscMax(iga->axis[i]->p,1);
+  ierr = PetscOptionsGetIntArray(((PetscObject)iga)->prefix,"-iga_vtk_order",n,&norder,&flg);CHKERRQ(ierr);
+  if (flg && norder > 0) {
+    for (i=norder; i<dim; i++) n[i] = n[0];
+    for (i=0; i<dim; i++) order[i] = PetscMax(n[i],1);
+  }
+  for (i=0; i<3; i++) n[i] = (i < dim) ? order[i] : 0;
+
+  /* 1D basis functions at equispaced element-local parameters */
+  for (i=0; i<dim; i++) {
+    IGAAxis  axis = iga->axis[i];
+    PetscInt p = axis->p;
+    ierr = PetscMalloc1((size_t)(n[i]+1)*(p+1),&B[i]);CHKERRQ(ierr);
+  }
+
+  /* sizes and VTK point permutation */
+  for (npe=1, i=0; i<dim; i++) npe *= (n[i]+1);
+  ierr = PetscMalloc1(npe,&perm);CHKERRQ(ierr);
+  for (a=0, k=0; k<=n[2]; k++)
+    for (j=0; j<=n[1]; j++)
+      for (i=0; i<=n[0]; i++)
+        perm[IGA_VTKPointIndex(dim,n,i,j,k)] = a++;
+
+  ierr = IGABeginElement(iga,&element);CHKERRQ(ierr);
+  nel  = element->count;
+  npts = nel*npe;
+  ierr = PetscMalloc1((size_t)npts*3,&xyz);CHKERRQ(ierr);
+  ierr = PetscMalloc1((size_t)npts*dof,&val);CHKERRQ(ierr);
+  ierr = PetscMalloc1((size_t)npts,&conn);CHKERRQ(ierr);
+  ierr = PetscMalloc1((size_t)nel,&offs);CHKERRQ(ierr);
+  ierr = PetscMalloc1((size_t)nel,&type);CHKERRQ(ierr);
+
+  /* Element loop */
+  ierr = IGAGetLocalVecArray(iga,vec,&localU,&arrayU);CHKERRQ(ierr);
+  {
+    PetscInt  e = 0, nen = element->nen;
+    PetscInt  inen = iga->axis[0]->p+1;
+    PetscInt  jnen = dim > 1 ? iga->axis[1]->p+1 : 1;
+    PetscInt  knen = dim > 2 ? iga->axis[2]->p+1 : 1;
+    PetscReal *N;
+    unsigned char ctype = (dim == 3) ? IGA_VTK_LAGRANGE_HEXAHEDRON :
+                          (dim == 2) ? IGA_VTK_LAGRANGE_QUADRILATERAL :
+                                       IGA_VTK_LAGRANGE_CURVE;
+    ierr = PetscMalloc1(nen,&N);CHKERRQ(ierr);
+    while (IGANextElement(iga,element)) {
+      PetscReal u[3] = {0,0,0};
+      PetscInt  pt = e*npe;
+      ierr = IGAElementGetValues(element,arrayU,&U);CHKERRQ(ierr);
+      for (i=0; i<dim; i++) {
+        IGAAxis   axis = iga->axis[i];
+        PetscInt  s = axis->span[element->ID[i]], q;
+        PetscReal u0 = axis->U[s], u1 = axis->U[s+1];
+        void (*ComputeBasis)(PetscInt,PetscReal,PetscInt,PetscInt,const PetscReal[],PetscReal[]);
+        switch (iga->basis[i]->type) {
+        case IGA_BASIS_LAGRANGE: ComputeBasis = IGA_Basis_Lagrange; break;
+        default:                 ComputeBasis = IGA_Basis_BSpline;
+        }
+        for (q=0; q<=n[i]; q++) {
+          PetscReal uq = u0 + (u1-u0)*(PetscReal)q/(PetscReal)n[i];
+          ComputeBasis(s,uq,axis->p,0,axis->U,&B[i][q*(axis->p+1)]);
+        }
+      }
+      for (k=0; k<=n[2]; k++)
+        for (j=0; j<=n[1]; j++)
+          for (i=0; i<=n[0]; i++, pt++) {
+            const PetscReal *Bi = B[0]+i*inen;
+            const PetscReal *Bj = dim > 1 ? B[1]+j*jnen : NULL;
+            const PetscReal *Bk = dim > 2 ? B[2]+k*knen : NULL;
+            PetscInt ia,ja,ka;
+            for (a=0, ka=0; ka<knen; ka++)
+              for (ja=0; ja<jnen; ja++)
+                for (ia=0; ia<inen; ia++, a++)
+                  N[a] = Bi[ia] * (Bj ? Bj[ja] : 1) * (Bk ? Bk[ka] : 1);
+            if (element->rational) {
+              PetscReal W = 0;
+              for (a=0; a<nen; a++) W += (N[a] *= element->rationalW[a]);
+              for (a=0; a<nen; a++) N[a] /= W;
+            }
+            for (c=0; c<3; c++) xyz[pt*3+c] = 0;
+            if (element->geometry) {
+              for (a=0; a<nen; a++)
+                for (c=0; c<nsd && c<3; c++)
+                  xyz[pt*3+c] += (double)(N[a]*element->geometryX[a*nsd+c]);
+            } else {
+              PetscInt idx[3]; idx[0] = i; idx[1] = j; idx[2] = k;
+              for (c=0; c<dim; c++) {
+                IGAAxis  axis = iga->axis[c];
+                PetscInt s = axis->span[element->ID[c]];
+                u[c] = axis->U[s] + (axis->U[s+1]-axis->U[s])*(PetscReal)idx[c]/(PetscReal)n[c];
+                xyz[pt*3+c] = (double)u[c];
+              }
+            }
+            for (c=0; c<dof; c++) {
+              PetscScalar v = 0;
+              for (a=0; a<nen; a++) v += N[a]*U[a*dof+c];
+              val[pt*dof+c] = (double)PetscRealPart(v);
+            }
+          }
+      for (a=0; a<npe; a++) conn[e*npe+a] = (long long)(e*npe + perm[a]);
+      offs[e] = (long long)((e+1)*npe);
+      type[e] = ctype;
+      e++;
+    }
+    ierr = PetscFree(N);CHKERRQ(ierr);
+  }
+  ierr = IGAEndElement(iga,&element);CHKERRQ(ierr);
+  ierr = IGARestoreLocalVecArray(iga,vec,&localU,&arrayU);CHKERRQ(ierr);
+
+  /* file names */
+  ierr = PetscStrncpy(base,filename,sizeof(base));CHKERRQ(ierr);
+  ierr = PetscStrrchr(base,'/',(char**)&pbase);CHKERRQ(ierr);
+  ierr = PetscStrrchr(pbase,'.',&ext);CHKERRQ(ierr);
+  if (ext != pbase) {
+    PetscBool isvtu = PETSC_FALSE;
+    ierr = PetscStrcmp(ext,"pvtu",&isvtu);CHKERRQ(ierr);
+    if (isvtu) ext[-1] = 0;
+  }
+  ierr = PetscSNPrintf(piece,sizeof(piece),"%s-%d.vtu",base,(int)rank);CHKERRQ(ierr);
+
+  /* piece file */
+  {
+    FILE     *fp;
+    size_t   offset = 0, hdr = sizeof(unsigned long long);
+    ierr = PetscFOpen(PETSC_COMM_SELF,piece,"wb",&fp);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "<?xml version=\"1.0\"?>\n"
+                        "<VTKFile type=\"UnstructuredGrid\" version=\"2.2\" "
+                        "byte_order=\"%s\" header_type=\"UInt64\">\n"
+                        " <UnstructuredGrid>\n"
+                        "  <Piece NumberOfPoints=\"%D\" NumberOfCells=\"%D\">\n",
+#if defined(PETSC_WORDS_BIGENDIAN)
+                        "BigEndian",
+#else
+                        "LittleEndian",
+#endif
+                        npts,nel);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "   <PointData>\n"
+                        "    <DataArray type=\"Float64\" Name=\"%s\" NumberOfComponents=\"%D\" "
+                        "format=\"appended\" offset=\"%llu\"/>\n"
+                        "   </PointData>\n",
+                        vecname,dof,(unsigned long long)offset);CHKERRQ(ierr);
+    offset += hdr + sizeof(double)*(size_t)npts*dof;
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "   <Points>\n"
+                        "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" "
+                        "format=\"appended\" offset=\"%llu\"/>\n"
+                        "   </Points>\n",
+                        (unsigned long long)offset);CHKERRQ(ierr);
+    offset += hdr + sizeof(double)*(size_t)npts*3;
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "   <Cells>\n"
+                        "    <DataArray type=\"Int64\" Name=\"connectivity\" "
+                        "format=\"appended\" offset=\"%llu\"/>\n",
+                        (unsigned long long)offset);CHKERRQ(ierr);
+    offset += hdr + sizeof(long long)*(size_t)npts;
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "    <DataArray type=\"Int64\" Name=\"offsets\" "
+                        "format=\"appended\" offset=\"%llu\"/>\n",
+                        (unsigned long long)offset);CHKERRQ(ierr);
+    offset += hdr + sizeof(long long)*(size_t)nel;
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "    <DataArray type=\"UInt8\" Name=\"types\" "
+                        "format=\"appended\" offset=\"%llu\"/>\n"
+                        "   </Cells>\n"
+                        "  </Piece>\n"
+                        " </UnstructuredGrid>\n"
+                        " <AppendedData encoding=\"raw\">\n_",
+                        (unsigned long long)offset);CHKERRQ(ierr);
+    ierr = IGA_VTKWriteBlock(fp,val, sizeof(double),(size_t)npts*dof);CHKERRQ(ierr);
+    ierr = IGA_VTKWriteBlock(fp,xyz, sizeof(double),(size_t)npts*3);CHKERRQ(ierr);
+    ierr = IGA_VTKWriteBlock(fp,conn,sizeof(long long),(size_t)npts);CHKERRQ(ierr);
+    ierr = IGA_VTKWriteBlock(fp,offs,sizeof(long long),(size_t)nel);CHKERRQ(ierr);
+    ierr = IGA_VTKWriteBlock(fp,type,sizeof(unsigned char),(size_t)nel);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"\n </AppendedData>\n</VTKFile>\n");CHKERRQ(ierr);
+    ierr = PetscFClose(PETSC_COMM_SELF,fp);CHKERRQ(ierr);
+  }
+
+  /* parallel file */
+  if (!rank) {
+    FILE        *fp;
+    const char  *pname = NULL;
+    char        pvtu[PETSC_MAX_PATH_LEN];
+    PetscMPIInt r;
+    ierr = PetscSNPrintf(pvtu,sizeof(pvtu),"%s.pvtu",base);CHKERRQ(ierr);
+    ierr = PetscStrrchr(base,'/',(char**)&pname);CHKERRQ(ierr);
+    ierr = PetscFOpen(PETSC_COMM_SELF,pvtu,"w",&fp);CHKERRQ(ierr);
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp,
+                        "<?xml version=\"1.0\"?>\n"
+                        "<VTKFile type=\"PUnstructuredGrid\" version=\"2.2\">\n"
+                        " <PUnstructuredGrid GhostLevel=\"0\">\n"
+                        "  <PPointData>\n"
+                        "   <PDataArray type=\"Float64\" Name=\"%s\" NumberOfComponents=\"%D\"/>\n"
+                        "  </PPointData>\n"
+                        "  <PPoints>\n"
+                        "   <PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n"
+                        "  </PPoints>\n",
+                        vecname,dof);CHKERRQ(ierr);
+    for (r=0; r<size; r++) {
+      ierr = PetscFPrintf(PETSC_COMM_SELF,fp,"  <Piece Source=\"%s-%d.vtu\"/>\n",pname,(int)r);CHKERRQ(ierr);
+    }
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fp," </PUnstructuredGrid>\n</VTKFile>\n");CHKERRQ(ierr);
+    ierr = PetscFClose(PETSC_COMM_SELF,fp);CHKERRQ(ierr);
+  }
+
+  for (i=0; i<dim; i++) {ierr = PetscFree(B[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(perm);CHKERRQ(ierr);
+  ierr = PetscFree(xyz);CHKERRQ(ierr);
+  ierr = PetscFree(val);CHKERRQ(ierr);
+  ierr = PetscFree(conn);CHKERRQ(ierr);
+  ierr = PetscFree(offs);CHKERRQ(ierr);
+  ierr = PetscFree(type);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -14,6 +14,7 @@ typedef struct {
   PetscReal shift_A;
   Vec       vec_sol_X;
   Vec       vec_sol_V;
+  Vec       vec_sol_A;
   Vec       X0,Xa,X1;
   Vec       V0,Va,V1;
   Vec       A0,Aa,A1;
@@ -110,7 +111,11 @@ static PetscErrorCode TSStep_Alpha2(TS ts)
   PetscFunctionBegin;
 
   if (ts->steps == 0) {
-    ierr = VecSet(th->A0,0.0);CHKERRQ(ierr);
+    if (th->vec_sol_A) {
+      ierr = VecCopy(th->vec_sol_A,th->A0);CHKERRQ(ierr);
+    } else {
+      ierr = VecSet(th->A0,0.0);CHKERRQ(ierr);
+    }
   } else {
     ierr = VecCopy(th->A1,th->A0);CHKERRQ(ierr);
   }
@@ -151,6 +156,7 @@ static PetscErrorCode TSStep_Alpha2(TS ts)
 
   ierr = VecCopy(th->X1,th->vec_sol_X);CHKERRQ(ierr);
   ierr = VecCopy(th->V1,th->vec_sol_V);CHKERRQ(ierr);
+  if (th->vec_sol_A) {ierr = VecCopy(th->A1,th->vec_sol_A);CHKERRQ(ierr);}
   ts->ptime += ts->time_step;
   ts->time_step = next_time_step;
   ts->steps++;
@@ -232,6 +238,7 @@ static PetscErrorCode TSReset_Alpha2(TS ts)
   ierr = VecDestroy(&th->A1);CHKERRQ(ierr);
   ierr = VecDestroy(&th->vec_sol_X);CHKERRQ(ierr);
   ierr = VecDestroy(&th->vec_sol_V);CHKERRQ(ierr);
+  ierr = VecDestroy(&th->vec_sol_A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -255,6 +262,8 @@ static PetscErrorCode TSDestroy_Alpha2(TS ts)
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetRadius_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetParams_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2GetParams_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetAcceleration_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2GetAcceleration_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -490,6 +499,40 @@ PetscErrorCode TSAlpha2GetParams_Alpha2(TS ts,PetscReal *alpha_m,PetscReal *alph
   PetscFunctionReturn(0);
 }
 
+#undef __FUNCT__
+#define __FUNCT__ "TSAlpha2SetAcceleration_Alpha2"
+PetscErrorCode TSAlpha2SetAcceleration_Alpha2(TS ts,Vec A)
+{
+  TS_Alpha2      *th = (TS_Alpha2*)ts->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+  ierr = VecDestroy(&th->vec_sol_A);CHKERRQ(ierr);
+  th->vec_sol_A = A;
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "TSAlpha2GetAcceleration_Alpha2"
+PetscErrorCode TSAlpha2GetAcceleration_Alpha2(TS ts,Vec *A)
+{
+  TS_Alpha2      *th = (TS_Alpha2*)ts->data;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  if (!th->vec_sol_A) {
+    Vec X = th->vec_sol_X ? th->vec_sol_X : ts->vec_sol;
+    if (!X) SETERRQ(((PetscObject)ts)->comm,PETSC_ERR_ARG_WRONGSTATE,"Must call TSSetSolution2() first");
+    ierr = VecDuplicate(X,&th->vec_sol_A);CHKERRQ(ierr);
+    if (ts->steps > 0 && th->A1) {
+      ierr = VecCopy(th->A1,th->vec_sol_A);CHKERRQ(ierr);
+    } else {
+      ierr = VecSet(th->vec_sol_A,0.0);CHKERRQ(ierr);
+    }
+  }
+  *A = th->vec_sol_A;
+  PetscFunctionReturn(0);
+}
+
 EXTERN_C_END
 
 /* ------------------------------------------------------------ */
@@ -548,6 +591,8 @@ PetscErrorCode TSCreate_Alpha2(TS ts)
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetRadius_C",TSAlpha2SetRadius_Alpha2);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetParams_C",TSAlpha2SetParams_Alpha2);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2GetParams_C",TSAlpha2GetParams_Alpha2);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2SetAcceleration_C",TSAlpha2SetAcceleration_Alpha2);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSAlpha2GetAcceleration_C",TSAlpha2GetAcceleration_Alpha2);CHKERRQ(ierr);
 
 #if PETSC_VERSION_LE(3,3,0)
   if (ts->exact_final_time == PETSC_DECIDE) ts->exact_final_time = PETSC_FALSE;
@@ -856,3 +901,62 @@ PetscErrorCode TSAlpha2GetParams(TS ts,PetscReal *alpha_m,PetscReal *alpha_f,Pet
   ierr = PetscUseMethod(ts,"TSAlpha2GetParams_C",(TS,PetscReal*,PetscReal*,PetscReal*,PetscReal*),(ts,alpha_m,alpha_f,gamma,beta));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+#undef __FUNCT__
+#define __FUNCT__ "TSAlpha2SetAcceleration"
+/*@
+  TSAlpha2SetAcceleration - sets the vector holding the second time
+  derivative of the solution
+
+  Logically Collective on TS
+
+  The vector provides the initial acceleration used in the first step
+  (zero if never set) and is updated after every accepted step, so
+  that together with TSSetSolution2() it captures the complete state
+  of the method for exact restarts.
+
+  Input Parameter:
++  ts - timestepping context
+-  A - the acceleration vector
+
+  Level: intermediate
+
+.seealso: TSAlpha2GetAcceleration(), TSSetSolution2()
+@*/
+PetscErrorCode TSAlpha2SetAcceleration(TS ts,Vec A)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidHeaderSpecific(A,VEC_CLASSID,2);
+  ierr = PetscTryMethod(ts,"TSAlpha2SetAcceleration_C",(TS,Vec),(ts,A));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "TSAlpha2GetAcceleration"
+/*@
+  TSAlpha2GetAcceleration - gets the vector holding the second time
+  derivative of the solution
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  A - the acceleration vector
+
+  Level: intermediate
+
+.seealso: TSAlpha2SetAcceleration(), TSGetSolution2()
+@*/
+PetscErrorCode TSAlpha2GetAcceleration(TS ts,Vec *A)
+{
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(A,2);
+  ierr = PetscUseMethod(ts,"TSAlpha2GetAcceleration_C",(TS,Vec*),(ts,A));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
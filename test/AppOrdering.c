@@ -0,0 +1,129 @@
+#include "petiga.h"
+#include "../src/petigagrid.h"
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckOwned"
+/* owned nodes in PETSc order map to their lexicographic grid index */
+static PetscErrorCode CheckOwned(MPI_Comm comm,AO ao,const PetscInt sizes[3],
+                                 const PetscInt start[3],const PetscInt width[3])
+{
+  PetscInt       i,j,k,n = width[0]*width[1]*width[2],rstart,pos = 0;
+  PetscInt       *petsc,*app,*work;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MPI_Scan(&n,&rstart,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  rstart -= n;
+  ierr = PetscMalloc1(n,&petsc);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&app);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&work);CHKERRQ(ierr);
+  for (k=start[2]; k<start[2]+width[2]; k++)
+    for (j=start[1]; j<start[1]+width[1]; j++)
+      for (i=start[0]; i<start[0]+width[0]; i++, pos++) {
+        petsc[pos] = rstart + pos;
+        app[pos]   = i + sizes[0]*(j + sizes[1]*k);
+      }
+  ierr = PetscMemcpy(work,petsc,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = AOPetscToApplication(ao,n,work);CHKERRQ(ierr);
+  for (i=0; i<n; i++) if (work[i] != app[i])
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"PETSc %D -> application %D, expected %D",petsc[i],work[i],app[i]);
+  ierr = PetscMemcpy(work,app,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = AOApplicationToPetsc(ao,n,work);CHKERRQ(ierr);
+  for (i=0; i<n; i++) if (work[i] != petsc[i])
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Application %D -> PETSc %D, expected %D",app[i],work[i],petsc[i]);
+  ierr = PetscFree(petsc);CHKERRQ(ierr);
+  ierr = PetscFree(app);CHKERRQ(ierr);
+  ierr = PetscFree(work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckSame"
+/* both orderings agree on every index, in both directions */
+static PetscErrorCode CheckSame(MPI_Comm comm,AO ao1,AO ao2,PetscInt N)
+{
+  PetscMPIInt    rank,size;
+  PetscInt       a,n = 0,*idx,*idx1,*idx2;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscMalloc1(N/size+1,&idx);CHKERRQ(ierr);
+  ierr = PetscMalloc1(N/size+1,&idx1);CHKERRQ(ierr);
+  ierr = PetscMalloc1(N/size+1,&idx2);CHKERRQ(ierr);
+  for (a=N-1-rank; a>=0; a-=size) idx[n++] = a; /* strided, off-process */
+  ierr = PetscMemcpy(idx1,idx,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscMemcpy(idx2,idx,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = AOApplicationToPetsc(ao1,n,idx1);CHKERRQ(ierr);
+  ierr = AOApplicationToPetsc(ao2,n,idx2);CHKERRQ(ierr);
+  for (a=0; a<n; a++) if (idx1[a] != idx2[a])
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Application %D -> PETSc %D, expected %D",idx[a],idx1[a],idx2[a]);
+  ierr = PetscMemcpy(idx1,idx,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscMemcpy(idx2,idx,n*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = AOPetscToApplication(ao1,n,idx1);CHKERRQ(ierr);
+  ierr = AOPetscToApplication(ao2,n,idx2);CHKERRQ(ierr);
+  for (a=0; a<n; a++) if (idx1[a] != idx2[a])
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"PETSc %D -> application %D, expected %D",idx[a],idx1[a],idx2[a]);
+  ierr = PetscFree(idx);CHKERRQ(ierr);
+  ierr = PetscFree(idx1);CHKERRQ(ierr);
+  ierr = PetscFree(idx2);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  IGA            iga;
+  AO             ao,aoref;
+  IGA_Grid       grid;
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size;
+  PetscInt       i,N = 1,napp,*iapp;
+  PetscBool      analytic;
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+  comm = PETSC_COMM_WORLD;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+
+  /* analytic ordering of a Cartesian partition vs AOMEMORYSCALABLE */
+  ierr = IGACreate(comm,&iga);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,1);CHKERRQ(ierr);
+  ierr = IGASetFromOptions(iga);CHKERRQ(ierr);
+  if (iga->dim < 1) {ierr = IGASetDim(iga,2);CHKERRQ(ierr);}
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+  ierr = IGAGetAO(iga,&ao);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ao,"iga",&analytic);CHKERRQ(ierr);
+  if (!analytic) SETERRQ(comm,PETSC_ERR_PLIB,"Expected the analytic ordering for a Cartesian partition");
+  ierr = IGA_Grid_Create(comm,&grid);CHKERRQ(ierr);
+  ierr = IGA_Grid_Init(grid,iga->dim,1,iga->node_sizes,
+                       iga->node_lstart,iga->node_lwidth,
+                       iga->node_lstart,iga->node_lwidth);CHKERRQ(ierr);
+  ierr = IGA_Grid_LocalIndices(grid,1,&napp,&iapp);CHKERRQ(ierr);
+  ierr = AOCreateMemoryScalable(comm,napp,iapp,NULL,&aoref);CHKERRQ(ierr);
+  ierr = PetscFree(iapp);CHKERRQ(ierr);
+  ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
+  for (i=0; i<3; i++) N *= iga->node_sizes[i];
+  ierr = CheckSame(comm,ao,aoref,N);CHKERRQ(ierr);
+  ierr = CheckOwned(comm,ao,iga->node_sizes,iga->node_lstart,iga->node_lwidth);CHKERRQ(ierr);
+  ierr = AODestroy(&aoref);CHKERRQ(ierr);
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+
+  /* a non-Cartesian partition falls back to AOMEMORYSCALABLE */
+  if (size == 3) {
+    /* rank 0 owns the bottom half, ranks 1 and 2 split the top half */
+    PetscInt sizes[3] = {5,4,1};
+    PetscInt start[3][3] = {{0,0,0},{0,2,0},{2,2,0}};
+    PetscInt width[3][3] = {{5,2,1},{2,2,1},{3,2,1}};
+    ierr = IGA_Grid_Create(comm,&grid);CHKERRQ(ierr);
+    ierr = IGA_Grid_Init(grid,2,1,sizes,start[rank],width[rank],start[rank],width[rank]);CHKERRQ(ierr);
+    ierr = IGA_Grid_GetAO(grid,&ao);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)ao,"iga",&analytic);CHKERRQ(ierr);
+    if (analytic) SETERRQ(comm,PETSC_ERR_PLIB,"Expected the fallback ordering for a non-Cartesian partition");
+    ierr = CheckOwned(comm,ao,sizes,start[rank],width[rank]);CHKERRQ(ierr);
+    ierr = IGA_Grid_Destroy(&grid);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
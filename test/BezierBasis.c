@@ -0,0 +1,134 @@
+#include "petiga.h"
+
+#define MAXP 8
+#define MAXE 64
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckBezier"
+/* Bezier extraction against the de Boor tables of IGABasisInitQuadrature() */
+static PetscErrorCode CheckBezier(const char name[],IGAAxis axis,PetscInt q,PetscInt d,PetscReal tol,PetscInt maxop)
+{
+  IGARule        rule;
+  IGABasis       B0,B1;
+  PetscInt       e,i,k,nen,ndr,nqp;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = IGARuleCreate(&rule);CHKERRQ(ierr);
+  ierr = IGARuleInit(rule,q);CHKERRQ(ierr);
+  ierr = IGABasisCreate(&B0);CHKERRQ(ierr);
+  ierr = IGABasisCreate(&B1);CHKERRQ(ierr);
+  ierr = IGABasisInitQuadrature(B0,axis,rule,d);CHKERRQ(ierr);
+  ierr = IGABasisInitBezier(B1,axis,rule,d);CHKERRQ(ierr);
+  ierr = IGARuleDestroy(&rule);CHKERRQ(ierr);
+
+  if (B0->nel != B1->nel || B0->nqp != B1->nqp || B0->nen != B1->nen)
+    SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s: table sizes differ",name);
+  if (maxop > 0 && B1->nop > maxop)
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s: %D extraction operators, expected at most %D",name,B1->nop,maxop);
+  nen = B0->nen; ndr = d+1; nqp = B0->nqp;
+  for (e=0; e<B0->nel; e++) {
+    const PetscReal *N0 = IGABasisGetValues(B0,e);
+    const PetscReal *N1 = IGABasisGetValues(B1,e);
+    if (B0->offset[e] != B1->offset[e] || B0->count[e] != B1->count[e])
+      SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s: element %D has different offset or count",name,e);
+    for (i=0; i<nqp; i++)
+      if (PetscAbsReal(B0->point[e*nqp+i]-B1->point[e*nqp+i]) > tol)
+        SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s: element %D has different points",name,e);
+    for (k=0; k<ndr; k++) {
+      PetscReal scale = 0, error = 0;
+      for (i=0; i<nqp*nen; i++) {
+        scale = PetscMax(scale,PetscAbsReal(N0[i*ndr+k]));
+        error = PetscMax(error,PetscAbsReal(N0[i*ndr+k]-N1[i*ndr+k]));
+      }
+      if (error > tol*PetscMax(scale,1))
+        SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s: element %D, derivative %D off by %g (scale %g)",
+                 name,e,k,(double)error,(double)scale);
+    }
+  }
+  ierr = IGABasisDestroy(&B0);CHKERRQ(ierr);
+  ierr = IGABasisDestroy(&B1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "InitKnots"
+/* open knot vector from the element lengths h[nel] and interior multiplicities s[nel-1] */
+static PetscErrorCode InitKnots(IGAAxis axis,PetscInt p,PetscInt nel,const PetscReal h[],const PetscInt s[])
+{
+  PetscReal      U[(MAXE+1)*MAXP+2],u = 0,L = 0;
+  PetscInt       i,j,m = 0;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  for (i=0; i<nel; i++) L += h[i];
+  for (j=0; j<=p; j++) U[m++] = 0;
+  for (i=0; i<nel-1; i++) {
+    u += h[i];
+    for (j=0; j<s[i]; j++) U[m++] = u/L;
+  }
+  for (j=0; j<=p; j++) U[m++] = 1;
+  ierr = IGAAxisInit(axis,p,m-1,U);CHKERRQ(ierr);
+  ierr = IGAAxisSetUp(axis);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  PetscInt       i,p,pmax = 8,d = 3,nel = 20,trial,ntrials = 4;
+  PetscInt       s[MAXE];
+  PetscReal      h[MAXE],tol = 1e-11;
+  PetscRandom    rnd;
+  IGAAxis        axis;
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","BezierBasis Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-p_max","maximum polynomial degree",__FILE__,pmax,&pmax,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-d","last derivative order",__FILE__,d,&d,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-N","number of elements",__FILE__,nel,&nel,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-trials","random knot vectors per degree",__FILE__,ntrials,&ntrials,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tol","relative tolerance",__FILE__,tol,&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (pmax < 1 || pmax > MAXP) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"p_max must be in [1,%d]",MAXP);
+  if (nel < 2 || nel > MAXE) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"N must be in [2,%d]",MAXE);
+  if (d < 0) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"d must be nonnegative, got %D",d);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rnd);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rnd);CHKERRQ(ierr);
+  ierr = IGAAxisCreate(&axis);CHKERRQ(ierr);
+  for (p=1; p<=pmax; p++) {
+    /* random lengths and multiplicities */
+    for (trial=0; trial<ntrials; trial++) {
+      for (i=0; i<nel; i++) {
+        PetscReal r;
+        ierr = PetscRandomGetValueReal(rnd,&r);CHKERRQ(ierr);
+        h[i] = (PetscReal)0.05 + r;
+        if (i == nel-1) continue;
+        ierr = PetscRandomGetValueReal(rnd,&r);CHKERRQ(ierr);
+        s[i] = (r < 0.6) ? 1 : PetscMin(p,1 + (PetscInt)(r*p));
+      }
+      ierr = InitKnots(axis,p,nel,h,s);CHKERRQ(ierr);
+      ierr = CheckBezier("random",axis,p+1,d,tol,0);CHKERRQ(ierr);
+      ierr = CheckBezier("random",axis,p+3,d,tol,0);CHKERRQ(ierr);
+    }
+    for (i=0; i<nel-1; i++) s[i] = 1;
+    /* graded mesh, neighbor operators nearly equal but never the same */
+    for (h[0]=1, i=1; i<nel; i++) h[i] = h[i-1]*(1 + (PetscReal)1e-6);
+    ierr = InitKnots(axis,p,nel,h,s);CHKERRQ(ierr);
+    ierr = CheckBezier("graded",axis,p+1,d,tol,0);CHKERRQ(ierr);
+    /* lengths repeating with period 3, interior operators are shared */
+    for (i=0; i<nel; i++) h[i] = (PetscReal)(1 + i%3);
+    ierr = InitKnots(axis,p,nel,h,s);CHKERRQ(ierr);
+    ierr = CheckBezier("periodic",axis,p+1,d,tol,2*p+3);CHKERRQ(ierr);
+    /* uniform mesh */
+    for (i=0; i<nel; i++) h[i] = 1;
+    ierr = InitKnots(axis,p,nel,h,s);CHKERRQ(ierr);
+    ierr = CheckBezier("uniform",axis,p+1,d,tol,2*p+1);CHKERRQ(ierr);
+  }
+  ierr = IGAAxisDestroy(&axis);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rnd);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
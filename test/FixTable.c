@@ -86,6 +86,157 @@ PetscErrorCode Error(IGAPoint p,const PetscScalar *U,PetscInt n,PetscScalar *S,v
   return 0;
 }
 
+/* minimal JSON reader for the -check_trace test, events are the
+   objects of the "traceEvents" array (nesting depth 2) */
+
+typedef struct {
+  PetscMPIInt size;
+  PetscInt    *procs; /* [size] process_name records of each rank */
+  PetscInt    *open;  /* [size][2] open IGAComputeSystem/MatAssembly */
+  PetscInt    *count; /* [size][2] IGAComputeSystem/MatAssembly begins */
+  PetscBool   bad;    /* pid out of range or unmatched end */
+} TraceCheck;
+
+static const char *TracePhases[2] = {"IGAComputeSystem","MatAssembly"};
+
+static void TraceAddEvent(TraceCheck *tc,const char name[],char ph,double pid)
+{
+  PetscInt k,r = (PetscInt)pid;
+  if (pid != (double)r || r < 0 || r >= tc->size) {tc->bad = PETSC_TRUE; return;}
+  if (ph == 'M' && !strcmp(name,"process_name")) tc->procs[r]++;
+  for (k=0; k<2; k++) {
+    if (strcmp(name,TracePhases[k])) continue;
+    if (ph == 'B') {tc->open[2*r+k]++; tc->count[2*r+k]++;}
+    if (ph == 'E') {if (tc->open[2*r+k]) tc->open[2*r+k]--; else tc->bad = PETSC_TRUE;}
+  }
+}
+
+static const char *JSONSpace(const char *s)
+{
+  while (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r') s++;
+  return s;
+}
+
+static const char *JSONString(const char *s,char out[],size_t len)
+{
+  size_t n = 0;
+  if (*s++ != '"') return NULL;
+  while (*s != '"') {
+    if ((unsigned char)*s < 0x20) return NULL; /* also the end of text */
+    if (*s == '\\' && !*++s) return NULL;
+    if (out && n+1 < len) out[n++] = *s;
+    s++;
+  }
+  if (out) out[n] = 0;
+  return s+1;
+}
+
+static const char *JSONNumber(const char *s,double *v)
+{
+  char *end;
+  if (*s != '-' && (*s < '0' || *s > '9')) return NULL;
+  *v = strtod(s,&end);
+  return end;
+}
+
+static const char *JSONValue(const char *s,PetscInt depth,TraceCheck *tc);
+
+static const char *JSONObject(const char *s,PetscInt depth,TraceCheck *tc)
+{
+  char   key[32],name[64] = "",ph[2] = "";
+  double pid = -1;
+  s = JSONSpace(s+1);
+  if (*s != '}') for (;;) {
+    if (!(s = JSONString(s,key,sizeof(key)))) return NULL;
+    s = JSONSpace(s);
+    if (*s++ != ':') return NULL;
+    s = JSONSpace(s);
+    if      (depth == 2 && !strcmp(key,"name")) s = JSONString(s,name,sizeof(name));
+    else if (depth == 2 && !strcmp(key,"ph"))   s = JSONString(s,ph,sizeof(ph));
+    else if (depth == 2 && !strcmp(key,"pid"))  s = JSONNumber(s,&pid);
+    else s = JSONValue(s,depth+1,tc);
+    if (!s) return NULL;
+    s = JSONSpace(s);
+    if (*s == '}') break;
+    if (*s++ != ',') return NULL;
+    s = JSONSpace(s);
+  }
+  if (depth == 2) TraceAddEvent(tc,name,ph[0],pid);
+  return s+1;
+}
+
+static const char *JSONArray(const char *s,PetscInt depth,TraceCheck *tc)
+{
+  s = JSONSpace(s+1);
+  if (*s != ']') for (;;) {
+    if (!(s = JSONValue(s,depth+1,tc))) return NULL;
+    s = JSONSpace(s);
+    if (*s == ']') break;
+    if (*s++ != ',') return NULL;
+    s = JSONSpace(s);
+  }
+  return s+1;
+}
+
+static const char *JSONValue(const char *s,PetscInt depth,TraceCheck *tc)
+{
+  double v;
+  switch (*s) {
+  case '{': return JSONObject(s,depth,tc);
+  case '[': return JSONArray(s,depth,tc);
+  case '"': return JSONString(s,NULL,0);
+  case 't': return strncmp(s,"true",4)  ? NULL : s+4;
+  case 'f': return strncmp(s,"false",5) ? NULL : s+5;
+  case 'n': return strncmp(s,"null",4)  ? NULL : s+4;
+  default : return JSONNumber(s,&v);
+  }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckTrace"
+/* the trace parses as JSON, has one process per rank, and the begin and
+   end events of IGAComputeSystem and MatAssembly balance on every rank */
+static PetscErrorCode CheckTrace(const char filename[],PetscMPIInt size,PetscInt nsys)
+{
+  TraceCheck     tc;
+  FILE           *fp;
+  long           len;
+  char           *text;
+  const char     *end;
+  PetscInt       r,k;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  fp = fopen(filename,"rb");
+  if (!fp) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Cannot open trace file %s",filename);
+  fseek(fp,0,SEEK_END); len = ftell(fp); fseek(fp,0,SEEK_SET);
+  ierr = PetscMalloc1((size_t)len+1,&text);CHKERRQ(ierr);
+  if (fread(text,1,(size_t)len,fp) != (size_t)len) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Cannot read trace file %s",filename);
+  text[len] = 0;
+  fclose(fp);
+
+  tc.size = size;
+  tc.bad  = PETSC_FALSE;
+  ierr = PetscCalloc1(size,&tc.procs);CHKERRQ(ierr);
+  ierr = PetscCalloc1(2*size,&tc.open);CHKERRQ(ierr);
+  ierr = PetscCalloc1(2*size,&tc.count);CHKERRQ(ierr);
+  end = JSONValue(JSONSpace(text),0,&tc);
+  if (!end || *JSONSpace(end)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Trace file %s is not valid JSON near offset %ld",
+                                        filename,end ? (long)(end-text) : -1L);
+  if (tc.bad) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Trace has a pid out of range or an end event without begin");
+  for (r=0; r<size; r++) {
+    if (tc.procs[r] != 1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %D has %D process records",r,tc.procs[r]);
+    for (k=0; k<2; k++) {
+      if (tc.open[2*r+k]) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %D has %D unmatched %s begin events",r,tc.open[2*r+k],TracePhases[k]);
+      if (tc.count[2*r+k] != nsys) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rank %D has %D %s events, expected %D",r,tc.count[2*r+k],TracePhases[k],nsys);
+    }
+  }
+  ierr = PetscFree(tc.procs);CHKERRQ(ierr);
+  ierr = PetscFree(tc.open);CHKERRQ(ierr);
+  ierr = PetscFree(tc.count);CHKERRQ(ierr);
+  ierr = PetscFree(text);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #undef __FUNCT__
 #define __FUNCT__ "main"
 int main(int argc, char *argv[]) {
@@ -97,9 +248,14 @@ int main(int argc, char *argv[]) {
   PetscBool check_error = PETSC_FALSE;
   PetscReal error_tol   = 1e-4;
   PetscBool draw = PETSC_FALSE;
+  PetscBool check_profile = PETSC_FALSE;
+  PetscBool check_trace = PETSC_FALSE;
+  char      trace[PETSC_MAX_PATH_LEN] = "fixtable-trace.json";
   ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","FixTable Options","IGA");CHKERRQ(ierr);
   ierr = PetscOptionsBool("-print_error","Prints the L2 error of the solution",__FILE__,print_error,&print_error,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-check_error","Checks the L2 error of the solution",__FILE__,error_tol,&error_tol,&check_error);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-check_profile","Checks the assembly profile counts",__FILE__,check_profile,&check_profile,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsString("-check_trace","Dumps the -iga_trace timeline and checks it",__FILE__,trace,trace,sizeof(trace),&check_trace);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-draw","If dim <= 2, then draw the solution to the screen",__FILE__,draw,&draw,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
@@ -150,6 +306,32 @@ int main(int argc, char *argv[]) {
   }
   ierr = IGASetFixTable(iga,NULL);CHKERRQ(ierr); /* Clear vector to read BCs from */
 
+  if (check_profile) { /* two system assemblies so far */
+    PetscInt i,nel = 1,nqp = 1,nsys = 2,count[IGA_PROFILE_PHASES];
+    for (i=0; i<dim; i++) nel *= iga->elem_width[i];
+    for (i=0; i<dim; i++) nqp *= iga->rule[i]->nqp;
+    ierr = IGAGetAssemblyProfile(iga,NULL,count);CHKERRQ(ierr);
+    if (count[IGA_PROFILE_CLOSURE] != nsys*nel)
+      SETERRQ2(PETSC_COMM_SELF,1,"Closure count %D != %D\n",count[IGA_PROFILE_CLOSURE],nsys*nel);
+    if (count[IGA_PROFILE_KERNEL] != nsys*nel*nqp)
+      SETERRQ2(PETSC_COMM_SELF,1,"Kernel count %D != %D\n",count[IGA_PROFILE_KERNEL],nsys*nel*nqp);
+    if (count[IGA_PROFILE_SETVALUES] != 2*nsys*nel)
+      SETERRQ2(PETSC_COMM_SELF,1,"SetValues count %D != %D\n",count[IGA_PROFILE_SETVALUES],2*nsys*nel);
+    if (count[IGA_PROFILE_ASSEMBLY] != nsys)
+      SETERRQ2(PETSC_COMM_SELF,1,"Assembly count %D != %D\n",count[IGA_PROFILE_ASSEMBLY],nsys);
+  }
+
+  if (check_trace) { /* two system assemblies so far */
+    PetscMPIInt rank,size;
+    PetscErrorCode terr = 0;
+    ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+    ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+    ierr = IGATraceDump(PETSC_COMM_WORLD,trace);CHKERRQ(ierr);
+    if (!rank) terr = CheckTrace(trace,size,2);
+    ierr = MPI_Bcast(&terr,1,MPI_INT,0,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    if (terr) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Trace file %s failed the check",trace);
+  }
+
   PetscScalar error = 0;
   ierr = IGAComputeScalar(iga,x,1,&error,Error,NULL);CHKERRQ(ierr);
   error = PetscSqrtReal(PetscRealPart(error));
@@ -1,4 +1,5 @@
 #include "petiga.h"
+#include "petigaprobe.h"
 
 /*
 #define hypot(x,y) sqrt((x)*(x)+(y)*(y))
@@ -437,6 +438,91 @@ PetscErrorCode Error(IGAPoint p,const PetscScalar *U,PetscInt n,PetscScalar *S,v
 }
 
 
+/* x = M u, a sheared and stretched box; linear maps are exact at the Greville points */
+static PetscReal M[3][3] = {
+  { 2.0, 0.5, 0.0 },
+  { 0.0, 1.0, 0.25},
+  { 0.0, 0.0, 3.0 },
+};
+
+#undef  __FUNCT__
+#define __FUNCT__ "LocateParallel"
+/* locate points across a distributed geometry, some owned elsewhere, some outside */
+PetscErrorCode LocateParallel(PetscInt dim)
+{
+  MPI_Comm       comm = PETSC_COMM_WORLD;
+  PetscMPIInt    size;
+  IGA            iga;
+  IGAAxis        axis;
+  IGAProbe       prb;
+  PetscInt       i,j,k,npts = 9,ninside = 7,nlocal,nmax,nsum;
+  PetscReal      u[9][3],x[9*3],v[9*3],*X;
+  PetscBool      found[9];
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = IGACreate(comm,&iga);CHKERRQ(ierr);
+  ierr = IGASetDim(iga,dim);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,1);CHKERRQ(ierr);
+  for (i=0; i<dim; i++) {
+    ierr = IGAGetAxis(iga,i,&axis);CHKERRQ(ierr);
+    ierr = IGAAxisSetDegree(axis,2);CHKERRQ(ierr);
+    ierr = IGAAxisInitUniform(axis,6,0.0,1.0,1);CHKERRQ(ierr);
+  }
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+
+  ierr = IGASetGeometryDim(iga,dim);CHKERRQ(ierr);
+  ierr = PetscMalloc(iga->geom_gwidth[0]*iga->geom_gwidth[1]*iga->geom_gwidth[2]*dim*sizeof(PetscReal),&iga->geometryX);CHKERRQ(ierr);
+  X = iga->geometryX;
+  for (k=0; k<iga->geom_gwidth[2]; k++)
+    for (j=0; j<iga->geom_gwidth[1]; j++)
+      for (i=0; i<iga->geom_gwidth[0]; i++) {
+        PetscInt  a,b,c,ijk[3];
+        PetscReal g[3] = {0,0,0};
+        ijk[0] = iga->geom_gstart[0]+i;
+        ijk[1] = iga->geom_gstart[1]+j;
+        ijk[2] = iga->geom_gstart[2]+k;
+        for (a=0; a<dim; a++) { /* Greville abscissae */
+          IGAAxis ax = iga->axis[a];
+          for (b=1; b<=ax->p; b++) g[a] += ax->U[ijk[a]+b];
+          g[a] /= ax->p;
+        }
+        for (a=0; a<dim; a++, X++)
+          for (*X=0, c=0; c<dim; c++) *X += M[a][c]*g[c];
+      }
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+
+  /* interior points away from element (and process) boundaries, then two outside */
+  for (k=0; k<ninside; k++)
+    for (i=0; i<3; i++)
+      u[k][i] = (PetscReal)((k*(i+2)+i)%ninside + 0.37)/(PetscReal)ninside;
+  for (i=0; i<3; i++) {u[7][i] = (i==0) ? -0.2 : 0.5; u[8][i] = (i==dim-1) ? 1.3 : 0.5;}
+  for (k=0; k<npts; k++)
+    for (i=0; i<dim; i++)
+      for (x[i+k*dim]=0, j=0; j<dim; j++) x[i+k*dim] += M[i][j]*u[k][j];
+
+  ierr = IGAProbeCreate(iga,NULL,&prb);CHKERRQ(ierr);
+  /* collective: every rank gets every point, whoever owns it */
+  ierr = IGAProbeLocatePoints(prb,npts,x,v,found);CHKERRQ(ierr);
+  for (k=0; k<npts; k++) {
+    if (k <  ninside && !found[k]) SETERRQ1(PETSC_COMM_SELF,1,"Point %D not found",k);
+    if (k >= ninside &&  found[k]) SETERRQ1(PETSC_COMM_SELF,1,"Point %D outside the domain found",k);
+    if (k < ninside) for (i=0; i<dim; i++) AssertEQUAL(v[i+k*dim],u[k][i]);
+  }
+  /* local: each interior point is found by exactly one rank */
+  ierr = IGAProbeSetCollective(prb,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = IGAProbeLocatePoints(prb,npts,x,v,found);CHKERRQ(ierr);
+  for (nlocal=0, k=0; k<npts; k++) if (found[k]) nlocal++;
+  ierr = MPI_Allreduce(&nlocal,&nsum,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  ierr = MPI_Allreduce(&nlocal,&nmax,1,MPIU_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  if (nsum != ninside) SETERRQ2(comm,1,"Points found %D times, expected %D",nsum,ninside);
+  if (size > 1 && nmax == ninside) SETERRQ(comm,1,"All points owned by one rank, ownership not exercised");
+  ierr = IGAProbeDestroy(&prb);CHKERRQ(ierr);
+
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #undef __FUNCT__
 #define __FUNCT__ "main"
 int main(int argc, char *argv[]) {
@@ -528,9 +614,33 @@ int main(int argc, char *argv[]) {
     ierr = VecDestroy(&x);CHKERRQ(ierr);
     AssertEQUAL(V, PetscRealPart(vol));
   }
+  {
+    IGAProbe  prb;
+    PetscInt  i,k,npts = 4;
+    PetscReal u[4][3] = {{0.5,0.5,0.5},{0.1,0.9,0.25},{0.0,0.0,0.0},{1.0,1.0,1.0}};
+    PetscReal x[4*3],v[4*3];
+    PetscBool found[4];
+    for (k=0; k<npts; k++)
+      for (i=0; i<dim; i++)
+        v[i+k*dim] = u[k][i];
+    ierr = IGAProbeCreate(iga,NULL,&prb);CHKERRQ(ierr);
+    ierr = IGAProbeSetPoints(prb,npts,v);CHKERRQ(ierr);
+    ierr = IGAProbeGeomMapMany(prb,x);CHKERRQ(ierr);
+    ierr = IGAProbeLocatePoints(prb,npts,x,v,found);CHKERRQ(ierr);
+    for (k=0; k<npts; k++) {
+      if (!found[k]) SETERRQ1(PETSC_COMM_SELF,1,"Point %D not found",k);
+      for (i=0; i<dim; i++) AssertEQUAL(v[i+k*dim], u[k][i]);
+    }
+    x[0] = 0.0; x[1] = 0.0; /* inside the hole */
+    ierr = IGAProbeLocatePoints(prb,1,x,v,found);CHKERRQ(ierr);
+    if (found[0]) SETERRQ(PETSC_COMM_SELF,1,"Point outside the domain found");
+    ierr = IGAProbeDestroy(&prb);CHKERRQ(ierr);
+  }
 
   ierr = IGADestroy(&iga);CHKERRQ(ierr);
 
+  ierr = LocateParallel(dim);CHKERRQ(ierr);
+
   ierr = PetscFinalize();CHKERRQ(ierr);
   return 0;
 }
@@ -151,6 +151,27 @@ int main(int argc, char *argv[]) {
                        (double)xmin,(double)xmax);CHKERRQ(ierr);
   }
 
+  if (iga->halo) { /* overlapping halo exchanges are refused */
+    Vec            l;
+    PetscErrorCode overlap,unmatched;
+    ierr = IGACreateVec(iga,&x);CHKERRQ(ierr);
+    ierr = IGACreateLocalVec(iga,&l);CHKERRQ(ierr);
+    ierr = IGAGlobalToLocalBegin(iga,x,l,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = PetscPushErrorHandler(PetscIgnoreErrorHandler,NULL);CHKERRQ(ierr);
+    overlap = IGALocalToGlobalBegin(iga,l,x,ADD_VALUES);
+    ierr = PetscPopErrorHandler();CHKERRQ(ierr);
+    ierr = IGAGlobalToLocalEnd(iga,x,l,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = PetscPushErrorHandler(PetscIgnoreErrorHandler,NULL);CHKERRQ(ierr);
+    unmatched = IGAGlobalToLocalEnd(iga,x,l,INSERT_VALUES);
+    ierr = PetscPopErrorHandler();CHKERRQ(ierr);
+    ierr = IGALocalToGlobalBegin(iga,l,x,ADD_VALUES);CHKERRQ(ierr);
+    ierr = IGALocalToGlobalEnd(iga,l,x,ADD_VALUES);CHKERRQ(ierr);
+    ierr = VecDestroy(&l);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    if (!overlap)   SETERRQ(PETSC_COMM_SELF,1,"Overlapping halo exchanges were not detected");
+    if (!unmatched) SETERRQ(PETSC_COMM_SELF,1,"Halo exchange End without Begin was not detected");
+  }
+
   ierr = IGACreateSNES(iga,&snes);CHKERRQ(ierr);
   ierr = SNESDestroy(&snes);CHKERRQ(ierr);
 
@@ -1,4 +1,167 @@
 #include "petiga.h"
+#if defined(PETSC_HAVE_HDF5)
+#include <petscviewerhdf5.h>
+#endif
+
+/* VTK_LAGRANGE_HEXAHEDRON of order 2, reference coordinates times 2 */
+static const int HexQ2[27][3] = {
+  {0,0,0},{2,0,0},{2,2,0},{0,2,0},{0,0,2},{2,0,2},{2,2,2},{0,2,2}, /* vertices */
+  {1,0,0},{2,1,0},{1,2,0},{0,1,0},{1,0,2},{2,1,2},{1,2,2},{0,1,2}, /* edges {0,1},{1,2},{3,2},{0,3} */
+  {0,0,1},{2,0,1},{2,2,1},{0,2,1},                                 /* edges {0,4},{1,5},{2,6},{3,7} */
+  {0,1,1},{2,1,1},{1,0,1},{1,2,1},{1,1,0},{1,1,2},                 /* faces -i,+i,-j,+j,-k,+k */
+  {1,1,1},                                                         /* interior */
+};
+
+#undef __FUNCT__
+#define __FUNCT__ "CheckVTK"
+/* write two quadratic hexahedra and check the points and cells in the piece file */
+static PetscErrorCode CheckVTK(void)
+{
+  IGA            iga;
+  Vec            vec;
+  PetscMPIInt    rank;
+  char           name[PETSC_MAX_PATH_LEN];
+  FILE           *fp;
+  long           size;
+  char           *buf,*data;
+  double         val[54],xyz[54*3];
+  long long      conn[54],offs[2];
+  unsigned char  type[2];
+  PetscInt       i,e,m,c;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = IGACreate(PETSC_COMM_SELF,&iga);CHKERRQ(ierr);
+  ierr = IGASetDim(iga,3);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,1);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {
+    IGAAxis axis;
+    ierr = IGAGetAxis(iga,i,&axis);CHKERRQ(ierr);
+    ierr = IGAAxisSetDegree(axis,2);CHKERRQ(ierr);
+    ierr = IGAAxisInitUniform(axis,i ? 1 : 2,0.0,1.0,1);CHKERRQ(ierr);
+  }
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&vec);CHKERRQ(ierr);
+  ierr = VecSet(vec,1.0);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"igahex%d.pvtu",(int)rank);CHKERRQ(ierr);
+  ierr = IGAWriteVecVTK(iga,vec,name);CHKERRQ(ierr);
+  ierr = VecDestroy(&vec);CHKERRQ(ierr);
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+
+  ierr = PetscSNPrintf(name,sizeof(name),"igahex%d-0.vtu",(int)rank);CHKERRQ(ierr);
+  fp = fopen(name,"rb");
+  if (!fp) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Cannot open %s",name);
+  fseek(fp,0,SEEK_END); size = ftell(fp); fseek(fp,0,SEEK_SET);
+  ierr = PetscMalloc1(size+1,&buf);CHKERRQ(ierr);
+  if (fread(buf,1,(size_t)size,fp) != (size_t)size) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Cannot read %s",name);
+  fclose(fp); buf[size] = 0;
+  ierr = PetscStrstr(buf,"<AppendedData encoding=\"raw\">",&data);CHKERRQ(ierr);
+  if (!data) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"No appended data");
+  data = strchr(data,'_') + 1;
+#define NextBlock(array) do {                                          \
+    unsigned long long nbytes;                                          \
+    memcpy(&nbytes,data,sizeof(nbytes)); data += sizeof(nbytes);        \
+    if (nbytes != sizeof(array))                                        \
+      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Bad VTK block size"); \
+    memcpy(array,data,sizeof(array)); data += sizeof(array);            \
+  } while (0)
+  NextBlock(val); NextBlock(xyz); NextBlock(conn); NextBlock(offs); NextBlock(type);
+#undef NextBlock
+
+  for (e=0; e<2; e++) {
+    if (offs[e] != 27*(e+1)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad VTK offset %D of cell %D",(PetscInt)offs[e],e);
+    if (type[e] != 72) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad VTK type %D of cell %D",(PetscInt)type[e],e);
+    for (m=0; m<27; m++) {
+      long long pt = conn[27*e+m];
+      double    X[3];
+      X[0] = 0.5*(e + 0.5*HexQ2[m][0]);
+      X[1] = 0.5*HexQ2[m][1];
+      X[2] = 0.5*HexQ2[m][2];
+      for (c=0; c<3; c++)
+        if (fabs(xyz[3*pt+c]-X[c]) > 1e-12)
+          SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad VTK point %D of cell %D, coordinate %D",m,e,c);
+      if (fabs(val[pt]-1.0) > 1e-12)
+        SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad VTK value at point %D of cell %D",m,e);
+    }
+  }
+  ierr = PetscFree(buf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+EXTERN_C_BEGIN
+extern PetscReal IGA_Greville(PetscInt i,PetscInt p,const PetscReal U[]);
+EXTERN_C_END
+
+/* value stored big-endian in n bytes */
+static double BigEndianValue(const unsigned char b[],size_t n)
+{
+  union {float f; double d; unsigned char c[8];} u;
+  int    one = 1;
+  size_t i;
+  for (i=0; i<n; i++) u.c[i] = *(char*)&one ? b[n-1-i] : b[i];
+  return (n == sizeof(float)) ? (double)u.f : u.d;
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "CheckSubset"
+/* read an IGAWriteVecSubset() file of a vector holding dof*g+c at node g, field c */
+static PetscErrorCode CheckSubset(IGA iga,const char filename[])
+{
+  PetscMPIInt    rank;
+  int            fd;
+  PetscInt       header[2],M[3] = {1,1,1},nf,size,field[64],*node[3] = {NULL,NULL,NULL};
+  PetscInt       N[3] = {1,1,1},i,j,k,c,a,m,pos,count;
+  unsigned char  *values;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(((PetscObject)iga)->comm,&rank);CHKERRQ(ierr);
+  if (rank) PetscFunctionReturn(0);
+  ierr = PetscBinaryOpen(filename,FILE_MODE_READ,&fd);CHKERRQ(ierr);
+  ierr = PetscBinaryRead(fd,header,2,PETSC_INT);CHKERRQ(ierr);
+  if (header[0] != IGA_SUBSET_FILE_CLASSID || header[1] != iga->dim)
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Bad subset file header");
+  ierr = PetscBinaryRead(fd,M,iga->dim,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscBinaryRead(fd,&nf,1,PETSC_INT);CHKERRQ(ierr);
+  ierr = PetscBinaryRead(fd,&size,1,PETSC_INT);CHKERRQ(ierr);
+  if (nf < 1 || nf > 64 || (size != 4 && size != 8))
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Bad subset file header");
+  ierr = PetscBinaryRead(fd,field,nf,PETSC_INT);CHKERRQ(ierr);
+  for (i=0; i<iga->dim; i++) { /* nodes from their Greville abscissae */
+    IGAAxis   axis = iga->axis[i];
+    PetscReal tol = 100*PETSC_MACHINE_EPSILON;
+    double    *X;
+    N[i] = iga->node_sizes[i];
+    ierr = PetscMalloc1(M[i],&X);CHKERRQ(ierr);
+    ierr = PetscMalloc1(M[i],&node[i]);CHKERRQ(ierr);
+    ierr = PetscBinaryRead(fd,X,M[i],PETSC_DOUBLE);CHKERRQ(ierr);
+    for (m=0; m<M[i]; m++) {
+      for (a=0; a<N[i]; a++)
+        if (PetscAbsReal(IGA_Greville(a,axis->p,axis->U)-(PetscReal)X[m]) <= tol) break;
+      if (a == N[i]) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad abscissa %D along direction %D",m,i);
+      node[i][m] = a;
+    }
+    ierr = PetscFree(X);CHKERRQ(ierr);
+  }
+  for (i=iga->dim; i<3; i++) {ierr = PetscCalloc1(1,&node[i]);CHKERRQ(ierr);}
+  count = nf*M[0]*M[1]*M[2];
+  ierr = PetscMalloc1(count*size,&values);CHKERRQ(ierr);
+  ierr = PetscBinaryRead(fd,values,count*size,PETSC_CHAR);CHKERRQ(ierr);
+  ierr = PetscBinaryClose(fd);CHKERRQ(ierr);
+  for (pos=0, k=0; k<M[2]; k++)
+    for (j=0; j<M[1]; j++)
+      for (i=0; i<M[0]; i++)
+        for (c=0; c<nf; c++, pos++) {
+          PetscInt g = node[0][i] + N[0]*(node[1][j] + N[1]*node[2][k]);
+          double   v = BigEndianValue(values+pos*size,(size_t)size);
+          if (v != (double)(iga->dof*g + field[c]))
+            SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Bad subset value of field %D at node %D",field[c],g);
+        }
+  ierr = PetscFree(values);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {ierr = PetscFree(node[i]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
 
 #undef __FUNCT__
 #define __FUNCT__ "main"
@@ -69,6 +232,75 @@ int main(int argc, char *argv[]) {
   ierr = IGASetUp(iga1);CHKERRQ(ierr);
   ierr = IGADestroy(&iga1);CHKERRQ(ierr);
 
+  { /* geometry loaded through the memory mapped cache matches the scatter loader */
+    IGA         igag,igam;
+    IGAElement  ex,em;
+    PetscMPIInt rank;
+    PetscBool   cached;
+    PetscInt    a,c,i,j,k,pos,pass,dim,nen,nsd;
+    PetscReal   error = 0;
+    ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+    ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
+    ierr = IGAClone(iga,1,&igag);CHKERRQ(ierr);
+    ierr = IGASetGeometryDim(igag,dim);CHKERRQ(ierr);
+    {
+      PetscInt *start = igag->geom_gstart, *width = igag->geom_gwidth, *sizes = igag->geom_sizes;
+      ierr = PetscMalloc1(width[0]*width[1]*width[2]*dim,&igag->geometryX);CHKERRQ(ierr);
+      ierr = PetscMalloc1(width[0]*width[1]*width[2],&igag->rationalW);CHKERRQ(ierr);
+      for (pos=0, k=start[2]; k<start[2]+width[2]; k++)
+        for (j=start[1]; j<start[1]+width[1]; j++)
+          for (i=start[0]; i<start[0]+width[0]; i++, pos++) {
+            PetscInt g[3];
+            g[0] = (i+sizes[0]) % sizes[0];
+            g[1] = (j+sizes[1]) % sizes[1];
+            g[2] = (k+sizes[2]) % sizes[2];
+            igag->rationalW[pos] = 1 + 0.25*(PetscReal)((g[0]+2*g[1]+3*g[2]) % 5);
+            for (c=0; c<dim; c++)
+              igag->geometryX[c+pos*dim] = (PetscReal)g[c] + (PetscReal)0.1*g[(c+1)%3];
+          }
+      igag->rational = PETSC_TRUE;
+    }
+    ierr = IGAWrite(igag,"igageo.dat");CHKERRQ(ierr);
+    ierr = IGADestroy(&igag);CHKERRQ(ierr);
+    if (!rank) (void)remove("igageo.dat.mmap");
+    ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+
+    ierr = IGACreate(comm,&iga1);CHKERRQ(ierr);
+    ierr = IGARead(iga1,"igageo.dat");CHKERRQ(ierr);
+    ierr = IGASetUp(iga1);CHKERRQ(ierr);
+    for (pass=0; pass<2; pass++) { /* the first pass writes the cache, the second reuses it */
+      ierr = IGACreate(comm,&igam);CHKERRQ(ierr);
+      ierr = IGASetOptionsPrefix(igam,"mmap_");CHKERRQ(ierr);
+      ierr = PetscOptionsSetValue("-mmap_iga_geometry_mmap","1");CHKERRQ(ierr);
+      ierr = IGARead(igam,"igageo.dat");CHKERRQ(ierr);
+      ierr = IGASetUp(igam);CHKERRQ(ierr);
+      ierr = PetscOptionsClearValue("-mmap_iga_geometry_mmap");CHKERRQ(ierr);
+      ierr = PetscTestFile("igageo.dat.mmap",'r',&cached);CHKERRQ(ierr);
+      if (!cached) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Geometry cache igageo.dat.mmap not written");
+      if (iga1->rational != igam->rational)
+        SETERRQ(comm,PETSC_ERR_PLIB,"Rational flag differs between geometry loaders");
+
+      ierr = IGABeginElement(iga1,&ex);CHKERRQ(ierr);
+      ierr = IGABeginElement(igam,&em);CHKERRQ(ierr);
+      while (IGANextElement(iga1,ex)) {
+        if (!IGANextElement(igam,em)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Element count differs");
+        nen = ex->nen; nsd = ex->nsd;
+        for (a=0; a<nen; a++) {
+          error = PetscMax(error,PetscAbsReal(ex->rationalW[a]-em->rationalW[a]));
+          for (c=0; c<nsd; c++)
+            error = PetscMax(error,PetscAbsReal(ex->geometryX[c+a*nsd]-em->geometryX[c+a*nsd]));
+        }
+      }
+      if (IGANextElement(igam,em)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Element count differs");
+      ierr = IGAEndElement(iga1,&ex);CHKERRQ(ierr);
+      ierr = IGAEndElement(igam,&em);CHKERRQ(ierr);
+      if (error > 100*PETSC_MACHINE_EPSILON)
+        SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Mapped geometry differs from scattered geometry by %g",(double)error);
+      ierr = IGADestroy(&igam);CHKERRQ(ierr);
+    }
+    ierr = IGADestroy(&iga1);CHKERRQ(ierr);
+  }
+
   {
     Vec         vec;
     PetscInt    size,bs;
@@ -78,6 +310,8 @@ int main(int argc, char *argv[]) {
     ierr = IGAWriteVec(iga,vec,"igavec.dat");CHKERRQ(ierr);
     ierr = VecSet(vec,0.0);CHKERRQ(ierr);
     ierr = IGAReadVec (iga,vec,"igavec.dat");CHKERRQ(ierr);
+    ierr = IGAWriteVecVTK(iga,vec,"igavec.pvtu");CHKERRQ(ierr);
+    ierr = CheckVTK();CHKERRQ(ierr);
     ierr = VecGetSize(vec,&size);CHKERRQ(ierr);
     ierr = VecSum(vec,&value);CHKERRQ(ierr);
     if ((PetscReal)size != PetscRealPart(value))
@@ -97,6 +331,116 @@ int main(int argc, char *argv[]) {
     ierr = VecDestroy(&vec);CHKERRQ(ierr);
   }
 
+  { /* subset dump read back against the natural ordering */
+    Vec         vec;
+    PetscInt    i,j,k,c,pos = 0,dof,*N = iga->node_sizes,*s = iga->node_lstart,*w = iga->node_lwidth;
+    PetscScalar *v;
+    ierr = IGAGetDof(iga,&dof);CHKERRQ(ierr);
+    ierr = IGACreateVec(iga,&vec);CHKERRQ(ierr);
+    ierr = VecGetArray(vec,&v);CHKERRQ(ierr);
+    for (k=s[2]; k<s[2]+w[2]; k++)
+      for (j=s[1]; j<s[1]+w[1]; j++)
+        for (i=s[0]; i<s[0]+w[0]; i++)
+          for (c=0; c<dof; c++)
+            v[pos++] = (PetscReal)(dof*(i + N[0]*(j + N[1]*k)) + c);
+    ierr = VecRestoreArray(vec,&v);CHKERRQ(ierr);
+    ierr = IGAWriteVecSubset(iga,vec,"igasub.dat");CHKERRQ(ierr);
+    ierr = CheckSubset(iga,"igasub.dat");CHKERRQ(ierr);
+    ierr = VecDestroy(&vec);CHKERRQ(ierr);
+  }
+
+#if defined(PETSC_HAVE_HDF5)
+  { /* HDF5 round trip, of a plain field and of a time series */
+    Vec         vec,load;
+    PetscInt    r,rstart,rend,step;
+    PetscScalar *v;
+    PetscBool   match = PETSC_FALSE;
+    PetscMPIInt rank;
+
+    ierr = IGACreateVec(iga,&vec);CHKERRQ(ierr);
+    ierr = IGACreateVec(iga,&load);CHKERRQ(ierr);
+    ierr = VecGetOwnershipRange(vec,&rstart,&rend);CHKERRQ(ierr);
+    ierr = PetscViewerHDF5Open(comm,"igavec.h5",FILE_MODE_WRITE,&viewer);CHKERRQ(ierr);
+    ierr = IGASave(iga,viewer);CHKERRQ(ierr);
+    ierr = PetscObjectSetName((PetscObject)vec,"u");CHKERRQ(ierr);
+    ierr = VecGetArray(vec,&v);CHKERRQ(ierr);
+    for (r=rstart; r<rend; r++) v[r-rstart] = (PetscReal)r;
+    ierr = VecRestoreArray(vec,&v);CHKERRQ(ierr);
+    ierr = IGASaveVec(iga,vec,viewer);CHKERRQ(ierr);
+    ierr = PetscObjectSetName((PetscObject)vec,"s");CHKERRQ(ierr);
+    for (step=0; step<2; step++) {
+      ierr = VecGetArray(vec,&v);CHKERRQ(ierr);
+      for (r=rstart; r<rend; r++) v[r-rstart] = (PetscReal)(r + 1000*step);
+      ierr = VecRestoreArray(vec,&v);CHKERRQ(ierr);
+      ierr = PetscViewerHDF5SetTimestep(viewer,step);CHKERRQ(ierr);
+      ierr = IGASaveVecTime(iga,vec,(PetscReal)0.25*(step+1),viewer);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+
+    ierr = PetscViewerHDF5Open(comm,"igavec.h5",FILE_MODE_READ,&viewer);CHKERRQ(ierr);
+    ierr = PetscObjectSetName((PetscObject)load,"s");CHKERRQ(ierr);
+    ierr = PetscViewerHDF5SetTimestep(viewer,1);CHKERRQ(ierr);
+    ierr = IGALoadVec(iga,load,viewer);CHKERRQ(ierr);
+    ierr = VecEqual(vec,load,&match);CHKERRQ(ierr);
+    if (!match) SETERRQ(comm,PETSC_ERR_PLIB,"Bad HDF5 time series data in file");
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+    ierr = PetscViewerHDF5Open(comm,"igavec.h5",FILE_MODE_READ,&viewer);CHKERRQ(ierr);
+    ierr = PetscObjectSetName((PetscObject)load,"u");CHKERRQ(ierr);
+    ierr = IGALoadVec(iga,load,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+    ierr = VecShift(vec,-1000.0);CHKERRQ(ierr);
+    ierr = VecEqual(vec,load,&match);CHKERRQ(ierr);
+    if (!match) SETERRQ(comm,PETSC_ERR_PLIB,"Bad HDF5 data in file");
+    ierr = VecDestroy(&load);CHKERRQ(ierr);
+    ierr = VecDestroy(&vec);CHKERRQ(ierr);
+
+    ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+    if (!rank) { /* the XDMF time values are the saved physical times */
+      char   xmf[16384],*found = NULL;
+      size_t len;
+      FILE   *fp;
+      ierr = PetscFOpen(PETSC_COMM_SELF,"igavec.xmf","r",&fp);CHKERRQ(ierr);
+      len = fread(xmf,1,sizeof(xmf)-1,fp); xmf[len] = 0;
+      ierr = PetscFClose(PETSC_COMM_SELF,fp);CHKERRQ(ierr);
+      ierr = PetscStrstr(xmf,"<Time Value=\"0.5\"/>",&found);CHKERRQ(ierr);
+      if (!found) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"XDMF file lacks the physical time of step 1");
+    }
+  }
+#endif
+
+  {
+    IGACheckpoint ckpt;
+    Vec           vecs[2],load[2];
+    PetscReal     t;
+    PetscInt      i,step;
+    PetscBool     match = PETSC_FALSE;
+
+    ierr = IGACreateVec(iga,&vecs[0]);CHKERRQ(ierr);
+    ierr = IGACreateVec(iga,&vecs[1]);CHKERRQ(ierr);
+    ierr = VecSet(vecs[0],1.0);CHKERRQ(ierr);
+    ierr = VecSet(vecs[1],2.0);CHKERRQ(ierr);
+    ierr = IGACheckpointCreate(iga,&ckpt);CHKERRQ(ierr);
+    ierr = IGACheckpointWrite(ckpt,"igackpt0.dat",0.5,5,2,vecs);CHKERRQ(ierr);
+    ierr = VecSet(vecs[0],3.0);CHKERRQ(ierr); /* snapshot already taken */
+    ierr = IGACheckpointWrite(ckpt,"igackpt1.dat",1.0,10,2,vecs);CHKERRQ(ierr);
+    ierr = IGACheckpointWrite(ckpt,"igackpt2.dat",1.5,15,1,vecs);CHKERRQ(ierr);
+    ierr = IGACheckpointDestroy(&ckpt);CHKERRQ(ierr);
+
+    ierr = IGACreateVec(iga,&load[0]);CHKERRQ(ierr);
+    ierr = IGACreateVec(iga,&load[1]);CHKERRQ(ierr);
+    ierr = IGACheckpointRead(iga,"igackpt0.dat",&t,&step,2,load);CHKERRQ(ierr);
+    if (t != 0.5 || step != 5) SETERRQ(comm,PETSC_ERR_PLIB,"Bad checkpoint header");
+    ierr = VecSet(vecs[0],1.0);CHKERRQ(ierr);
+    for (i=0; i<2; i++) {
+      ierr = VecEqual(vecs[i],load[i],&match);CHKERRQ(ierr);
+      if (!match) SETERRQ(comm,PETSC_ERR_PLIB,"Bad checkpoint data in file");
+    }
+    ierr = VecDestroy(&load[0]);CHKERRQ(ierr);
+    ierr = VecDestroy(&load[1]);CHKERRQ(ierr);
+    ierr = VecDestroy(&vecs[0]);CHKERRQ(ierr);
+    ierr = VecDestroy(&vecs[1]);CHKERRQ(ierr);
+  }
+
   {
     Mat         mat;
     Vec         diag,diag2;
@@ -123,6 +123,40 @@ PetscErrorCode Test(IGAProbe prb,PetscReal u[])
   PetscFunctionReturn(0);
 }
 
+#undef  __FUNCT__
+#define __FUNCT__ "TestMany"
+PetscErrorCode TestMany(IGAProbe prb)
+{
+  PetscInt       i,k,dim = prb->dim, npts = 5;
+  PetscReal      u[5*3],X[5*3];
+  PetscScalar    a0[5],a1[5*3];
+  PetscReal      b0,b1[3];
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+
+  for (k=0; k<npts; k++)
+    for (i=0; i<dim; i++)
+      u[i+k*dim] = (PetscReal)k/(PetscReal)(npts-1);
+
+  ierr = IGAProbeSetPoints(prb,npts,u);CHKERRQ(ierr);
+  ierr = IGAProbeSetPoints(prb,npts,u);CHKERRQ(ierr); /* cached */
+  ierr = IGAProbeEvaluateMany(prb,0,a0);CHKERRQ(ierr);
+  ierr = IGAProbeEvaluateMany(prb,1,a1);CHKERRQ(ierr);
+  ierr = IGAProbeGeomMapMany(prb,X);CHKERRQ(ierr);
+
+  for (k=0; k<npts; k++) {
+    PetscReal x[3] = {0.0, 0.0, 0.0};
+    for (i=0; i<dim; i++) x[i] = X[i+k*dim];
+    Function(x,&b0);
+    CheckCLOSE(1e-6,1e-4,PetscRealPart(a0[k]), b0);
+    Gradient(x,b1);
+    for (i=0; i<dim; i++)
+      CheckCLOSE(1e-5,1e-3,PetscRealPart(a1[i+k*dim]), b1[i]);
+  }
+
+  PetscFunctionReturn(0);
+}
+
 int main(int argc, char *argv[]) {
 
   PetscBool      collective = PETSC_TRUE;
@@ -201,6 +235,9 @@ int main(int argc, char *argv[]) {
       PetscReal u[3] = {1.0, 1.0, 1.0};
       ierr = Test(prb,u);CHKERRQ(ierr);
     }
+    if (collective || size == 1) {
+      ierr = TestMany(prb);CHKERRQ(ierr);
+    }
   }
 
   ierr = IGAProbeDestroy(&prb);CHKERRQ(ierr);
@@ -0,0 +1,122 @@
+#include "petiga.h"
+
+EXTERN_C_BEGIN
+extern void IGA_Basis_Lagrange    (PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+extern void IGA_Basis_Hierarchical(PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+EXTERN_C_END
+
+typedef void (*BasisFunction)(PetscInt,PetscReal,PetscInt,PetscInt,const PetscReal[],PetscReal[]);
+
+#define MAXP 16
+#define MAXD 3
+
+/* k-th derivative of u^q */
+static PetscReal Monomial(PetscReal u,PetscInt q,PetscInt k)
+{
+  PetscInt  i;
+  PetscReal c = 1, v = 1;
+  if (k > q) return 0;
+  for (i=0; i<k; i++) c *= (PetscReal)(q-i);
+  for (i=0; i<q-k; i++) v *= u;
+  return c*v;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckDerivatives"
+static PetscErrorCode CheckDerivatives(BasisFunction Basis,const char name[],PetscInt p,const PetscReal U[],PetscReal u)
+{
+  PetscInt  a,k,d = MAXD;
+  PetscReal h = 1e-5*(U[p+1]-U[p]);
+  PetscReal B[(MAXD+1)*(MAXP+1)],Bp[(MAXD+1)*(MAXP+1)],Bm[(MAXD+1)*(MAXP+1)];
+  PetscFunctionBegin;
+  Basis(p,u,p,d,U,B);
+  Basis(p,u+h,p,d,U,Bp);
+  Basis(p,u-h,p,d,U,Bm);
+  for (k=1; k<=d; k++) {
+    PetscReal scale = 1, error = 0;
+    for (a=0; a<=p; a++) scale = PetscMax(scale,PetscAbsReal(B[a*(d+1)+k]));
+    for (a=0; a<=p; a++) {
+      PetscReal fd = (Bp[a*(d+1)+k-1] - Bm[a*(d+1)+k-1])/(2*h);
+      error = PetscMax(error,PetscAbsReal(fd - B[a*(d+1)+k]));
+    }
+    if (error > 1e-5*scale)
+      SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_PLIB,"%s p=%D u=%g: derivative %D off by %g",name,p,(double)u,k,(double)error);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckLagrange"
+static PetscErrorCode CheckLagrange(PetscInt p,const PetscReal U[],PetscReal u)
+{
+  PetscInt  a,k,q,d = MAXD;
+  PetscReal B[(MAXD+1)*(MAXP+1)],X[MAXP+1];
+  PetscFunctionBegin;
+  for (a=0; a<=p; a++) X[a] = U[p] + a*(U[p+1]-U[p])/PetscMax(p,1);
+  IGA_Basis_Lagrange(p,u,p,d,U,B);
+  /* the basis reproduces polynomials up to degree p */
+  for (q=0; q<=p; q++) {
+    for (k=0; k<=d; k++) {
+      PetscReal exact = Monomial(u,q,k), value = 0, scale = 1;
+      for (a=0; a<=p; a++) {
+        value += B[a*(d+1)+k]*Monomial(X[a],q,0);
+        scale = PetscMax(scale,PetscAbsReal(B[a*(d+1)+k]*Monomial(X[a],q,0)));
+      }
+      if (PetscAbsReal(value - exact) > 1e-10*scale)
+        SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Lagrange p=%D u=%g: derivative %D of u^%D off by %g",
+                 p,(double)u,k,q,(double)PetscAbsReal(value-exact));
+    }
+  }
+  /* interpolation at the nodes */
+  for (a=0; a<=p; a++) {
+    PetscInt b;
+    IGA_Basis_Lagrange(p,X[a],p,0,U,B);
+    for (b=0; b<=p; b++)
+      if (B[b] != (PetscReal)(a==b))
+        SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Lagrange p=%D: L_%D(X_%D) is not Kronecker delta",p,b,a);
+  }
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  PetscInt       i,p,pmax = 8,npts = 13,nrep = 10000;
+  PetscBool      timing = PETSC_FALSE;
+  PetscReal      U[2*(MAXP+1)];
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","LagrangeBasis Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-p_max","maximum polynomial degree",__FILE__,pmax,&pmax,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-timing","report time per evaluation",__FILE__,timing,&timing,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-repeat","evaluations per timing",__FILE__,nrep,&nrep,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (pmax < 1 || pmax > MAXP) SETERRQ2(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"p_max must be in [1,%d], got %D",MAXP,pmax);
+
+  for (p=1; p<=pmax; p++) {
+    /* a single element [U[p],U[p+1]] = [-0.5,1.5] */
+    for (i=0; i<=p; i++) {U[i] = -0.5; U[p+1+i] = 1.5;}
+    for (i=0; i<npts; i++) {
+      PetscReal u = U[p] + (i+0.37)*(U[p+1]-U[p])/npts;
+      ierr = CheckLagrange(p,U,u);CHKERRQ(ierr);
+      ierr = CheckDerivatives(IGA_Basis_Lagrange,"Lagrange",p,U,u);CHKERRQ(ierr);
+      ierr = CheckDerivatives(IGA_Basis_Hierarchical,"Hierarchical",p,U,u);CHKERRQ(ierr);
+    }
+    if (timing) {
+      PetscReal      B[(MAXD+1)*(MAXP+1)];
+      PetscLogDouble t0,t1,t2;
+      t0 = MPI_Wtime();
+      for (i=0; i<nrep; i++) IGA_Basis_Lagrange(p,U[p]+(i%npts+0.5)/npts*(U[p+1]-U[p]),p,MAXD,U,B);
+      t1 = MPI_Wtime();
+      for (i=0; i<nrep; i++) IGA_Basis_Hierarchical(p,U[p]+(i%npts+0.5)/npts*(U[p+1]-U[p]),p,MAXD,U,B);
+      t2 = MPI_Wtime();
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"p=%2D  Lagrange %8.3f us  Hierarchical %8.3f us\n",
+                         p,(double)((t1-t0)/nrep*1e6),(double)((t2-t1)/nrep*1e6));CHKERRQ(ierr);
+    }
+  }
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
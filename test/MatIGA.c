@@ -0,0 +1,116 @@
+#include "petiga.h"
+
+#undef  __FUNCT__
+#define __FUNCT__ "Matrix"
+/* nonsymmetric, coupled advection-diffusion-reaction operator */
+PetscErrorCode Matrix(IGAPoint p,PetscScalar *K,void *ctx)
+{
+  PetscInt  dim = p->dim;
+  PetscInt  dof = p->dof;
+  PetscInt  nen = p->nen;
+  PetscReal *N0 = p->shape[0];
+  PetscReal *N1 = p->shape[1];
+  PetscInt  a,b,i,j,k;
+  for (a=0; a<nen; a++)
+    for (i=0; i<dof; i++)
+      for (b=0; b<nen; b++)
+        for (j=0; j<dof; j++) {
+          PetscReal diffusion = 0, advection = 0;
+          for (k=0; k<dim; k++) {
+            diffusion += N1[a*dim+k]*N1[b*dim+k];
+            advection += N0[a]*(k+1)*N1[b*dim+k];
+          }
+          K[((a*dof+i)*nen+b)*dof+j] = ((i==j) ? diffusion : 0) + (i+1)*advection + 0.1*(i+2*j+1)*N0[a]*N0[b];
+        }
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckNorm"
+static PetscErrorCode CheckNorm(const char name[],PetscReal error,PetscReal scale,PetscReal tol)
+{
+  PetscFunctionBegin;
+  if (error > tol*scale)
+    SETERRQ3(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"%s: MATIGA differs from AIJ by %g (scale %g)",name,(double)error,(double)scale);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  IGA            iga;
+  Mat            A,B,C;
+  Vec            x,y,z;
+  PetscReal      tol = 1e-12,error,scale;
+  PetscInt       pass;
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","MatIGA Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tol","relative tolerance",__FILE__,tol,&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  ierr = IGACreate(PETSC_COMM_WORLD,&iga);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,2);CHKERRQ(ierr);
+  ierr = IGASetFromOptions(iga);CHKERRQ(ierr);
+  if (iga->dim < 1) {ierr = IGASetDim(iga,2);CHKERRQ(ierr);}
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+  ierr = IGASetFormMatrix(iga,Matrix,NULL);CHKERRQ(ierr);
+
+  ierr = IGACreateVec(iga,&x);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&y);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&z);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+
+  for (pass=0; pass<2; pass++) {
+    PetscBool roworiented = pass ? PETSC_FALSE : PETSC_TRUE;
+    ierr = IGASetMatType(iga,MATIGA);CHKERRQ(ierr);
+    ierr = IGACreateMat(iga,&A);CHKERRQ(ierr);
+    ierr = MatSetOption(A,MAT_ROW_ORIENTED,roworiented);CHKERRQ(ierr);
+    ierr = IGAComputeMatrix(iga,A);CHKERRQ(ierr);
+    ierr = IGASetMatType(iga,MATAIJ);CHKERRQ(ierr);
+    ierr = IGACreateMat(iga,&B);CHKERRQ(ierr);
+    ierr = MatSetOption(B,MAT_ROW_ORIENTED,roworiented);CHKERRQ(ierr);
+    ierr = IGAComputeMatrix(iga,B);CHKERRQ(ierr);
+
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = MatMult(B,x,z);CHKERRQ(ierr);
+    ierr = VecNorm(z,NORM_INFINITY,&scale);CHKERRQ(ierr);
+    ierr = VecAXPY(y,-1.0,z);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_INFINITY,&error);CHKERRQ(ierr);
+    ierr = CheckNorm("MatMult",error,scale,tol);CHKERRQ(ierr);
+
+    ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);
+    ierr = MatMultTranspose(B,x,z);CHKERRQ(ierr);
+    ierr = VecNorm(z,NORM_INFINITY,&scale);CHKERRQ(ierr);
+    ierr = VecAXPY(y,-1.0,z);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_INFINITY,&error);CHKERRQ(ierr);
+    ierr = CheckNorm("MatMultTranspose",error,scale,tol);CHKERRQ(ierr);
+
+    ierr = MatConvert(A,MATAIJ,MAT_INITIAL_MATRIX,&C);CHKERRQ(ierr);
+    ierr = MatNorm(B,NORM_FROBENIUS,&scale);CHKERRQ(ierr);
+    ierr = MatAXPY(C,-1.0,B,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatNorm(C,NORM_FROBENIUS,&error);CHKERRQ(ierr);
+    ierr = CheckNorm("MatConvert",error,scale,tol);CHKERRQ(ierr);
+    ierr = MatDestroy(&C);CHKERRQ(ierr);
+
+    if (!pass) { /* options without meaning for the stencil are refused */
+      PetscErrorCode refused;
+      ierr = PetscPushErrorHandler(PetscIgnoreErrorHandler,NULL);CHKERRQ(ierr);
+      refused = MatSetOption(A,MAT_USE_INODES,PETSC_TRUE);
+      ierr = PetscPopErrorHandler();CHKERRQ(ierr);
+      if (!refused) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"MATIGA accepted MAT_USE_INODES");
+    }
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
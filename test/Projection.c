@@ -0,0 +1,117 @@
+#include "petiga.h"
+
+typedef struct {
+  const PetscScalar *arrayU;
+  PetscScalar       *U;
+} AppCtx;
+
+/* moments of the spline with coefficients arrayU */
+#undef  __FUNCT__
+#define __FUNCT__ "Moments"
+PetscErrorCode Moments(IGAPoint p,PetscScalar *F,void *ctx)
+{
+  AppCtx   *app = (AppCtx*)ctx;
+  PetscInt a,c,nen = p->nen,dof = p->dof;
+  const PetscInt  *map = p->parent->mapping;
+  const PetscReal *N = p->shape[0];
+  PetscScalar u[16];
+  for (a=0; a<nen; a++)
+    for (c=0; c<dof; c++)
+      app->U[a*dof+c] = app->arrayU[map[a]*dof+c];
+  IGAPointFormValue(p,app->U,u);
+  for (a=0; a<nen; a++)
+    for (c=0; c<dof; c++)
+      F[a*dof+c] = N[a] * u[c];
+  return 0;
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckError"
+static PetscErrorCode CheckError(const char name[],Vec x,Vec x0,PetscReal tol)
+{
+  Vec            e;
+  PetscReal      error,scale;
+  PetscErrorCode ierr;
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&e);CHKERRQ(ierr);
+  ierr = VecWAXPY(e,-1.0,x0,x);CHKERRQ(ierr);
+  ierr = VecNorm(e,NORM_INFINITY,&error);CHKERRQ(ierr);
+  ierr = VecNorm(x0,NORM_INFINITY,&scale);CHKERRQ(ierr);
+  ierr = VecDestroy(&e);CHKERRQ(ierr);
+  if (error > tol*scale)
+    SETERRQ3(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"%s does not reproduce the spline, error %g > %g",name,(double)error,(double)(tol*scale));
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  IGA            iga;
+  AppCtx         app;
+  Vec            x0,x,b,localU;
+  PetscInt       i,dim,dof,nen = 1;
+  PetscBool      rational = PETSC_FALSE;
+  PetscReal      tol = 1e-6;
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","Projection Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-rational","Use rational weights",__FILE__,rational,&rational,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tol","Relative tolerance",__FILE__,tol,&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  ierr = IGACreate(PETSC_COMM_WORLD,&iga);CHKERRQ(ierr);
+  ierr = IGASetDof(iga,1);CHKERRQ(ierr);
+  ierr = IGASetFromOptions(iga);CHKERRQ(ierr);
+  ierr = IGASetUp(iga);CHKERRQ(ierr);
+  ierr = IGAGetDim(iga,&dim);CHKERRQ(ierr);
+  ierr = IGAGetDof(iga,&dof);CHKERRQ(ierr);
+  if (dof > 16) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"dof must be at most 16, got %D",dof);
+
+  if (rational) { /* smooth positive weights, the mass matrix is no longer a Kronecker product */
+    PetscInt *start = iga->node_gstart, *width = iga->node_gwidth, *sizes = iga->node_sizes;
+    PetscInt j,k,pos = 0;
+    ierr = PetscMalloc1(width[0]*width[1]*width[2],&iga->rationalW);CHKERRQ(ierr);
+    for (k=start[2]; k<start[2]+width[2]; k++)
+      for (j=start[1]; j<start[1]+width[1]; j++)
+        for (i=start[0]; i<start[0]+width[0]; i++) {
+          PetscInt c[3] = {i,j,k},d;
+          PetscReal s = 0;
+          for (d=0; d<3; d++) s += (d+1)*(PetscReal)((c[d]+sizes[d]) % sizes[d]);
+          iga->rationalW[pos++] = 1 + 0.5*(PetscReal)sin((double)s);
+        }
+    iga->rational = PETSC_TRUE;
+  }
+
+  for (i=0; i<dim; i++) nen *= iga->axis[i]->p + 1;
+  ierr = PetscMalloc1(nen*dof,&app.U);CHKERRQ(ierr);
+
+  ierr = IGACreateVec(iga,&x0);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&x);CHKERRQ(ierr);
+  ierr = IGACreateVec(iga,&b);CHKERRQ(ierr);
+  ierr = VecSetRandom(x0,NULL);CHKERRQ(ierr);
+  ierr = IGAGetLocalVecArray(iga,x0,&localU,&app.arrayU);CHKERRQ(ierr);
+  ierr = IGASetFormVector(iga,Moments,&app);CHKERRQ(ierr);
+
+  /* L2 projection of a spline, b = M x0 */
+  ierr = IGAComputeVector(iga,b);CHKERRQ(ierr);
+  ierr = IGAProject(iga,b,x);CHKERRQ(ierr);
+  ierr = CheckError("IGAProject",x,x0,tol);CHKERRQ(ierr);
+  ierr = IGAProject(iga,b,x);CHKERRQ(ierr); /* reuse the factorizations */
+  ierr = CheckError("IGAProject",x,x0,tol);CHKERRQ(ierr);
+
+  /* quasi-interpolation of a spline */
+  ierr = IGAQuasiInterpolate(iga,x);CHKERRQ(ierr);
+  ierr = CheckError("IGAQuasiInterpolate",x,x0,tol);CHKERRQ(ierr);
+
+  ierr = IGARestoreLocalVecArray(iga,x0,&localU,&app.arrayU);CHKERRQ(ierr);
+  ierr = PetscFree(app.U);CHKERRQ(ierr);
+  ierr = VecDestroy(&x0);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = IGADestroy(&iga);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include "petiga.h"
+
+EXTERN_C_BEGIN
+extern void IGA_Basis_BSpline(PetscInt i,PetscReal u,PetscInt p,PetscInt d,const PetscReal U[],PetscReal B[]);
+EXTERN_C_END
+
+#define MAXP 8
+#define MAXE 64
+
+/* add w N_a N_b to the mass matrix and w N_a' N_b' to the stiffness matrix */
+static void Accumulate(PetscInt n,PetscInt p,const PetscReal U[],PetscInt k,PetscReal u,PetscReal w,PetscReal M[],PetscReal K[])
+{
+  PetscInt  a,b;
+  PetscReal B[2*(MAXP+1)];
+  IGA_Basis_BSpline(k,u,p,1,U,B);
+  for (a=0; a<=p; a++)
+    for (b=0; b<=p; b++) {
+      PetscInt i = k-p+a, j = k-p+b;
+      M[i*n+j] += w*B[2*a]*B[2*b];
+      K[i*n+j] += w*B[2*a+1]*B[2*b+1];
+    }
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "Compare"
+static PetscErrorCode Compare(const char name[],PetscInt p,PetscInt n,const PetscReal A[],const PetscReal B[],PetscReal tol)
+{
+  PetscInt  i;
+  PetscReal scale = 0, error = 0;
+  PetscFunctionBegin;
+  for (i=0; i<n*n; i++) {
+    scale = PetscMax(scale,PetscAbsReal(B[i]));
+    error = PetscMax(error,PetscAbsReal(A[i]-B[i]));
+  }
+  if (error > tol*scale)
+    SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_PLIB,"p=%D: reduced %s matrix off by %g (scale %g)",p,name,(double)error,(double)scale);
+  PetscFunctionReturn(0);
+}
+
+#undef  __FUNCT__
+#define __FUNCT__ "CheckReduced"
+/* the reduced rule integrates spline products like Gauss-Legendre with p+1 points */
+static PetscErrorCode CheckReduced(IGAAxis axis,PetscReal tol)
+{
+  PetscInt        p = axis->p,nel = axis->nel,n = axis->nnp;
+  const PetscInt  *span = axis->span;
+  const PetscReal *U = axis->U;
+  PetscInt        e,q,pos,total = 0,*count;
+  PetscReal       *X,*W,*Mr,*Kr,*Mg,*Kg;
+  IGARule         gauss;
+  PetscErrorCode  ierr;
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(nel,&count);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nel*(p+1),&X);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nel*(p+1),&W);CHKERRQ(ierr);
+  ierr = PetscCalloc1(n*n,&Mr);CHKERRQ(ierr);
+  ierr = PetscCalloc1(n*n,&Kr);CHKERRQ(ierr);
+  ierr = PetscCalloc1(n*n,&Mg);CHKERRQ(ierr);
+  ierr = PetscCalloc1(n*n,&Kg);CHKERRQ(ierr);
+
+  ierr = IGARuleComputeReduced(axis,count,X,W);CHKERRQ(ierr);
+  for (e=0; e<nel; e++) total += count[e];
+  if (total > nel*(p+1))
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"p=%D: reduced rule has %D points, Gauss-Legendre %D",p,total,nel*(p+1));
+  for (pos=0, e=0; e<nel; e++)
+    for (q=0; q<count[e]; q++, pos++) {
+      if (X[pos] < U[span[e]] || X[pos] > U[span[e]+1])
+        SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"p=%D: point %g outside of element %D",p,(double)X[pos],e);
+      Accumulate(n,p,U,span[e],X[pos],W[pos],Mr,Kr);
+    }
+
+  ierr = IGARuleCreate(&gauss);CHKERRQ(ierr);
+  ierr = IGARuleInit(gauss,p+1);CHKERRQ(ierr);
+  for (e=0; e<nel; e++) {
+    PetscReal u0 = U[span[e]], h = U[span[e]+1] - u0;
+    for (q=0; q<=p; q++)
+      Accumulate(n,p,U,span[e],u0+(gauss->point[q]+1)*h/2,gauss->weight[q]*h/2,Mg,Kg);
+  }
+  ierr = IGARuleDestroy(&gauss);CHKERRQ(ierr);
+
+  ierr = Compare("mass",p,n,Mr,Mg,tol);CHKERRQ(ierr);
+  ierr = Compare("stiffness",p,n,Kr,Kg,tol);CHKERRQ(ierr);
+
+  ierr = PetscFree(count);CHKERRQ(ierr);
+  ierr = PetscFree(X);CHKERRQ(ierr);
+  ierr = PetscFree(W);CHKERRQ(ierr);
+  ierr = PetscFree(Mr);CHKERRQ(ierr);
+  ierr = PetscFree(Kr);CHKERRQ(ierr);
+  ierr = PetscFree(Mg);CHKERRQ(ierr);
+  ierr = PetscFree(Kg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#undef __FUNCT__
+#define __FUNCT__ "main"
+int main(int argc, char *argv[]) {
+
+  PetscInt       i,j,p,pmin = 2,pmax = 6,nel = 24,trial,ntrials = 3;
+  PetscReal      tol = 1e-9;
+  PetscRandom    rnd;
+  IGAAxis        axis;
+  PetscErrorCode ierr;
+  ierr = PetscInitialize(&argc,&argv,0,0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PETSC_COMM_WORLD,"","ReducedRule Options","IGA");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-p_min","minimum polynomial degree",__FILE__,pmin,&pmin,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-p_max","maximum polynomial degree",__FILE__,pmax,&pmax,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-N","number of breaks",__FILE__,nel,&nel,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-trials","random knot vectors per degree",__FILE__,ntrials,&ntrials,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tol","relative tolerance",__FILE__,tol,&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (pmin < 1 || pmax > MAXP || pmin > pmax) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Degrees must be in [1,%d]",MAXP);
+  if (nel < 4 || nel > MAXE) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"N must be in [4,%d]",MAXE);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rnd);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rnd);CHKERRQ(ierr);
+  ierr = IGAAxisCreate(&axis);CHKERRQ(ierr);
+  for (p=pmin; p<=pmax; p++) {
+    for (trial=0; trial<ntrials; trial++) {
+      PetscReal u[MAXE+1],U[(MAXE+1)*MAXP+2];
+      PetscInt  m = 0;
+      /* breaks: a uniform stretch (rules are reused), then random lengths */
+      for (u[0]=0, i=1; i<=nel; i++) {
+        PetscReal r = 0;
+        if (i > nel/3) {ierr = PetscRandomGetValueReal(rnd,&r);CHKERRQ(ierr);}
+        u[i] = u[i-1] + ((i > nel/3) ? (PetscReal)0.1 + 2*r : 1);
+      }
+      for (i=1; i<=nel; i++) u[i] /= u[nel];
+      /* knots: repeated knots, including a C^0 one */
+      for (j=0; j<=p; j++) U[m++] = 0;
+      for (i=1; i<nel; i++) {
+        PetscInt s = 1;
+        if (i % 5 == 2)          s = PetscMin(2,p);
+        if (i == nel/2 + trial)  s = p;
+        for (j=0; j<s; j++) U[m++] = u[i];
+      }
+      for (j=0; j<=p; j++) U[m++] = 1;
+      ierr = IGAAxisInit(axis,p,m-1,U);CHKERRQ(ierr);
+      ierr = IGAAxisSetUp(axis);CHKERRQ(ierr);
+      ierr = CheckReduced(axis,tol);CHKERRQ(ierr);
+    }
+  }
+  ierr = IGAAxisDestroy(&axis);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rnd);CHKERRQ(ierr);
+
+  ierr = PetscFinalize();CHKERRQ(ierr);
+  return 0;
+}